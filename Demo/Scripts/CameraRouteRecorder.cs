@@ -3,6 +3,7 @@ using System.Collections.Generic;
 using System.IO;
 using UnityEngine;
 using System;
+using FoveatedRenderingVRS;
 
 [Serializable]
 public class CameraKeyframe
@@ -29,8 +30,11 @@ public class CameraRoute
 public class CameraRouteRecorder : MonoBehaviour
 {
     public float recordInterval = 0.2f;
+    // Also record a native session trace with gaze, every frame's camera pose and the foveation configuration
+    public bool recordNativeTrace = false;
     private CameraRoute route = new CameraRoute();
     private bool isRecording = false;
+    private bool isTracing = false;
 
     private void Update()
     {
@@ -42,6 +46,23 @@ public class CameraRouteRecorder : MonoBehaviour
             else
                 StopRecording();
         }
+
+        if (isTracing)
+        {
+            Vector3 position = transform.position;
+            Quaternion rotation = transform.rotation;
+            VrsPluginApi.RecordTraceFrame(ref position, ref rotation, Time.unscaledDeltaTime * 1000.0f);
+        }
+    }
+
+    private void OnDisable()
+    {
+        // The plugin outlives play mode in the editor, do not leave the trace open
+        if (isTracing)
+        {
+            isTracing = false;
+            VrsPluginApi.StopTraceRecording();
+        }
     }
 
     private void StartRecording()
@@ -49,6 +70,13 @@ public class CameraRouteRecorder : MonoBehaviour
         route.keyframes.Clear();
         isRecording = true;
         StartCoroutine(RecordRoutine());
+        if (recordNativeTrace)
+        {
+            string tracePath = Path.Combine(Application.dataPath, "CameraRouteMountains.vrstrace");
+            isTracing = VrsPluginApi.StartTraceRecording(tracePath);
+            if (!isTracing)
+                Debug.LogWarning($"Cannot record session trace to {tracePath}");
+        }
         Debug.Log("Recording started.");
     }
 
@@ -57,6 +85,13 @@ public class CameraRouteRecorder : MonoBehaviour
         isRecording = false;
         StopAllCoroutines();
         SaveRoute();
+        if (isTracing)
+        {
+            isTracing = false;
+            VrsPluginApi.GetTraceRecordingStats(out TraceWriterStats stats);
+            VrsPluginApi.StopTraceRecording();
+            Debug.Log($"Session trace saved, {stats.records} records");
+        }
         Debug.Log("Recording stopped and route saved.");
     }
 
@@ -1,40 +1,188 @@
-#include <iostream>
-#include <iomanip>
+// Публикует сэмплы трекера в разделяемую память (SharedGazeRing).
+//
+// Использование: BeamSDK [--source beam|synthetic|replay] [--trace file.csv] [--rate hz] [--loop]
+//                        [--name FoveatedGaze] [--log]
+// --log запускает процесс как читателя: печатает всё, что публикует writer.
+// В Unity кольцо читает плагин VrsBased (SharedGazeReader, GazeTrackingMethod.SharedRing).
+
+#include "GazeSources.h"
+#include "SharedGazeRing.h"
 #include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
 #include <thread>
+
+#ifdef _WIN32
 #include <windows.h>
 #include "eyeware/tracker_client.h"
 
-int main() {
-    // Получаем разрешение монитора
-    int screenWidth = GetSystemMetrics(SM_CXSCREEN);
-    int screenHeight = GetSystemMetrics(SM_CYSCREEN);
+// Источник на основе Beam Eye Tracker
+class BeamGazeSource : public GazeSource {
+public:
+    bool Open() override {
+        // Получаем разрешение монитора
+        screenWidth = GetSystemMetrics(SM_CXSCREEN);
+        screenHeight = GetSystemMetrics(SM_CYSCREEN);
+        return screenWidth > 0 && screenHeight > 0;
+    }
 
-    // Создаем экземпляр клиента трекинга
-    eyeware::TrackerClient tracker;
+    bool Next(SharedGazeRecord &record, int timeoutMs) override {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
 
-    while (true) {
-        if (tracker.connected()) {
-            // Получаем данные положения головы и экрана взгляда
-            auto head_pose = tracker.get_head_pose_info();
-            auto screen_gaze = tracker.get_screen_gaze_info();
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (!tracker.connected()) {
+                // Если соединение не установлено, выводим сообщение каждые 2 секунды
+                auto now = std::chrono::steady_clock::now();
+                if (now - lastWarning > std::chrono::seconds(2)) {
+                    printf("No connection with tracker server\n");
+                    fflush(stdout);
+                    lastWarning = now;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                continue;
+            }
+
+            // SDK не умеет блокирующее ожидание: опрашиваем часто и отдаём только новые данные
+            auto screenGaze = tracker.get_screen_gaze_info();
+            auto headPose = tracker.get_head_pose_info();
+            bool changed = screenGaze.x != lastX || screenGaze.y != lastY || screenGaze.is_lost != lastLost;
+            if (!changed) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            lastX = screenGaze.x;
+            lastY = screenGaze.y;
+            lastLost = screenGaze.is_lost;
 
-            if (!screen_gaze.is_lost) {
-                // Нормализуем координаты взгляда
-                float normalizedX = static_cast<float>(screen_gaze.x) / screenWidth;
-                float normalizedY = static_cast<float>(screen_gaze.y) / screenHeight;
+            record = {};
+            record.captureTimestampUs = GetHostTimestampMicroseconds();
+            record.x = static_cast<float>(screenGaze.x) / screenWidth;
+            record.y = static_cast<float>(screenGaze.y) / screenHeight;
+            record.confidence = static_cast<float>(screenGaze.confidence) / static_cast<float>(eyeware::TrackingConfidence::HIGH);
+            record.flags = screenGaze.is_lost ? 0 : SHARED_GAZE_VALID;
 
-                std::cout << "<x=" << std::fixed << std::setprecision(4) << normalizedX
-                          << ", y=" << std::fixed << std::setprecision(4) << normalizedY
-                          << ">" << std::endl;
+            // Положение головы раньше отбрасывалось, теперь публикуется вместе со взглядом
+            if (!headPose.is_lost) {
+                record.flags |= SHARED_GAZE_HEAD_POSE_VALID;
+                for (int row = 0; row < 3; ++row) {
+                    for (int column = 0; column < 3; ++column) {
+                        record.headRotation[row * 3 + column] = headPose.transform.rotation[row][column];
+                    }
+                }
+                record.headTranslation[0] = headPose.transform.translation.x;
+                record.headTranslation[1] = headPose.transform.translation.y;
+                record.headTranslation[2] = headPose.transform.translation.z;
             }
+            return true;
+        }
+        return false;
+    }
+
+private:
+    eyeware::TrackerClient tracker;
+    int screenWidth = 0;
+    int screenHeight = 0;
+    uint32_t lastX = UINT32_MAX;
+    uint32_t lastY = UINT32_MAX;
+    bool lastLost = true;
+    std::chrono::steady_clock::time_point lastWarning;
+};
+#endif
+
+struct Options {
+    std::string source = "beam";
+    std::string trace;
+    std::string name = "FoveatedGaze";
+    float rate = 120.0f;
+    bool loop = false;
+    bool log = false;
+};
+
+static Options ParseOptions(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--source") && hasValue) {
+            options.source = argv[++i];
+        } else if (!strcmp(argv[i], "--trace") && hasValue) {
+            options.trace = argv[++i];
+        } else if (!strcmp(argv[i], "--name") && hasValue) {
+            options.name = argv[++i];
+        } else if (!strcmp(argv[i], "--rate") && hasValue) {
+            options.rate = static_cast<float>(atof(argv[++i]));
+        } else if (!strcmp(argv[i], "--loop")) {
+            options.loop = true;
+        } else if (!strcmp(argv[i], "--log")) {
+            options.log = true;
+        }
+    }
+    return options;
+}
+
+// Читатель: ждёт события от writer и печатает новые сэмплы
+static int RunLogger(const Options &options) {
+    SharedGazeRing ring;
+    while (!ring.OpenReader(options.name)) {
+        printf("Waiting for publisher %s\n", options.name.c_str());
+        fflush(stdout);
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+
+    uint64_t cursor = ring.GetPublishedCount();
+    SharedGazeRecord records[SharedGazeRing::CAPACITY];
+    for (;;) {
+        if (!ring.WaitForData(cursor, 500)) {
+            continue;
+        }
+
+        size_t count = ring.ReadSince(cursor, records, SharedGazeRing::CAPACITY);
+        uint64_t now = GetHostTimestampMicroseconds();
+        for (size_t i = 0; i < count; ++i) {
+            const SharedGazeRecord &record = records[i];
+            printf("<seq=%llu, x=%.4f, y=%.4f, valid=%u, age=%lluus>\n",
+                   static_cast<unsigned long long>(record.sequence), record.x, record.y, record.flags & SHARED_GAZE_VALID,
+                   static_cast<unsigned long long>(now - record.captureTimestampUs));
+        }
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options = ParseOptions(argc, argv);
+    if (options.log) {
+        return RunLogger(options);
+    }
+
+    std::unique_ptr<GazeSource> source;
+    if (options.source == "synthetic") {
+        source.reset(new SyntheticGazeSource(options.rate));
+    } else if (options.source == "replay") {
+        source.reset(new ReplayGazeSource(options.trace, options.loop));
+#ifdef _WIN32
+    } else if (options.source == "beam") {
+        source.reset(new BeamGazeSource());
+#endif
+    }
+
+    if (!source || !source->Open()) {
+        fprintf(stderr, "Cannot open gaze source %s\n", options.source.c_str());
+        return 1;
+    }
+
+    SharedGazeRing ring;
+    if (!ring.CreateWriter(options.name)) {
+        fprintf(stderr, "Cannot create shared memory %s\n", options.name.c_str());
+        return 1;
+    }
+    printf("Publishing %s gaze to %s\n", options.source.c_str(), options.name.c_str());
+    fflush(stdout);
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
-        } else {
-            // Если соединение не установлено, выводим сообщение каждые 2 секунды
-            const int MESSAGE_PERIOD_IN_SECONDS = 2;
-            std::this_thread::sleep_for(std::chrono::seconds(MESSAGE_PERIOD_IN_SECONDS));
-            std::cout << "No connection with tracker server" << std::endl;
+    SharedGazeRecord record;
+    while (!source->IsFinished()) {
+        if (source->Next(record, 100)) {
+            ring.Publish(record);
         }
     }
 
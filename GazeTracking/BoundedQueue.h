@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Fixed-capacity queue between two pipeline threads. A full queue drops its
+// oldest item instead of blocking the producer, so a slow stage sheds stale
+// work and the newest data always gets through.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+        : items(capacity > 0 ? capacity : 1), head(0), count(0), closed(false) {
+    }
+
+    // Append an item. If the queue was full the oldest item is moved to evicted and true returned.
+    bool Push(const T &item, T &evicted) {
+        bool dropped = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == items.size()) {
+                evicted = items[head];
+                head = (head + 1) % items.size();
+                --count;
+                dropped = true;
+            }
+            items[(head + count) % items.size()] = item;
+            ++count;
+        }
+        available.notify_one();
+        return dropped;
+    }
+
+    // Wait up to timeoutMs for an item, false on timeout or once closed and drained
+    bool Pop(T &item, int timeoutMs) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!available.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return count > 0 || closed; }) || count == 0) {
+            return false;
+        }
+        item = items[head];
+        head = (head + 1) % items.size();
+        --count;
+        return true;
+    }
+
+    // Take an item without waiting
+    bool TryPop(T &item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (count == 0) {
+            return false;
+        }
+        item = items[head];
+        head = (head + 1) % items.size();
+        --count;
+        return true;
+    }
+
+    // Wake every waiter, Pop fails once the remaining items are drained
+    void Close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        available.notify_all();
+    }
+
+    bool IsClosed() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return closed && count == 0;
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::condition_variable available;
+    std::vector<T> items;
+    size_t head;
+    size_t count;
+    bool closed;
+};
@@ -4,12 +4,19 @@ import cv2
 import pygame
 import numpy as np
 import socket
+import struct
+import time
 
 # Настройка связи с Unity через UDP
 UNITY_HOST = '127.0.0.1'
 UNITY_PORT = 50666
 udp_socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
 
+# Бинарный пакет (GazePacket.h): magic, sequence, timestamp (мкс), x, y, valid, confidence
+GAZE_PACKET = struct.Struct('<IIQffB3xf')
+GAZE_PACKET_MAGIC = 0x315A4746
+packet_sequence = 0
+
 pygame.init()
 pygame.font.init()
 
@@ -113,8 +120,11 @@ while running:
 
             # Отправляем координаты в Unity через UDP
             try:
-                data = f"{norm_x:.4f},{norm_y:.4f}"
-                udp_socket.sendto(data.encode(), (UNITY_HOST, UNITY_PORT))
+                packet_sequence = (packet_sequence + 1) & 0xFFFFFFFF
+                timestamp_us = time.perf_counter_ns() // 1000
+                data = GAZE_PACKET.pack(GAZE_PACKET_MAGIC, packet_sequence, timestamp_us,
+                                        norm_x, norm_y, 1, 1.0)
+                udp_socket.sendto(data, (UNITY_HOST, UNITY_PORT))
             except Exception as e:
                 print(f"Ошибка передачи: {e}")
 
@@ -0,0 +1,327 @@
+#include "FrameSources.h"
+#include "GazeSources.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#ifdef GAZE_WITH_OPENCV
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+#endif
+
+// Period of a frame rate, zero for unpaced sources
+static std::chrono::steady_clock::duration FramePeriod(float rateHz) {
+    if (rateHz <= 0.0f) {
+        return std::chrono::steady_clock::duration::zero();
+    }
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / rateHz));
+}
+
+// Sleep until a paced frame is due, false if it is not due within the timeout
+static bool WaitForFrame(std::chrono::steady_clock::time_point &due, std::chrono::steady_clock::duration period, int timeoutMs) {
+    if (period == std::chrono::steady_clock::duration::zero()) {
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (due - now > std::chrono::milliseconds(timeoutMs)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        return false;
+    }
+    std::this_thread::sleep_until(due);
+
+    // A stalled consumer must not make the source burst to catch up
+    due = (std::max)(due + period, now);
+    return true;
+}
+
+// Next header token of a netpbm file, comments skipped
+static bool ReadPnmToken(FILE *file, char *token, size_t size) {
+    int c = fgetc(file);
+    for (;;) {
+        while (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            c = fgetc(file);
+        }
+        if (c != '#') {
+            break;
+        }
+        while (c != EOF && c != '\n') {
+            c = fgetc(file);
+        }
+    }
+
+    size_t used = 0;
+    while (c != EOF && c != ' ' && c != '\t' && c != '\r' && c != '\n' && used + 1 < size) {
+        token[used++] = static_cast<char>(c);
+        c = fgetc(file);
+    }
+    token[used] = '\0';
+    return used > 0;
+}
+
+// Load a binary PGM (P5) or PPM (P6) with 8-bit samples, color is converted to luma
+static bool ReadPnm(const std::string &path, GrayFrame &frame) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+
+    char magic[4], widthText[16], heightText[16], maxText[16];
+    bool valid = ReadPnmToken(file, magic, sizeof(magic)) && ReadPnmToken(file, widthText, sizeof(widthText)) &&
+                 ReadPnmToken(file, heightText, sizeof(heightText)) && ReadPnmToken(file, maxText, sizeof(maxText));
+    bool color = valid && strcmp(magic, "P6") == 0;
+    int width = valid ? atoi(widthText) : 0;
+    int height = valid ? atoi(heightText) : 0;
+    valid = valid && (color || strcmp(magic, "P5") == 0) && width > 0 && height > 0 && atoi(maxText) == 255;
+    if (!valid) {
+        fclose(file);
+        return false;
+    }
+
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    frame.width = width;
+    frame.height = height;
+    frame.pixels.resize(pixelCount);
+    if (!color) {
+        valid = fread(frame.pixels.data(), 1, pixelCount, file) == pixelCount;
+    } else {
+        // One row of RGB at a time keeps the scratch buffer small
+        std::vector<uint8_t> row(static_cast<size_t>(width) * 3);
+        for (int y = 0; y < height && valid; ++y) {
+            valid = fread(row.data(), 1, row.size(), file) == row.size();
+            uint8_t *out = frame.pixels.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                const uint8_t *rgb = row.data() + x * 3;
+                out[x] = static_cast<uint8_t>((77 * rgb[0] + 150 * rgb[1] + 29 * rgb[2]) >> 8);
+            }
+        }
+    }
+    fclose(file);
+    return valid;
+}
+
+bool WritePgm(const std::string &path, const GrayFrame &frame) {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    fprintf(file, "P5\n%d %d\n255\n", frame.width, frame.height);
+    size_t pixelCount = static_cast<size_t>(frame.width) * frame.height;
+    bool written = fwrite(frame.pixels.data(), 1, pixelCount, file) == pixelCount;
+    return fclose(file) == 0 && written;
+}
+
+// ImageSequenceFrameSource
+
+ImageSequenceFrameSource::ImageSequenceFrameSource(const std::string &framePattern, float rateHz, bool loopSequence)
+    : pattern(framePattern), period(FramePeriod(rateHz)), loop(loopSequence), finished(false),
+    firstNumber(0), number(0), index(0) {
+}
+
+std::string ImageSequenceFrameSource::FramePath(int frameNumber) const {
+    char path[1024];
+    snprintf(path, sizeof(path), pattern.c_str(), frameNumber);
+    return path;
+}
+
+bool ImageSequenceFrameSource::Open() {
+    // Sequences are numbered from either zero or one
+    for (firstNumber = 0; firstNumber <= 1; ++firstNumber) {
+        FILE *file = fopen(FramePath(firstNumber).c_str(), "rb");
+        if (file) {
+            fclose(file);
+            number = firstNumber;
+            nextFrame = std::chrono::steady_clock::now();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ImageSequenceFrameSource::Next(GrayFrame &frame, int timeoutMs) {
+    if (finished || !WaitForFrame(nextFrame, period, timeoutMs)) {
+        return false;
+    }
+
+    uint64_t captureTime = GetHostTimestampMicroseconds();
+    if (!ReadPnm(FramePath(number), frame)) {
+        // The first missing number ends the sequence
+        if (!loop || number == firstNumber) {
+            finished = true;
+            return false;
+        }
+        number = firstNumber;
+        if (!ReadPnm(FramePath(number), frame)) {
+            finished = true;
+            return false;
+        }
+    }
+
+    ++number;
+    frame.index = index++;
+    frame.captureTimestampUs = captureTime;
+    frame.hasTruth = false;
+    return true;
+}
+
+// SyntheticFrameSource
+
+SyntheticFrameSource::SyntheticFrameSource(int frameWidth, int frameHeight, float rateHz, uint64_t frames)
+    : width(frameWidth), height(frameHeight), period(FramePeriod(rateHz)), frameCount(frames), index(0),
+    rng(1234), noiseState(0x9e3779b9u), fromX(0.0f), fromY(0.0f), toX(0.0f), toY(0.0f), saccadeStart(0) {
+}
+
+bool SyntheticFrameSource::Open() {
+    nextFrame = std::chrono::steady_clock::now();
+    return width >= 64 && height >= 48;
+}
+
+bool SyntheticFrameSource::Next(GrayFrame &frame, int timeoutMs) {
+    if (IsFinished() || !WaitForFrame(nextFrame, period, timeoutMs)) {
+        return false;
+    }
+
+    // Unpaced replays keep the 30 Hz timeline of a typical webcam
+    double seconds = period == std::chrono::steady_clock::duration::zero() ? 1.0 / 30.0 : std::chrono::duration<double>(period).count();
+    double time = index * seconds;
+
+    // New fixation on the screen every ~600 ms, reached by a 40 ms saccade
+    uint64_t fixationFrames = static_cast<uint64_t>(0.6 / seconds) + 1;
+    uint64_t saccadeFrames = static_cast<uint64_t>(0.04 / seconds) + 1;
+    if (index % fixationFrames == 0) {
+        std::uniform_real_distribution<float> targetX(-0.9f, 0.9f);
+        std::uniform_real_distribution<float> targetY(-0.9f, 0.9f);
+        fromX = toX;
+        fromY = toY;
+        toX = targetX(rng);
+        toY = targetY(rng);
+        saccadeStart = index;
+    }
+    float progress = static_cast<float>(index - saccadeStart) / saccadeFrames;
+    progress = progress > 1.0f ? 1.0f : 0.5f - 0.5f * cosf(3.14159265f * progress);
+    float gazeX = fromX + (toX - fromX) * progress;
+    float gazeY = fromY + (toY - fromY) * progress;
+
+    // Eye model: the screen spans about +-29 degrees across and +-18 degrees up and down from
+    // the eye, the camera sits above the screen, and the iris offset is the sine of the angle
+    float angleX = atanf(0.55f * gazeX);
+    float angleY = atanf(0.32f * gazeY - 0.12f);
+    float featureX = 0.9f * sinf(angleX) * (1.0f - 0.15f * sinf(angleY));
+    float featureY = 0.6f * sinf(angleY);
+
+    // Slow head drift, and a 150 ms blink every four seconds
+    float headX = 0.02f * width * static_cast<float>(sin(6.2831853 * time / 7.0));
+    float headY = 0.015f * height * static_cast<float>(sin(6.2831853 * time / 5.0));
+    double blinkPhase = fmod(time, 4.0) - 3.85;
+    float openness = blinkPhase > 0.0 ? 0.05f : 1.0f;
+
+    uint64_t captureTime = GetHostTimestampMicroseconds();
+    Render(frame, featureX, featureY, headX, headY, openness);
+    frame.index = index++;
+    frame.captureTimestampUs = captureTime;
+    frame.hasTruth = openness > 0.5f;
+    frame.truthX = gazeX;
+    frame.truthY = gazeY;
+    return true;
+}
+
+void SyntheticFrameSource::Render(GrayFrame &frame, float featureX, float featureY, float headX, float headY, float openness) {
+    frame.width = width;
+    frame.height = height;
+    frame.pixels.assign(static_cast<size_t>(width) * height, 120);
+
+    // Eye openings, irises offset by the feature in units of the half-width, and eyebrows as distractors
+    float halfWidth = 0.055f * width;
+    float halfHeight = 0.45f * halfWidth * openness;
+    float irisRadius = 0.42f * halfWidth;
+    for (int eye = 0; eye < 2; ++eye) {
+        float centerX = (eye == 0 ? 0.38f : 0.62f) * width + headX;
+        float centerY = 0.42f * height + headY;
+        float irisX = centerX + featureX * halfWidth;
+        float irisY = centerY - featureY * halfWidth;
+
+        int browTop = static_cast<int>(centerY - 1.6f * halfWidth);
+        for (int y = (std::max)(browTop, 0); y < (std::min)(browTop + static_cast<int>(0.25f * halfWidth), height); ++y) {
+            for (int x = (std::max)(static_cast<int>(centerX - 1.1f * halfWidth), 0);
+                 x < (std::min)(static_cast<int>(centerX + 1.1f * halfWidth), width); ++x) {
+                frame.pixels[static_cast<size_t>(y) * width + x] = 80;
+            }
+        }
+
+        if (halfHeight < 1.0f) {
+            continue;
+        }
+        for (int y = (std::max)(static_cast<int>(centerY - halfHeight), 0); y <= (std::min)(static_cast<int>(centerY + halfHeight), height - 1); ++y) {
+            for (int x = (std::max)(static_cast<int>(centerX - halfWidth), 0); x <= (std::min)(static_cast<int>(centerX + halfWidth), width - 1); ++x) {
+                float ex = (x - centerX) / halfWidth;
+                float ey = (y - centerY) / halfHeight;
+                if (ex * ex + ey * ey > 1.0f) {
+                    continue;
+                }
+
+                float ix = x - irisX;
+                float iy = y - irisY;
+                float distance2 = ix * ix + iy * iy;
+                uint8_t value = 205;
+                if (distance2 <= irisRadius * irisRadius) {
+                    value = distance2 <= 0.2f * irisRadius * irisRadius ? 25 : 60;
+                }
+                frame.pixels[static_cast<size_t>(y) * width + x] = value;
+            }
+        }
+    }
+
+    // Sensor noise, xorshift is plenty and keeps rendering cheap
+    for (uint8_t &pixel : frame.pixels) {
+        noiseState ^= noiseState << 13;
+        noiseState ^= noiseState >> 17;
+        noiseState ^= noiseState << 5;
+        pixel = static_cast<uint8_t>(pixel + (noiseState & 15) - 8);
+    }
+}
+
+#ifdef GAZE_WITH_OPENCV
+// CameraFrameSource
+
+CameraFrameSource::CameraFrameSource(int cameraDevice)
+    : device(cameraDevice), capture(nullptr), index(0) {
+}
+
+CameraFrameSource::~CameraFrameSource() {
+    delete capture;
+}
+
+bool CameraFrameSource::Open() {
+    capture = new cv::VideoCapture(device);
+    return capture->isOpened();
+}
+
+bool CameraFrameSource::Next(GrayFrame &frame, int timeoutMs) {
+    // VideoCapture blocks until the driver delivers, the timeout is not needed
+    (void)timeoutMs;
+    cv::Mat color;
+    if (!capture->read(color) || color.empty()) {
+        return false;
+    }
+    uint64_t captureTime = GetHostTimestampMicroseconds();
+
+    frame.width = color.cols;
+    frame.height = color.rows;
+    frame.pixels.resize(static_cast<size_t>(color.cols) * color.rows);
+    cv::Mat gray(color.rows, color.cols, CV_8UC1, frame.pixels.data());
+    if (color.channels() == 1) {
+        color.copyTo(gray);
+    } else {
+        cv::cvtColor(color, gray, cv::COLOR_BGR2GRAY);
+    }
+
+    frame.index = index++;
+    frame.captureTimestampUs = captureTime;
+    frame.hasTruth = false;
+    return true;
+}
+#endif
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Grayscale camera frame, one byte per pixel, rows tightly packed
+struct GrayFrame {
+    uint64_t index;               // Position in the source, assigned by the source
+    uint64_t captureTimestampUs;  // Host clock when the source began acquiring it, see GetHostTimestampMicroseconds
+    int width;
+    int height;
+    std::vector<uint8_t> pixels;
+
+    // Screen gaze the frame was rendered looking at, in the GazePacket convention, synthetic frames only
+    bool hasTruth;
+    float truthX;
+    float truthY;
+};
+
+// Source of camera frames driving the webcam gaze pipeline
+class FrameSource {
+public:
+    virtual ~FrameSource() {}
+
+    // Prepare the source, returns false if it cannot deliver frames
+    virtual bool Open() = 0;
+
+    // Wait for the next frame, returns false on timeout or when the source is exhausted.
+    // The frame's pixel buffer is reused, so a steady stream does not allocate.
+    virtual bool Next(GrayFrame &frame, int timeoutMs) = 0;
+
+    // True once no further frames will arrive
+    virtual bool IsFinished() const { return false; }
+};
+
+// Numbered PGM/PPM images ("frames/%06d.pgm"), read one at a time while streaming.
+// A rate of zero delivers frames as fast as they decode, for benchmarking.
+class ImageSequenceFrameSource : public FrameSource {
+public:
+    ImageSequenceFrameSource(const std::string &pattern, float rateHz, bool loop);
+
+    bool Open() override;
+    bool Next(GrayFrame &frame, int timeoutMs) override;
+    bool IsFinished() const override { return finished; }
+
+private:
+    std::string FramePath(int number) const;
+
+    std::string pattern;
+    std::chrono::steady_clock::duration period;
+    bool loop;
+    bool finished;
+    int firstNumber;
+    int number;
+    uint64_t index;
+    std::chrono::steady_clock::time_point nextFrame;
+};
+
+// Renders a face with two eyes looking at screen points in a fixation/saccade
+// pattern, with sensor noise, slow head drift and blinks. Iris offsets follow
+// the screen point through a nonlinear eye model (viewing angles, camera above
+// the screen). Frames carry the screen point, so detection and calibration
+// accuracy can be measured without a camera.
+class SyntheticFrameSource : public FrameSource {
+public:
+    SyntheticFrameSource(int width, int height, float rateHz, uint64_t frameCount);
+
+    bool Open() override;
+    bool Next(GrayFrame &frame, int timeoutMs) override;
+    bool IsFinished() const override { return frameCount > 0 && index >= frameCount; }
+
+private:
+    void Render(GrayFrame &frame, float featureX, float featureY, float headX, float headY, float openness);
+
+    int width;
+    int height;
+    std::chrono::steady_clock::duration period;
+    uint64_t frameCount;
+    uint64_t index;
+    std::chrono::steady_clock::time_point nextFrame;
+    std::mt19937 rng;
+    uint32_t noiseState;
+    float fromX, fromY, toX, toY;
+    uint64_t saccadeStart;
+};
+
+#ifdef GAZE_WITH_OPENCV
+namespace cv {
+class VideoCapture;
+}
+
+// Webcam frames through OpenCV, converted to grayscale
+class CameraFrameSource : public FrameSource {
+public:
+    explicit CameraFrameSource(int device);
+    ~CameraFrameSource();
+
+    bool Open() override;
+    bool Next(GrayFrame &frame, int timeoutMs) override;
+
+private:
+    int device;
+    cv::VideoCapture *capture;
+    uint64_t index;
+};
+#endif
+
+// Write a frame as a binary PGM, returns false if the file cannot be written
+bool WritePgm(const std::string &path, const GrayFrame &frame);
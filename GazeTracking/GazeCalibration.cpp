@@ -0,0 +1,284 @@
+#include "GazeCalibration.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// Profile file: header, then weights[2][terms], covariance[terms * terms] and
+// residualSquares[2] as doubles. All fields are little endian.
+static const char PROFILE_MAGIC[8] = {'G', 'A', 'Z', 'E', 'C', 'A', 'L', 'B'};
+static const uint32_t PROFILE_VERSION = 1;
+
+#pragma pack(push, 1)
+struct CalibrationProfileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t model;
+    int32_t polynomialDegree;
+    int32_t rbfGrid;
+    float rbfRange;
+    float forgetting;
+    float priorVariance;
+    float priorGainX;
+    float priorGainY;
+    uint32_t termCount;
+    uint64_t samples;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(CalibrationProfileHeader) == 56, "Calibration profile header layout");
+
+// Terms of a full polynomial in two variables up to a degree
+static int PolynomialTerms(int degree) {
+    return (degree + 1) * (degree + 2) / 2;
+}
+
+GazeCalibration::GazeCalibration()
+    : settings(GetDefaultSettings()), termCount(0), rbfCenters{}, rbfScale(0.0f), samples(0) {
+    Configure(settings);
+}
+
+GazeCalibrationSettings GazeCalibration::GetDefaultSettings() {
+    GazeCalibrationSettings defaults = {};
+    defaults.model = CalibrationModel::POLYNOMIAL;
+    defaults.polynomialDegree = 2;
+    defaults.rbfGrid = 4;
+    defaults.rbfRange = 0.4f;
+    defaults.forgetting = 1.0f;
+    defaults.priorVariance = 100.0f;
+    defaults.priorGainX = 2.5f;
+    defaults.priorGainY = 4.0f;
+    return defaults;
+}
+
+void GazeCalibration::Configure(const GazeCalibrationSettings &calibrationSettings) {
+    settings = calibrationSettings;
+    settings.polynomialDegree = (std::max)(1, (std::min)(3, settings.polynomialDegree));
+    settings.rbfGrid = (std::max)(2, (std::min)(6, settings.rbfGrid));
+    settings.rbfRange = (std::max)(0.01f, settings.rbfRange);
+    settings.forgetting = (std::max)(0.9f, (std::min)(1.0f, settings.forgetting));
+    settings.priorVariance = (std::max)(1e-6f, settings.priorVariance);
+
+    if (settings.model == CalibrationModel::RBF) {
+        termCount = 3 + settings.rbfGrid * settings.rbfGrid;
+
+        // Neighbouring bumps overlap by one sigma, so the sum stays smooth between centers
+        float spacing = 2.0f * settings.rbfRange / (settings.rbfGrid - 1);
+        for (int i = 0; i < settings.rbfGrid; ++i) {
+            rbfCenters[i] = -settings.rbfRange + i * spacing;
+        }
+        rbfScale = -1.0f / (2.0f * spacing * spacing);
+    } else {
+        termCount = PolynomialTerms(settings.polynomialDegree);
+    }
+    Reset();
+}
+
+void GazeCalibration::Reset() {
+    memset(weights, 0, sizeof(weights));
+    memset(covariance, 0, sizeof(covariance));
+
+    // Both models start with 1, x, y, so the prior is the linear gain
+    weights[0][1] = settings.priorGainX;
+    weights[1][2] = settings.priorGainY;
+    for (int i = 0; i < termCount; ++i) {
+        covariance[i * MAX_TERMS + i] = settings.priorVariance;
+    }
+
+    samples = 0;
+    residualSquares[0] = 0.0;
+    residualSquares[1] = 0.0;
+    UpdateMapWeights();
+}
+
+int GazeCalibration::Basis(float featureX, float featureY, float *terms) const {
+    terms[0] = 1.0f;
+    terms[1] = featureX;
+    terms[2] = featureY;
+
+    if (settings.model == CalibrationModel::RBF) {
+        // Gaussians are separable, so a grid of bumps costs two exponentials per axis center
+        float bumpX[6];
+        float bumpY[6];
+        for (int i = 0; i < settings.rbfGrid; ++i) {
+            float dx = featureX - rbfCenters[i];
+            float dy = featureY - rbfCenters[i];
+            bumpX[i] = expf(rbfScale * dx * dx);
+            bumpY[i] = expf(rbfScale * dy * dy);
+        }
+        int term = 3;
+        for (int j = 0; j < settings.rbfGrid; ++j) {
+            for (int i = 0; i < settings.rbfGrid; ++i) {
+                terms[term++] = bumpX[i] * bumpY[j];
+            }
+        }
+        return term;
+    }
+
+    int term = 3;
+    if (settings.polynomialDegree >= 2) {
+        terms[term++] = featureX * featureX;
+        terms[term++] = featureX * featureY;
+        terms[term++] = featureY * featureY;
+    }
+    if (settings.polynomialDegree >= 3) {
+        terms[term++] = featureX * featureX * featureX;
+        terms[term++] = featureX * featureX * featureY;
+        terms[term++] = featureX * featureY * featureY;
+        terms[term++] = featureY * featureY * featureY;
+    }
+    return term;
+}
+
+void GazeCalibration::AddSample(float featureX, float featureY, float targetX, float targetY) {
+    float basis[MAX_TERMS];
+    int n = Basis(featureX, featureY, basis);
+
+    // Gain k = P phi / (lambda + phi' P phi); both outputs share the basis and so the covariance
+    double projected[MAX_TERMS];
+    double denominator = settings.forgetting;
+    for (int i = 0; i < n; ++i) {
+        const double *row = &covariance[i * MAX_TERMS];
+        double sum = 0.0;
+        for (int j = 0; j < n; ++j) {
+            sum += row[j] * basis[j];
+        }
+        projected[i] = sum;
+        denominator += basis[i] * sum;
+    }
+
+    const double targets[2] = {targetX, targetY};
+    for (int output = 0; output < 2; ++output) {
+        double predicted = 0.0;
+        for (int i = 0; i < n; ++i) {
+            predicted += weights[output][i] * basis[i];
+        }
+        double residual = targets[output] - predicted;
+        residualSquares[output] += residual * residual;
+        for (int i = 0; i < n; ++i) {
+            weights[output][i] += projected[i] * residual / denominator;
+        }
+    }
+
+    // P = (P - k phi' P) / lambda, P stays symmetric so only the upper half is computed
+    double inverseForgetting = 1.0 / settings.forgetting;
+    for (int i = 0; i < n; ++i) {
+        for (int j = i; j < n; ++j) {
+            double value = (covariance[i * MAX_TERMS + j] - projected[i] * projected[j] / denominator) * inverseForgetting;
+            covariance[i * MAX_TERMS + j] = value;
+            covariance[j * MAX_TERMS + i] = value;
+        }
+    }
+
+    ++samples;
+    UpdateMapWeights();
+}
+
+void GazeCalibration::Map(float featureX, float featureY, float &x, float &y) const {
+    float basis[MAX_TERMS];
+    int n = Basis(featureX, featureY, basis);
+
+    float sumX = 0.0f;
+    float sumY = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        sumX += mapWeights[0][i] * basis[i];
+        sumY += mapWeights[1][i] * basis[i];
+    }
+    x = sumX;
+    y = sumY;
+}
+
+void GazeCalibration::UpdateMapWeights() {
+    for (int output = 0; output < 2; ++output) {
+        for (int i = 0; i < MAX_TERMS; ++i) {
+            mapWeights[output][i] = static_cast<float>(weights[output][i]);
+        }
+    }
+}
+
+GazeCalibrationStats GazeCalibration::GetStats() const {
+    GazeCalibrationStats stats = {};
+    stats.samples = samples;
+    if (samples > 0) {
+        stats.residualRmsX = static_cast<float>(sqrt(residualSquares[0] / samples));
+        stats.residualRmsY = static_cast<float>(sqrt(residualSquares[1] / samples));
+    }
+    return stats;
+}
+
+bool GazeCalibration::Save(const std::string &path) const {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    CalibrationProfileHeader header = {};
+    memcpy(header.magic, PROFILE_MAGIC, sizeof(header.magic));
+    header.version = PROFILE_VERSION;
+    header.model = static_cast<uint32_t>(settings.model);
+    header.polynomialDegree = settings.polynomialDegree;
+    header.rbfGrid = settings.rbfGrid;
+    header.rbfRange = settings.rbfRange;
+    header.forgetting = settings.forgetting;
+    header.priorVariance = settings.priorVariance;
+    header.priorGainX = settings.priorGainX;
+    header.priorGainY = settings.priorGainY;
+    header.termCount = static_cast<uint32_t>(termCount);
+    header.samples = samples;
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (int output = 0; output < 2 && written; ++output) {
+        written = fwrite(weights[output], sizeof(double), termCount, file) == static_cast<size_t>(termCount);
+    }
+    for (int i = 0; i < termCount && written; ++i) {
+        written = fwrite(&covariance[i * MAX_TERMS], sizeof(double), termCount, file) == static_cast<size_t>(termCount);
+    }
+    written = written && fwrite(residualSquares, sizeof(double), 2, file) == 2;
+    return fclose(file) == 0 && written;
+}
+
+bool GazeCalibration::Load(const std::string &path) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+
+    CalibrationProfileHeader header = {};
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, PROFILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != PROFILE_VERSION || header.model > static_cast<uint32_t>(CalibrationModel::RBF)) {
+        fclose(file);
+        return false;
+    }
+
+    // Configure on a copy, a truncated or inconsistent profile must not replace the current fit
+    GazeCalibration loaded;
+    GazeCalibrationSettings loadedSettings = {};
+    loadedSettings.model = static_cast<CalibrationModel>(header.model);
+    loadedSettings.polynomialDegree = header.polynomialDegree;
+    loadedSettings.rbfGrid = header.rbfGrid;
+    loadedSettings.rbfRange = header.rbfRange;
+    loadedSettings.forgetting = header.forgetting;
+    loadedSettings.priorVariance = header.priorVariance;
+    loadedSettings.priorGainX = header.priorGainX;
+    loadedSettings.priorGainY = header.priorGainY;
+    loaded.Configure(loadedSettings);
+
+    int n = loaded.termCount;
+    bool read = header.termCount == static_cast<uint32_t>(n);
+    for (int output = 0; output < 2 && read; ++output) {
+        read = fread(loaded.weights[output], sizeof(double), n, file) == static_cast<size_t>(n);
+    }
+    for (int i = 0; i < n && read; ++i) {
+        read = fread(&loaded.covariance[i * MAX_TERMS], sizeof(double), n, file) == static_cast<size_t>(n);
+    }
+    read = read && fread(loaded.residualSquares, sizeof(double), 2, file) == 2;
+    fclose(file);
+    if (!read) {
+        return false;
+    }
+
+    loaded.samples = header.samples;
+    loaded.UpdateMapWeights();
+    *this = loaded;
+    return true;
+}
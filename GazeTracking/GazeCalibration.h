@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+enum class CalibrationModel {
+    POLYNOMIAL = 0,     // Monomials of the feature up to the configured degree
+    RBF = 1             // Affine terms plus Gaussian bumps on a grid over the feature range
+};
+
+struct GazeCalibrationSettings {
+    CalibrationModel model;
+    int polynomialDegree;   // 1 to 3
+    int rbfGrid;            // Centers per axis, 2 to 6
+    float rbfRange;         // Centers span [-range, range] of the feature
+    float forgetting;       // RLS forgetting factor in (0.9, 1], below 1 follows slow drift
+    float priorVariance;    // Initial weight variance, smaller keeps the fit closer to the prior gain
+
+    // Linear mapping used before any calibration sample, and the fit's prior
+    float priorGainX;
+    float priorGainY;
+};
+
+// Running fit quality, residuals are measured before each sample updated the fit
+struct GazeCalibrationStats {
+    uint64_t samples;
+    float residualRmsX;
+    float residualRmsY;
+};
+
+// Mapping from the detector's gaze feature to [-1, 1] screen gaze (GazePacket
+// convention), fitted by recursive least squares while calibration targets
+// are shown. Every sample refines the fit in O(terms^2) without storing
+// samples, so calibration converges while the user looks at the targets and
+// can keep adapting afterwards. The weights and the RLS covariance are saved
+// as a per-user profile, a loaded profile continues where it stopped.
+class GazeCalibration {
+public:
+    static const int MAX_TERMS = 40;
+
+    GazeCalibration();
+
+    // Choose the model and start over from the prior gain
+    void Configure(const GazeCalibrationSettings &settings);
+
+    // Forget every sample, the mapping returns to the prior gain
+    void Reset();
+
+    // Fit one feature observed while the user looked at target (screen gaze)
+    void AddSample(float featureX, float featureY, float targetX, float targetY);
+
+    // Screen gaze of a feature, unclamped
+    void Map(float featureX, float featureY, float &x, float &y) const;
+
+    GazeCalibrationStats GetStats() const;
+    const GazeCalibrationSettings &GetSettings() const { return settings; }
+
+    // Write the model, weights and covariance
+    bool Save(const std::string &path) const;
+
+    // Replace the calibration by a saved profile, false leaves it unchanged
+    bool Load(const std::string &path);
+
+    static GazeCalibrationSettings GetDefaultSettings();
+
+private:
+    // Basis functions of a feature, returns the term count
+    int Basis(float featureX, float featureY, float *terms) const;
+
+    // Refresh the single precision copy Map evaluates
+    void UpdateMapWeights();
+
+    GazeCalibrationSettings settings;
+    int termCount;
+    float rbfCenters[6];
+    float rbfScale;             // -1 / (2 sigma^2)
+
+    double weights[2][MAX_TERMS];
+    double covariance[MAX_TERMS * MAX_TERMS];
+    float mapWeights[2][MAX_TERMS];
+
+    uint64_t samples;
+    double residualSquares[2];
+};
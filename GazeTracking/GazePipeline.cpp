@@ -0,0 +1,275 @@
+#include "GazePipeline.h"
+#include "GazeSources.h"
+#include <algorithm>
+
+// Wake-up interval of idle stages, bounds how long Stop waits for them
+static const int STAGE_TIMEOUT_MS = 50;
+
+GazePipeline::GazePipeline()
+    : source(nullptr), settings(GetDefaultSettings()), calibration(&defaultCalibration), target{}, running(false),
+    finished(false), framesWithGaze(0) {
+    ResetStats();
+}
+
+GazePipeline::~GazePipeline() {
+    Stop();
+}
+
+GazePipelineSettings GazePipeline::GetDefaultSettings() {
+    GazePipelineSettings defaults = {};
+    defaults.queueCapacity = 2;
+    defaults.detector = IrisDetector::GetDefaultSettings();
+    defaults.filterStages[0] = GazeFilterType::ONE_EURO;
+    defaults.filterStageCount = 1;
+    defaults.filters = GazeFilterChain::GetDefaultSettings();
+    defaults.calibrationSettleMs = 400;
+    defaults.truthCalibrationFrames = 0;
+    return defaults;
+}
+
+void GazePipeline::AddSink(GazeSink *sink) {
+    if (sink && !running.load(std::memory_order_acquire)) {
+        sinks.push_back(sink);
+    }
+}
+
+void GazePipeline::SetCalibration(GazeCalibration *gazeCalibration) {
+    if (!running.load(std::memory_order_acquire)) {
+        calibration = gazeCalibration ? gazeCalibration : &defaultCalibration;
+    }
+}
+
+void GazePipeline::SetCalibrationTarget(float x, float y) {
+    std::lock_guard<std::mutex> lock(targetMutex);
+    target.active = true;
+    target.x = x;
+    target.y = y;
+    target.shownUs = GetHostTimestampMicroseconds();
+}
+
+void GazePipeline::ClearCalibrationTarget() {
+    std::lock_guard<std::mutex> lock(targetMutex);
+    target.active = false;
+}
+
+bool GazePipeline::Start(FrameSource *frameSource, const GazePipelineSettings &pipelineSettings) {
+    if (running.load(std::memory_order_acquire) || !frameSource) {
+        return false;
+    }
+
+    source = frameSource;
+    settings = pipelineSettings;
+    size_t capacity = static_cast<size_t>((std::max)(settings.queueCapacity, 1));
+
+    // One frame is being captured and one detected besides the queued ones, so the pool never runs dry
+    framePool.clear();
+    freeFrames.reset(new BoundedQueue<GrayFrame *>(capacity + 2));
+    for (size_t i = 0; i < capacity + 2; ++i) {
+        framePool.emplace_back(new GrayFrame());
+        GrayFrame *unused = nullptr;
+        freeFrames->Push(framePool.back().get(), unused);
+    }
+    detectQueue.reset(new BoundedQueue<FrameItem>(capacity));
+    filterQueue.reset(new BoundedQueue<GazeItem>(capacity));
+    publishQueue.reset(new BoundedQueue<GazeItem>(capacity));
+
+    detector.Configure(settings.detector);
+    detector.Reset();
+    filterChain.SetStages(settings.filterStages, settings.filterStageCount);
+    filterChain.Configure(settings.filters);
+    filterChain.Reset();
+
+    finished.store(false, std::memory_order_release);
+    running.store(true, std::memory_order_release);
+    threads[static_cast<int>(PipelineStage::CAPTURE)] = std::thread(&GazePipeline::CaptureLoop, this);
+    threads[static_cast<int>(PipelineStage::DETECT)] = std::thread(&GazePipeline::DetectLoop, this);
+    threads[static_cast<int>(PipelineStage::FILTER)] = std::thread(&GazePipeline::FilterLoop, this);
+    threads[static_cast<int>(PipelineStage::PUBLISH)] = std::thread(&GazePipeline::PublishLoop, this);
+    return true;
+}
+
+void GazePipeline::Stop() {
+    running.store(false, std::memory_order_release);
+
+    // Capture exits first, every later stage drains its queue and closes the next one
+    for (std::thread &thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void GazePipeline::CaptureLoop() {
+    StageCounters &capture = counters[static_cast<int>(PipelineStage::CAPTURE)];
+    StageCounters &detect = counters[static_cast<int>(PipelineStage::DETECT)];
+
+    while (running.load(std::memory_order_acquire) && !source->IsFinished()) {
+        GrayFrame *frame = nullptr;
+        if (!freeFrames->Pop(frame, STAGE_TIMEOUT_MS)) {
+            capture.dropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (!source->Next(*frame, STAGE_TIMEOUT_MS)) {
+            GrayFrame *unused = nullptr;
+            freeFrames->Push(frame, unused);
+            continue;
+        }
+
+        uint64_t now = GetHostTimestampMicroseconds();
+        capture.service.Record(now - (std::min)(frame->captureTimestampUs, now));
+        capture.processed.fetch_add(1, std::memory_order_relaxed);
+
+        // A stale frame the detector did not get to goes back to the pool
+        FrameItem evicted = {};
+        if (detectQueue->Push({frame, now}, evicted)) {
+            GrayFrame *unused = nullptr;
+            freeFrames->Push(evicted.frame, unused);
+            detect.dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    detectQueue->Close();
+}
+
+void GazePipeline::DetectLoop() {
+    while (!detectQueue->IsClosed()) {
+        FrameItem item = {};
+        if (!detectQueue->Pop(item, STAGE_TIMEOUT_MS)) {
+            continue;
+        }
+
+        const GrayFrame &frame = *item.frame;
+        uint64_t start = GetHostTimestampMicroseconds();
+        GazeItem gaze = {};
+        gaze.output.frameIndex = frame.index;
+        gaze.output.captureTimestampUs = frame.captureTimestampUs;
+        gaze.output.valid = detector.Detect(frame, gaze.output.feature);
+        gaze.output.confidence = gaze.output.feature.confidence;
+        gaze.output.hasTruth = frame.hasTruth;
+        gaze.output.truthX = frame.truthX;
+        gaze.output.truthY = frame.truthY;
+
+        GrayFrame *unused = nullptr;
+        freeFrames->Push(item.frame, unused);
+
+        uint64_t end = GetHostTimestampMicroseconds();
+        RecordStage(PipelineStage::DETECT, item.enqueueTimeUs, start, end);
+        gaze.enqueueTimeUs = end;
+
+        GazeItem evicted = {};
+        if (filterQueue->Push(gaze, evicted)) {
+            counters[static_cast<int>(PipelineStage::FILTER)].dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    filterQueue->Close();
+}
+
+void GazePipeline::FilterLoop() {
+    GazeSample filtered = {};
+    while (!filterQueue->IsClosed()) {
+        GazeItem item = {};
+        if (!filterQueue->Pop(item, STAGE_TIMEOUT_MS)) {
+            continue;
+        }
+
+        uint64_t start = GetHostTimestampMicroseconds();
+        GazeOutput &output = item.output;
+        if (output.valid) {
+            Calibrate(output);
+            GazeSample sample = {};
+            sample.position.x = (std::max)(-1.0f, (std::min)(1.0f, output.mappedX));
+            sample.position.y = (std::max)(-1.0f, (std::min)(1.0f, output.mappedY));
+            sample.captureTime = output.captureTimestampUs;
+            sample.receiveTime = output.captureTimestampUs;
+            sample.sequence = output.frameIndex;
+            filterChain.Process(sample);
+            filtered = sample;
+        }
+
+        // Frames without eyes repeat the last gaze, flagged invalid
+        output.x = filtered.position.x;
+        output.y = filtered.position.y;
+
+        uint64_t end = GetHostTimestampMicroseconds();
+        RecordStage(PipelineStage::FILTER, item.enqueueTimeUs, start, end);
+        item.enqueueTimeUs = end;
+
+        GazeItem evicted = {};
+        if (publishQueue->Push(item, evicted)) {
+            counters[static_cast<int>(PipelineStage::PUBLISH)].dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    publishQueue->Close();
+}
+
+void GazePipeline::PublishLoop() {
+    while (!publishQueue->IsClosed()) {
+        GazeItem item = {};
+        if (!publishQueue->Pop(item, STAGE_TIMEOUT_MS)) {
+            continue;
+        }
+
+        uint64_t start = GetHostTimestampMicroseconds();
+        for (GazeSink *sink : sinks) {
+            sink->Publish(item.output);
+        }
+        uint64_t end = GetHostTimestampMicroseconds();
+        RecordStage(PipelineStage::PUBLISH, item.enqueueTimeUs, start, end);
+
+        endToEnd.Record(end - (std::min)(item.output.captureTimestampUs, end));
+        if (item.output.valid) {
+            framesWithGaze.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    finished.store(true, std::memory_order_release);
+}
+
+void GazePipeline::Calibrate(GazeOutput &output) {
+    // Map before learning from the frame, so the output is never fitted to its own target
+    calibration->Map(output.feature.x, output.feature.y, output.mappedX, output.mappedY);
+
+    if (output.hasTruth && output.frameIndex < settings.truthCalibrationFrames) {
+        calibration->AddSample(output.feature.x, output.feature.y, output.truthX, output.truthY);
+        return;
+    }
+
+    CalibrationTarget shown = {};
+    {
+        std::lock_guard<std::mutex> lock(targetMutex);
+        shown = target;
+    }
+    uint64_t settleUs = static_cast<uint64_t>((std::max)(settings.calibrationSettleMs, 0)) * 1000;
+    if (shown.active && output.captureTimestampUs >= shown.shownUs + settleUs) {
+        calibration->AddSample(output.feature.x, output.feature.y, shown.x, shown.y);
+    }
+}
+
+void GazePipeline::RecordStage(PipelineStage stage, uint64_t enqueueTimeUs, uint64_t startUs, uint64_t endUs) {
+    StageCounters &counter = counters[static_cast<int>(stage)];
+    counter.wait.Record(startUs - (std::min)(enqueueTimeUs, startUs));
+    counter.service.Record(endUs - startUs);
+    counter.processed.fetch_add(1, std::memory_order_relaxed);
+}
+
+GazePipelineStats GazePipeline::GetStats() const {
+    GazePipelineStats stats = {};
+    for (int i = 0; i < static_cast<int>(PipelineStage::COUNT); ++i) {
+        stats.stages[i].processed = counters[i].processed.load(std::memory_order_relaxed);
+        stats.stages[i].dropped = counters[i].dropped.load(std::memory_order_relaxed);
+        stats.stages[i].service = counters[i].service.Summarize();
+        stats.stages[i].wait = counters[i].wait.Summarize();
+    }
+    stats.endToEnd = endToEnd.Summarize();
+    stats.framesWithGaze = framesWithGaze.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void GazePipeline::ResetStats() {
+    for (StageCounters &counter : counters) {
+        counter.processed.store(0, std::memory_order_relaxed);
+        counter.dropped.store(0, std::memory_order_relaxed);
+        counter.service.Reset();
+        counter.wait.Reset();
+    }
+    endToEnd.Reset();
+    framesWithGaze.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "BoundedQueue.h"
+#include "FrameSources.h"
+#include "GazeCalibration.h"
+#include "GazeFilters.h"
+#include "IrisDetector.h"
+#include "LatencyStats.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Gaze of one frame as it leaves the pipeline, in the GazePacket convention:
+// [-1, 1] screen space, x mirrored (camera image), +y up
+struct GazeOutput {
+    uint64_t frameIndex;
+    uint64_t captureTimestampUs;
+    float x;
+    float y;
+    float confidence;
+    bool valid;                 // False while no eye is found, x/y hold the last gaze
+    GazeFeature feature;        // Unmapped detector output
+    float mappedX;              // Calibrated gaze before filtering, unclamped
+    float mappedY;
+
+    // Gaze point synthetic frames were rendered looking at
+    bool hasTruth;
+    float truthX;
+    float truthY;
+};
+
+// Destination of the pipeline's gaze, called on the publish thread
+class GazeSink {
+public:
+    virtual ~GazeSink() {}
+
+    virtual void Publish(const GazeOutput &output) = 0;
+};
+
+enum class PipelineStage {
+    CAPTURE,
+    DETECT,
+    FILTER,
+    PUBLISH,
+    COUNT
+};
+
+// Counters of one stage, all times in microseconds
+struct PipelineStageStats {
+    uint64_t processed;
+    uint64_t dropped;           // Evicted from the stage's input queue under backpressure
+    LatencySummary service;     // Processing one item; for capture the acquisition after the frame started
+    LatencySummary wait;        // Time in the stage's input queue, empty for capture
+};
+
+struct GazePipelineStats {
+    PipelineStageStats stages[static_cast<int>(PipelineStage::COUNT)];
+    LatencySummary endToEnd;    // Capture to publish
+    uint64_t framesWithGaze;
+};
+
+struct GazePipelineSettings {
+    int queueCapacity;          // Items between two stages, the oldest is dropped when full
+    IrisDetectorSettings detector;
+    GazeFilterType filterStages[GazeFilterChain::MAX_STAGES];
+    int filterStageCount;
+    GazeFilterSettings filters;
+
+    // Time the eyes get to reach a new calibration target before its samples count
+    int calibrationSettleMs;
+
+    // Leading synthetic frames whose rendered gaze is fed to the calibration as targets
+    uint64_t truthCalibrationFrames;
+};
+
+// Webcam gaze tracking as four threads connected by bounded queues:
+// capture -> detect (eye regions and iris centers) -> filter (calibrated
+// mapping and smoothing) -> publish.
+// Every queue drops its oldest item when the next stage falls behind, so the
+// tracker degrades to a lower rate instead of adding latency. Frame buffers
+// are pooled and recycled through the queues, nothing is allocated per frame
+// once the stream runs.
+class GazePipeline {
+public:
+    GazePipeline();
+    ~GazePipeline();
+
+    // Add a destination of the published gaze, before Start
+    void AddSink(GazeSink *sink);
+
+    // Map features through a calibration that is refined on the filter thread, before Start.
+    // Without one the default calibration's prior gain applies.
+    void SetCalibration(GazeCalibration *calibration);
+
+    // Show a calibration target at a screen gaze point, safe from any thread. Every valid
+    // frame captured after the settle time then becomes a calibration sample.
+    void SetCalibrationTarget(float x, float y);
+
+    // Hide the calibration target, safe from any thread
+    void ClearCalibrationTarget();
+
+    // Start pulling frames from a source, the source and sinks must outlive the pipeline
+    bool Start(FrameSource *source, const GazePipelineSettings &settings);
+
+    // Stop capturing and wait until the frames in flight are published
+    void Stop();
+
+    // True once the source ran out and every stage drained
+    bool IsFinished() const { return finished.load(std::memory_order_acquire); }
+
+    // Snapshot of the per-stage counters, safe from any thread
+    GazePipelineStats GetStats() const;
+
+    // Clear the counters, safe from any thread
+    void ResetStats();
+
+    static GazePipelineSettings GetDefaultSettings();
+
+private:
+    // Frame in flight between capture and detection
+    struct FrameItem {
+        GrayFrame *frame;
+        uint64_t enqueueTimeUs;
+    };
+
+    // Gaze in flight between detection, filtering and publishing
+    struct GazeItem {
+        GazeOutput output;
+        uint64_t enqueueTimeUs;
+    };
+
+    // Calibration target as set by the caller
+    struct CalibrationTarget {
+        bool active;
+        float x;
+        float y;
+        uint64_t shownUs;
+    };
+
+    // Per-stage counters
+    struct StageCounters {
+        std::atomic<uint64_t> processed;
+        std::atomic<uint64_t> dropped;
+        LatencyHistogram service;
+        LatencyHistogram wait;
+    };
+
+    void CaptureLoop();
+    void DetectLoop();
+    void FilterLoop();
+    void PublishLoop();
+
+    // Map a valid frame's feature, and refine the calibration if a target is on screen
+    void Calibrate(GazeOutput &output);
+
+    // Time an item spent in its queue, then count the stage's work on it
+    void RecordStage(PipelineStage stage, uint64_t enqueueTimeUs, uint64_t startUs, uint64_t endUs);
+
+    FrameSource *source;
+    GazePipelineSettings settings;
+    std::vector<GazeSink *> sinks;
+
+    std::unique_ptr<BoundedQueue<GrayFrame *>> freeFrames;
+    std::vector<std::unique_ptr<GrayFrame>> framePool;
+    std::unique_ptr<BoundedQueue<FrameItem>> detectQueue;
+    std::unique_ptr<BoundedQueue<GazeItem>> filterQueue;
+    std::unique_ptr<BoundedQueue<GazeItem>> publishQueue;
+
+    IrisDetector detector;
+    GazeFilterChain filterChain;
+    GazeCalibration defaultCalibration;
+    GazeCalibration *calibration;
+
+    std::mutex targetMutex;
+    CalibrationTarget target;
+
+    std::thread threads[static_cast<int>(PipelineStage::COUNT)];
+    std::atomic<bool> running;
+    std::atomic<bool> finished;
+
+    StageCounters counters[static_cast<int>(PipelineStage::COUNT)];
+    LatencyHistogram endToEnd;
+    std::atomic<uint64_t> framesWithGaze;
+};
@@ -0,0 +1,140 @@
+// Socket headers must come before windows.h pulled in by other headers
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "GazeSinks.h"
+#include "GazePacket.h"
+#include <cstring>
+
+#ifdef _WIN32
+typedef SOCKET SocketType;
+static const intptr_t INVALID_SOCKET_HANDLE = static_cast<intptr_t>(INVALID_SOCKET);
+static void CloseSocket(intptr_t handle) { closesocket(static_cast<SOCKET>(handle)); }
+#else
+typedef int SocketType;
+static const intptr_t INVALID_SOCKET_HANDLE = -1;
+static void CloseSocket(intptr_t handle) { close(static_cast<int>(handle)); }
+#endif
+
+static_assert(sizeof(sockaddr_in) <= 16, "Receiver address must fit its storage");
+
+// UdpGazeSink
+
+UdpGazeSink::UdpGazeSink()
+    : socketHandle(INVALID_SOCKET_HANDLE), address{}, sequence(0) {
+}
+
+UdpGazeSink::~UdpGazeSink() {
+    if (socketHandle != INVALID_SOCKET_HANDLE) {
+        CloseSocket(socketHandle);
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+}
+
+bool UdpGazeSink::Open(const std::string &host, uint16_t port) {
+    sockaddr_in receiver = {};
+    receiver.sin_family = AF_INET;
+    receiver.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &receiver.sin_addr) != 1) {
+        return false;
+    }
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        return false;
+    }
+    SOCKET handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle == INVALID_SOCKET) {
+        WSACleanup();
+        return false;
+    }
+#else
+    int handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle < 0) {
+        return false;
+    }
+#endif
+
+    socketHandle = static_cast<intptr_t>(handle);
+    memcpy(address, &receiver, sizeof(receiver));
+    return true;
+}
+
+void UdpGazeSink::Publish(const GazeOutput &output) {
+    if (socketHandle == INVALID_SOCKET_HANDLE) {
+        return;
+    }
+
+    GazePacket packet = {};
+    packet.magic = GAZE_PACKET_MAGIC;
+    packet.sequence = ++sequence;
+    packet.captureTimestampUs = output.captureTimestampUs;
+    packet.x = output.x;
+    packet.y = output.y;
+    packet.valid = output.valid ? 1 : 0;
+    packet.confidence = output.confidence;
+
+    // Fire and forget, a lost datagram is superseded by the next frame
+    sendto(static_cast<SocketType>(socketHandle), reinterpret_cast<const char *>(&packet), sizeof(packet), 0,
+           reinterpret_cast<const sockaddr *>(address), sizeof(sockaddr_in));
+}
+
+// SharedRingGazeSink
+
+void SharedRingGazeSink::Publish(const GazeOutput &output) {
+    // The ring holds [0, 1] screen coordinates from the top-left corner, unmirrored
+    SharedGazeRecord record = {};
+    record.captureTimestampUs = output.captureTimestampUs;
+    record.x = 0.5f - 0.5f * output.x;
+    record.y = 0.5f - 0.5f * output.y;
+    record.confidence = output.confidence;
+    record.flags = output.valid ? SHARED_GAZE_VALID : 0;
+    ring.Publish(record);
+}
+
+// CsvGazeSink
+
+CsvGazeSink::CsvGazeSink()
+    : file(nullptr) {
+}
+
+CsvGazeSink::~CsvGazeSink() {
+    if (file) {
+        fclose(file);
+    }
+}
+
+bool CsvGazeSink::Open(const std::string &path) {
+    file = fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "frame,capture_us,x,y,valid,confidence,feature_x,feature_y,eyes,truth_x,truth_y\n");
+    return true;
+}
+
+void CsvGazeSink::Publish(const GazeOutput &output) {
+    if (!file) {
+        return;
+    }
+
+    fprintf(file, "%llu,%llu,%.5f,%.5f,%d,%.3f,%.5f,%.5f,%d,", static_cast<unsigned long long>(output.frameIndex),
+            static_cast<unsigned long long>(output.captureTimestampUs), output.x, output.y, output.valid ? 1 : 0,
+            output.confidence, output.feature.x, output.feature.y, output.feature.eyes);
+    if (output.hasTruth) {
+        fprintf(file, "%.5f,%.5f\n", output.truthX, output.truthY);
+    } else {
+        fprintf(file, ",\n");
+    }
+}
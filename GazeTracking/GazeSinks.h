@@ -0,0 +1,49 @@
+#pragma once
+
+#include "GazePipeline.h"
+#include "SharedGazeRing.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Sends every gaze as a binary GazePacket to the plugin's native UDP receiver
+class UdpGazeSink : public GazeSink {
+public:
+    UdpGazeSink();
+    ~UdpGazeSink();
+
+    // Create the socket, host is a dotted IPv4 address
+    bool Open(const std::string &host, uint16_t port);
+
+    void Publish(const GazeOutput &output) override;
+
+private:
+    intptr_t socketHandle;
+    uint8_t address[16];        // sockaddr_in of the receiver
+    uint32_t sequence;
+};
+
+// Publishes every gaze into a SharedGazeRing for readers in other processes
+class SharedRingGazeSink : public GazeSink {
+public:
+    bool Open(const std::string &name) { return ring.CreateWriter(name); }
+
+    void Publish(const GazeOutput &output) override;
+
+private:
+    SharedGazeRing ring;
+};
+
+// Writes every gaze as a CSV line, for offline analysis of recorded sequences
+class CsvGazeSink : public GazeSink {
+public:
+    CsvGazeSink();
+    ~CsvGazeSink();
+
+    bool Open(const std::string &path);
+
+    void Publish(const GazeOutput &output) override;
+
+private:
+    FILE *file;
+};
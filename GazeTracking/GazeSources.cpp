@@ -0,0 +1,106 @@
+#include "GazeSources.h"
+#include <cmath>
+#include <thread>
+
+// SyntheticGazeSource
+
+SyntheticGazeSource::SyntheticGazeSource(float rateHz)
+    : period(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / (rateHz > 1.0f ? rateHz : 1.0f)))),
+    rng(1234), fromX(0.5f), fromY(0.5f), toX(0.5f), toY(0.5f), sampleIndex(0), saccadeStart(0) {
+}
+
+bool SyntheticGazeSource::Open() {
+    nextSample = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool SyntheticGazeSource::Next(SharedGazeRecord &record, int timeoutMs) {
+    auto now = std::chrono::steady_clock::now();
+    if (nextSample - now > std::chrono::milliseconds(timeoutMs)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        return false;
+    }
+    std::this_thread::sleep_until(nextSample);
+    nextSample += period;
+
+    // New fixation target every ~400 ms, reached by a 40 ms saccade
+    double seconds = std::chrono::duration<double>(period).count();
+    uint64_t fixationSamples = static_cast<uint64_t>(0.4 / seconds) + 1;
+    uint64_t saccadeSamples = static_cast<uint64_t>(0.04 / seconds) + 1;
+    if (sampleIndex % fixationSamples == 0) {
+        std::uniform_real_distribution<float> target(0.1f, 0.9f);
+        fromX = toX;
+        fromY = toY;
+        toX = target(rng);
+        toY = target(rng);
+        saccadeStart = sampleIndex;
+    }
+
+    float progress = static_cast<float>(sampleIndex - saccadeStart) / saccadeSamples;
+    progress = progress > 1.0f ? 1.0f : 0.5f - 0.5f * cosf(3.14159265f * progress);
+    std::normal_distribution<float> jitter(0.0f, 0.004f);
+
+    record = {};
+    record.captureTimestampUs = GetHostTimestampMicroseconds();
+    record.x = fromX + (toX - fromX) * progress + jitter(rng);
+    record.y = fromY + (toY - fromY) * progress + jitter(rng);
+    record.confidence = 1.0f;
+    record.flags = SHARED_GAZE_VALID;
+    ++sampleIndex;
+    return true;
+}
+
+// ReplayGazeSource
+
+ReplayGazeSource::ReplayGazeSource(const std::string &tracePath, bool loopTrace)
+    : path(tracePath), loop(loopTrace), position(0) {
+}
+
+bool ReplayGazeSource::Open() {
+    FILE *file = fopen(path.c_str(), "r");
+    if (!file) {
+        return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        unsigned long long timestamp;
+        Sample sample = {0, 0.0f, 0.0f, 1.0f};
+        if (line[0] != '#' && sscanf(line, "%llu,%f,%f,%f", &timestamp, &sample.x, &sample.y, &sample.confidence) >= 3) {
+            sample.timestampUs = timestamp;
+            samples.push_back(sample);
+        }
+    }
+    fclose(file);
+
+    position = 0;
+    start = std::chrono::steady_clock::now();
+    return !samples.empty();
+}
+
+bool ReplayGazeSource::Next(SharedGazeRecord &record, int timeoutMs) {
+    if (position >= samples.size()) {
+        if (!loop) {
+            return false;
+        }
+        position = 0;
+        start = std::chrono::steady_clock::now();
+    }
+
+    const Sample &sample = samples[position];
+    auto due = start + std::chrono::microseconds(sample.timestampUs - samples.front().timestampUs);
+    if (due - std::chrono::steady_clock::now() > std::chrono::milliseconds(timeoutMs)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        return false;
+    }
+    std::this_thread::sleep_until(due);
+
+    record = {};
+    record.captureTimestampUs = GetHostTimestampMicroseconds();
+    record.x = sample.x;
+    record.y = sample.y;
+    record.confidence = sample.confidence;
+    record.flags = SHARED_GAZE_VALID;
+    ++position;
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "SharedGazeRing.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Source of tracker samples driving the shared-memory publisher
+class GazeSource {
+public:
+    virtual ~GazeSource() {}
+
+    // Prepare the source, returns false if it cannot deliver samples
+    virtual bool Open() = 0;
+
+    // Wait for the next sample, returns false on timeout or when the source is exhausted
+    virtual bool Next(SharedGazeRecord &record, int timeoutMs) = 0;
+
+    // True once no further samples will arrive
+    virtual bool IsFinished() const { return false; }
+};
+
+// Deterministic fixation/saccade pattern with tracker-like jitter at a fixed rate
+class SyntheticGazeSource : public GazeSource {
+public:
+    explicit SyntheticGazeSource(float rateHz);
+
+    bool Open() override;
+    bool Next(SharedGazeRecord &record, int timeoutMs) override;
+
+private:
+    std::chrono::steady_clock::duration period;
+    std::chrono::steady_clock::time_point nextSample;
+    std::mt19937 rng;
+    float fromX, fromY, toX, toY;
+    uint64_t sampleIndex;
+    uint64_t saccadeStart;
+};
+
+// Replays a recorded CSV trace ("timestamp_us,x,y[,confidence]", x/y in [0, 1]) with its original pacing
+class ReplayGazeSource : public GazeSource {
+public:
+    ReplayGazeSource(const std::string &path, bool loop);
+
+    bool Open() override;
+    bool Next(SharedGazeRecord &record, int timeoutMs) override;
+    bool IsFinished() const override { return !loop && position >= samples.size(); }
+
+private:
+    struct Sample {
+        uint64_t timestampUs;
+        float x, y, confidence;
+    };
+
+    std::string path;
+    bool loop;
+    std::vector<Sample> samples;
+    size_t position;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Monotonic microseconds on the same clock the plugin uses
+inline uint64_t GetHostTimestampMicroseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
@@ -0,0 +1,384 @@
+#include "IrisDetector.h"
+#include <algorithm>
+#include <cmath>
+
+// Consecutive frames an eye may be missed, e.g. by a blink, before it is searched for again
+static const int MAX_MISSED_FRAMES = 15;
+
+// Weight of a new corner measurement, corners only move with the head
+static const float CORNER_SMOOTHING = 0.5f;
+
+IrisDetector::IrisDetector()
+    : settings(GetDefaultSettings()), missedFrames{}, framesSinceSearch(0), searchIntegral{}, eyeIntegral{}, histogram{} {
+    Reset();
+}
+
+IrisDetector::~IrisDetector() {
+}
+
+IrisDetectorSettings IrisDetector::GetDefaultSettings() {
+    IrisDetectorSettings defaults = {};
+    defaults.minIrisRadius = 0.01f;
+    defaults.maxIrisRadius = 0.04f;
+    defaults.minContrast = 25.0f;
+    defaults.redetectInterval = 60;
+    return defaults;
+}
+
+void IrisDetector::Configure(const IrisDetectorSettings &detectorSettings) {
+    settings = detectorSettings;
+    settings.minIrisRadius = (std::max)(settings.minIrisRadius, 0.001f);
+    settings.maxIrisRadius = (std::max)(settings.maxIrisRadius, settings.minIrisRadius);
+}
+
+void IrisDetector::Reset() {
+    for (EyeObservation &eye : eyes) {
+        eye = {};
+    }
+    for (int &missed : missedFrames) {
+        missed = MAX_MISSED_FRAMES + 1;
+    }
+    framesSinceSearch = 0;
+}
+
+bool IrisDetector::Detect(const GrayFrame &frame, GazeFeature &feature) {
+    feature = {0.0f, 0.0f, 0.0f, 0};
+    if (frame.width < 16 || frame.height < 16) {
+        return false;
+    }
+
+    ++framesSinceSearch;
+    bool lost = missedFrames[0] > MAX_MISSED_FRAMES || missedFrames[1] > MAX_MISSED_FRAMES;
+    if (lost || (settings.redetectInterval > 0 && framesSinceSearch >= settings.redetectInterval)) {
+        if (SearchEyes(frame)) {
+            framesSinceSearch = 0;
+        }
+    }
+
+    float contrast = 0.0f;
+    for (int i = 0; i < 2; ++i) {
+        EyeObservation &eye = eyes[i];
+        eye.found = missedFrames[i] <= MAX_MISSED_FRAMES && TrackEye(frame, eye);
+        missedFrames[i] = eye.found ? 0 : missedFrames[i] + 1;
+        if (!eye.found || !eye.cornersValid) {
+            continue;
+        }
+
+        float middleX = 0.5f * (eye.leftCornerX + eye.rightCornerX);
+        float middleY = 0.5f * (eye.leftCornerY + eye.rightCornerY);
+        float halfWidth = 0.5f * (eye.rightCornerX - eye.leftCornerX);
+        feature.x += (eye.irisX - middleX) / halfWidth;
+        feature.y += (middleY - eye.irisY) / halfWidth;
+        contrast += eye.contrast;
+        ++feature.eyes;
+    }
+
+    if (feature.eyes == 0) {
+        return false;
+    }
+    feature.x /= feature.eyes;
+    feature.y /= feature.eyes;
+    feature.confidence = (std::min)(contrast / (feature.eyes * 3.0f * settings.minContrast), 1.0f) * (feature.eyes == 2 ? 1.0f : 0.7f);
+    return true;
+}
+
+void IrisDetector::BuildIntegral(const GrayFrame &frame, int x0, int y0, int x1, int y1, int scale, Integral &integral) {
+    integral.scale = scale;
+    integral.originX = x0;
+    integral.originY = y0;
+    integral.width = (x1 - x0) / scale;
+    integral.height = (y1 - y0) / scale;
+
+    const int stride = integral.width + 1;
+    integral.sums.assign(static_cast<size_t>(stride) * (integral.height + 1), 0);
+    for (int cy = 0; cy < integral.height; ++cy) {
+        uint32_t *row = integral.sums.data() + static_cast<size_t>(cy + 1) * stride;
+        const uint32_t *above = row - stride;
+        uint32_t rowSum = 0;
+        for (int cx = 0; cx < integral.width; ++cx) {
+            uint32_t cell = 0;
+            for (int y = 0; y < scale; ++y) {
+                const uint8_t *pixels = frame.pixels.data() + static_cast<size_t>(y0 + cy * scale + y) * frame.width + x0 + cx * scale;
+                for (int x = 0; x < scale; ++x) {
+                    cell += pixels[x];
+                }
+            }
+            rowSum += cell;
+            row[cx + 1] = above[cx + 1] + rowSum;
+        }
+    }
+}
+
+float IrisDetector::BoxMean(const Integral &integral, int x0, int y0, int x1, int y1) {
+    x0 = (std::max)(x0, 0);
+    y0 = (std::max)(y0, 0);
+    x1 = (std::min)(x1, integral.width);
+    y1 = (std::min)(y1, integral.height);
+    if (x1 <= x0 || y1 <= y0) {
+        return 0.0f;
+    }
+
+    const int stride = integral.width + 1;
+    const uint32_t *sums = integral.sums.data();
+    uint32_t sum = sums[y1 * stride + x1] - sums[y0 * stride + x1] - sums[y1 * stride + x0] + sums[y0 * stride + x0];
+    return static_cast<float>(sum) / (static_cast<float>((x1 - x0) * (y1 - y0)) * integral.scale * integral.scale);
+}
+
+bool IrisDetector::SearchEyes(const GrayFrame &frame) {
+    // About 160 cells across keeps the search well below a millisecond
+    const int scale = (std::max)(1, frame.width / 160);
+    BuildIntegral(frame, 0, 0, frame.width, frame.height, scale, searchIntegral);
+    const int width = searchIntegral.width;
+    const int height = searchIntegral.height;
+
+    // Dark disc score: mean of the surrounding box minus mean of the inner box, best radius per cell
+    scores.assign(static_cast<size_t>(width) * height, 0.0f);
+    radii.assign(static_cast<size_t>(width) * height, 0.0f);
+    int minRadius = (std::max)(1, static_cast<int>(settings.minIrisRadius * frame.width / scale));
+    int maxRadius = (std::max)(minRadius, static_cast<int>(ceilf(settings.maxIrisRadius * frame.width / scale)));
+    for (int r = minRadius; r <= maxRadius; ++r) {
+        const float innerArea = static_cast<float>((2 * r + 1) * (2 * r + 1));
+        const float outerArea = static_cast<float>((4 * r + 1) * (4 * r + 1));
+        for (int y = 2 * r; y < height - 2 * r; ++y) {
+            for (int x = 2 * r; x < width - 2 * r; ++x) {
+                float inner = BoxMean(searchIntegral, x - r, y - r, x + r + 1, y + r + 1);
+                float outer = BoxMean(searchIntegral, x - 2 * r, y - 2 * r, x + 2 * r + 1, y + 2 * r + 1);
+                float surround = (outer * outerArea - inner * innerArea) / (outerArea - innerArea);
+                float score = surround - inner;
+                size_t cell = static_cast<size_t>(y) * width + x;
+                if (score > scores[cell]) {
+                    scores[cell] = score;
+                    radii[cell] = static_cast<float>(r);
+                }
+            }
+        }
+    }
+
+    // Local maxima of the score are the candidate irises
+    candidates.clear();
+    for (int y = 1; y < height - 1; ++y) {
+        for (int x = 1; x < width - 1; ++x) {
+            float score = scores[static_cast<size_t>(y) * width + x];
+            if (score < settings.minContrast) {
+                continue;
+            }
+            bool maximum = true;
+            for (int dy = -2; dy <= 2 && maximum; ++dy) {
+                for (int dx = -2; dx <= 2 && maximum; ++dx) {
+                    int nx = x + dx;
+                    int ny = y + dy;
+                    if ((dx || dy) && nx >= 0 && ny >= 0 && nx < width && ny < height) {
+                        float neighbour = scores[static_cast<size_t>(ny) * width + nx];
+                        maximum = neighbour < score || (neighbour == score && (dy > 0 || (dy == 0 && dx > 0)));
+                    }
+                }
+            }
+            if (maximum) {
+                float radius = (radii[static_cast<size_t>(y) * width + x] + 0.5f) * scale;
+                candidates.push_back({(x + 0.5f) * scale - 0.5f, (y + 0.5f) * scale - 0.5f, radius, score});
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) { return a.score > b.score; });
+    if (candidates.size() > 24) {
+        candidates.resize(24);
+    }
+
+    // Eyes are a pair of similar discs side by side, about ten iris radii apart
+    int bestFirst = -1;
+    int bestSecond = -1;
+    float bestScore = 0.0f;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        for (size_t j = i + 1; j < candidates.size(); ++j) {
+            const Candidate &a = candidates[i];
+            const Candidate &b = candidates[j];
+            float radius = 0.5f * (a.radius + b.radius);
+            float dx = fabsf(a.x - b.x);
+            float dy = fabsf(a.y - b.y);
+            float ratio = (std::max)(a.radius, b.radius) / (std::min)(a.radius, b.radius);
+            if (dx < 5.0f * radius || dx > 16.0f * radius || dy > 0.25f * dx || ratio > 1.6f) {
+                continue;
+            }
+            if (a.score + b.score > bestScore) {
+                bestScore = a.score + b.score;
+                bestFirst = static_cast<int>(i);
+                bestSecond = static_cast<int>(j);
+            }
+        }
+    }
+    if (bestFirst < 0) {
+        return false;
+    }
+
+    const Candidate *found[2] = {&candidates[bestFirst], &candidates[bestSecond]};
+    if (found[0]->x > found[1]->x) {
+        std::swap(found[0], found[1]);
+    }
+    for (int i = 0; i < 2; ++i) {
+        EyeObservation &eye = eyes[i];
+
+        // Corners survive a re-detection that confirms the tracked eye
+        float dx = found[i]->x - eye.irisX;
+        float dy = found[i]->y - eye.irisY;
+        if (missedFrames[i] > MAX_MISSED_FRAMES || dx * dx + dy * dy > eye.irisRadius * eye.irisRadius) {
+            eye.cornersValid = false;
+        }
+        eye.irisX = found[i]->x;
+        eye.irisY = found[i]->y;
+        eye.irisRadius = found[i]->radius;
+        missedFrames[i] = 0;
+    }
+    return true;
+}
+
+bool IrisDetector::TrackEye(const GrayFrame &frame, EyeObservation &eye) {
+    const float r = eye.irisRadius;
+    const int inner = (std::max)(1, static_cast<int>(lroundf(0.75f * r)));
+    const int outer = 2 * inner;
+
+    // Saccades move the iris by up to two radii between webcam frames
+    const int reach = (std::max)(2, static_cast<int>(ceilf(2.0f * r)));
+    int x0 = (std::max)(0, static_cast<int>(eye.irisX - 4.5f * r));
+    int y0 = (std::max)(0, static_cast<int>(eye.irisY - reach - outer - 1));
+    int x1 = (std::min)(frame.width, static_cast<int>(eye.irisX + 4.5f * r) + 1);
+    int y1 = (std::min)(frame.height, static_cast<int>(eye.irisY + reach + outer + 2));
+    if (x1 - x0 < 2 * outer + 1 || y1 - y0 < 2 * outer + 1) {
+        return false;
+    }
+    BuildIntegral(frame, x0, y0, x1, y1, 1, eyeIntegral);
+
+    // Coarse center by the same center-surround score as the full search
+    const float innerArea = static_cast<float>((2 * inner + 1) * (2 * inner + 1));
+    const float outerArea = static_cast<float>((2 * outer + 1) * (2 * outer + 1));
+    int centerX = static_cast<int>(lroundf(eye.irisX)) - x0;
+    int centerY = static_cast<int>(lroundf(eye.irisY)) - y0;
+    float bestScore = -1.0f;
+    float bestInner = 0.0f;
+    int bestX = 0;
+    int bestY = 0;
+    for (int y = (std::max)(centerY - reach, outer); y < (std::min)(centerY + reach + 1, eyeIntegral.height - outer); ++y) {
+        for (int x = (std::max)(centerX - reach, outer); x < (std::min)(centerX + reach + 1, eyeIntegral.width - outer); ++x) {
+            float innerMean = BoxMean(eyeIntegral, x - inner, y - inner, x + inner + 1, y + inner + 1);
+            float outerMean = BoxMean(eyeIntegral, x - outer, y - outer, x + outer + 1, y + outer + 1);
+            float score = (outerMean * outerArea - innerMean * innerArea) / (outerArea - innerArea) - innerMean;
+            if (score > bestScore) {
+                bestScore = score;
+                bestInner = innerMean;
+                bestX = x;
+                bestY = y;
+            }
+        }
+    }
+    if (bestScore < settings.minContrast) {
+        return false;
+    }
+
+    // Sub-pixel center: centroid of the pixels darker than halfway between iris and surround
+    const float threshold = bestInner + 0.5f * bestScore;
+    const float limit = 1.2f * r;
+    double sumWeight = 0.0;
+    double sumX = 0.0;
+    double sumY = 0.0;
+    for (int y = (std::max)(bestY + y0 - static_cast<int>(limit), 0); y <= (std::min)(bestY + y0 + static_cast<int>(limit), frame.height - 1); ++y) {
+        const uint8_t *row = frame.pixels.data() + static_cast<size_t>(y) * frame.width;
+        float dy = static_cast<float>(y - bestY - y0);
+        for (int x = (std::max)(bestX + x0 - static_cast<int>(limit), 0); x <= (std::min)(bestX + x0 + static_cast<int>(limit), frame.width - 1); ++x) {
+            float dx = static_cast<float>(x - bestX - x0);
+            float weight = threshold - row[x];
+            if (weight > 0.0f && dx * dx + dy * dy <= limit * limit) {
+                sumWeight += weight;
+                sumX += weight * x;
+                sumY += weight * y;
+            }
+        }
+    }
+    if (sumWeight > 0.0) {
+        eye.irisX = static_cast<float>(sumX / sumWeight);
+        eye.irisY = static_cast<float>(sumY / sumWeight);
+    } else {
+        eye.irisX = static_cast<float>(bestX + x0);
+        eye.irisY = static_cast<float>(bestY + y0);
+    }
+    eye.contrast = bestScore;
+
+    UpdateCorners(frame, eye, x0, y0, x1, y1);
+    return true;
+}
+
+void IrisDetector::UpdateCorners(const GrayFrame &frame, EyeObservation &eye, int x0, int y0, int x1, int y1) {
+    // Sclera is the brightest part of the window, skin its bulk
+    std::fill(histogram, histogram + 256, 0u);
+    for (int y = y0; y < y1; ++y) {
+        const uint8_t *row = frame.pixels.data() + static_cast<size_t>(y) * frame.width;
+        for (int x = x0; x < x1; ++x) {
+            ++histogram[row[x]];
+        }
+    }
+    uint32_t total = static_cast<uint32_t>((x1 - x0) * (y1 - y0));
+    int median = -1;
+    int bright = -1;
+    uint32_t seen = 0;
+    for (int level = 0; level < 256; ++level) {
+        seen += histogram[level];
+        if (median < 0 && seen * 2 >= total) {
+            median = level;
+        }
+        if (bright < 0 && seen * 100 >= total * 97) {
+            bright = level;
+        }
+    }
+    if (bright - median < settings.minContrast) {
+        return;
+    }
+    const int sclera = (median + bright) / 2;
+
+    // Outermost runs of sclera on the rows through the iris
+    const float r = eye.irisRadius;
+    int leftX = x1;
+    int rightX = x0 - 1;
+    float leftY = 0.0f;
+    float rightY = 0.0f;
+    for (int y = (std::max)(y0, static_cast<int>(eye.irisY - 1.5f * r)); y <= (std::min)(y1 - 1, static_cast<int>(eye.irisY + 1.5f * r)); ++y) {
+        const uint8_t *row = frame.pixels.data() + static_cast<size_t>(y) * frame.width;
+        for (int x = x0; x < (std::min)(leftX, x1 - 1); ++x) {
+            if (row[x] > sclera && row[x + 1] > sclera) {
+                leftX = x;
+                leftY = static_cast<float>(y);
+                break;
+            }
+        }
+        for (int x = x1 - 1; x > (std::max)(rightX, x0); --x) {
+            if (row[x] > sclera && row[x - 1] > sclera) {
+                rightX = x;
+                rightY = static_cast<float>(y);
+                break;
+            }
+        }
+    }
+
+    // A side the iris covers has no sclera left; keep its previous corner
+    bool leftValid = leftX < eye.irisX - 0.5f * r;
+    bool rightValid = rightX > eye.irisX + 0.5f * r;
+    if (!eye.cornersValid) {
+        float width = static_cast<float>(rightX - leftX);
+        if (!leftValid || !rightValid || width < 2.5f * r || width > 10.0f * r) {
+            return;
+        }
+        eye.leftCornerX = static_cast<float>(leftX);
+        eye.leftCornerY = leftY;
+        eye.rightCornerX = static_cast<float>(rightX);
+        eye.rightCornerY = rightY;
+        eye.cornersValid = true;
+        return;
+    }
+
+    // Corners move with the head only, a jump is a misdetection
+    if (leftValid && fabsf(leftX - eye.leftCornerX) < r) {
+        eye.leftCornerX += CORNER_SMOOTHING * (leftX - eye.leftCornerX);
+        eye.leftCornerY += CORNER_SMOOTHING * (leftY - eye.leftCornerY);
+    }
+    if (rightValid && fabsf(rightX - eye.rightCornerX) < r) {
+        eye.rightCornerX += CORNER_SMOOTHING * (rightX - eye.rightCornerX);
+        eye.rightCornerY += CORNER_SMOOTHING * (rightY - eye.rightCornerY);
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "FrameSources.h"
+#include <cstdint>
+#include <vector>
+
+// Iris and eye corners of one eye, in frame pixels
+struct EyeObservation {
+    bool found;
+    float irisX;
+    float irisY;
+    float irisRadius;
+    float contrast;      // Surround minus iris brightness, grey levels
+
+    // Corners of the visible sclera, smoothed over frames; image left and right
+    bool cornersValid;
+    float leftCornerX, leftCornerY;
+    float rightCornerX, rightCornerY;
+};
+
+// Gaze feature of a frame: iris offset from the middle of the eye corners in
+// units of half the eye width, x towards the image right, y up. Averaged over
+// the eyes found, so slow head motion cancels out.
+struct GazeFeature {
+    float x;
+    float y;
+    float confidence;    // [0, 1]
+    int eyes;            // Eyes the feature was measured on, zero if none
+};
+
+struct IrisDetectorSettings {
+    float minIrisRadius;    // Fraction of the frame width
+    float maxIrisRadius;
+    float minContrast;      // Grey levels the iris must be darker than its surround
+    int redetectInterval;   // Frames between full-frame searches while tracking, zero for never
+};
+
+// Finds both eyes by a center-surround search for dark discs at eye distance
+// on a downsampled integral image, then tracks each iris at full resolution
+// inside a small window: a box search, a sub-pixel centroid of the dark
+// pixels and the sclera extent for the eye corners. The full-frame search
+// only runs after an eye was lost or every redetect interval.
+class IrisDetector {
+public:
+    IrisDetector();
+    ~IrisDetector();
+
+    void Configure(const IrisDetectorSettings &settings);
+
+    // Detect the eyes of a frame, returns false if no eye was found
+    bool Detect(const GrayFrame &frame, GazeFeature &feature);
+
+    // Forget the tracked eyes, the next frame is searched in full
+    void Reset();
+
+    const EyeObservation &GetEye(int eye) const { return eyes[eye]; }
+
+    static IrisDetectorSettings GetDefaultSettings();
+
+private:
+    // Candidate dark disc of the full-frame search, in frame pixels
+    struct Candidate {
+        float x, y, radius, score;
+    };
+
+    // Integral image over a window of the frame, each cell summing a scale x scale block
+    struct Integral {
+        std::vector<uint32_t> sums;
+        int width, height, scale;
+        int originX, originY;
+    };
+
+    // Build the integral image of a frame window
+    static void BuildIntegral(const GrayFrame &frame, int x0, int y0, int x1, int y1, int scale, Integral &integral);
+
+    // Mean brightness of a box in integral cells, bounds are clamped
+    static float BoxMean(const Integral &integral, int x0, int y0, int x1, int y1);
+
+    // Search the whole frame for a pair of dark discs at eye distance
+    bool SearchEyes(const GrayFrame &frame);
+
+    // Refine the iris and corners of an eye around its last position
+    bool TrackEye(const GrayFrame &frame, EyeObservation &eye);
+
+    // Locate the sclera extent around the iris and smooth the corners
+    void UpdateCorners(const GrayFrame &frame, EyeObservation &eye, int x0, int y0, int x1, int y1);
+
+    IrisDetectorSettings settings;
+    EyeObservation eyes[2];
+    int missedFrames[2];
+    int framesSinceSearch;
+
+    // Scratch buffers reused across frames
+    Integral searchIntegral;
+    Integral eyeIntegral;
+    std::vector<float> scores;
+    std::vector<float> radii;
+    std::vector<Candidate> candidates;
+    uint32_t histogram[256];
+};
@@ -0,0 +1,293 @@
+#include "SharedGazeRing.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <climits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+#endif
+
+static const uint32_t SHARED_GAZE_MAGIC = 0x475A4846;  // "FHZG"
+static const uint32_t SHARED_GAZE_LAYOUT_VERSION = 1;
+
+static_assert(sizeof(SharedGazeRecord) % sizeof(uint64_t) == 0, "Record is copied in 64-bit words");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared atomics must be address-free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared atomics must be address-free");
+
+#ifdef _WIN32
+static std::string ReaderEventName(const std::string &mappingName, int slot) {
+    return mappingName + "_reader" + std::to_string(slot);
+}
+#endif
+
+SharedGazeRing::SharedGazeRing()
+    : mapping(nullptr), writer(false), readerSlot(-1), fileHandle(0), readerEvent(0), writerEvents{} {
+}
+
+SharedGazeRing::~SharedGazeRing() {
+    Close();
+}
+
+bool SharedGazeRing::CreateWriter(const std::string &name) {
+    Close();
+    if (!Map(name, true)) {
+        return false;
+    }
+
+    writer = true;
+    Header &header = mapping->header;
+    header.head.store(0, std::memory_order_relaxed);
+    for (Slot &slot : mapping->slots) {
+        slot.version.store(0, std::memory_order_relaxed);
+    }
+    header.capacity = CAPACITY;
+    header.recordSize = sizeof(SharedGazeRecord);
+    header.layoutVersion = SHARED_GAZE_LAYOUT_VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    header.magic = SHARED_GAZE_MAGIC;
+    return true;
+}
+
+bool SharedGazeRing::OpenReader(const std::string &name) {
+    Close();
+    if (!Map(name, false)) {
+        return false;
+    }
+
+    const Header &header = mapping->header;
+    if (header.magic != SHARED_GAZE_MAGIC || header.layoutVersion != SHARED_GAZE_LAYOUT_VERSION ||
+        header.capacity != CAPACITY || header.recordSize != sizeof(SharedGazeRecord)) {
+        Close();
+        return false;
+    }
+
+    // Claim a wake slot, readers beyond MAX_READERS fall back to timed polling
+    for (uint32_t i = 0; i < MAX_READERS; ++i) {
+        uint32_t expected = 0;
+        if (mapping->header.readers[i].compare_exchange_strong(expected, 1)) {
+            readerSlot = static_cast<int>(i);
+            break;
+        }
+    }
+
+#ifdef _WIN32
+    if (readerSlot >= 0) {
+        HANDLE event = CreateEventA(nullptr, FALSE, FALSE, ReaderEventName(mappingName, readerSlot).c_str());
+        readerEvent = reinterpret_cast<intptr_t>(event);
+    }
+#endif
+    return true;
+}
+
+bool SharedGazeRing::Map(const std::string &name, bool create) {
+    mappingName = name;
+
+#ifdef _WIN32
+    HANDLE handle = create
+        ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(Mapping), name.c_str())
+        : OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    if (!handle) {
+        return false;
+    }
+
+    void *view = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(Mapping));
+    if (!view) {
+        CloseHandle(handle);
+        return false;
+    }
+    fileHandle = reinterpret_cast<intptr_t>(handle);
+#else
+    std::string path = "/" + name;
+    int descriptor = create ? shm_open(path.c_str(), O_CREAT | O_RDWR, 0666) : shm_open(path.c_str(), O_RDWR, 0);
+    if (descriptor < 0) {
+        return false;
+    }
+    if (create && ftruncate(descriptor, sizeof(Mapping)) != 0) {
+        close(descriptor);
+        return false;
+    }
+
+    void *view = mmap(nullptr, sizeof(Mapping), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    fileHandle = create ? 1 : 0;
+#endif
+
+    mapping = static_cast<Mapping *>(view);
+    return true;
+}
+
+void SharedGazeRing::Close() {
+    if (!mapping) {
+        return;
+    }
+
+    if (readerSlot >= 0) {
+        mapping->header.readers[readerSlot].store(0, std::memory_order_release);
+        readerSlot = -1;
+    }
+
+#ifdef _WIN32
+    if (readerEvent) {
+        CloseHandle(reinterpret_cast<HANDLE>(readerEvent));
+        readerEvent = 0;
+    }
+    for (intptr_t &event : writerEvents) {
+        if (event) {
+            CloseHandle(reinterpret_cast<HANDLE>(event));
+            event = 0;
+        }
+    }
+    UnmapViewOfFile(mapping);
+    CloseHandle(reinterpret_cast<HANDLE>(fileHandle));
+#else
+    munmap(mapping, sizeof(Mapping));
+    if (writer) {
+        shm_unlink(("/" + mappingName).c_str());
+    }
+#endif
+
+    mapping = nullptr;
+    fileHandle = 0;
+    writer = false;
+}
+
+void SharedGazeRing::Publish(SharedGazeRecord record) {
+    if (!mapping || !writer) {
+        return;
+    }
+
+    Header &header = mapping->header;
+    uint64_t index = header.head.load(std::memory_order_relaxed);
+    Slot &slot = mapping->slots[index % CAPACITY];
+    record.sequence = index;
+
+    slot.version.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Word-wise relaxed copy keeps the seqlock free of data races on readers' side
+    uint64_t words[sizeof(SharedGazeRecord) / sizeof(uint64_t)];
+    memcpy(words, &record, sizeof(record));
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); ++i) {
+        reinterpret_cast<std::atomic<uint64_t> &>(slot.words[i]).store(words[i], std::memory_order_relaxed);
+    }
+
+    slot.version.store(2 * index + 2, std::memory_order_release);
+    header.head.store(index + 1, std::memory_order_release);
+
+    WakeReaders();
+}
+
+void SharedGazeRing::WakeReaders() {
+    Header &header = mapping->header;
+    header.wakeCounter.fetch_add(1, std::memory_order_release);
+
+#if defined(_WIN32)
+    for (uint32_t i = 0; i < MAX_READERS; ++i) {
+        if (!header.readers[i].load(std::memory_order_acquire)) {
+            continue;
+        }
+        // Readers may attach after the writer, open their events lazily
+        if (!writerEvents[i]) {
+            HANDLE event = OpenEventA(EVENT_MODIFY_STATE, FALSE, ReaderEventName(mappingName, i).c_str());
+            writerEvents[i] = reinterpret_cast<intptr_t>(event);
+        }
+        if (writerEvents[i]) {
+            SetEvent(reinterpret_cast<HANDLE>(writerEvents[i]));
+        }
+    }
+#elif defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&header.wakeCounter), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+bool SharedGazeRing::WaitForData(uint64_t cursor, int timeoutMs) {
+    if (!mapping) {
+        return false;
+    }
+
+    Header &header = mapping->header;
+    uint32_t wake = header.wakeCounter.load(std::memory_order_acquire);
+    if (header.head.load(std::memory_order_acquire) > cursor) {
+        return true;
+    }
+
+#if defined(_WIN32)
+    if (readerEvent) {
+        WaitForSingleObject(reinterpret_cast<HANDLE>(readerEvent), static_cast<DWORD>(timeoutMs));
+    } else {
+        Sleep(1);
+    }
+#elif defined(__linux__)
+    // Returns immediately if the writer published between the loads above and the wait
+    timespec timeout = {timeoutMs / 1000, (timeoutMs % 1000) * 1000000L};
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&header.wakeCounter), FUTEX_WAIT, wake, &timeout, nullptr, 0);
+#else
+    (void)wake;
+    usleep(1000);
+#endif
+
+    return header.head.load(std::memory_order_acquire) > cursor;
+}
+
+size_t SharedGazeRing::ReadSince(uint64_t &cursor, SharedGazeRecord *records, size_t maxCount) const {
+    if (!mapping || maxCount == 0) {
+        return 0;
+    }
+
+    uint64_t published = GetPublishedCount();
+    uint64_t first = cursor;
+    if (published - first > CAPACITY) {
+        first = published - CAPACITY;
+    }
+    if (published - first > maxCount) {
+        first = published - maxCount;
+    }
+
+    size_t count = 0;
+    for (uint64_t index = first; index < published; ++index) {
+        if (TryRead(index, records[count])) {
+            ++count;
+        }
+    }
+
+    cursor = published;
+    return count;
+}
+
+bool SharedGazeRing::TryRead(uint64_t index, SharedGazeRecord &record) const {
+    const Slot &slot = mapping->slots[index % CAPACITY];
+
+    uint64_t before = slot.version.load(std::memory_order_acquire);
+    if (before != 2 * index + 2) {
+        return false;
+    }
+
+    uint64_t words[sizeof(SharedGazeRecord) / sizeof(uint64_t)];
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); ++i) {
+        words[i] = reinterpret_cast<const std::atomic<uint64_t> &>(slot.words[i]).load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.version.load(std::memory_order_relaxed) != before) {
+        return false;
+    }
+
+    memcpy(&record, words, sizeof(record));
+    return true;
+}
+
+uint64_t SharedGazeRing::GetPublishedCount() const {
+    return mapping ? mapping->header.head.load(std::memory_order_acquire) : 0;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// One tracker sample as published in shared memory
+struct SharedGazeRecord {
+    uint64_t sequence;            // Index of the sample, assigned by the publisher
+    uint64_t captureTimestampUs;  // Monotonic clock of the publisher host (steady_clock)
+    float x;                      // Normalized screen coordinates, [0, 1] from the top-left corner
+    float y;
+    float confidence;             // [0, 1]
+    uint32_t flags;               // SHARED_GAZE_* bits
+    float headRotation[9];        // Row-major 3x3
+    float headTranslation[3];     // Meters
+};
+
+static const uint32_t SHARED_GAZE_VALID = 1u << 0;
+static const uint32_t SHARED_GAZE_HEAD_POSE_VALID = 1u << 1;
+
+// Memory-mapped ring of SharedGazeRecord with one writer and any number of
+// readers in other processes. Every slot is guarded by a seqlock, so the writer
+// never waits for readers and readers detect torn or overwritten slots.
+// Readers sleep on a wake primitive (futex on Linux, per-reader events on
+// Windows) that the writer signals after every publish.
+class SharedGazeRing {
+public:
+    static const uint32_t CAPACITY = 256;
+    static const uint32_t MAX_READERS = 8;
+
+    SharedGazeRing();
+    ~SharedGazeRing();
+
+    // Create the mapping as the single writer
+    bool CreateWriter(const std::string &name);
+
+    // Attach to an existing mapping as a reader
+    bool OpenReader(const std::string &name);
+
+    // Unmap and release wake primitives
+    void Close();
+
+    // Publish a sample and wake all readers (writer only), sequence is filled in
+    void Publish(SharedGazeRecord record);
+
+    // Sleep until something is published after cursor or timeout expires (reader only)
+    bool WaitForData(uint64_t cursor, int timeoutMs);
+
+    // Read the samples published after cursor, oldest first, and advance cursor.
+    // Samples overwritten before they could be read are skipped.
+    size_t ReadSince(uint64_t &cursor, SharedGazeRecord *records, size_t maxCount) const;
+
+    // Number of samples published so far
+    uint64_t GetPublishedCount() const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> version;  // 2n + 1 while sample n is written, 2n + 2 once complete
+        uint64_t words[sizeof(SharedGazeRecord) / sizeof(uint64_t)];
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t layoutVersion;
+        uint32_t capacity;
+        uint32_t recordSize;
+        std::atomic<uint64_t> head;
+        std::atomic<uint32_t> wakeCounter;       // Futex word on Linux
+        std::atomic<uint32_t> readers[MAX_READERS];  // Non-zero while a reader owns the wake slot
+    };
+
+    struct Mapping {
+        Header header;
+        Slot slots[CAPACITY];
+    };
+
+    bool Map(const std::string &name, bool create);
+    bool TryRead(uint64_t index, SharedGazeRecord &record) const;
+    void WakeReaders();
+
+    Mapping *mapping;
+    std::string mappingName;
+    bool writer;
+    int readerSlot;
+
+    // Platform handles
+    intptr_t fileHandle;
+    intptr_t readerEvent;
+    intptr_t writerEvents[MAX_READERS];
+};
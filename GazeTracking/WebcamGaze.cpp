@@ -0,0 +1,372 @@
+// Native webcam gaze tracker, replaces the blocking Python loop of Baseline.py.
+//
+// Usage: WebcamGaze [options]
+//   --source <camera|frames|synthetic>  Frame source (default camera when built with OpenCV, otherwise synthetic)
+//   --camera <index>                    Camera device (default 0)
+//   --frames <pattern>                  Numbered PGM/PPM sequence, e.g. capture/%06d.pgm
+//   --rate <hz>                         Pacing of frames/synthetic sources, 0 for as fast as possible (default 30)
+//   --count <n>                         Synthetic frames to render, 0 for endless (default 0)
+//   --size <w>x<h>                      Synthetic frame size (default 640x480)
+//   --loop                              Restart a frame sequence at its end
+//   --host <ip> --port <n>              Plugin gaze receiver (default 127.0.0.1:50666)
+//   --no-send                           Do not send GazePackets
+//   --shared <name>                     Also publish into a SharedGazeRing
+//   --output <gaze.csv>                 Write every published gaze
+//   --dump <pattern>                    Save the captured frames as PGM, to replay them later
+//   --queue <n>                         Items between two stages before the oldest is dropped (default 2)
+//   --filters <chain>                   Comma separated dead-zone, one-euro, kalman, ivt, idt (default one-euro)
+//   --gain <x>,<y>                      Feature to gaze gain before calibration (default 2.5,4)
+//   --model <poly1|poly2|poly3|rbf>     Calibration mapping (default poly2)
+//   --forgetting <f>                    Calibration forgetting factor, below 1 keeps adapting (default 1)
+//   --profile <path>                    Per-user calibration profile, loaded at startup and saved at exit
+//   --calibrate <frames>                Calibrate on the rendered gaze of the first synthetic frames
+//   --stats <s>                         Interval of the stage statistics (default 5)
+// Build: g++ -O2 -std=c++17 -pthread -I../NativePluginsSrc/VrsBased/include WebcamGaze.cpp GazePipeline.cpp
+//        GazeCalibration.cpp IrisDetector.cpp FrameSources.cpp GazeSinks.cpp SharedGazeRing.cpp ../NativePluginsSrc/VrsBased/GazeFilters.cpp
+//        ../NativePluginsSrc/VrsBased/LatencyStats.cpp
+//        [-DGAZE_WITH_OPENCV $(pkg-config --cflags --libs opencv4)]
+//
+// Capture, detection, filtering and publishing run on their own threads
+// connected by bounded queues (see GazePipeline.h); the gaze goes straight to
+// the plugin's GazeReceiver. Frame sequences and synthetic frames make the
+// tracker testable and benchmarkable without a camera. A calibration profile
+// replaces the fixed gain by the user's fitted mapping; applications showing
+// calibration targets drive GazePipeline::SetCalibrationTarget.
+
+#include "FrameSources.h"
+#include "GazePipeline.h"
+#include "GazeSinks.h"
+#include "GazeSources.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+
+struct Options {
+#ifdef GAZE_WITH_OPENCV
+    std::string source = "camera";
+#else
+    std::string source = "synthetic";
+#endif
+    int camera = 0;
+    std::string frames;
+    float rate = 30.0f;
+    uint64_t count = 0;
+    int width = 640;
+    int height = 480;
+    bool loop = false;
+    std::string host = "127.0.0.1";
+    int port = 50666;
+    bool send = true;
+    std::string shared;
+    std::string output;
+    std::string dump;
+    float statsInterval = 5.0f;
+    std::string profile;
+    GazePipelineSettings settings = GazePipeline::GetDefaultSettings();
+    GazeCalibrationSettings calibration = GazeCalibration::GetDefaultSettings();
+};
+
+// Saves every frame of another source before handing it on
+class DumpingFrameSource : public FrameSource {
+public:
+    DumpingFrameSource(std::unique_ptr<FrameSource> frameSource, const std::string &framePattern)
+        : source(std::move(frameSource)), pattern(framePattern) {}
+
+    bool Open() override { return source->Open(); }
+    bool IsFinished() const override { return source->IsFinished(); }
+
+    bool Next(GrayFrame &frame, int timeoutMs) override {
+        if (!source->Next(frame, timeoutMs)) {
+            return false;
+        }
+        char path[1024];
+        snprintf(path, sizeof(path), pattern.c_str(), static_cast<int>(frame.index));
+        WritePgm(path, frame);
+        return true;
+    }
+
+private:
+    std::unique_ptr<FrameSource> source;
+    std::string pattern;
+};
+
+// Gaze error against the rendered gaze of synthetic frames, after calibration
+class TruthSink : public GazeSink {
+public:
+    explicit TruthSink(uint64_t calibrationFrames)
+        : firstFrame(calibrationFrames) {}
+
+    void Publish(const GazeOutput &output) override {
+        if (!output.hasTruth || output.frameIndex < firstFrame) {
+            return;
+        }
+        ++frames;
+        if (!output.valid) {
+            return;
+        }
+        ++detected;
+        double dx = output.mappedX - output.truthX;
+        double dy = output.mappedY - output.truthY;
+        squaredX += dx * dx;
+        squaredY += dy * dy;
+    }
+
+    void Print() const {
+        if (frames == 0) {
+            return;
+        }
+        printf("detected %llu of %llu open-eye frames", static_cast<unsigned long long>(detected), static_cast<unsigned long long>(frames));
+        if (detected > 0) {
+            printf(", gaze error rms %.4f x %.4f y", sqrt(squaredX / detected), sqrt(squaredY / detected));
+        }
+        printf("\n");
+    }
+
+private:
+    uint64_t firstFrame;
+    uint64_t frames = 0;
+    uint64_t detected = 0;
+    double squaredX = 0.0, squaredY = 0.0;
+};
+
+static bool ParseModel(const char *text, GazeCalibrationSettings &settings) {
+    if (!strcmp(text, "rbf")) {
+        settings.model = CalibrationModel::RBF;
+        return true;
+    }
+    if (!strncmp(text, "poly", 4) && text[4] >= '1' && text[4] <= '3' && text[5] == 0) {
+        settings.model = CalibrationModel::POLYNOMIAL;
+        settings.polynomialDegree = text[4] - '0';
+        return true;
+    }
+    return false;
+}
+
+static bool ParseFilters(const char *text, GazePipelineSettings &settings) {
+    static const struct { const char *name; GazeFilterType type; } names[] = {
+        {"dead-zone", GazeFilterType::DEAD_ZONE}, {"one-euro", GazeFilterType::ONE_EURO}, {"kalman", GazeFilterType::KALMAN},
+        {"ivt", GazeFilterType::FIXATION_IVT}, {"idt", GazeFilterType::FIXATION_IDT},
+    };
+
+    settings.filterStageCount = 0;
+    std::string list = text;
+    size_t begin = 0;
+    while (!list.empty() && begin <= list.size()) {
+        size_t end = list.find(',', begin);
+        std::string name = list.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+        bool found = false;
+        for (const auto &entry : names) {
+            if (name == entry.name && settings.filterStageCount < GazeFilterChain::MAX_STAGES) {
+                settings.filterStages[settings.filterStageCount++] = entry.type;
+                found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+        if (end == std::string::npos) {
+            break;
+        }
+        begin = end + 1;
+    }
+    return true;
+}
+
+static bool ParseOptions(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; ++i) {
+        const char *option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(option, "--loop")) {
+            options.loop = true;
+        } else if (!strcmp(option, "--no-send")) {
+            options.send = false;
+        } else if (!hasValue) {
+            fprintf(stderr, "Missing value of %s\n", option);
+            return false;
+        } else if (!strcmp(option, "--source")) {
+            options.source = argv[++i];
+        } else if (!strcmp(option, "--camera")) {
+            options.camera = atoi(argv[++i]);
+        } else if (!strcmp(option, "--frames")) {
+            options.frames = argv[++i];
+        } else if (!strcmp(option, "--rate")) {
+            options.rate = static_cast<float>(atof(argv[++i]));
+        } else if (!strcmp(option, "--count")) {
+            options.count = strtoull(argv[++i], nullptr, 10);
+        } else if (!strcmp(option, "--size")) {
+            if (sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2) {
+                fprintf(stderr, "Invalid size %s\n", argv[i]);
+                return false;
+            }
+        } else if (!strcmp(option, "--host")) {
+            options.host = argv[++i];
+        } else if (!strcmp(option, "--port")) {
+            options.port = atoi(argv[++i]);
+        } else if (!strcmp(option, "--shared")) {
+            options.shared = argv[++i];
+        } else if (!strcmp(option, "--output")) {
+            options.output = argv[++i];
+        } else if (!strcmp(option, "--dump")) {
+            options.dump = argv[++i];
+        } else if (!strcmp(option, "--queue")) {
+            options.settings.queueCapacity = atoi(argv[++i]);
+        } else if (!strcmp(option, "--filters")) {
+            if (!ParseFilters(argv[++i], options.settings)) {
+                fprintf(stderr, "Invalid filter chain %s\n", argv[i]);
+                return false;
+            }
+        } else if (!strcmp(option, "--gain")) {
+            if (sscanf(argv[++i], "%f,%f", &options.calibration.priorGainX, &options.calibration.priorGainY) != 2) {
+                fprintf(stderr, "Invalid gain %s\n", argv[i]);
+                return false;
+            }
+        } else if (!strcmp(option, "--model")) {
+            if (!ParseModel(argv[++i], options.calibration)) {
+                fprintf(stderr, "Invalid calibration model %s\n", argv[i]);
+                return false;
+            }
+        } else if (!strcmp(option, "--forgetting")) {
+            options.calibration.forgetting = static_cast<float>(atof(argv[++i]));
+        } else if (!strcmp(option, "--profile")) {
+            options.profile = argv[++i];
+        } else if (!strcmp(option, "--calibrate")) {
+            options.settings.truthCalibrationFrames = strtoull(argv[++i], nullptr, 10);
+        } else if (!strcmp(option, "--stats")) {
+            options.statsInterval = static_cast<float>(atof(argv[++i]));
+        } else {
+            fprintf(stderr, "Unknown option %s\n", option);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void PrintStats(const GazePipelineStats &stats, double seconds) {
+    static const char *names[] = {"capture", "detect", "filter", "publish"};
+    const PipelineStageStats &published = stats.stages[static_cast<int>(PipelineStage::PUBLISH)];
+    printf("%.1f fps published, %llu with gaze\n", seconds > 0.0 ? published.processed / seconds : 0.0,
+           static_cast<unsigned long long>(stats.framesWithGaze));
+    printf("stage      processed  dropped   service us p50/p95/max   queue wait us p50/p95/max\n");
+    for (int i = 0; i < static_cast<int>(PipelineStage::COUNT); ++i) {
+        const PipelineStageStats &stage = stats.stages[i];
+        printf("%-9s %10llu %8llu %10llu %6llu %6llu %11llu %6llu %6llu\n", names[i],
+               static_cast<unsigned long long>(stage.processed), static_cast<unsigned long long>(stage.dropped),
+               static_cast<unsigned long long>(stage.service.p50Us), static_cast<unsigned long long>(stage.service.p95Us),
+               static_cast<unsigned long long>(stage.service.maxUs), static_cast<unsigned long long>(stage.wait.p50Us),
+               static_cast<unsigned long long>(stage.wait.p95Us), static_cast<unsigned long long>(stage.wait.maxUs));
+    }
+    printf("end-to-end capture to publish us: mean %llu, p50 %llu, p95 %llu, p99 %llu, max %llu\n",
+           static_cast<unsigned long long>(stats.endToEnd.meanUs), static_cast<unsigned long long>(stats.endToEnd.p50Us),
+           static_cast<unsigned long long>(stats.endToEnd.p95Us), static_cast<unsigned long long>(stats.endToEnd.p99Us),
+           static_cast<unsigned long long>(stats.endToEnd.maxUs));
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    std::unique_ptr<FrameSource> source;
+    if (options.source == "synthetic") {
+        source.reset(new SyntheticFrameSource(options.width, options.height, options.rate, options.count));
+    } else if (options.source == "frames") {
+        source.reset(new ImageSequenceFrameSource(options.frames, options.rate, options.loop));
+#ifdef GAZE_WITH_OPENCV
+    } else if (options.source == "camera") {
+        source.reset(new CameraFrameSource(options.camera));
+#endif
+    }
+    if (source && !options.dump.empty()) {
+        source.reset(new DumpingFrameSource(std::move(source), options.dump));
+    }
+    if (!source || !source->Open()) {
+        fprintf(stderr, "Cannot open frame source %s\n", options.source.c_str());
+        return 1;
+    }
+
+    // A saved profile wins over the command line model, the user continues their calibration
+    GazeCalibration calibration;
+    calibration.Configure(options.calibration);
+    if (!options.profile.empty()) {
+        if (calibration.Load(options.profile)) {
+            printf("Loaded calibration profile %s, %llu samples\n", options.profile.c_str(),
+                   static_cast<unsigned long long>(calibration.GetStats().samples));
+        } else {
+            printf("Cannot load calibration profile %s, starting from the default gain\n", options.profile.c_str());
+        }
+    }
+    uint64_t profileSamples = calibration.GetStats().samples;
+
+    GazePipeline pipeline;
+    UdpGazeSink udp;
+    SharedRingGazeSink shared;
+    CsvGazeSink csv;
+    TruthSink truth(options.settings.truthCalibrationFrames);
+    pipeline.SetCalibration(&calibration);
+    if (options.send) {
+        if (!udp.Open(options.host, static_cast<uint16_t>(options.port))) {
+            fprintf(stderr, "Cannot send to %s:%d\n", options.host.c_str(), options.port);
+            return 1;
+        }
+        pipeline.AddSink(&udp);
+    }
+    if (!options.shared.empty()) {
+        if (!shared.Open(options.shared)) {
+            fprintf(stderr, "Cannot create shared memory %s\n", options.shared.c_str());
+            return 1;
+        }
+        pipeline.AddSink(&shared);
+    }
+    if (!options.output.empty()) {
+        if (!csv.Open(options.output)) {
+            fprintf(stderr, "Cannot write %s\n", options.output.c_str());
+            return 1;
+        }
+        pipeline.AddSink(&csv);
+    }
+    pipeline.AddSink(&truth);
+
+    if (!pipeline.Start(source.get(), options.settings)) {
+        fprintf(stderr, "Cannot start the pipeline\n");
+        return 1;
+    }
+    printf("Tracking %s frames", options.source.c_str());
+    if (options.send) {
+        printf(", sending to %s:%d", options.host.c_str(), options.port);
+    }
+    printf("\n");
+    fflush(stdout);
+
+    auto start = std::chrono::steady_clock::now();
+    auto lastStats = start;
+    while (!pipeline.IsFinished()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auto now = std::chrono::steady_clock::now();
+        if (options.statsInterval > 0.0f && std::chrono::duration<double>(now - lastStats).count() >= options.statsInterval) {
+            PrintStats(pipeline.GetStats(), std::chrono::duration<double>(now - start).count());
+            lastStats = now;
+        }
+    }
+    pipeline.Stop();
+
+    PrintStats(pipeline.GetStats(), std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    truth.Print();
+
+    GazeCalibrationStats calibrationStats = calibration.GetStats();
+    if (calibrationStats.samples > profileSamples) {
+        printf("calibration: %llu samples, prior residual rms %.4f x %.4f y\n",
+               static_cast<unsigned long long>(calibrationStats.samples), calibrationStats.residualRmsX, calibrationStats.residualRmsY);
+        if (!options.profile.empty() && !calibration.Save(options.profile)) {
+            fprintf(stderr, "Cannot save calibration profile %s\n", options.profile.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,509 @@
+// Headless replay of a recorded camera route through the native foveation pipeline.
+//
+// Usage: CameraRouteBenchmark <route.json | session.vrstrace> [options]
+//   --gaze <trace.csv>     Recorded gaze, "timestamp_us,x,y" in normalized gaze space
+//                          (default: the gaze of a .vrstrace session, otherwise synthetic)
+//   --fps <hz>             Frame rate of the replay (default 90)
+//   --gaze-rate <hz>       Tracker rate of the synthetic gaze (default 120)
+//   --size <w>x<h>         Render target size (default 3840x2160)
+//   --tile <px>            Shading-rate tile size (default 16)
+//   --fov <deg>            Vertical field of view (default 60)
+//   --preset <1-5>         ShadingRatePreset (default 1, HIGHEST_PERFORMANCE, or the session's first configuration)
+//   --pattern <1-3>        ShadingPatternPreset (default 2, BALANCED, or the session's first configuration)
+//   --filters <chain>      Comma separated dead-zone, one-euro, kalman, ivt, idt (default dead-zone)
+//   --predict <ms>         Enable gaze prediction with the given latency (default off)
+//   --repeat <n>           Replay the route n times (default 5)
+//   --frames <file.csv>    Write per-frame gaze, tiles written and shading cost of the last replay
+// Build: g++ -O2 -std=c++17 -I../VrsBased/include CameraRouteBenchmark.cpp ../VrsBased/Foveation.cpp
+//        ../VrsBased/GazeFilters.cpp ../VrsBased/GazePredictor.cpp ../VrsBased/ShadingCostModel.cpp ../VrsBased/ShadingRateImage.cpp
+//        ../VrsBased/TraceReader.cpp
+//
+// The route is streamed with a small pull scanner, no document is built, so
+// arbitrarily long recordings replay in constant memory. A .vrstrace session
+// (see TraceFormat.h) is memory-mapped and replays its camera, gaze and
+// foveation configuration deterministically. Synthetic gaze fixates
+// world-fixed targets: while the camera turns the gaze counter-rotates on screen
+// (like the vestibulo-ocular reflex), and a saccade picks a new target when the
+// fixation ends or leaves the screen.
+
+#include "Foveation.h"
+#include "GazeFilters.h"
+#include "GazePredictor.h"
+#include "RouteReader.h"
+#include "ShadingCostModel.h"
+#include "ShadingRateImage.h"
+#include "TraceReader.h"
+#include "Utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+static Quaternion Nlerp(const Quaternion &a, Quaternion b, float t) {
+    // Same as Quaternion.Lerp in Unity, shortest arc then normalize
+    if (a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w < 0.0f) {
+        b = {-b.x, -b.y, -b.z, -b.w};
+    }
+    Quaternion q = {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t};
+    float length = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    return {q.x / length, q.y / length, q.z / length, q.w / length};
+}
+
+static Vector3 Rotate(const Quaternion &q, const Vector3 &v) {
+    // v + 2w(u x v) + 2u x (u x v)
+    Vector3 t = {2.0f * (q.y * v.z - q.z * v.y), 2.0f * (q.z * v.x - q.x * v.z), 2.0f * (q.x * v.y - q.y * v.x)};
+    return {v.x + q.w * t.x + (q.y * t.z - q.z * t.y),
+            v.y + q.w * t.y + (q.z * t.x - q.x * t.z),
+            v.z + q.w * t.z + (q.x * t.y - q.y * t.x)};
+}
+
+static Quaternion Inverse(const Quaternion &q) {
+    return {-q.x, -q.y, -q.z, q.w};
+}
+
+// Camera orientation at a route time, keyframes interpolated like CameraRoutePlayer.cs
+static Quaternion SampleRoute(const std::vector<RouteKeyframe> &route, float time, size_t &cursor) {
+    while (cursor + 2 < route.size() && route[cursor + 1].time <= time) {
+        ++cursor;
+    }
+    const RouteKeyframe &current = route[cursor];
+    const RouteKeyframe &next = route[(std::min)(cursor + 1, route.size() - 1)];
+    float span = next.time - current.time;
+    float t = span > 0.0f ? (std::min)((std::max)((time - current.time) / span, 0.0f), 1.0f) : 0.0f;
+    return Nlerp(current.rotation, next.rotation, t);
+}
+
+struct ViewSettings {
+    float tanHalfHorizontalFov;
+    float tanHalfVerticalFov;
+};
+
+// Same mapping as GazeManager::CalculateNormalizedGaze
+static bool ProjectGaze(const Vector3 &local, const ViewSettings &view, Vector2 &gaze) {
+    if (local.z <= 0.0f) {
+        return false;
+    }
+    gaze = {-(local.x / local.z) / view.tanHalfHorizontalFov / 2.0f, (local.y / local.z) / view.tanHalfVerticalFov / 2.0f};
+    return fabsf(gaze.x) <= 0.45f && fabsf(gaze.y) <= 0.45f;
+}
+
+static Vector3 UnprojectGaze(const Vector2 &gaze, const ViewSettings &view) {
+    return {-gaze.x * 2.0f * view.tanHalfHorizontalFov, gaze.y * 2.0f * view.tanHalfVerticalFov, 1.0f};
+}
+
+// World-anchored fixations with saccades, see header
+static std::vector<GazeSample> GenerateGaze(const std::vector<RouteKeyframe> &route, const ViewSettings &view, float rate) {
+    std::mt19937 rng(42);
+    std::normal_distribution<float> jitter(0.0f, 0.004f);
+    std::uniform_real_distribution<float> target(-0.35f, 0.35f);
+    std::uniform_real_distribution<float> duration(0.2f, 0.6f);
+
+    std::vector<GazeSample> trace;
+    float start = route.front().time;
+    float end = route.back().time;
+    size_t cursor = 0;
+
+    Vector3 worldTarget = {0.0f, 0.0f, 1.0f};
+    Vector2 gaze = {0.0f, 0.0f};
+    float fixationEnd = start;
+    for (float time = start; time <= end; time += 1.0f / rate) {
+        Quaternion camera = SampleRoute(route, time, cursor);
+        if (time >= fixationEnd || !ProjectGaze(Rotate(Inverse(camera), worldTarget), view, gaze)) {
+            gaze = {target(rng), target(rng)};
+            worldTarget = Rotate(camera, UnprojectGaze(gaze, view));
+            fixationEnd = time + duration(rng);
+        }
+
+        GazeSample sample = {};
+        sample.position = {gaze.x + jitter(rng), gaze.y + jitter(rng)};
+        sample.captureTime = static_cast<uint64_t>((time - start) * 1e6f);
+        sample.receiveTime = sample.captureTime;
+        sample.sequence = trace.size();
+        trace.push_back(sample);
+    }
+    return trace;
+}
+
+static bool LoadGaze(const char *path, std::vector<GazeSample> &trace) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+
+    char line[256];
+    unsigned long long first = 0;
+    while (fgets(line, sizeof(line), file)) {
+        unsigned long long timestamp;
+        float x, y;
+        if (line[0] != '#' && sscanf(line, "%llu,%f,%f", &timestamp, &x, &y) == 3) {
+            if (trace.empty()) {
+                first = timestamp;
+            }
+            // Rebase to the start of the route
+            uint64_t time = timestamp - first;
+            GazeSample sample = {{x, y}, time, time, trace.size()};
+            trace.push_back(sample);
+        }
+    }
+
+    fclose(file);
+    return !trace.empty();
+}
+
+// Read the camera poses, left-eye gaze and first configuration of a recorded session
+static bool LoadSession(const char *path, std::vector<RouteKeyframe> &route, std::vector<GazeSample> &trace,
+                        VrsConfiguration &configuration, bool &hasConfiguration) {
+    TraceReader reader;
+    if (!reader.Open(path)) {
+        return false;
+    }
+    if (!reader.HasIndex()) {
+        fprintf(stderr, "Session %s has no index, it was not closed; reading %zu chunks\n", path, reader.GetChunkCount());
+    }
+
+    TraceRecord record;
+    int64_t firstGaze = 0;
+    hasConfiguration = false;
+    while (reader.Next(record)) {
+        if (record.type == TraceRecordType::CAMERA_POSE) {
+            route.push_back({record.position, record.rotation, record.time * 1e-6f});
+        } else if (record.type == TraceRecordType::GAZE && record.eye == Eye::LEFT) {
+            if (trace.empty()) {
+                firstGaze = record.time;
+            }
+            uint64_t time = static_cast<uint64_t>((std::max)(record.time - firstGaze, static_cast<int64_t>(0)));
+            GazeSample sample = {record.gaze, time, time, trace.size()};
+            trace.push_back(sample);
+        } else if (record.type == TraceRecordType::CONFIGURATION && !hasConfiguration) {
+            configuration = record.configuration;
+            hasConfiguration = true;
+        }
+    }
+    return true;
+}
+
+static bool ParseFilters(const char *text, std::vector<GazeFilterType> &stages) {
+    static const struct { const char *name; GazeFilterType type; } names[] = {
+        {"dead-zone", GazeFilterType::DEAD_ZONE}, {"one-euro", GazeFilterType::ONE_EURO}, {"kalman", GazeFilterType::KALMAN},
+        {"ivt", GazeFilterType::FIXATION_IVT}, {"idt", GazeFilterType::FIXATION_IDT},
+    };
+
+    stages.clear();
+    std::string list = text;
+    size_t begin = 0;
+    while (begin <= list.size() && !list.empty()) {
+        size_t end = list.find(',', begin);
+        std::string name = list.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+        bool found = false;
+        for (const auto &entry : names) {
+            if (name == entry.name) {
+                stages.push_back(entry.type);
+                found = true;
+            }
+        }
+        if (!found || stages.size() > GazeFilterChain::MAX_STAGES) {
+            return false;
+        }
+        if (end == std::string::npos) {
+            break;
+        }
+        begin = end + 1;
+    }
+    return true;
+}
+
+// Per-frame durations of one pipeline stage
+struct StageTimer {
+    const char *name;
+    std::vector<double> microseconds;
+
+    void Print() {
+        if (microseconds.empty()) {
+            return;
+        }
+        std::vector<double> sorted = microseconds;
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (double value : sorted) {
+            sum += value;
+        }
+        printf("%-16s %10.3f %10.3f %10.3f %10.3f\n", name, sum / sorted.size(), sorted[sorted.size() / 2],
+               sorted[(sorted.size() * 99) / 100], sorted.back());
+    }
+};
+
+static double ElapsedMicroseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <route.json> [--gaze trace.csv] [--fps hz] [--gaze-rate hz] [--size WxH] [--tile px] [--fov deg]\n"
+                        "       [--preset 1-5] [--pattern 1-3] [--filters chain] [--predict ms] [--repeat n] [--frames out.csv]\n", argv[0]);
+        return 1;
+    }
+
+    const char *gazePath = nullptr;
+    const char *framesPath = nullptr;
+    float fps = 90.0f;
+    float gazeRate = 120.0f;
+    int width = 3840;
+    int height = 2160;
+    int tileSize = 16;
+    float verticalFov = 60.0f;
+    int preset = 0;     // Default or from the session
+    int pattern = 0;
+    float predictionMs = -1.0f;
+    int repetitions = 5;
+    std::vector<GazeFilterType> stages = {GazeFilterType::DEAD_ZONE};
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        const char *option = argv[i];
+        const char *value = argv[i + 1];
+        if (strcmp(option, "--gaze") == 0) gazePath = value;
+        else if (strcmp(option, "--fps") == 0) fps = static_cast<float>(atof(value));
+        else if (strcmp(option, "--gaze-rate") == 0) gazeRate = static_cast<float>(atof(value));
+        else if (strcmp(option, "--size") == 0) sscanf(value, "%dx%d", &width, &height);
+        else if (strcmp(option, "--tile") == 0) tileSize = atoi(value);
+        else if (strcmp(option, "--fov") == 0) verticalFov = static_cast<float>(atof(value));
+        else if (strcmp(option, "--preset") == 0) preset = atoi(value);
+        else if (strcmp(option, "--pattern") == 0) pattern = atoi(value);
+        else if (strcmp(option, "--predict") == 0) predictionMs = static_cast<float>(atof(value));
+        else if (strcmp(option, "--repeat") == 0) repetitions = (std::max)(atoi(value), 1);
+        else if (strcmp(option, "--frames") == 0) framesPath = value;
+        else if (strcmp(option, "--filters") == 0) {
+            if (!ParseFilters(value, stages)) {
+                fprintf(stderr, "Invalid filter chain %s\n", value);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Unknown option %s\n", option);
+            return 1;
+        }
+    }
+
+    // Stream the route, or map a recorded session
+    auto parseStart = std::chrono::steady_clock::now();
+    std::vector<RouteKeyframe> route;
+    std::vector<GazeSample> sessionGaze;
+    VrsConfiguration sessionConfiguration = {};
+    bool hasSessionConfiguration = false;
+    size_t pathLength = strlen(argv[1]);
+    if (pathLength > 9 && strcmp(argv[1] + pathLength - 9, ".vrstrace") == 0) {
+        if (!LoadSession(argv[1], route, sessionGaze, sessionConfiguration, hasSessionConfiguration)) {
+            fprintf(stderr, "Cannot open session %s\n", argv[1]);
+            return 1;
+        }
+    } else {
+        RouteReader *reader = new RouteReader();
+        if (!reader->Open(argv[1])) {
+            fprintf(stderr, "Cannot open route %s\n", argv[1]);
+            delete reader;
+            return 1;
+        }
+        RouteKeyframe keyframe;
+        while (reader->Next(keyframe)) {
+            route.push_back(keyframe);
+        }
+        delete reader;
+    }
+    double parseMicroseconds = ElapsedMicroseconds(parseStart);
+    if (route.size() < 2 || fps <= 0.0f || gazeRate <= 0.0f) {
+        fprintf(stderr, "Route %s has fewer than two keyframes\n", argv[1]);
+        return 1;
+    }
+
+    ViewSettings view;
+    view.tanHalfVerticalFov = tanf(verticalFov * 0.5f * 3.14159265f / 180.0f);
+    view.tanHalfHorizontalFov = view.tanHalfVerticalFov * width / height;
+
+    std::vector<GazeSample> gaze;
+    if (gazePath) {
+        if (!LoadGaze(gazePath, gaze)) {
+            fprintf(stderr, "Cannot read gaze trace %s\n", gazePath);
+            return 1;
+        }
+    } else if (!sessionGaze.empty()) {
+        gaze.swap(sessionGaze);
+    } else {
+        gaze = GenerateGaze(route, view, gazeRate);
+    }
+
+    // Explicit presets override the session's configuration
+    FoveationDesc desc = {};
+    ShadingRatePreset ratePreset = ShadingRatePreset::HIGHEST_PERFORMANCE;
+    ShadingPatternPreset patternPreset = ShadingPatternPreset::BALANCED;
+    if (hasSessionConfiguration) {
+        desc = {sessionConfiguration.innerRadii, sessionConfiguration.middleRadii, sessionConfiguration.peripheralRadii,
+                sessionConfiguration.innerRate, sessionConfiguration.middleRate, sessionConfiguration.peripheralRate};
+        ratePreset = sessionConfiguration.shadingRatePreset;
+        patternPreset = sessionConfiguration.foveationPatternPreset;
+    }
+    if (preset > 0) {
+        ratePreset = static_cast<ShadingRatePreset>(Clamp(preset, 1, 5));
+    }
+    if (pattern > 0) {
+        patternPreset = static_cast<ShadingPatternPreset>(Clamp(pattern, 1, 3));
+    }
+    ResolveShadingRatePreset(ratePreset, desc);
+    ResolveFoveationPatternPreset(patternPreset, desc);
+
+    float routeSeconds = route.back().time - route.front().time;
+    size_t frameCount = static_cast<size_t>(routeSeconds * fps) + 1;
+    uint64_t gazeSpan = gaze.back().captureTime + 1;
+
+    printf("route %s: %zu keyframes, %.1f s, parsed in %.0f us\n", argv[1], route.size(), routeSeconds, parseMicroseconds);
+    printf("%zu frames at %.0f Hz, %zu gaze samples, %dx%d target, %d px tiles, %d repetitions\n",
+           frameCount, fps, gaze.size(), width, height, tileSize, repetitions);
+
+    StageTimer filterTimer = {"filter", {}};
+    StageTimer predictTimer = {"predict", {}};
+    StageTimer imageTimer = {"shading-image", {}};
+    StageTimer classifyTimer = {"classify", {}};
+    StageTimer costTimer = {"cost-model", {}};
+    StageTimer frameTimer = {"frame", {}};
+
+    double costSum = 0.0;
+    double tilesWrittenSum = 0.0;
+    double modelCostSum = 0.0;
+    double modelAnalyticCostSum = 0.0;
+    double modelError = 0.0;
+    std::vector<float> frameCosts(frameCount);
+    std::vector<int> frameTiles(frameCount);
+    std::vector<Vector2> frameGaze(frameCount);
+
+    for (int repetition = 0; repetition < repetitions; ++repetition) {
+        GazeFilterChain chain;
+        chain.SetStages(stages.data(), static_cast<int>(stages.size()));
+        GazePredictor predictor;
+        GazePredictionSettings prediction = predictor.GetSettings();
+        prediction.enabled = predictionMs >= 0.0f;
+        prediction.latencyMs = (std::max)(predictionMs, 0.0f);
+        predictor.Configure(prediction);
+
+        ShadingRateImage image;
+        if (!image.Initialize(width, height, tileSize)) {
+            fprintf(stderr, "Cannot allocate the shading-rate image\n");
+            return 1;
+        }
+
+        size_t gazeIndex = 0;
+        uint64_t gazeLoopOffset = 0;
+        Vector2 gazePos = {0.0f, 0.0f};
+        for (size_t frame = 0; frame < frameCount; ++frame) {
+            uint64_t frameTime = static_cast<uint64_t>(frame * 1e6 / fps);
+            auto frameStart = std::chrono::steady_clock::now();
+
+            // Latch every gaze sample captured up to this frame, looping short traces
+            auto stageStart = std::chrono::steady_clock::now();
+            GazeSample latched[256];
+            int latchedCount = 0;
+            while (latchedCount < 256 && gaze[gazeIndex].captureTime + gazeLoopOffset <= frameTime) {
+                GazeSample sample = gaze[gazeIndex];
+                sample.captureTime += gazeLoopOffset;
+                sample.receiveTime += gazeLoopOffset;
+                chain.Process(sample);
+                latched[latchedCount++] = sample;
+                if (++gazeIndex == gaze.size()) {
+                    gazeIndex = 0;
+                    gazeLoopOffset += gazeSpan;
+                }
+            }
+            filterTimer.microseconds.push_back(ElapsedMicroseconds(stageStart));
+
+            stageStart = std::chrono::steady_clock::now();
+            for (int i = 0; i < latchedCount; ++i) {
+                predictor.AddSample(latched[i]);
+            }
+            if (latchedCount > 0 || prediction.enabled) {
+                uint64_t photonTime = frameTime + static_cast<uint64_t>(prediction.latencyMs * 1000.0f);
+                gazePos = predictor.Predict(photonTime);
+                chain.Hold(gazePos, photonTime);
+            }
+            predictTimer.microseconds.push_back(ElapsedMicroseconds(stageStart));
+
+            stageStart = std::chrono::steady_clock::now();
+            int tilesWritten = image.Update(gazePos, desc);
+            imageTimer.microseconds.push_back(ElapsedMicroseconds(stageStart));
+
+            // Tiles per shading rate give the shading work of the frame
+            stageStart = std::chrono::steady_clock::now();
+            // Four interleaved histograms avoid serializing on repeated increments of the same rate
+            const int RATES = static_cast<int>(ShadingRate::X1_PER_4X4_PIXELS) + 1;
+            uint32_t rateCounts[4][RATES] = {};
+            const uint8_t *tiles = image.GetData();
+            size_t tileCount = image.GetSize();
+            size_t i = 0;
+            for (; i + 4 <= tileCount; i += 4) {
+                ++rateCounts[0][tiles[i]];
+                ++rateCounts[1][tiles[i + 1]];
+                ++rateCounts[2][tiles[i + 2]];
+                ++rateCounts[3][tiles[i + 3]];
+            }
+            for (; i < tileCount; ++i) {
+                ++rateCounts[0][tiles[i]];
+            }
+            double cost = 0.0;
+            for (int rate = 0; rate < RATES; ++rate) {
+                uint32_t count = rateCounts[0][rate] + rateCounts[1][rate] + rateCounts[2][rate] + rateCounts[3][rate];
+                cost += count * GetShadingRateCost(static_cast<ShadingRate>(rate));
+            }
+            cost /= static_cast<double>(image.GetSize());
+            classifyTimer.microseconds.push_back(ElapsedMicroseconds(stageStart));
+
+            // Analytic estimate as exported by the plugin, checked against the tile histogram
+            stageStart = std::chrono::steady_clock::now();
+            ShadingCostEstimate estimate = EstimateShadingCost(width, height, tileSize, gazePos, desc);
+            costTimer.microseconds.push_back(ElapsedMicroseconds(stageStart));
+
+            frameTimer.microseconds.push_back(ElapsedMicroseconds(frameStart));
+
+            modelCostSum += estimate.relativeCost;
+            modelAnalyticCostSum += estimate.analyticCoverage[0] * GetShadingRateCost(desc.innerRate) +
+                                    estimate.analyticCoverage[1] * GetShadingRateCost(desc.middleRate) +
+                                    estimate.analyticCoverage[2] * GetShadingRateCost(desc.peripheralRate);
+            modelError = (std::max)(modelError, fabs(estimate.relativeCost - cost));
+
+            costSum += cost;
+            tilesWrittenSum += tilesWritten;
+            frameCosts[frame] = static_cast<float>(cost);
+            frameTiles[frame] = tilesWritten;
+            frameGaze[frame] = gazePos;
+        }
+    }
+
+    printf("\n%-16s %10s %10s %10s %10s\n", "stage (us)", "mean", "p50", "p99", "max");
+    filterTimer.Print();
+    predictTimer.Print();
+    imageTimer.Print();
+    classifyTimer.Print();
+    costTimer.Print();
+    frameTimer.Print();
+
+    double frames = static_cast<double>(frameCount) * repetitions;
+    double meanCost = costSum / frames;
+    printf("\nshading cost %.3f of full rate, estimated savings %.1f%%, %.0f tiles rewritten per frame\n",
+           meanCost, (1.0 - meanCost) * 100.0, tilesWrittenSum / frames);
+    printf("cost model %.3f tile accurate (max error %.4f), %.3f for exact ellipses without tile snapping\n",
+           modelCostSum / frames, modelError, modelAnalyticCostSum / frames);
+
+    if (framesPath) {
+        FILE *file = fopen(framesPath, "w");
+        if (!file) {
+            fprintf(stderr, "Cannot write %s\n", framesPath);
+            return 1;
+        }
+        fprintf(file, "# frame,gaze_x,gaze_y,tiles_written,shading_cost\n");
+        for (size_t frame = 0; frame < frameCount; ++frame) {
+            fprintf(file, "%zu,%.5f,%.5f,%d,%.5f\n", frame, frameGaze[frame].x, frameGaze[frame].y, frameTiles[frame], frameCosts[frame]);
+        }
+        fclose(file);
+    }
+
+    return 0;
+}
@@ -0,0 +1,327 @@
+// Image quality of foveated frames against full-rate references, for validating presets.
+//
+// Usage: FoveatedQualityEvaluator <reference pattern> <foveated pattern> [options]
+//   Patterns are printf paths of numbered PGM/PPM frames, e.g. ref/%06d.ppm
+//   --first <n>            Number of the first frame (default 0)
+//   --count <n>            Frames to evaluate (default: until a frame is missing)
+//   --gaze <x>,<y>         Fixed gaze in normalized gaze space (default 0,0)
+//   --gaze-frames <file>   Per-frame gaze, "frame,x,y" as written by CameraRouteBenchmark --frames
+//   --fov <deg>            Vertical field of view (default 60)
+//   --tile <px>            Shading-rate tile size, a multiple of 4 (default 16)
+//   --preset <1-5>         ShadingRatePreset the frames were rendered with (default 1, HIGHEST_PERFORMANCE)
+//   --pattern <1-3>        ShadingPatternPreset the frames were rendered with (default 2, BALANCED)
+//   --e2 <deg>             Eccentricity at which acuity has halved (default 2.3)
+//   --threads <n>          Worker threads besides the main thread (default: hardware threads - 1)
+//   --frames <file.csv>    Write per-frame totals and per-region PSNR and SSIM
+//   --tiles <file.csv>     Write per-tile PSNR and SSIM over the sequence and how often each region covered the tile
+// Build: g++ -O2 -std=c++17 -pthread -I../VrsBased/include FoveatedQualityEvaluator.cpp ../VrsBased/Foveation.cpp
+//        ../VrsBased/ShadingCostModel.cpp ../VrsBased/ShadingRateImage.cpp ../VrsBased/WorkerPool.cpp
+//
+// Frames are streamed: the next pair decodes on a background thread while
+// the current one is evaluated, so memory stays at two frame pairs however
+// long the sequence is. The foveation regions are rebuilt around each
+// frame's gaze with the shading-rate image the plugin uses, so per-region
+// results line up with the tiles the rates were applied to. Colour frames
+// are compared on Rec. 709 luma. Capture reference and foveated frames of
+// the same camera route, for example with the preset switched off and on,
+// and convert them with any tool that writes binary netpbm.
+
+#include "Foveation.h"
+#include "QualityMetrics.h"
+#include "ShadingCostModel.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <string>
+#include <vector>
+
+static const char *REGION_NAMES[3] = {"inner", "middle", "peripheral"};
+
+// Reference and foveated frame of one number
+struct FramePair {
+    int number;
+    LumaImage reference;
+    LumaImage foveated;
+};
+
+static bool LoadPair(const char *referencePattern, const char *foveatedPattern, int number, FramePair *pair) {
+    char referencePath[1024];
+    char foveatedPath[1024];
+    snprintf(referencePath, sizeof(referencePath), referencePattern, number);
+    snprintf(foveatedPath, sizeof(foveatedPath), foveatedPattern, number);
+    pair->number = number;
+    return ReadPnmLuma(referencePath, pair->reference) && ReadPnmLuma(foveatedPath, pair->foveated);
+}
+
+// Per-frame gaze, "frame,x,y[,...]" lines, '#' comments skipped
+static bool LoadFrameGaze(const char *path, std::vector<Vector2> &gaze) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        size_t frame;
+        Vector2 position;
+        if (line[0] == '#' || sscanf(line, "%zu,%f,%f", &frame, &position.x, &position.y) != 3) {
+            continue;
+        }
+        if (frame >= gaze.size()) {
+            gaze.resize(frame + 1, position);
+        }
+        gaze[frame] = position;
+    }
+    fclose(file);
+    return !gaze.empty();
+}
+
+// Mean and worst value of one metric over the sequence
+struct MetricSummary {
+    double sum = 0.0;
+    double worst = 1e30;
+    size_t count = 0;
+
+    void Add(double value) {
+        sum += value;
+        worst = (std::min)(worst, value);
+        ++count;
+    }
+
+    void Print(const char *name, const char *unit) const {
+        if (count > 0) {
+            printf("%-22s %10.4f %10.4f %s\n", name, sum / count, worst, unit);
+        }
+    }
+};
+
+static double ElapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <reference pattern> <foveated pattern> [--first n] [--count n] [--gaze x,y] [--gaze-frames file.csv]\n"
+                        "       [--fov deg] [--tile px] [--preset 1-5] [--pattern 1-3] [--e2 deg] [--threads n]\n"
+                        "       [--frames out.csv] [--tiles out.csv]\n", argv[0]);
+        return 1;
+    }
+
+    const char *referencePattern = argv[1];
+    const char *foveatedPattern = argv[2];
+    const char *gazePath = nullptr;
+    const char *framesPath = nullptr;
+    const char *tilesPath = nullptr;
+    int first = 0;
+    int count = 0;
+    Vector2 fixedGaze = {0.0f, 0.0f};
+    QualitySettings settings = {16, 60.0f, 2.3f};
+    int preset = static_cast<int>(ShadingRatePreset::HIGHEST_PERFORMANCE);
+    int pattern = static_cast<int>(ShadingPatternPreset::BALANCED);
+    int threads = -1;
+
+    for (int i = 3; i + 1 < argc; i += 2) {
+        const char *option = argv[i];
+        const char *value = argv[i + 1];
+        if (strcmp(option, "--first") == 0) first = atoi(value);
+        else if (strcmp(option, "--count") == 0) count = (std::max)(atoi(value), 0);
+        else if (strcmp(option, "--gaze") == 0) sscanf(value, "%f,%f", &fixedGaze.x, &fixedGaze.y);
+        else if (strcmp(option, "--gaze-frames") == 0) gazePath = value;
+        else if (strcmp(option, "--fov") == 0) settings.verticalFov = static_cast<float>(atof(value));
+        else if (strcmp(option, "--tile") == 0) settings.tileSize = atoi(value);
+        else if (strcmp(option, "--preset") == 0) preset = atoi(value);
+        else if (strcmp(option, "--pattern") == 0) pattern = atoi(value);
+        else if (strcmp(option, "--e2") == 0) settings.acuityEccentricity = static_cast<float>(atof(value));
+        else if (strcmp(option, "--threads") == 0) threads = atoi(value);
+        else if (strcmp(option, "--frames") == 0) framesPath = value;
+        else if (strcmp(option, "--tiles") == 0) tilesPath = value;
+        else {
+            fprintf(stderr, "Unknown option %s\n", option);
+            return 1;
+        }
+    }
+
+    if (preset < 1 || preset >= static_cast<int>(ShadingRatePreset::CUSTOM) ||
+        pattern < 1 || pattern >= static_cast<int>(ShadingPatternPreset::CUSTOM)) {
+        fprintf(stderr, "Preset must be 1-5 and pattern 1-3\n");
+        return 1;
+    }
+
+    std::vector<Vector2> frameGaze;
+    if (gazePath && !LoadFrameGaze(gazePath, frameGaze)) {
+        fprintf(stderr, "Cannot read gaze from %s\n", gazePath);
+        return 1;
+    }
+
+    FoveationDesc desc = {};
+    ResolveShadingRatePreset(static_cast<ShadingRatePreset>(preset), desc);
+    ResolveFoveationPatternPreset(static_cast<ShadingPatternPreset>(pattern), desc);
+
+    FramePair pairs[2];
+    if (!LoadPair(referencePattern, foveatedPattern, first, &pairs[0])) {
+        fprintf(stderr, "Cannot read frame %d of %s and %s\n", first, referencePattern, foveatedPattern);
+        return 1;
+    }
+    const int width = pairs[0].reference.width;
+    const int height = pairs[0].reference.height;
+
+    FoveatedQualityMetric metric;
+    if (!metric.Initialize(width, height, settings)) {
+        fprintf(stderr, "Unsupported frame size %dx%d or settings (tile %d, fov %.1f, e2 %.2f)\n",
+                width, height, settings.tileSize, settings.verticalFov, settings.acuityEccentricity);
+        return 1;
+    }
+    WorkerPool pool(threads);
+
+    FILE *framesFile = nullptr;
+    if (framesPath) {
+        framesFile = fopen(framesPath, "w");
+        if (!framesFile) {
+            fprintf(stderr, "Cannot write %s\n", framesPath);
+            return 1;
+        }
+        fprintf(framesFile, "# frame,gaze_x,gaze_y,psnr,ssim,weighted_psnr,weighted_ssim,"
+                            "inner_psnr,inner_ssim,middle_psnr,middle_ssim,peripheral_psnr,peripheral_ssim\n");
+    }
+
+    printf("%dx%d frames, %d worker threads, tile %d, fov %.1f, e2 %.2f, preset %d, pattern %d\n",
+           width, height, pool.GetWorkerCount(), settings.tileSize, settings.verticalFov, settings.acuityEccentricity, preset, pattern);
+
+    // Sequence totals per tile in screen space
+    const int tilesX = metric.GetTilesX();
+    const int tilesY = metric.GetTilesY();
+    const size_t tileCount = static_cast<size_t>(tilesX) * tilesY;
+    std::vector<double> tileSquaredError(tileCount, 0.0);
+    std::vector<double> tilePixels(tileCount, 0.0);
+    std::vector<double> tileSsimSum(tileCount, 0.0);
+    std::vector<double> tileWindows(tileCount, 0.0);
+    std::vector<uint32_t> tileRegionFrames(tileCount * 3, 0);
+
+    MetricSummary psnr, ssim, weightedPsnr, weightedSsim;
+    MetricSummary regionPsnr[3], regionSsim[3];
+    double regionCoverage[3] = {};
+    double costSum = 0.0;
+    double evaluateMs = 0.0;
+    double waitMs = 0.0;
+
+    std::future<bool> pending;
+    size_t frame = 0;
+    for (;; ++frame) {
+        FramePair &current = pairs[frame & 1];
+        if (frame > 0) {
+            auto waitStart = std::chrono::steady_clock::now();
+            bool loaded = pending.get();
+            waitMs += ElapsedMilliseconds(waitStart);
+            if (!loaded) {
+                break;
+            }
+        }
+
+        const LumaImage &reference = current.reference;
+        const LumaImage &foveated = current.foveated;
+        if (reference.width != width || reference.height != height || foveated.width != width || foveated.height != height) {
+            fprintf(stderr, "Frame %d is not %dx%d in both sequences\n", current.number, width, height);
+            return 1;
+        }
+
+        // Decode the next pair while this one is evaluated
+        bool more = count == 0 || frame + 1 < static_cast<size_t>(count);
+        if (more) {
+            pending = std::async(std::launch::async, LoadPair, referencePattern, foveatedPattern, current.number + 1, &pairs[(frame + 1) & 1]);
+        }
+
+        Vector2 gazePos = fixedGaze;
+        if (!frameGaze.empty()) {
+            gazePos = frameGaze[(std::min)(frame, frameGaze.size() - 1)];
+        }
+
+        auto evaluateStart = std::chrono::steady_clock::now();
+        FrameQuality quality = metric.Evaluate(reference.pixels.data(), foveated.pixels.data(), gazePos, desc, pool);
+        evaluateMs += ElapsedMilliseconds(evaluateStart);
+
+        psnr.Add(quality.psnr);
+        ssim.Add(quality.ssim);
+        weightedPsnr.Add(quality.weightedPsnr);
+        weightedSsim.Add(quality.weightedSsim);
+        for (int region = 0; region < 3; ++region) {
+            const RegionQuality &result = quality.regions[region];
+            regionCoverage[region] += result.coverage;
+            if (result.coverage > 0.0f) {
+                regionPsnr[region].Add(result.psnr);
+                regionSsim[region].Add(result.ssim);
+            }
+        }
+        costSum += EstimateShadingCost(width, height, settings.tileSize, gazePos, desc).relativeCost;
+
+        for (int row = 0; row < tilesY; ++row) {
+            for (int column = 0; column < tilesX; ++column) {
+                size_t index = static_cast<size_t>(row) * tilesX + column;
+                const TileQuality &tile = metric.GetTile(column, row);
+                tileSquaredError[index] += tile.squaredError;
+                tilePixels[index] += tile.pixels;
+                tileSsimSum[index] += tile.ssimSum;
+                tileWindows[index] += tile.windows;
+                ++tileRegionFrames[index * 3 + static_cast<int>(metric.GetRegion(column, row))];
+            }
+        }
+
+        if (framesFile) {
+            fprintf(framesFile, "%d,%.5f,%.5f,%.4f,%.6f,%.4f,%.6f", current.number, gazePos.x, gazePos.y,
+                    quality.psnr, quality.ssim, quality.weightedPsnr, quality.weightedSsim);
+            for (const RegionQuality &result : quality.regions) {
+                fprintf(framesFile, ",%.4f,%.6f", result.psnr, result.ssim);
+            }
+            fprintf(framesFile, "\n");
+        }
+
+        if (!more) {
+            ++frame;
+            break;
+        }
+    }
+    if (framesFile) {
+        fclose(framesFile);
+    }
+
+    double frames = static_cast<double>(frame);
+    double megapixels = static_cast<double>(width) * height * 1e-6;
+    printf("%zu frames, evaluation %.2f ms per frame (%.0f Mpixel/s), waited %.2f ms per frame for decoding\n",
+           frame, evaluateMs / frames, megapixels * frames / (evaluateMs * 1e-3), waitMs / frames);
+    printf("estimated shading cost %.3f of full rate\n\n", costSum / frames);
+
+    printf("%-22s %10s %10s\n", "metric", "mean", "worst");
+    psnr.Print("psnr", "dB");
+    ssim.Print("ssim", "");
+    weightedPsnr.Print("weighted psnr", "dB");
+    weightedSsim.Print("weighted ssim", "");
+    for (int region = 0; region < 3; ++region) {
+        std::string name = REGION_NAMES[region];
+        printf("%-22s %10.4f\n", (name + " coverage").c_str(), regionCoverage[region] / frames);
+        regionPsnr[region].Print((name + " psnr").c_str(), "dB");
+        regionSsim[region].Print((name + " ssim").c_str(), "");
+    }
+
+    if (tilesPath) {
+        FILE *file = fopen(tilesPath, "w");
+        if (!file) {
+            fprintf(stderr, "Cannot write %s\n", tilesPath);
+            return 1;
+        }
+        fprintf(file, "# tile_x,tile_y,psnr,ssim,inner_frames,middle_frames,peripheral_frames\n");
+        for (int row = 0; row < tilesY; ++row) {
+            for (int column = 0; column < tilesX; ++column) {
+                size_t index = static_cast<size_t>(row) * tilesX + column;
+                double tileSsim = tileWindows[index] > 0.0 ? tileSsimSum[index] / tileWindows[index] : 1.0;
+                fprintf(file, "%d,%d,%.4f,%.6f,%u,%u,%u\n", column, row, PsnrFromMse(tileSquaredError[index] / tilePixels[index]), tileSsim,
+                        tileRegionFrames[index * 3], tileRegionFrames[index * 3 + 1], tileRegionFrames[index * 3 + 2]);
+            }
+        }
+        fclose(file);
+    }
+
+    return 0;
+}
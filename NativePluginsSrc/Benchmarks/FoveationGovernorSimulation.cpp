@@ -0,0 +1,91 @@
+// Closed-loop simulation of the frame-time governor against a synthetic GPU load.
+//
+// Usage: FoveationGovernorSimulation [target_ms] [frames]
+// Frame time = scene cost + full-rate shading cost * relative shading cost of the
+// requested foveation (ShadingCostModel at 3840x2160) + noise. The scene cost steps
+// through light, heavy and spiky phases; per phase the tool reports mean frame time,
+// frames over budget, mean quality and how often the governor changed direction.
+// Build: g++ -O2 -std=c++17 -I../VrsBased/include FoveationGovernorSimulation.cpp ../VrsBased/Foveation.cpp
+//        ../VrsBased/FoveationGovernor.cpp ../VrsBased/ShadingCostModel.cpp
+
+#include "FoveationGovernor.h"
+#include "ShadingCostModel.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+struct LoadPhase {
+    const char *name;
+    float sceneMs;        // Cost independent of shading
+    float shadingMs;      // Shading cost at 1x1 everywhere
+    float noiseMs;        // Frame to frame jitter
+    float spikeChance;    // Probability of a 2x scene cost frame
+};
+
+int main(int argc, char **argv) {
+    float target = argc > 1 ? static_cast<float>(atof(argv[1])) : 1000.0f / 90.0f;
+    int framesPerPhase = argc > 2 ? atoi(argv[2]) : 1800;
+
+    const LoadPhase phases[] = {
+        {"light", 4.0f, 8.0f, 0.3f, 0.0f},
+        {"heavy", 7.0f, 10.0f, 0.5f, 0.0f},
+        {"spiky", 5.0f, 9.0f, 0.5f, 0.05f},
+        {"overload", 10.0f, 10.0f, 0.5f, 0.0f},
+        {"light", 4.0f, 8.0f, 0.3f, 0.0f},
+    };
+
+    FoveationGovernor governor;
+    FoveationGovernorSettings settings = FoveationGovernor::GetDefaultSettings();
+    settings.enabled = true;
+    settings.targetFrameTimeMs = target;
+    governor.Configure(settings);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+    printf("target %.2f ms, %d frames per phase\n", target, framesPerPhase);
+    printf("%-10s %10s %10s %10s %10s %12s\n", "phase", "mean ms", "over %", "quality", "cost", "reversals");
+
+    FoveationDesc desc = governor.GetState().foveation;
+    for (const LoadPhase &phase : phases) {
+        std::normal_distribution<float> noise(0.0f, phase.noiseMs);
+        double frameTimeSum = 0.0;
+        double qualitySum = 0.0;
+        double costSum = 0.0;
+        int overBudget = 0;
+        int reversals = 0;
+        int lastDirection = 0;
+        float lastQuality = governor.GetState().quality;
+
+        for (int frame = 0; frame < framesPerPhase; ++frame) {
+            // The render thread picks up the foveation at the next enable event
+            bool active;
+            governor.ConsumeFoveation(desc, active);
+
+            float cost = EstimateShadingCost(3840, 2160, 16, {0.0f, 0.0f}, desc).relativeCost;
+            float scene = phase.sceneMs * (uniform(rng) < phase.spikeChance ? 2.0f : 1.0f);
+            float frameTime = (std::max)(scene + phase.shadingMs * cost + noise(rng), 0.1f);
+            governor.SubmitFrameTime(frameTime);
+
+            FoveationGovernorState state = governor.GetState();
+            if (state.quality != lastQuality) {
+                int direction = state.quality > lastQuality ? 1 : -1;
+                reversals += lastDirection != 0 && direction != lastDirection;
+                lastDirection = direction;
+                lastQuality = state.quality;
+            }
+
+            frameTimeSum += frameTime;
+            qualitySum += state.quality;
+            costSum += cost;
+            overBudget += frameTime > target * (1.0f + settings.hysteresis);
+        }
+
+        printf("%-10s %10.2f %10.1f %10.2f %10.3f %12d\n", phase.name, frameTimeSum / framesPerPhase,
+               100.0 * overBudget / framesPerPhase, qualitySum / framesPerPhase, costSum / framesPerPhase, reversals);
+    }
+
+    printf("%llu adjustments in total\n", static_cast<unsigned long long>(governor.GetState().adjustments));
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Throughput benchmark of the gaze filter chain on a recorded or synthetic trace.
+//
+// Usage: GazeFilterBenchmark [trace.csv] [repetitions]
+// Trace lines are "timestamp_us,x,y" in normalized gaze space, lines starting with '#' are skipped.
+// Build: g++ -O2 -std=c++17 -I../VrsBased/include GazeFilterBenchmark.cpp ../VrsBased/GazeFilters.cpp
+
+#include "GazeFilters.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Webcam-like trace: fixations with jitter, separated by saccades, sampled at 60 Hz
+static std::vector<GazeSample> GenerateTrace(size_t count) {
+    std::mt19937 rng(42);
+    std::normal_distribution<float> jitter(0.0f, 0.01f);
+    std::uniform_real_distribution<float> target(-0.4f, 0.4f);
+
+    std::vector<GazeSample> trace;
+    trace.reserve(count);
+
+    Vector2 fixation = {0.0f, 0.0f};
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 30 == 0) {
+            fixation = {target(rng), target(rng)};
+        }
+        GazeSample sample = {};
+        sample.position = {fixation.x + jitter(rng), fixation.y + jitter(rng)};
+        sample.captureTime = static_cast<uint64_t>(i) * 16667;
+        sample.receiveTime = sample.captureTime;
+        sample.sequence = i;
+        trace.push_back(sample);
+    }
+    return trace;
+}
+
+static bool LoadTrace(const char *path, std::vector<GazeSample> &trace) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        unsigned long long timestamp;
+        float x, y;
+        if (line[0] != '#' && sscanf(line, "%llu,%f,%f", &timestamp, &x, &y) == 3) {
+            GazeSample sample = {{x, y}, timestamp, timestamp, trace.size()};
+            trace.push_back(sample);
+        }
+    }
+
+    fclose(file);
+    return !trace.empty();
+}
+
+struct Scenario {
+    const char *name;
+    GazeFilterType stages[GazeFilterChain::MAX_STAGES];
+    int count;
+};
+
+int main(int argc, char **argv) {
+    std::vector<GazeSample> trace;
+    if (argc > 1) {
+        if (!LoadTrace(argv[1], trace)) {
+            fprintf(stderr, "Cannot read trace %s\n", argv[1]);
+            return 1;
+        }
+    } else {
+        trace = GenerateTrace(100000);
+    }
+    int repetitions = argc > 2 ? atoi(argv[2]) : 20;
+
+    const Scenario scenarios[] = {
+        {"none", {}, 0},
+        {"dead-zone", {GazeFilterType::DEAD_ZONE}, 1},
+        {"one-euro", {GazeFilterType::ONE_EURO}, 1},
+        {"kalman", {GazeFilterType::KALMAN}, 1},
+        {"one-euro+ivt", {GazeFilterType::ONE_EURO, GazeFilterType::FIXATION_IVT}, 2},
+        {"kalman+idt", {GazeFilterType::KALMAN, GazeFilterType::FIXATION_IDT}, 2},
+    };
+
+    printf("%zu samples x %d repetitions\n", trace.size(), repetitions);
+    printf("%-16s %12s %14s %12s\n", "chain", "ns/sample", "Msamples/s", "jitter");
+
+    std::vector<GazeSample> work(trace.size());
+    for (const Scenario &scenario : scenarios) {
+        GazeFilterChain chain;
+        chain.SetStages(scenario.stages, scenario.count);
+
+        double seconds = 0.0;
+        for (int repetition = 0; repetition < repetitions; ++repetition) {
+            work = trace;
+            chain.Reset();
+
+            auto start = std::chrono::steady_clock::now();
+            // Without a predictor the dead zone holds every filtered sample
+            for (GazeSample &sample : work) {
+                chain.Process(sample);
+                chain.Hold(sample.position, sample.captureTime);
+            }
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        // Median sample-to-sample motion of the output (saccades fall out of the median),
+        // lower means a steadier foveal region
+        std::vector<double> steps;
+        steps.reserve(work.size());
+        for (size_t i = 1; i < work.size(); ++i) {
+            steps.push_back(hypot(work[i].position.x - work[i - 1].position.x, work[i].position.y - work[i - 1].position.y));
+        }
+        double jitter = 0.0;
+        if (!steps.empty()) {
+            std::nth_element(steps.begin(), steps.begin() + steps.size() / 2, steps.end());
+            jitter = steps[steps.size() / 2];
+        }
+
+        double samples = static_cast<double>(trace.size()) * repetitions;
+        printf("%-16s %12.2f %14.2f %12.5f\n", scenario.name, seconds * 1e9 / samples, samples / seconds * 1e-6, jitter);
+    }
+
+    return 0;
+}
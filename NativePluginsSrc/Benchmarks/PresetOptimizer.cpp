@@ -0,0 +1,543 @@
+// Offline search for custom foveation presets on recorded frames and gaze.
+//
+// Usage: PresetOptimizer <reference pattern> [options]
+//   The pattern is a printf path of numbered full-rate PGM/PPM frames, e.g. ref/%06d.ppm
+//   --first <n>            Number of the first frame (default 0)
+//   --count <n>            Frames to use (default: until a frame is missing)
+//   --gaze <x>,<y>         Fixed gaze in normalized gaze space (default 0,0)
+//   --gaze-frames <file>   Per-frame gaze, "frame,x,y" as written by CameraRouteBenchmark --frames
+//   --fov <deg>            Vertical field of view (default 60)
+//   --tile <px>            Shading-rate tile size, a multiple of 4 (default 16)
+//   --e2 <deg>             Eccentricity at which acuity has halved (default 2.3)
+//   --radii <min:max:step> Horizontal inner and middle radii to sweep (default 0.1:0.6:0.05)
+//   --aspects <list>       Comma separated vertical to horizontal radius ratios (default 1)
+//   --gap <r>              Smallest difference of middle and inner radius (default 0.05)
+//   --rates <list>         Comma separated coarse rates to combine, 1x1 2x1 1x2 2x2 4x2 2x4 4x4 (default all)
+//   --threads <n>          Worker threads besides the main thread (default: hardware threads - 1)
+//   --out <file>           Preset file of the Pareto frontier (default foveation_presets.txt)
+// Build: g++ -O2 -std=c++17 -pthread -I../VrsBased/include PresetOptimizer.cpp ../VrsBased/Foveation.cpp
+//        ../VrsBased/FoveationPresetFile.cpp ../VrsBased/ShadingCostModel.cpp ../VrsBased/ShadingRateImage.cpp
+//        ../VrsBased/WorkerPool.cpp
+//
+// Every candidate, CUSTOM radii plus a rate per region that coarsens
+// outwards, is scored by its mean shading cost (ShadingCostModel) and the
+// acuity-weighted squared error its rates cause (QualityMetrics.h), and the
+// non-dominated candidates are written sorted by cost. The plugin loads an
+// entry with LoadFoveationPreset; check the chosen entries on real captures
+// with FoveatedQualityEvaluator.
+//
+// Coarse shading is emulated by averaging each coarse pixel block of the
+// reference. The error a rate causes in a tile does not depend on the
+// candidate, only which rate a tile gets does, so every frame is streamed
+// once and reduced to a table of weighted errors per tile and rate. A
+// candidate then costs one pass over the tiles per frame for its radii,
+// shared by all its rate combinations, and combinations are dropped as
+// soon as their partial error already puts them behind the frontier.
+// Radii are searched in parallel across cores.
+
+#include "FoveationPresetFile.h"
+#include "QualityMetrics.h"
+#include "ShadingCostModel.h"
+#include "ShadingRateImage.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Frames between two checks of the partial errors against the frontier
+static const int PRUNE_INTERVAL = 8;
+
+// Coarse rate and the pixel block it shades once
+struct CoarseRate {
+    ShadingRate rate;
+    int width;
+    int height;
+};
+
+static const CoarseRate COARSE_RATES[] = {
+    {ShadingRate::X1_PER_PIXEL, 1, 1},
+    {ShadingRate::X1_PER_2X1_PIXELS, 2, 1},
+    {ShadingRate::X1_PER_1X2_PIXELS, 1, 2},
+    {ShadingRate::X1_PER_2X2_PIXELS, 2, 2},
+    {ShadingRate::X1_PER_4X2_PIXELS, 4, 2},
+    {ShadingRate::X1_PER_2X4_PIXELS, 2, 4},
+    {ShadingRate::X1_PER_4X4_PIXELS, 4, 4},
+};
+
+// Rates of the three regions, as indices into the rates being combined
+struct RateCombination {
+    int inner;
+    int middle;
+    int peripheral;
+};
+
+struct Candidate {
+    FoveationDesc desc;
+    double cost;
+    double error;       // Mean acuity-weighted squared error per pixel
+    size_t id;          // Breaks ties between equal scores deterministically
+};
+
+// Non-dominated candidates found so far, shared by the search threads
+class ParetoFrontier {
+public:
+    // Whether a candidate scoring at least cost and error cannot enter the frontier
+    bool IsDominated(double cost, double error, size_t id) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const Candidate &point : points) {
+            if (Dominates(point, cost, error, id)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Insert(const Candidate &candidate) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const Candidate &point : points) {
+            if (Dominates(point, candidate.cost, candidate.error, candidate.id)) {
+                return;
+            }
+        }
+        points.erase(std::remove_if(points.begin(), points.end(), [&](const Candidate &point) {
+            return Dominates(candidate, point.cost, point.error, point.id);
+        }), points.end());
+        points.push_back(candidate);
+    }
+
+    std::vector<Candidate> GetSorted() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<Candidate> sorted = points;
+        std::sort(sorted.begin(), sorted.end(), [](const Candidate &a, const Candidate &b) { return a.cost < b.cost; });
+        return sorted;
+    }
+
+private:
+    static bool Dominates(const Candidate &point, double cost, double error, size_t id) {
+        if (point.cost > cost || point.error > error) {
+            return false;
+        }
+        return point.cost < cost || point.error < error || point.id < id;
+    }
+
+    mutable std::mutex mutex;
+    std::vector<Candidate> points;
+};
+
+// Per-frame gaze, "frame,x,y[,...]" lines, '#' comments skipped
+static bool LoadFrameGaze(const char *path, std::vector<Vector2> &gaze) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        size_t frame;
+        Vector2 position;
+        if (line[0] == '#' || sscanf(line, "%zu,%f,%f", &frame, &position.x, &position.y) != 3) {
+            continue;
+        }
+        if (frame >= gaze.size()) {
+            gaze.resize(frame + 1, position);
+        }
+        gaze[frame] = position;
+    }
+    fclose(file);
+    return !gaze.empty();
+}
+
+static bool ParseRates(const char *text, std::vector<CoarseRate> &rates) {
+    rates.clear();
+    std::string list = text;
+    size_t begin = 0;
+    for (;;) {
+        size_t end = list.find(',', begin);
+        std::string name = list.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+        ShadingRate rate;
+        if (!ParseShadingRateName(name.c_str(), rate)) {
+            return false;
+        }
+
+        // The reference is shaded once per pixel, finer rates cannot be scored against it
+        bool found = false;
+        for (const CoarseRate &coarse : COARSE_RATES) {
+            if (coarse.rate == rate) {
+                rates.push_back(coarse);
+                found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+        if (end == std::string::npos) {
+            break;
+        }
+        begin = end + 1;
+    }
+    return true;
+}
+
+static bool ParseList(const char *text, std::vector<float> &values) {
+    values.clear();
+    for (const char *cursor = text; *cursor;) {
+        char *end;
+        float value = strtof(cursor, &end);
+        if (end == cursor || value <= 0.0f) {
+            return false;
+        }
+        values.push_back(value);
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    return !values.empty();
+}
+
+// Replace every coarse pixel block of a luma image by its average, rows [beginY, endY) of block-aligned bands
+static void EmulateCoarseShading(const LumaImage &reference, const CoarseRate &rate, int beginY, int endY, uint8_t *output) {
+    const int width = reference.width;
+    for (int y = beginY; y < endY; y += rate.height) {
+        int rows = (std::min)(rate.height, endY - y);
+        for (int x = 0; x < width; x += rate.width) {
+            int columns = (std::min)(rate.width, width - x);
+            int sum = 0;
+            for (int row = 0; row < rows; ++row) {
+                const uint8_t *pixels = reference.pixels.data() + static_cast<size_t>(y + row) * width + x;
+                for (int column = 0; column < columns; ++column) {
+                    sum += pixels[column];
+                }
+            }
+            int count = rows * columns;
+            uint8_t average = static_cast<uint8_t>((sum + count / 2) / count);
+            for (int row = 0; row < rows; ++row) {
+                memset(output + static_cast<size_t>(y + row) * width + x, average, columns);
+            }
+        }
+    }
+}
+
+static double ElapsedSeconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <reference pattern> [--first n] [--count n] [--gaze x,y] [--gaze-frames file.csv] [--fov deg]\n"
+                        "       [--tile px] [--e2 deg] [--radii min:max:step] [--aspects list] [--gap r] [--rates list]\n"
+                        "       [--threads n] [--out presets.txt]\n", argv[0]);
+        return 1;
+    }
+
+    const char *referencePattern = argv[1];
+    const char *gazePath = nullptr;
+    const char *outPath = "foveation_presets.txt";
+    int first = 0;
+    int count = 0;
+    Vector2 fixedGaze = {0.0f, 0.0f};
+    QualitySettings settings = {16, 60.0f, 2.3f};
+    float radiusMin = 0.1f, radiusMax = 0.6f, radiusStep = 0.05f;
+    std::vector<float> aspects = {1.0f};
+    float gap = 0.05f;
+    std::vector<CoarseRate> rates(COARSE_RATES, COARSE_RATES + sizeof(COARSE_RATES) / sizeof(COARSE_RATES[0]));
+    int threads = -1;
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        const char *option = argv[i];
+        const char *value = argv[i + 1];
+        if (strcmp(option, "--first") == 0) first = atoi(value);
+        else if (strcmp(option, "--count") == 0) count = (std::max)(atoi(value), 0);
+        else if (strcmp(option, "--gaze") == 0) sscanf(value, "%f,%f", &fixedGaze.x, &fixedGaze.y);
+        else if (strcmp(option, "--gaze-frames") == 0) gazePath = value;
+        else if (strcmp(option, "--fov") == 0) settings.verticalFov = static_cast<float>(atof(value));
+        else if (strcmp(option, "--tile") == 0) settings.tileSize = atoi(value);
+        else if (strcmp(option, "--e2") == 0) settings.acuityEccentricity = static_cast<float>(atof(value));
+        else if (strcmp(option, "--gap") == 0) gap = static_cast<float>(atof(value));
+        else if (strcmp(option, "--threads") == 0) threads = atoi(value);
+        else if (strcmp(option, "--out") == 0) outPath = value;
+        else if (strcmp(option, "--radii") == 0) {
+            if (sscanf(value, "%f:%f:%f", &radiusMin, &radiusMax, &radiusStep) != 3 || radiusMin <= 0.0f || radiusStep <= 0.0f) {
+                fprintf(stderr, "Invalid radius range %s\n", value);
+                return 1;
+            }
+        } else if (strcmp(option, "--aspects") == 0) {
+            if (!ParseList(value, aspects)) {
+                fprintf(stderr, "Invalid aspect list %s\n", value);
+                return 1;
+            }
+        } else if (strcmp(option, "--rates") == 0) {
+            if (!ParseRates(value, rates)) {
+                fprintf(stderr, "Invalid rate list %s, use 1x1, 2x1, 1x2, 2x2, 4x2, 2x4 and 4x4\n", value);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Unknown option %s\n", option);
+            return 1;
+        }
+    }
+
+    std::vector<Vector2> trace;
+    if (gazePath && !LoadFrameGaze(gazePath, trace)) {
+        fprintf(stderr, "Cannot read gaze from %s\n", gazePath);
+        return 1;
+    }
+
+    auto readPath = [&](int number) {
+        char path[1024];
+        snprintf(path, sizeof(path), referencePattern, number);
+        return std::string(path);
+    };
+
+    LumaImage frames[2];
+    if (!ReadPnmLuma(readPath(first).c_str(), frames[0])) {
+        fprintf(stderr, "Cannot read frame %d of %s\n", first, referencePattern);
+        return 1;
+    }
+    const int width = frames[0].width;
+    const int height = frames[0].height;
+
+    FoveatedQualityMetric metric;
+    if (!metric.Initialize(width, height, settings)) {
+        fprintf(stderr, "Unsupported frame size %dx%d or settings (tile %d, fov %.1f, e2 %.2f)\n",
+                width, height, settings.tileSize, settings.verticalFov, settings.acuityEccentricity);
+        return 1;
+    }
+    WorkerPool pool(threads);
+
+    const int tilesX = metric.GetTilesX();
+    const int tilesY = metric.GetTilesY();
+    const size_t tileCount = static_cast<size_t>(tilesX) * tilesY;
+    const size_t rateCount = rates.size();
+    printf("%dx%d frames, %d worker threads, %zu rates, %dx%d tiles of %d\n",
+           width, height, pool.GetWorkerCount(), rateCount, tilesX, tilesY, settings.tileSize);
+
+    // Pass 1: stream the frames into per-tile error tables, errors[frame][rate][tile]
+    auto tableStart = std::chrono::steady_clock::now();
+    std::vector<float> errors;
+    std::vector<double> frameWeights;
+    std::vector<Vector2> frameGaze;
+    std::vector<uint8_t> emulated(static_cast<size_t>(width) * height);
+    std::future<bool> pending;
+    for (size_t frame = 0;; ++frame) {
+        LumaImage &reference = frames[frame & 1];
+        if (frame > 0 && !pending.get()) {
+            break;
+        }
+        if (reference.width != width || reference.height != height) {
+            fprintf(stderr, "Frame %zu is not %dx%d\n", first + frame, width, height);
+            return 1;
+        }
+
+        bool more = count == 0 || frame + 1 < static_cast<size_t>(count);
+        if (more) {
+            LumaImage *next = &frames[(frame + 1) & 1];
+            std::string path = readPath(first + static_cast<int>(frame) + 1);
+            pending = std::async(std::launch::async, [next, path]() { return ReadPnmLuma(path.c_str(), *next); });
+        }
+
+        Vector2 gazePos = trace.empty() ? fixedGaze : trace[(std::min)(frame, trace.size() - 1)];
+        frameGaze.push_back(gazePos);
+
+        // The regions do not matter for the per-tile sums
+        FoveationDesc desc = {};
+        ResolveShadingRatePreset(ShadingRatePreset::HIGHEST_PERFORMANCE, desc);
+        ResolveFoveationPatternPreset(ShadingPatternPreset::BALANCED, desc);
+
+        size_t frameOffset = errors.size();
+        errors.resize(frameOffset + rateCount * tileCount, 0.0f);
+        double frameWeight = 0.0;
+        for (size_t rate = 0; rate < rateCount; ++rate) {
+            const CoarseRate &coarse = rates[rate];
+            if (coarse.width == 1 && coarse.height == 1) {
+                continue;
+            }
+            pool.Run(tilesY, [&](int tileRow) {
+                int endY = (std::min)(height, (tileRow + 1) * settings.tileSize);
+                EmulateCoarseShading(reference, coarse, tileRow * settings.tileSize, endY, emulated.data());
+            });
+            metric.Evaluate(reference.pixels.data(), emulated.data(), gazePos, desc, pool);
+
+            float *table = &errors[frameOffset + rate * tileCount];
+            frameWeight = 0.0;
+            for (int row = 0; row < tilesY; ++row) {
+                for (int column = 0; column < tilesX; ++column) {
+                    const TileQuality &tile = metric.GetTile(column, row);
+                    table[static_cast<size_t>(row) * tilesX + column] = static_cast<float>(tile.weightedSquaredError);
+                    frameWeight += tile.pixelWeight;
+                }
+            }
+        }
+        if (frameWeight == 0.0) {
+            // Only 1x1 is combined, weights are needed for normalization alone
+            metric.Evaluate(reference.pixels.data(), reference.pixels.data(), gazePos, desc, pool);
+            for (int row = 0; row < tilesY; ++row) {
+                for (int column = 0; column < tilesX; ++column) {
+                    frameWeight += metric.GetTile(column, row).pixelWeight;
+                }
+            }
+        }
+        frameWeights.push_back(frameWeight);
+
+        if (!more) {
+            break;
+        }
+    }
+    const size_t frameCount = frameWeights.size();
+    printf("error tables of %zu frames in %.1f s, %.1f MB\n", frameCount, ElapsedSeconds(tableStart),
+           errors.size() * sizeof(float) / (1024.0 * 1024.0));
+
+    // Radii pairs and rate combinations that coarsen outwards
+    std::vector<float> radii;
+    for (float radius = radiusMin; radius <= radiusMax + radiusStep * 0.5f; radius += radiusStep) {
+        radii.push_back(radius);
+    }
+    std::vector<FoveationDesc> regionShapes;
+    for (float aspect : aspects) {
+        for (float inner : radii) {
+            for (float middle : radii) {
+                if (middle < inner + gap - 1e-4f) {
+                    continue;
+                }
+                FoveationDesc desc = {};
+                desc.innerRadii = {inner, inner * aspect};
+                desc.middleRadii = {middle, middle * aspect};
+                desc.peripheralRadii = {(std::max)(1.0f, middle), (std::max)(1.0f, middle * aspect)};
+                regionShapes.push_back(desc);
+            }
+        }
+    }
+
+    std::vector<RateCombination> combinations;
+    std::vector<float> rateCosts(rateCount);
+    for (size_t rate = 0; rate < rateCount; ++rate) {
+        rateCosts[rate] = GetShadingRateCost(rates[rate].rate);
+    }
+    for (int inner = 0; inner < static_cast<int>(rateCount); ++inner) {
+        for (int middle = 0; middle < static_cast<int>(rateCount); ++middle) {
+            for (int peripheral = 0; peripheral < static_cast<int>(rateCount); ++peripheral) {
+                if (rateCosts[middle] <= rateCosts[inner] && rateCosts[peripheral] <= rateCosts[middle]) {
+                    combinations.push_back({inner, middle, peripheral});
+                }
+            }
+        }
+    }
+    if (regionShapes.empty() || combinations.empty()) {
+        fprintf(stderr, "No candidates, widen --radii or reduce --gap\n");
+        return 1;
+    }
+
+    // Pass 2: score the candidates of each region shape on one thread, shapes in parallel
+    auto searchStart = std::chrono::steady_clock::now();
+    ParetoFrontier frontier;
+    std::vector<size_t> prunedCandidates(regionShapes.size(), 0);
+    std::vector<size_t> scoredPasses(regionShapes.size(), 0);
+    pool.Run(static_cast<int>(regionShapes.size()), [&](int shape) {
+        FoveationDesc desc = regionShapes[shape];
+        ShadingRateImage image;
+        image.Initialize(width, height, settings.tileSize);
+
+        // Mean cost of every combination over the gaze trace, exact before any error is known
+        std::vector<double> coverage(3, 0.0);
+        for (const Vector2 &gazePos : frameGaze) {
+            ShadingCostEstimate estimate = EstimateShadingCost(width, height, settings.tileSize, gazePos, desc);
+            for (int region = 0; region < 3; ++region) {
+                coverage[region] += estimate.regionCoverage[region] / static_cast<double>(frameCount);
+            }
+        }
+
+        std::vector<int> alive;
+        std::vector<double> costs(combinations.size());
+        std::vector<double> errorSums(combinations.size(), 0.0);
+        for (size_t index = 0; index < combinations.size(); ++index) {
+            const RateCombination &rate = combinations[index];
+            costs[index] = coverage[0] * rateCosts[rate.inner] + coverage[1] * rateCosts[rate.middle] + coverage[2] * rateCosts[rate.peripheral];
+            alive.push_back(static_cast<int>(index));
+        }
+
+        std::vector<double> regionErrors(3 * rateCount);
+        for (size_t frame = 0; frame < frameCount && !alive.empty(); ++frame) {
+            image.Update(frameGaze[frame], desc);
+
+            // Error of each rate summed over the tiles of each region, shared by all combinations
+            std::fill(regionErrors.begin(), regionErrors.end(), 0.0);
+            const float *frameErrors = &errors[frame * rateCount * tileCount];
+            for (int row = 0; row < tilesY; ++row) {
+                for (int column = 0; column < tilesX; ++column) {
+                    size_t tile = static_cast<size_t>(row) * tilesX + column;
+                    double *sums = &regionErrors[static_cast<int>(image.GetRegion(column, row)) * rateCount];
+                    for (size_t rate = 0; rate < rateCount; ++rate) {
+                        sums[rate] += frameErrors[rate * tileCount + tile];
+                    }
+                }
+            }
+
+            double inverseWeight = 1.0 / frameWeights[frame];
+            for (int index : alive) {
+                const RateCombination &rate = combinations[index];
+                errorSums[index] += (regionErrors[rate.inner] + regionErrors[rateCount + rate.middle] +
+                                     regionErrors[2 * rateCount + rate.peripheral]) * inverseWeight;
+            }
+            scoredPasses[shape] += alive.size();
+
+            // Errors only grow with more frames, so the partial mean bounds the final error from below
+            if ((frame + 1) % PRUNE_INTERVAL == 0 && frame + 1 < frameCount) {
+                size_t before = alive.size();
+                alive.erase(std::remove_if(alive.begin(), alive.end(), [&](int index) {
+                    size_t id = static_cast<size_t>(shape) * combinations.size() + index;
+                    return frontier.IsDominated(costs[index], errorSums[index] / frameCount, id);
+                }), alive.end());
+                prunedCandidates[shape] += before - alive.size();
+            }
+        }
+
+        for (int index : alive) {
+            const RateCombination &rate = combinations[index];
+            Candidate candidate = {desc, costs[index], errorSums[index] / frameCount, static_cast<size_t>(shape) * combinations.size() + index};
+            candidate.desc.innerRate = rates[rate.inner].rate;
+            candidate.desc.middleRate = rates[rate.middle].rate;
+            candidate.desc.peripheralRate = rates[rate.peripheral].rate;
+            frontier.Insert(candidate);
+        }
+    });
+
+    size_t candidateCount = regionShapes.size() * combinations.size();
+    size_t pruned = 0;
+    size_t scored = 0;
+    for (size_t shape = 0; shape < regionShapes.size(); ++shape) {
+        pruned += prunedCandidates[shape];
+        scored += scoredPasses[shape];
+    }
+    printf("%zu candidates (%zu region shapes x %zu rate combinations) searched in %.1f s, %zu pruned early, "
+           "%.0f%% of the frame scores skipped\n", candidateCount, regionShapes.size(), combinations.size(),
+           ElapsedSeconds(searchStart), pruned, 100.0 * (1.0 - static_cast<double>(scored) / (candidateCount * frameCount)));
+
+    std::vector<Candidate> sorted = frontier.GetSorted();
+    std::vector<FoveationPresetEntry> entries;
+    printf("\n%-10s %8s %10s  %-13s %-13s %s\n", "preset", "cost", "wpsnr dB", "inner radii", "middle radii", "rates");
+    for (size_t index = 0; index < sorted.size(); ++index) {
+        const Candidate &candidate = sorted[index];
+        char name[32];
+        snprintf(name, sizeof(name), "pareto-%02zu", index);
+        FoveationPresetEntry entry = {name, candidate.desc, static_cast<float>(candidate.cost), static_cast<float>(PsnrFromMse(candidate.error))};
+        entries.push_back(entry);
+
+        const FoveationDesc &desc = candidate.desc;
+        printf("%-10s %8.4f %10.3f  %5.3f x %5.3f %5.3f x %5.3f %s/%s/%s\n", name, entry.relativeCost, entry.weightedPsnr,
+               desc.innerRadii.x, desc.innerRadii.y, desc.middleRadii.x, desc.middleRadii.y, GetShadingRateName(desc.innerRate),
+               GetShadingRateName(desc.middleRate), GetShadingRateName(desc.peripheralRate));
+    }
+
+    char comment[256];
+    snprintf(comment, sizeof(comment), "Pareto frontier of %zu frames of %s at %dx%d, tile %d, fov %.1f, e2 %.2f",
+             frameCount, referencePattern, width, height, settings.tileSize, settings.verticalFov, settings.acuityEccentricity);
+    if (!WriteFoveationPresets(outPath, entries, comment)) {
+        fprintf(stderr, "Cannot write %s\n", outPath);
+        return 1;
+    }
+    printf("\n%zu presets written to %s\n", entries.size(), outPath);
+    return 0;
+}
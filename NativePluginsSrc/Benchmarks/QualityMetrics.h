@@ -0,0 +1,418 @@
+#pragma once
+
+// Full-reference quality of foveated frames, shared by the benchmark tools
+
+#include "Enums.h"
+#include "Foveation.h"
+#include "ShadingRateImage.h"
+#include "Vector.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define QUALITY_METRICS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// 8-bit luma image, rows tightly packed
+struct LumaImage {
+    int width;
+    int height;
+    std::vector<uint8_t> pixels;
+};
+
+// Next header token of a netpbm file, comments skipped
+inline bool ReadPnmToken(FILE *file, char *token, size_t size) {
+    int c = fgetc(file);
+    for (;;) {
+        while (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            c = fgetc(file);
+        }
+        if (c != '#') {
+            break;
+        }
+        while (c != EOF && c != '\n') {
+            c = fgetc(file);
+        }
+    }
+
+    size_t used = 0;
+    while (c != EOF && c != ' ' && c != '\t' && c != '\r' && c != '\n' && used + 1 < size) {
+        token[used++] = static_cast<char>(c);
+        c = fgetc(file);
+    }
+    token[used] = '\0';
+    return used > 0;
+}
+
+// Load a binary PGM (P5) or PPM (P6) with 8-bit samples, color is converted to Rec. 709 luma
+inline bool ReadPnmLuma(const char *path, LumaImage &image) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    char magic[4], widthText[16], heightText[16], maxText[16];
+    bool valid = ReadPnmToken(file, magic, sizeof(magic)) && ReadPnmToken(file, widthText, sizeof(widthText)) &&
+                 ReadPnmToken(file, heightText, sizeof(heightText)) && ReadPnmToken(file, maxText, sizeof(maxText));
+    bool color = valid && strcmp(magic, "P6") == 0;
+    int width = valid ? atoi(widthText) : 0;
+    int height = valid ? atoi(heightText) : 0;
+    valid = valid && (color || strcmp(magic, "P5") == 0) && width > 0 && height > 0 && atoi(maxText) == 255;
+    if (!valid) {
+        fclose(file);
+        return false;
+    }
+
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(pixelCount);
+    if (!color) {
+        valid = fread(image.pixels.data(), 1, pixelCount, file) == pixelCount;
+    } else {
+        // One row of RGB at a time keeps the scratch buffer small
+        std::vector<uint8_t> row(static_cast<size_t>(width) * 3);
+        for (int y = 0; y < height && valid; ++y) {
+            valid = fread(row.data(), 1, row.size(), file) == row.size();
+            uint8_t *out = image.pixels.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                const uint8_t *rgb = row.data() + x * 3;
+                out[x] = static_cast<uint8_t>((54 * rgb[0] + 183 * rgb[1] + 19 * rgb[2]) >> 8);
+            }
+        }
+    }
+    fclose(file);
+    return valid;
+}
+
+// Identical images report this PSNR instead of infinity
+static const double QUALITY_MAX_PSNR = 100.0;
+
+inline double PsnrFromMse(double mse) {
+    return mse > 0.0 ? (std::min)(10.0 * log10(255.0 * 255.0 / mse), QUALITY_MAX_PSNR) : QUALITY_MAX_PSNR;
+}
+
+struct QualitySettings {
+    int tileSize;               // Tile of the per-tile report and the region classification, a multiple of 4 pixels
+    float verticalFov;          // Degrees, maps pixels to their eccentricity from the gaze
+    float acuityEccentricity;   // Eccentricity in degrees at which acuity has halved (E2)
+};
+
+struct RegionQuality {
+    double psnr;
+    double ssim;
+    float coverage;             // Fraction of the frame's pixels, 0 when the region is off screen
+};
+
+struct FrameQuality {
+    double psnr;
+    double ssim;
+    double weightedPsnr;        // Errors weighted by the acuity at their eccentricity
+    double weightedSsim;
+    RegionQuality regions[3];   // Indexed by TargetArea
+};
+
+// Errors of one tile in the last evaluated frame
+struct TileQuality {
+    double squaredError;
+    double ssimSum;
+    uint32_t pixels;
+    uint32_t windows;
+
+    // Same sums weighted by acuity
+    double weightedSquaredError;
+    double pixelWeight;
+    double weightedSsimSum;
+    double windowWeight;
+};
+
+// PSNR and SSIM of a frame against its full-rate reference, on luma, in
+// total, per foveation region and per tile, plus variants that discount
+// errors by the visual acuity at their eccentricity from the gaze.
+//
+// Acuity falls off as E2 / (E2 + e) with eccentricity e (cortical
+// magnification, Levi et al.; E2 is about 2.3 degrees), so an error 10
+// degrees into the periphery weighs about a fifth of the same error at
+// the gaze point.
+//
+// Each frame is reduced to sums over 4x4 pixel blocks (SSE2, 16 pixels per
+// step). PSNR adds up the block sums exactly; SSIM uses 8x8 windows of 2x2
+// blocks at a stride of 4 pixels, the fast windowing of video encoders, and
+// attributes each window to the tile of its top-left block. Tile rows are
+// evaluated in parallel on a WorkerPool.
+class FoveatedQualityMetric {
+public:
+    static const int BLOCK_SIZE = 4;
+
+    FoveatedQualityMetric()
+        : width(0), height(0), settings{}, tanHalfX(0.0f), tanHalfY(0.0f), gazeDirection{0.0f, 0.0f, 1.0f},
+          blocksX(0), blocksY(0), tilesX(0), tilesY(0) {}
+
+    // Size the metric for frames of one resolution, returns false for unsupported settings
+    bool Initialize(int frameWidth, int frameHeight, const QualitySettings &qualitySettings) {
+        if (frameWidth < 2 * BLOCK_SIZE || frameHeight < 2 * BLOCK_SIZE || qualitySettings.tileSize <= 0 ||
+            qualitySettings.tileSize % BLOCK_SIZE != 0 || qualitySettings.verticalFov <= 0.0f ||
+            qualitySettings.verticalFov >= 180.0f || qualitySettings.acuityEccentricity <= 0.0f) {
+            return false;
+        }
+
+        width = frameWidth;
+        height = frameHeight;
+        settings = qualitySettings;
+        blocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        blocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+        size_t blockCount = static_cast<size_t>(blocksX) * blocksY;
+        for (std::vector<uint32_t> &sums : blockSums) {
+            sums.assign(blockCount, 0);
+        }
+        blockWeights.assign(blockCount, 0.0f);
+
+        regions.Initialize(width, height, settings.tileSize);
+        tilesX = regions.GetWidth();
+        tilesY = regions.GetHeight();
+        tiles.assign(static_cast<size_t>(tilesX) * tilesY, TileQuality{});
+        return true;
+    }
+
+    // Compare a frame to its reference, both luma of the initialized size.
+    // Gaze and regions use the normalized NVAPI screen space of FoveationDesc.
+    FrameQuality Evaluate(const uint8_t *reference, const uint8_t *test, const Vector2 &gazePos, const FoveationDesc &desc, WorkerPool &pool) {
+        regions.Update(gazePos, desc);
+
+        // View directions on the image plane at distance 1, +y up like the gaze
+        const float degreesToRadians = 3.14159265f / 180.0f;
+        tanHalfY = tanf(settings.verticalFov * 0.5f * degreesToRadians);
+        tanHalfX = tanHalfY * width / height;
+        gazeDirection = {gazePos.x * 2.0f * tanHalfX, gazePos.y * 2.0f * tanHalfY, 1.0f};
+
+        // Windows read the block row below their own, so all block sums are needed first
+        const int blockRowsPerTile = settings.tileSize / BLOCK_SIZE;
+        pool.Run(tilesY, [&](int tileRow) {
+            int end = (std::min)(blocksY, (tileRow + 1) * blockRowsPerTile);
+            for (int blockRow = tileRow * blockRowsPerTile; blockRow < end; ++blockRow) {
+                AccumulateBlockRow(reference, test, blockRow);
+            }
+        });
+        pool.Run(tilesY, [&](int tileRow) { EvaluateTileRow(tileRow); });
+
+        // Reduce in tile order so results do not depend on the thread count
+        double squaredError = 0.0, weightedSquaredError = 0.0, pixelWeight = 0.0;
+        double ssimSum = 0.0, weightedSsimSum = 0.0, windowWeight = 0.0;
+        uint64_t pixels = 0, windows = 0;
+        double regionSquaredError[3] = {}, regionSsimSum[3] = {};
+        uint64_t regionPixels[3] = {}, regionWindows[3] = {};
+        for (int row = 0; row < tilesY; ++row) {
+            for (int column = 0; column < tilesX; ++column) {
+                const TileQuality &tile = tiles[static_cast<size_t>(row) * tilesX + column];
+                int region = static_cast<int>(regions.GetRegion(column, row));
+                squaredError += tile.squaredError;
+                ssimSum += tile.ssimSum;
+                pixels += tile.pixels;
+                windows += tile.windows;
+                weightedSquaredError += tile.weightedSquaredError;
+                pixelWeight += tile.pixelWeight;
+                weightedSsimSum += tile.weightedSsimSum;
+                windowWeight += tile.windowWeight;
+                regionSquaredError[region] += tile.squaredError;
+                regionSsimSum[region] += tile.ssimSum;
+                regionPixels[region] += tile.pixels;
+                regionWindows[region] += tile.windows;
+            }
+        }
+
+        FrameQuality quality = {};
+        quality.psnr = PsnrFromMse(squaredError / pixels);
+        quality.ssim = ssimSum / windows;
+        quality.weightedPsnr = PsnrFromMse(weightedSquaredError / pixelWeight);
+        quality.weightedSsim = weightedSsimSum / windowWeight;
+        for (int region = 0; region < 3; ++region) {
+            RegionQuality &result = quality.regions[region];
+            result.coverage = static_cast<float>(static_cast<double>(regionPixels[region]) / pixels);
+            result.psnr = regionPixels[region] > 0 ? PsnrFromMse(regionSquaredError[region] / regionPixels[region]) : QUALITY_MAX_PSNR;
+            result.ssim = regionWindows[region] > 0 ? regionSsimSum[region] / regionWindows[region] : 1.0;
+        }
+        return quality;
+    }
+
+    // Tile grid of the last evaluation, the shading-rate tile grid of the settings
+    int GetTilesX() const { return tilesX; }
+    int GetTilesY() const { return tilesY; }
+    const TileQuality &GetTile(int column, int row) const { return tiles[static_cast<size_t>(row) * tilesX + column]; }
+    TargetArea GetRegion(int column, int row) const { return regions.GetRegion(column, row); }
+
+    // Acuity relative to the gaze point, E2 / (E2 + eccentricity), of a pixel position
+    float GetAcuityWeight(float pixelX, float pixelY) const {
+        Vector3 direction = {(pixelX / width * 2.0f - 1.0f) * tanHalfX, (1.0f - pixelY / height * 2.0f) * tanHalfY, 1.0f};
+        float dot = direction.x * gazeDirection.x + direction.y * gazeDirection.y + direction.z * gazeDirection.z;
+        float lengths = sqrtf((direction.x * direction.x + direction.y * direction.y + 1.0f) *
+                              (gazeDirection.x * gazeDirection.x + gazeDirection.y * gazeDirection.y + 1.0f));
+        float eccentricity = acosf((std::min)(dot / lengths, 1.0f)) * (180.0f / 3.14159265f);
+        return settings.acuityEccentricity / (settings.acuityEccentricity + eccentricity);
+    }
+
+private:
+    enum BlockSum {
+        SUM_REFERENCE,
+        SUM_TEST,
+        SUM_REFERENCE_SQUARED,
+        SUM_TEST_SQUARED,
+        SUM_PRODUCT,
+        BLOCK_SUMS
+    };
+
+#ifdef QUALITY_METRICS_SSE2
+    // Per 4-pixel group sums of two 8-lane madd results: [a0 + a1, a2 + a3, b0 + b1, b2 + b3]
+    static __m128i SumPairs(__m128i a, __m128i b) {
+        __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(3, 1, 3, 1));
+        return _mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd));
+    }
+
+    static void AddTo(uint32_t *sums, __m128i value) {
+        __m128i *target = reinterpret_cast<__m128i *>(sums);
+        _mm_storeu_si128(target, _mm_add_epi32(_mm_loadu_si128(target), value));
+    }
+#endif
+
+    // Sums of one row of blocks and the acuity weight at each block center
+    void AccumulateBlockRow(const uint8_t *reference, const uint8_t *test, int blockRow) {
+        size_t rowOffset = static_cast<size_t>(blockRow) * blocksX;
+        uint32_t *sums[BLOCK_SUMS];
+        for (int sum = 0; sum < BLOCK_SUMS; ++sum) {
+            sums[sum] = blockSums[sum].data() + rowOffset;
+            memset(sums[sum], 0, blocksX * sizeof(uint32_t));
+        }
+
+        int endY = (std::min)(height, (blockRow + 1) * BLOCK_SIZE);
+        for (int y = blockRow * BLOCK_SIZE; y < endY; ++y) {
+            const uint8_t *referenceRow = reference + static_cast<size_t>(y) * width;
+            const uint8_t *testRow = test + static_cast<size_t>(y) * width;
+            int x = 0;
+#ifdef QUALITY_METRICS_SSE2
+            // 16 pixels are four blocks; madd of 16-bit pixels sums adjacent pairs without overflow
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i ones = _mm_set1_epi16(1);
+            for (; x + 16 <= width; x += 16) {
+                __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(referenceRow + x));
+                __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i *>(testRow + x));
+                __m128i rLow = _mm_unpacklo_epi8(r, zero);
+                __m128i rHigh = _mm_unpackhi_epi8(r, zero);
+                __m128i tLow = _mm_unpacklo_epi8(t, zero);
+                __m128i tHigh = _mm_unpackhi_epi8(t, zero);
+
+                int block = x / BLOCK_SIZE;
+                AddTo(sums[SUM_REFERENCE] + block, SumPairs(_mm_madd_epi16(rLow, ones), _mm_madd_epi16(rHigh, ones)));
+                AddTo(sums[SUM_TEST] + block, SumPairs(_mm_madd_epi16(tLow, ones), _mm_madd_epi16(tHigh, ones)));
+                AddTo(sums[SUM_REFERENCE_SQUARED] + block, SumPairs(_mm_madd_epi16(rLow, rLow), _mm_madd_epi16(rHigh, rHigh)));
+                AddTo(sums[SUM_TEST_SQUARED] + block, SumPairs(_mm_madd_epi16(tLow, tLow), _mm_madd_epi16(tHigh, tHigh)));
+                AddTo(sums[SUM_PRODUCT] + block, SumPairs(_mm_madd_epi16(rLow, tLow), _mm_madd_epi16(rHigh, tHigh)));
+            }
+#endif
+            for (; x < width; ++x) {
+                uint32_t r = referenceRow[x];
+                uint32_t t = testRow[x];
+                int block = x / BLOCK_SIZE;
+                sums[SUM_REFERENCE][block] += r;
+                sums[SUM_TEST][block] += t;
+                sums[SUM_REFERENCE_SQUARED][block] += r * r;
+                sums[SUM_TEST_SQUARED][block] += t * t;
+                sums[SUM_PRODUCT][block] += r * t;
+            }
+        }
+
+        float centerY = blockRow * BLOCK_SIZE + BLOCK_SIZE * 0.5f;
+        for (int block = 0; block < blocksX; ++block) {
+            blockWeights[rowOffset + block] = GetAcuityWeight(block * BLOCK_SIZE + BLOCK_SIZE * 0.5f, centerY);
+        }
+    }
+
+    int BlockPixels(int blockX, int blockY) const {
+        return ((std::min)(width, (blockX + 1) * BLOCK_SIZE) - blockX * BLOCK_SIZE) *
+               ((std::min)(height, (blockY + 1) * BLOCK_SIZE) - blockY * BLOCK_SIZE);
+    }
+
+    // SSIM of a window from its sums, constants of Wang et al. for 8-bit samples
+    static double Ssim(double sumReference, double sumTest, double sumReferenceSquared, double sumTestSquared, double sumProduct, int pixels) {
+        const double c1 = (0.01 * 255.0) * (0.01 * 255.0);
+        const double c2 = (0.03 * 255.0) * (0.03 * 255.0);
+        double inverse = 1.0 / pixels;
+        double meanReference = sumReference * inverse;
+        double meanTest = sumTest * inverse;
+        double varianceReference = sumReferenceSquared * inverse - meanReference * meanReference;
+        double varianceTest = sumTestSquared * inverse - meanTest * meanTest;
+        double covariance = sumProduct * inverse - meanReference * meanTest;
+        return ((2.0 * meanReference * meanTest + c1) * (2.0 * covariance + c2)) /
+               ((meanReference * meanReference + meanTest * meanTest + c1) * (varianceReference + varianceTest + c2));
+    }
+
+    void EvaluateTileRow(int tileRow) {
+        TileQuality *rowTiles = &tiles[static_cast<size_t>(tileRow) * tilesX];
+        std::fill(rowTiles, rowTiles + tilesX, TileQuality{});
+
+        const int blocksPerTile = settings.tileSize / BLOCK_SIZE;
+        int endY = (std::min)(blocksY, (tileRow + 1) * blocksPerTile);
+        for (int blockY = tileRow * blocksPerTile; blockY < endY; ++blockY) {
+            for (int blockX = 0; blockX < blocksX; ++blockX) {
+                size_t index = static_cast<size_t>(blockY) * blocksX + blockX;
+                TileQuality &tile = rowTiles[blockX / blocksPerTile];
+
+                // (r - t)^2 summed from the moments, exact in integers
+                int64_t squaredError = static_cast<int64_t>(blockSums[SUM_REFERENCE_SQUARED][index]) +
+                                       blockSums[SUM_TEST_SQUARED][index] - 2 * static_cast<int64_t>(blockSums[SUM_PRODUCT][index]);
+                int pixels = BlockPixels(blockX, blockY);
+                double weight = blockWeights[index];
+                tile.squaredError += static_cast<double>(squaredError);
+                tile.pixels += pixels;
+                tile.weightedSquaredError += weight * static_cast<double>(squaredError);
+                tile.pixelWeight += weight * pixels;
+
+                // 8x8 window of this block and its right, lower and diagonal neighbours
+                if (blockX + 1 >= blocksX || blockY + 1 >= blocksY) {
+                    continue;
+                }
+                const size_t window[4] = {index, index + 1, index + blocksX, index + blocksX + 1};
+                double sums[BLOCK_SUMS] = {};
+                double windowWeight = 0.0;
+                for (size_t block : window) {
+                    for (int sum = 0; sum < BLOCK_SUMS; ++sum) {
+                        sums[sum] += blockSums[sum][block];
+                    }
+                    windowWeight += blockWeights[block];
+                }
+                windowWeight *= 0.25;
+                int windowPixels = pixels + BlockPixels(blockX + 1, blockY) + BlockPixels(blockX, blockY + 1) + BlockPixels(blockX + 1, blockY + 1);
+
+                double ssim = Ssim(sums[SUM_REFERENCE], sums[SUM_TEST], sums[SUM_REFERENCE_SQUARED], sums[SUM_TEST_SQUARED], sums[SUM_PRODUCT], windowPixels);
+                tile.ssimSum += ssim;
+                tile.windows += 1;
+                tile.weightedSsimSum += windowWeight * ssim;
+                tile.windowWeight += windowWeight;
+            }
+        }
+    }
+
+    int width;
+    int height;
+    QualitySettings settings;
+    float tanHalfX;
+    float tanHalfY;
+    Vector3 gazeDirection;
+
+    int blocksX;
+    int blocksY;
+    std::vector<uint32_t> blockSums[BLOCK_SUMS];
+    std::vector<float> blockWeights;
+
+    ShadingRateImage regions;
+    int tilesX;
+    int tilesY;
+    std::vector<TileQuality> tiles;
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+// Streaming reader of CameraRoute.json files, shared by the benchmark tools
+
+#include "Vector.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+struct RouteKeyframe {
+    Vector3 position;
+    Quaternion rotation;
+    float time;
+};
+
+// Pull scanner over CameraRoute.json as written by CameraRouteRecorder.cs:
+// {"keyframes": [{"position": {x, y, z}, "rotation": {x, y, z, w}, "time": t}, ...]}
+// Keys are matched by their enclosing object, unknown keys are skipped.
+class RouteReader {
+public:
+    RouteReader() : file(nullptr), length(0), offset(0), depth(0), keyframeDepth(-1) {}
+    ~RouteReader() { if (file) fclose(file); }
+
+    bool Open(const char *path) {
+        file = fopen(path, "rb");
+        return file != nullptr;
+    }
+
+    // Read the next keyframe, returns false at the end of the route
+    bool Next(RouteKeyframe &keyframe) {
+        keyframe = {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, 0.0f};
+        char key[32] = "";
+        int c;
+        while ((c = Get()) >= 0) {
+            if (c == '"') {
+                char text[32];
+                ReadString(text, sizeof(text));
+                if (SkipSpace() == ':') {
+                    Get();
+                    strcpy(key, text);
+                }
+            } else if (c == '{' || c == '[') {
+                if (depth < MAX_DEPTH) {
+                    strcpy(containers[depth], key);
+                }
+                // Objects directly inside the "keyframes" array are keyframes
+                if (c == '{' && depth > 0 && strcmp(containers[depth - 1], "keyframes") == 0) {
+                    keyframeDepth = depth;
+                }
+                ++depth;
+                key[0] = '\0';
+            } else if (c == '}' || c == ']') {
+                --depth;
+                if (depth == keyframeDepth) {
+                    keyframeDepth = -1;
+                    return true;
+                }
+            } else if (c == '-' || (c >= '0' && c <= '9')) {
+                float value = ReadNumber(c);
+                Assign(depth > 0 ? containers[depth - 1] : "", key, value, keyframe);
+            }
+        }
+        return false;
+    }
+
+private:
+    static const int MAX_DEPTH = 8;
+    static const size_t BUFFER_SIZE = 64 * 1024;
+
+    int Get() {
+        if (offset == length) {
+            length = fread(buffer, 1, BUFFER_SIZE, file);
+            offset = 0;
+            if (length == 0) {
+                return -1;
+            }
+        }
+        return static_cast<unsigned char>(buffer[offset++]);
+    }
+
+    int Peek() {
+        int c = Get();
+        if (c >= 0) {
+            --offset;
+        }
+        return c;
+    }
+
+    int SkipSpace() {
+        int c = Peek();
+        while (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+            Get();
+            c = Peek();
+        }
+        return c;
+    }
+
+    void ReadString(char *text, size_t size) {
+        size_t used = 0;
+        int c;
+        while ((c = Get()) >= 0 && c != '"') {
+            if (c == '\\') {
+                c = Get();
+            }
+            if (used + 1 < size) {
+                text[used++] = static_cast<char>(c);
+            }
+        }
+        text[used] = '\0';
+    }
+
+    float ReadNumber(int first) {
+        char text[64];
+        size_t used = 0;
+        text[used++] = static_cast<char>(first);
+        int c = Peek();
+        while (c >= 0 && strchr("0123456789+-.eE", c) && used + 1 < sizeof(text)) {
+            text[used++] = static_cast<char>(Get());
+            c = Peek();
+        }
+        text[used] = '\0';
+        return strtof(text, nullptr);
+    }
+
+    static void Assign(const char *object, const char *key, float value, RouteKeyframe &keyframe) {
+        char axis = key[1] == '\0' ? key[0] : '\0';
+        if (strcmp(object, "position") == 0) {
+            float *target = axis == 'x' ? &keyframe.position.x : axis == 'y' ? &keyframe.position.y : axis == 'z' ? &keyframe.position.z : nullptr;
+            if (target) *target = value;
+        } else if (strcmp(object, "rotation") == 0) {
+            float *target = axis == 'x' ? &keyframe.rotation.x : axis == 'y' ? &keyframe.rotation.y :
+                            axis == 'z' ? &keyframe.rotation.z : axis == 'w' ? &keyframe.rotation.w : nullptr;
+            if (target) *target = value;
+        } else if (strcmp(key, "time") == 0) {
+            keyframe.time = value;
+        }
+    }
+
+    FILE *file;
+    char buffer[BUFFER_SIZE];
+    size_t length;
+    size_t offset;
+    char containers[MAX_DEPTH][32];
+    int depth;
+    int keyframeDepth;
+};
@@ -0,0 +1,448 @@
+// Headless validation of temporal reuse of peripheral shading along a recorded camera route.
+//
+// Usage: TemporalReuseBenchmark <route.json | session.vrstrace> [options]
+//   --fps <hz>             Frame rate of the replay (default 90)
+//   --count <n>            Frames to replay from the start of the route (default 450)
+//   --size <w>x<h>         Render target size (default 960x540)
+//   --tile <px>            Shading-rate tile size (default 16)
+//   --fov <deg>            Vertical field of view (default 60)
+//   --gaze <x>,<y>         Fixed gaze in normalized gaze space (default 0,0)
+//   --preset <1-5>         ShadingRatePreset (default 1, HIGHEST_PERFORMANCE)
+//   --pattern <1-3>        ShadingPatternPreset (default 2, BALANCED)
+//   --middle <0|1>         Also reuse middle region tiles (default 0)
+//   --tolerance <f>        Relative depth tolerance (default 0.02)
+//   --disocclusion <f>     Fraction of disoccluded pixels a reused tile may have (default 0.05)
+//   --budget <px>          Accumulated motion error budget in pixels (default 8)
+//   --refresh <n>          Staggered refresh interval in frames (default 4)
+//   --frames <file.csv>    Write per-frame tile decisions, shading cost and PSNR of the reused tiles
+//   --images <pattern>     Write composited frames as PPM, a printf path such as out/%04d.ppm
+// Build: g++ -O2 -std=c++17 -I../VrsBased/include TemporalReuseBenchmark.cpp ../VrsBased/Foveation.cpp
+//        ../VrsBased/ShadingCostModel.cpp ../VrsBased/ShadingRateImage.cpp ../VrsBased/TemporalFoveation.cpp
+//        ../VrsBased/TraceReader.cpp
+//
+// Every frame of the route is ray cast from a procedural scene (a textured
+// ground plane and a lattice of spheres under a sky gradient) into a color
+// and a linear depth buffer. The temporal stage classifies the tiles from
+// depth and camera motion, then the reused tiles of the ground truth are
+// replaced by the reprojected previous composite, so reuse errors
+// accumulate across frames like they would on the GPU. Reported are the
+// share of reused tiles, why eligible tiles were reshaded, the shading
+// cost with and without reuse and the PSNR of the reused pixels against
+// the ground truth.
+
+#include "Foveation.h"
+#include "QualityMetrics.h"
+#include "RouteReader.h"
+#include "ShadingCostModel.h"
+#include "ShadingRateImage.h"
+#include "TemporalFoveation.h"
+#include "TraceReader.h"
+#include "Utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Scene: spheres stand on the ground in a lattice of square cells, some cells are empty
+static const float CELL_SIZE = 10.0f;
+static const float SPHERE_RADIUS = 2.5f;
+static const float MAX_DISTANCE = 250.0f;
+static const int MAX_CELL_STEPS = 64;
+
+static Quaternion Nlerp(const Quaternion &a, Quaternion b, float t) {
+    // Same as Quaternion.Lerp in Unity, shortest arc then normalize
+    if (a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w < 0.0f) {
+        b = {-b.x, -b.y, -b.z, -b.w};
+    }
+    Quaternion q = {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t};
+    float length = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    return {q.x / length, q.y / length, q.z / length, q.w / length};
+}
+
+static Vector3 Rotate(const Quaternion &q, const Vector3 &v) {
+    // v + 2w(u x v) + 2u x (u x v)
+    Vector3 t = {2.0f * (q.y * v.z - q.z * v.y), 2.0f * (q.z * v.x - q.x * v.z), 2.0f * (q.x * v.y - q.y * v.x)};
+    return {v.x + q.w * t.x + (q.y * t.z - q.z * t.y),
+            v.y + q.w * t.y + (q.z * t.x - q.x * t.z),
+            v.z + q.w * t.z + (q.x * t.y - q.y * t.x)};
+}
+
+// Camera at a route time, keyframes interpolated like CameraRoutePlayer.cs
+static void SampleRoute(const std::vector<RouteKeyframe> &route, float time, size_t &cursor, Vector3 &position, Quaternion &rotation) {
+    while (cursor + 2 < route.size() && route[cursor + 1].time <= time) {
+        ++cursor;
+    }
+    const RouteKeyframe &current = route[cursor];
+    const RouteKeyframe &next = route[(std::min)(cursor + 1, route.size() - 1)];
+    float span = next.time - current.time;
+    float t = span > 0.0f ? (std::min)((std::max)((time - current.time) / span, 0.0f), 1.0f) : 0.0f;
+    position = {current.position.x + (next.position.x - current.position.x) * t,
+                current.position.y + (next.position.y - current.position.y) * t,
+                current.position.z + (next.position.z - current.position.z) * t};
+    rotation = Nlerp(current.rotation, next.rotation, t);
+}
+
+static bool LoadRoute(const char *path, std::vector<RouteKeyframe> &route) {
+    size_t pathLength = strlen(path);
+    if (pathLength > 9 && strcmp(path + pathLength - 9, ".vrstrace") == 0) {
+        TraceReader reader;
+        if (!reader.Open(path)) {
+            return false;
+        }
+        TraceRecord record;
+        while (reader.Next(record)) {
+            if (record.type == TraceRecordType::CAMERA_POSE) {
+                route.push_back({record.position, record.rotation, record.time * 1e-6f});
+            }
+        }
+        return true;
+    }
+
+    RouteReader *reader = new RouteReader();
+    bool opened = reader->Open(path);
+    RouteKeyframe keyframe;
+    while (opened && reader->Next(keyframe)) {
+        route.push_back(keyframe);
+    }
+    delete reader;
+    return opened;
+}
+
+static uint32_t HashCell(int x, int z) {
+    uint32_t hash = static_cast<uint32_t>(x) * 0x9E3779B1u ^ static_cast<uint32_t>(z) * 0x85EBCA77u;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE3Du;
+    return hash ^ (hash >> 16);
+}
+
+static uint32_t PackColor(float r, float g, float b) {
+    uint32_t red = static_cast<uint32_t>(Clamp(r, 0.0f, 1.0f) * 255.0f + 0.5f);
+    uint32_t green = static_cast<uint32_t>(Clamp(g, 0.0f, 1.0f) * 255.0f + 0.5f);
+    uint32_t blue = static_cast<uint32_t>(Clamp(b, 0.0f, 1.0f) * 255.0f + 0.5f);
+    return red | green << 8 | blue << 16 | 0xFF000000u;
+}
+
+// Nearest sphere hit along a ray in front of the ground hit, stepping through the lattice cells the ray crosses
+static bool IntersectSpheres(const Vector3 &origin, const Vector3 &dir, float limit, float &hitT, int &cellX, int &cellZ) {
+    int x = static_cast<int>(floorf(origin.x / CELL_SIZE));
+    int z = static_cast<int>(floorf(origin.z / CELL_SIZE));
+    int stepX = dir.x > 0.0f ? 1 : -1;
+    int stepZ = dir.z > 0.0f ? 1 : -1;
+    float deltaX = dir.x != 0.0f ? fabsf(CELL_SIZE / dir.x) : 1e30f;
+    float deltaZ = dir.z != 0.0f ? fabsf(CELL_SIZE / dir.z) : 1e30f;
+    float nextX = dir.x != 0.0f ? ((x + (stepX > 0)) * CELL_SIZE - origin.x) / dir.x : 1e30f;
+    float nextZ = dir.z != 0.0f ? ((z + (stepZ > 0)) * CELL_SIZE - origin.z) / dir.z : 1e30f;
+
+    float enter = 0.0f;
+    for (int step = 0; step < MAX_CELL_STEPS && enter < limit; ++step) {
+        // Spheres lie inside their cell, so the first hit in cell order is the nearest
+        if (HashCell(x, z) % 5 < 3) {
+            Vector3 center = {(x + 0.5f) * CELL_SIZE, SPHERE_RADIUS, (z + 0.5f) * CELL_SIZE};
+            Vector3 offset = {origin.x - center.x, origin.y - center.y, origin.z - center.z};
+            float a = dir.x * dir.x + dir.y * dir.y + dir.z * dir.z;
+            float b = offset.x * dir.x + offset.y * dir.y + offset.z * dir.z;
+            float c = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z - SPHERE_RADIUS * SPHERE_RADIUS;
+            float discriminant = b * b - a * c;
+            if (discriminant >= 0.0f) {
+                float t = (-b - sqrtf(discriminant)) / a;
+                if (t > 0.0f && t < limit) {
+                    hitT = t;
+                    cellX = x;
+                    cellZ = z;
+                    return true;
+                }
+            }
+        }
+        if (nextX < nextZ) {
+            enter = nextX;
+            nextX += deltaX;
+            x += stepX;
+        } else {
+            enter = nextZ;
+            nextZ += deltaZ;
+            z += stepZ;
+        }
+    }
+    return false;
+}
+
+// Ray cast the scene, depth is the linear view depth and zero for sky
+static void RenderScene(const Vector3 &position, const Quaternion &rotation, const ViewFrustum &frustum, int width, int height,
+                        std::vector<uint32_t> &color, std::vector<float> &depth) {
+    const Vector3 sun = {0.48f, 0.80f, 0.36f};
+    for (int y = 0; y < height; ++y) {
+        float dirY = frustum.tanUp - (y + 0.5f) * (frustum.tanUp - frustum.tanDown) / height;
+        for (int x = 0; x < width; ++x) {
+            // Unit z in view space, so the ray parameter is the view depth
+            float dirX = frustum.tanLeft + (x + 0.5f) * (frustum.tanRight - frustum.tanLeft) / width;
+            Vector3 dir = Rotate(rotation, {dirX, dirY, 1.0f});
+            size_t pixel = static_cast<size_t>(y) * width + x;
+
+            float groundT = dir.y < 0.0f && position.y > 0.0f ? -position.y / dir.y : MAX_DISTANCE;
+            float limit = (std::min)(groundT, MAX_DISTANCE);
+            float t;
+            int cellX, cellZ;
+            if (IntersectSpheres(position, dir, limit, t, cellX, cellZ)) {
+                Vector3 hit = {position.x + dir.x * t, position.y + dir.y * t, position.z + dir.z * t};
+                Vector3 normal = {(hit.x - (cellX + 0.5f) * CELL_SIZE) / SPHERE_RADIUS, (hit.y - SPHERE_RADIUS) / SPHERE_RADIUS,
+                                  (hit.z - (cellZ + 0.5f) * CELL_SIZE) / SPHERE_RADIUS};
+                uint32_t hash = HashCell(cellX, cellZ);
+                float light = 0.25f + 0.75f * (std::max)(normal.x * sun.x + normal.y * sun.y + normal.z * sun.z, 0.0f);
+                float stripe = (static_cast<int>(floorf(hit.y * 4.0f)) & 1) ? 1.0f : 0.7f;
+                float shade = light * stripe;
+                color[pixel] = PackColor(shade * (0.3f + (hash & 0xFF) / 400.0f), shade * (0.3f + (hash >> 8 & 0xFF) / 400.0f),
+                                         shade * (0.3f + (hash >> 16 & 0xFF) / 400.0f));
+                depth[pixel] = t;
+            } else if (groundT < MAX_DISTANCE) {
+                float hitX = position.x + dir.x * groundT;
+                float hitZ = position.z + dir.z * groundT;
+                bool checker = ((static_cast<int>(floorf(hitX)) + static_cast<int>(floorf(hitZ))) & 1) != 0;
+                float grain = (HashCell(static_cast<int>(floorf(hitX * 8.0f)), static_cast<int>(floorf(hitZ * 8.0f))) & 0xFF) / 2550.0f;
+                float shade = (checker ? 0.55f : 0.40f) + grain;
+                color[pixel] = PackColor(shade * 0.8f, shade, shade * 0.6f);
+                depth[pixel] = groundT;
+            } else {
+                float up = Clamp(dir.y / sqrtf(dir.x * dir.x + dir.y * dir.y + dir.z * dir.z), 0.0f, 1.0f);
+                color[pixel] = PackColor(0.75f - 0.45f * up, 0.85f - 0.35f * up, 1.0f);
+                depth[pixel] = 0.0f;
+            }
+        }
+    }
+}
+
+static bool WriteFrame(const char *pattern, int frame, const std::vector<uint32_t> &color, int width, int height) {
+    char path[1024];
+    snprintf(path, sizeof(path), pattern, frame);
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    std::vector<uint8_t> row(static_cast<size_t>(width) * 3);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            uint32_t pixel = color[static_cast<size_t>(y) * width + x];
+            row[x * 3] = static_cast<uint8_t>(pixel);
+            row[x * 3 + 1] = static_cast<uint8_t>(pixel >> 8);
+            row[x * 3 + 2] = static_cast<uint8_t>(pixel >> 16);
+        }
+        fwrite(row.data(), 1, row.size(), file);
+    }
+    return fclose(file) == 0;
+}
+
+static double ElapsedMilliseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <route.json | session.vrstrace> [--fps hz] [--count n] [--size WxH] [--tile px] [--fov deg]\n"
+                        "       [--gaze x,y] [--preset 1-5] [--pattern 1-3] [--middle 0|1] [--tolerance f] [--disocclusion f]\n"
+                        "       [--budget px] [--refresh n] [--frames out.csv] [--images out/%%04d.ppm]\n", argv[0]);
+        return 1;
+    }
+
+    const char *framesPath = nullptr;
+    const char *imagesPattern = nullptr;
+    float fps = 90.0f;
+    int count = 450;
+    int width = 960;
+    int height = 540;
+    int tileSize = 16;
+    float verticalFov = 60.0f;
+    Vector2 gaze = {0.0f, 0.0f};
+    int preset = 1;
+    int pattern = 2;
+    TemporalFoveationSettings settings = TemporalFoveation::GetDefaultSettings();
+    settings.enabled = true;
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        const char *option = argv[i];
+        const char *value = argv[i + 1];
+        if (strcmp(option, "--fps") == 0) fps = static_cast<float>(atof(value));
+        else if (strcmp(option, "--count") == 0) count = atoi(value);
+        else if (strcmp(option, "--size") == 0) sscanf(value, "%dx%d", &width, &height);
+        else if (strcmp(option, "--tile") == 0) tileSize = atoi(value);
+        else if (strcmp(option, "--fov") == 0) verticalFov = static_cast<float>(atof(value));
+        else if (strcmp(option, "--gaze") == 0) sscanf(value, "%f,%f", &gaze.x, &gaze.y);
+        else if (strcmp(option, "--preset") == 0) preset = atoi(value);
+        else if (strcmp(option, "--pattern") == 0) pattern = atoi(value);
+        else if (strcmp(option, "--middle") == 0) settings.reuseMiddle = atoi(value) != 0;
+        else if (strcmp(option, "--tolerance") == 0) settings.depthTolerance = static_cast<float>(atof(value));
+        else if (strcmp(option, "--disocclusion") == 0) settings.disocclusionBudget = static_cast<float>(atof(value));
+        else if (strcmp(option, "--budget") == 0) settings.errorBudget = static_cast<float>(atof(value));
+        else if (strcmp(option, "--refresh") == 0) settings.refreshInterval = atoi(value);
+        else if (strcmp(option, "--frames") == 0) framesPath = value;
+        else if (strcmp(option, "--images") == 0) imagesPattern = value;
+        else {
+            fprintf(stderr, "Unknown option %s\n", option);
+            return 1;
+        }
+    }
+
+    std::vector<RouteKeyframe> route;
+    if (!LoadRoute(argv[1], route)) {
+        fprintf(stderr, "Cannot open route %s\n", argv[1]);
+        return 1;
+    }
+    if (route.size() < 2 || fps <= 0.0f || count <= 0) {
+        fprintf(stderr, "Route %s has fewer than two keyframes\n", argv[1]);
+        return 1;
+    }
+
+    ShadingRateImage regions;
+    if (width <= 0 || height <= 0 || !regions.Initialize(width, height, tileSize)) {
+        fprintf(stderr, "Invalid size %dx%d or tile %d\n", width, height, tileSize);
+        return 1;
+    }
+
+    FoveationDesc desc = {};
+    ResolveShadingRatePreset(static_cast<ShadingRatePreset>(Clamp(preset, 1, 5)), desc);
+    ResolveFoveationPatternPreset(static_cast<ShadingPatternPreset>(Clamp(pattern, 1, 3)), desc);
+    const float regionCost[3] = {GetShadingRateCost(desc.innerRate), GetShadingRateCost(desc.middleRate),
+                                 GetShadingRateCost(desc.peripheralRate)};
+
+    TemporalFoveation temporal;
+    temporal.Configure(settings);
+    settings = temporal.GetSettings();
+
+    float tanHalfVertical = tanf(verticalFov * 0.5f * 3.14159265f / 180.0f);
+    float tanHalfHorizontal = tanHalfVertical * width / height;
+    VrsCameraPose pose = {};
+    pose.frustum = {-tanHalfHorizontal, tanHalfHorizontal, tanHalfVertical, -tanHalfVertical};
+
+    FILE *framesFile = nullptr;
+    if (framesPath) {
+        framesFile = fopen(framesPath, "w");
+        if (!framesFile) {
+            fprintf(stderr, "Cannot write %s\n", framesPath);
+            return 1;
+        }
+        fprintf(framesFile, "frame,reused,disoccluded,over_budget,refreshed,eligible,cost,cost_with_reuse,reused_psnr,process_ms\n");
+    }
+
+    std::vector<uint32_t> truth(static_cast<size_t>(width) * height);
+    std::vector<uint32_t> composite(truth.size());
+    std::vector<uint32_t> previousComposite(truth.size());
+    std::vector<float> depth(truth.size());
+
+    const int tilesX = regions.GetWidth();
+    const int tilesY = regions.GetHeight();
+    const float duration = route.back().time - route.front().time;
+    size_t cursor = 0;
+    int frames = 0;
+    uint64_t reusedTiles = 0, eligibleTiles = 0, disoccludedTiles = 0, overBudgetTiles = 0, refreshedTiles = 0;
+    double costSum = 0.0, reuseCostSum = 0.0;
+    double reusedSquaredError = 0.0;
+    uint64_t reusedSamples = 0;
+    double worstPsnr = QUALITY_MAX_PSNR;
+    double processMs = 0.0, worstProcessMs = 0.0, renderMs = 0.0;
+
+    for (; frames < count; ++frames) {
+        float time = route.front().time + frames / fps;
+        if (time > route.front().time + duration) {
+            break;
+        }
+
+        auto renderStart = std::chrono::steady_clock::now();
+        SampleRoute(route, time, cursor, pose.position, pose.rotation);
+        RenderScene(pose.position, pose.rotation, pose.frustum, width, height, truth, depth);
+        renderMs += ElapsedMilliseconds(renderStart);
+
+        regions.Update(gaze, desc);
+        VrsDepthFrame depthFrame = {depth.data(), width, height, static_cast<int>(width * sizeof(float))};
+        temporal.Process(depthFrame, pose, regions);
+        TemporalFoveationStats stats = temporal.GetStats();
+        processMs += stats.lastProcessMs;
+        worstProcessMs = (std::max)(worstProcessMs, static_cast<double>(stats.lastProcessMs));
+
+        // Reused tiles show the reprojected previous composite instead of the freshly shaded truth
+        composite = truth;
+        temporal.ResolveReusedTiles(reinterpret_cast<const uint8_t *>(previousComposite.data()), width * 4,
+                                    reinterpret_cast<uint8_t *>(composite.data()), width * 4);
+
+        const uint8_t *mask = temporal.GetTileMask();
+        double frameSquaredError = 0.0;
+        uint64_t frameSamples = 0;
+        double cost = 0.0, reuseCost = 0.0;
+        for (int row = 0; row < tilesY; ++row) {
+            int endY = (std::min)(height, (row + 1) * tileSize);
+            for (int column = 0; column < tilesX; ++column) {
+                int endX = (std::min)(width, (column + 1) * tileSize);
+                double pixels = static_cast<double>(endX - column * tileSize) * (endY - row * tileSize);
+                double tileCost = pixels * regionCost[static_cast<int>(regions.GetRegion(column, row))];
+                cost += tileCost;
+                if (mask[row * tilesX + column] != TemporalFoveation::TEMPORAL_TILE_REUSE) {
+                    reuseCost += tileCost;
+                    continue;
+                }
+                for (int y = row * tileSize; y < endY; ++y) {
+                    for (int x = column * tileSize; x < endX; ++x) {
+                        size_t pixel = static_cast<size_t>(y) * width + x;
+                        for (int channel = 0; channel < 24; channel += 8) {
+                            int difference = static_cast<int>(composite[pixel] >> channel & 0xFF) - static_cast<int>(truth[pixel] >> channel & 0xFF);
+                            frameSquaredError += difference * difference;
+                        }
+                    }
+                }
+                frameSamples += static_cast<uint64_t>(pixels) * 3;
+            }
+        }
+        cost /= static_cast<double>(width) * height;
+        reuseCost /= static_cast<double>(width) * height;
+        costSum += cost;
+        reuseCostSum += reuseCost;
+        reusedSquaredError += frameSquaredError;
+        reusedSamples += frameSamples;
+        double framePsnr = frameSamples > 0 ? PsnrFromMse(frameSquaredError / frameSamples) : QUALITY_MAX_PSNR;
+        worstPsnr = (std::min)(worstPsnr, framePsnr);
+
+        int eligible = stats.tilesReused + stats.tilesDisoccluded + stats.tilesOverBudget + stats.tilesRefreshed;
+        reusedTiles += stats.tilesReused;
+        eligibleTiles += eligible;
+        disoccludedTiles += stats.tilesDisoccluded;
+        overBudgetTiles += stats.tilesOverBudget;
+        refreshedTiles += stats.tilesRefreshed;
+
+        if (framesFile) {
+            fprintf(framesFile, "%d,%d,%d,%d,%d,%d,%.5f,%.5f,%.3f,%.4f\n", frames, stats.tilesReused, stats.tilesDisoccluded,
+                    stats.tilesOverBudget, stats.tilesRefreshed, eligible, cost, reuseCost, framePsnr, stats.lastProcessMs);
+        }
+        if (imagesPattern && !WriteFrame(imagesPattern, frames, composite, width, height)) {
+            fprintf(stderr, "Cannot write frame %d to %s\n", frames, imagesPattern);
+            imagesPattern = nullptr;
+        }
+        composite.swap(previousComposite);
+    }
+    if (framesFile) {
+        fclose(framesFile);
+    }
+    if (frames == 0) {
+        fprintf(stderr, "No frames replayed\n");
+        return 1;
+    }
+
+    double tiles = static_cast<double>(tilesX) * tilesY * frames;
+    printf("Route: %s, %d frames at %.0f Hz, %dx%d, %dx%d tiles of %d px\n", argv[1], frames, fps, width, height, tilesX, tilesY, tileSize);
+    printf("Settings: %s reuse, depth tolerance %.3f, disocclusion budget %.3f, error budget %.1f px, refresh every %d frames\n",
+           settings.reuseMiddle ? "middle and peripheral" : "peripheral", settings.depthTolerance, settings.disocclusionBudget,
+           settings.errorBudget, settings.refreshInterval);
+    printf("Tiles reused:        %6.2f%% of all, %6.2f%% of eligible\n", 100.0 * reusedTiles / tiles,
+           eligibleTiles > 0 ? 100.0 * reusedTiles / eligibleTiles : 0.0);
+    printf("Eligible reshaded:   %6.2f%% disoccluded, %6.2f%% over budget, %6.2f%% refreshed\n",
+           eligibleTiles > 0 ? 100.0 * disoccludedTiles / eligibleTiles : 0.0,
+           eligibleTiles > 0 ? 100.0 * overBudgetTiles / eligibleTiles : 0.0,
+           eligibleTiles > 0 ? 100.0 * refreshedTiles / eligibleTiles : 0.0);
+    printf("Shading cost:        %.4f foveated, %.4f with reuse (%.2f%% saved)\n", costSum / frames, reuseCostSum / frames,
+           costSum > 0.0 ? 100.0 * (1.0 - reuseCostSum / costSum) : 0.0);
+    printf("Reused pixel PSNR:   %.2f dB mean, %.2f dB worst frame\n",
+           reusedSamples > 0 ? PsnrFromMse(reusedSquaredError / reusedSamples) : QUALITY_MAX_PSNR, worstPsnr);
+    printf("Classification:      %.3f ms mean, %.3f ms worst (ray casting %.1f ms per frame)\n", processMs / frames, worstProcessMs,
+           renderMs / frames);
+    return 0;
+}
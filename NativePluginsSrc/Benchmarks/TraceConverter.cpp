@@ -0,0 +1,120 @@
+// Converts recorded camera routes to the binary session trace and inspects traces.
+//
+// Usage: TraceConverter <route.json> <out.vrstrace>
+//        TraceConverter --info <session.vrstrace>
+// Build: g++ -O2 -std=c++17 -I../VrsBased/include TraceConverter.cpp ../VrsBased/TraceWriter.cpp
+//        ../VrsBased/TraceReader.cpp
+//
+// A converted route holds camera poses only, timed relative to its first
+// keyframe; CameraRouteBenchmark synthesizes gaze for it as for the JSON route.
+
+#include "RouteReader.h"
+#include "TraceReader.h"
+#include "TraceWriter.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+static long FileSize(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+static int Convert(const char *routePath, const char *tracePath) {
+    RouteReader *reader = new RouteReader();
+    if (!reader->Open(routePath)) {
+        fprintf(stderr, "Cannot open route %s\n", routePath);
+        delete reader;
+        return 1;
+    }
+
+    TraceWriter writer;
+    if (!writer.Open(tracePath, 0)) {
+        fprintf(stderr, "Cannot create trace %s\n", tracePath);
+        delete reader;
+        return 1;
+    }
+
+    RouteKeyframe keyframe;
+    bool first = true;
+    float firstTime = 0.0f;
+    while (reader->Next(keyframe)) {
+        if (first) {
+            firstTime = keyframe.time;
+            first = false;
+        }
+        double seconds = (std::max)(0.0, static_cast<double>(keyframe.time) - firstTime);
+        writer.RecordCameraPose(static_cast<uint64_t>(seconds * 1e6 + 0.5), keyframe.position, keyframe.rotation);
+    }
+    delete reader;
+
+    TraceWriterStats stats = writer.GetStats();
+    writer.Close();
+
+    long routeBytes = FileSize(routePath);
+    long traceBytes = FileSize(tracePath);
+    printf("%llu keyframes: %ld bytes -> %ld bytes (%.1fx)\n",
+           static_cast<unsigned long long>(stats.records), routeBytes, traceBytes,
+           traceBytes > 0 ? static_cast<double>(routeBytes) / traceBytes : 0.0);
+    return 0;
+}
+
+static int Info(const char *tracePath) {
+    TraceReader reader;
+    if (!reader.Open(tracePath)) {
+        fprintf(stderr, "Cannot open trace %s\n", tracePath);
+        return 1;
+    }
+
+    uint64_t counts[5] = {};
+    int64_t firstTime = 0;
+    int64_t lastTime = 0;
+    uint64_t records = 0;
+    TraceRecord record;
+    while (reader.Next(record)) {
+        if (records++ == 0) {
+            firstTime = record.time;
+        }
+        lastTime = record.time;
+        int type = static_cast<int>(record.type);
+        if (type > 0 && type < 5) {
+            ++counts[type];
+        }
+    }
+
+    printf("%s: %ld bytes, %zu chunks, %s\n", tracePath, FileSize(tracePath), reader.GetChunkCount(),
+           reader.HasIndex() ? "indexed" : "index rebuilt (no footer)");
+    printf("start time %llu us, span %.3f s\n", static_cast<unsigned long long>(reader.GetStartTime()),
+           (lastTime - firstTime) * 1e-6);
+    printf("%llu records: %llu camera poses, %llu gaze samples, %llu frames, %llu configurations\n",
+           static_cast<unsigned long long>(records),
+           static_cast<unsigned long long>(counts[static_cast<int>(TraceRecordType::CAMERA_POSE)]),
+           static_cast<unsigned long long>(counts[static_cast<int>(TraceRecordType::GAZE)]),
+           static_cast<unsigned long long>(counts[static_cast<int>(TraceRecordType::FRAME)]),
+           static_cast<unsigned long long>(counts[static_cast<int>(TraceRecordType::CONFIGURATION)]));
+    if (records != reader.GetRecordCount()) {
+        printf("warning: %llu records indexed, the trace ends in a corrupt chunk\n",
+               static_cast<unsigned long long>(reader.GetRecordCount()));
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 3 && strcmp(argv[1], "--info") == 0) {
+        return Info(argv[2]);
+    }
+    if (argc == 3) {
+        return Convert(argv[1], argv[2]);
+    }
+
+    fprintf(stderr, "Usage: %s <route.json> <out.vrstrace>\n"
+                    "       %s --info <session.vrstrace>\n", argv[0], argv[0]);
+    return 1;
+}
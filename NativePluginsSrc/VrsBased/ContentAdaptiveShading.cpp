@@ -0,0 +1,248 @@
+#include "ContentAdaptiveShading.h"
+#include "Clock.h"
+#include "Utils.h"
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define CONTENT_ADAPTIVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Rec. 709 luma weights in 1/256
+static const int LUMA_RED = 54;
+static const int LUMA_GREEN = 183;
+static const int LUMA_BLUE = 19;
+
+// Error of a quarter rate relative to a half rate along the same axis
+static const float QUARTER_RATE_ERROR = 2.13f;
+
+// Bytes of padding after a luma row, covers the neighbour read of the last SIMD block
+static const int LUMA_PADDING = 16;
+
+// Constructor
+ContentAdaptiveShading::ContentAdaptiveShading()
+    : published{}, publishedVersion(0), settings(GetDefaultSettings()), settingsVersion(1), scratch{},
+    latched{}, latchedVersion(0), latchedSettingsVersion(0), latchedSettings(GetDefaultSettings()),
+    framesAnalyzed(0), lastAnalysisMs(0.0f) {
+}
+
+// Destructor
+ContentAdaptiveShading::~ContentAdaptiveShading() {
+}
+
+ContentShadingSettings ContentAdaptiveShading::GetDefaultSettings() {
+    ContentShadingSettings defaults = {};
+    defaults.enabled = false;
+    defaults.threshold = 3.0f;
+    defaults.middleScale = 2.0f;
+    defaults.peripheralScale = 4.0f;
+    return defaults;
+}
+
+void ContentAdaptiveShading::Configure(const ContentShadingSettings &contentSettings) {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    settings = contentSettings;
+    settings.threshold = (std::max)(settings.threshold, 0.0f);
+    settings.middleScale = (std::max)(settings.middleScale, 0.0f);
+    settings.peripheralScale = (std::max)(settings.peripheralScale, 0.0f);
+    ++settingsVersion;
+}
+
+ContentShadingSettings ContentAdaptiveShading::GetSettings() const {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    return settings;
+}
+
+void ContentAdaptiveShading::ComputeLumaRow(const uint8_t *pixels, int width, ContentPixelFormat format, uint8_t *luma) {
+    const int red = format == ContentPixelFormat::BGRA8 ? 2 : 0;
+    const int blue = 2 - red;
+
+    int x = 0;
+#ifdef CONTENT_ADAPTIVE_SSE2
+    const __m128i weights = format == ContentPixelFormat::BGRA8
+        ? _mm_setr_epi16(LUMA_BLUE, LUMA_GREEN, LUMA_RED, 0, LUMA_BLUE, LUMA_GREEN, LUMA_RED, 0)
+        : _mm_setr_epi16(LUMA_RED, LUMA_GREEN, LUMA_BLUE, 0, LUMA_RED, LUMA_GREEN, LUMA_BLUE, 0);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; x + 16 <= width; x += 16) {
+        __m128i groups[4];
+        for (int group = 0; group < 4; ++group) {
+            // Two pixels per half, madd leaves red+green and blue+alpha of each pixel to be added
+            __m128i quad = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + (x + group * 4) * 4));
+            __m128i low = _mm_madd_epi16(_mm_unpacklo_epi8(quad, zero), weights);
+            __m128i high = _mm_madd_epi16(_mm_unpackhi_epi8(quad, zero), weights);
+            __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high), _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high), _MM_SHUFFLE(3, 1, 3, 1));
+            groups[group] = _mm_srli_epi32(_mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd)), 8);
+        }
+        __m128i packed = _mm_packus_epi16(_mm_packs_epi32(groups[0], groups[1]), _mm_packs_epi32(groups[2], groups[3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(luma + x), packed);
+    }
+#endif
+
+    for (; x < width; ++x) {
+        const uint8_t *pixel = pixels + x * 4;
+        luma[x] = static_cast<uint8_t>((pixel[red] * LUMA_RED + pixel[1] * LUMA_GREEN + pixel[blue] * LUMA_BLUE) >> 8);
+    }
+
+    // Repeat the last pixel, the right neighbour of the last column is itself
+    memset(luma + width, luma[width - 1], LUMA_PADDING);
+}
+
+void ContentAdaptiveShading::AccumulateRow(const uint8_t *luma, const uint8_t *nextLuma, int width, uint32_t *sumX, uint32_t *sumY) {
+    // Sums keep four lanes per block so the SIMD path never reduces horizontally per row
+    int block = 0;
+#ifdef CONTENT_ADAPTIVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; (block + 1) * BLOCK_SIZE <= width; ++block) {
+        const uint8_t *pixels = luma + block * BLOCK_SIZE;
+        __m128i center = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pixels)), zero);
+        __m128i right = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pixels + 1)), zero);
+        __m128i below = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(nextLuma + block * BLOCK_SIZE)), zero);
+        __m128i dx = _mm_sub_epi16(right, center);
+        __m128i dy = _mm_sub_epi16(below, center);
+
+        __m128i *laneX = reinterpret_cast<__m128i *>(sumX + block * 4);
+        __m128i *laneY = reinterpret_cast<__m128i *>(sumY + block * 4);
+        _mm_storeu_si128(laneX, _mm_add_epi32(_mm_loadu_si128(laneX), _mm_madd_epi16(dx, dx)));
+        _mm_storeu_si128(laneY, _mm_add_epi32(_mm_loadu_si128(laneY), _mm_madd_epi16(dy, dy)));
+    }
+#endif
+
+    for (int x = block * BLOCK_SIZE; x < width; ++x) {
+        int dx = luma[x + 1] - luma[x];
+        int dy = nextLuma[x] - luma[x];
+        sumX[(x / BLOCK_SIZE) * 4] += static_cast<uint32_t>(dx * dx);
+        sumY[(x / BLOCK_SIZE) * 4] += static_cast<uint32_t>(dy * dy);
+    }
+}
+
+bool ContentAdaptiveShading::Analyze(const VrsContentFrame &frame) {
+    if (!frame.pixels || frame.width <= 0 || frame.height <= 0 || frame.rowPitch < frame.width * 4) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> analyzeLock(analyzeMutex);
+    uint64_t start = GetTimestampNanoseconds();
+
+    BlockGrid &grid = scratch;
+    grid.width = frame.width;
+    grid.height = frame.height;
+    grid.blocksX = (frame.width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    grid.blocksY = (frame.height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    grid.errorX.resize(static_cast<size_t>(grid.blocksX) * grid.blocksY);
+    grid.errorY.resize(grid.errorX.size());
+    for (std::vector<uint8_t> &row : lumaRows) {
+        row.resize(static_cast<size_t>(frame.width) + LUMA_PADDING);
+    }
+    sumX.resize(static_cast<size_t>(grid.blocksX) * 4);
+    sumY.resize(sumX.size());
+
+    // Rows are walked top down whatever their order in memory, tile rows count from the top
+    auto pixelRow = [&frame](int y) {
+        size_t row = static_cast<size_t>(frame.bottomUp ? frame.height - 1 - y : y);
+        return frame.pixels + row * frame.rowPitch;
+    };
+
+    ComputeLumaRow(pixelRow(0), frame.width, frame.format, lumaRows[0].data());
+    for (int blockY = 0; blockY < grid.blocksY; ++blockY) {
+        std::fill(sumX.begin(), sumX.end(), 0u);
+        std::fill(sumY.begin(), sumY.end(), 0u);
+
+        int firstRow = blockY * BLOCK_SIZE;
+        int lastRow = (std::min)(firstRow + BLOCK_SIZE, frame.height);
+        for (int y = firstRow; y < lastRow; ++y) {
+            // The bottom row is its own lower neighbour
+            const uint8_t *luma = lumaRows[y & 1].data();
+            const uint8_t *nextLuma = luma;
+            if (y + 1 < frame.height) {
+                ComputeLumaRow(pixelRow(y + 1), frame.width, frame.format, lumaRows[(y + 1) & 1].data());
+                nextLuma = lumaRows[(y + 1) & 1].data();
+            }
+            AccumulateRow(luma, nextLuma, frame.width, sumX.data(), sumY.data());
+        }
+
+        uint16_t *errorX = grid.errorX.data() + static_cast<size_t>(blockY) * grid.blocksX;
+        uint16_t *errorY = grid.errorY.data() + static_cast<size_t>(blockY) * grid.blocksX;
+        for (int blockX = 0; blockX < grid.blocksX; ++blockX) {
+            const uint32_t *laneX = &sumX[blockX * 4];
+            const uint32_t *laneY = &sumY[blockX * 4];
+            int pixels = ((std::min)((blockX + 1) * BLOCK_SIZE, frame.width) - blockX * BLOCK_SIZE) * (lastRow - firstRow);
+            float scale = 65536.0f / pixels;
+            errorX[blockX] = static_cast<uint16_t>((std::min)(sqrtf((laneX[0] + laneX[1] + laneX[2] + laneX[3]) * scale), 65535.0f));
+            errorY[blockX] = static_cast<uint16_t>((std::min)(sqrtf((laneY[0] + laneY[1] + laneY[2] + laneY[3]) * scale), 65535.0f));
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(publishMutex);
+        std::swap(scratch, published);
+        ++publishedVersion;
+    }
+
+    framesAnalyzed.fetch_add(1, std::memory_order_relaxed);
+    lastAnalysisMs.store(static_cast<float>(GetTimestampNanoseconds() - start) * 1e-6f, std::memory_order_relaxed);
+    return true;
+}
+
+bool ContentAdaptiveShading::Latch() {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    bool gridChanged = false;
+    if (publishedVersion != latchedVersion) {
+        // The analyzing thread only touches published under the lock, swapping hands it the old grid to reuse
+        std::swap(published, latched);
+        latchedVersion = publishedVersion;
+        gridChanged = true;
+    }
+
+    // Switching off changes the image as much as switching on
+    bool settingsChanged = false;
+    if (settingsVersion != latchedSettingsVersion) {
+        settingsChanged = settings.enabled || latchedSettings.enabled;
+        latchedSettings = settings;
+        latchedSettingsVersion = settingsVersion;
+    }
+    return settingsChanged || (gridChanged && latchedSettings.enabled);
+}
+
+bool ContentAdaptiveShading::IsActive(int width, int height) const {
+    return latchedSettings.enabled && latched.width == width && latched.height == height && !latched.errorX.empty();
+}
+
+uint8_t ContentAdaptiveShading::GetCoarsestRate(int beginX, int beginY, int endX, int endY, TargetArea area) const {
+    int blockBeginX = Clamp(beginX / BLOCK_SIZE, 0, latched.blocksX);
+    int blockBeginY = Clamp(beginY / BLOCK_SIZE, 0, latched.blocksY);
+    int blockEndX = Clamp((endX + BLOCK_SIZE - 1) / BLOCK_SIZE, 0, latched.blocksX);
+    int blockEndY = Clamp((endY + BLOCK_SIZE - 1) / BLOCK_SIZE, 0, latched.blocksY);
+
+    // The busiest block decides, a tile is only as coarse as all of its blocks allow
+    uint32_t errorX = 0;
+    uint32_t errorY = 0;
+    for (int y = blockBeginY; y < blockEndY; ++y) {
+        const uint16_t *rowX = latched.errorX.data() + static_cast<size_t>(y) * latched.blocksX;
+        const uint16_t *rowY = latched.errorY.data() + static_cast<size_t>(y) * latched.blocksX;
+        for (int x = blockBeginX; x < blockEndX; ++x) {
+            errorX = (std::max)(errorX, static_cast<uint32_t>(rowX[x]));
+            errorY = (std::max)(errorY, static_cast<uint32_t>(rowY[x]));
+        }
+    }
+
+    // Detail is harder to see away from the gaze, so the outer regions tolerate more error
+    float scale = area == TargetArea::INNER ? 1.0f : (area == TargetArea::MIDDLE ? latchedSettings.middleScale : latchedSettings.peripheralScale);
+    float threshold = latchedSettings.threshold * scale * 256.0f;
+    int log2X = QUARTER_RATE_ERROR * errorX < threshold ? 2 : (errorX < threshold ? 1 : 0);
+    int log2Y = QUARTER_RATE_ERROR * errorY < threshold ? 2 : (errorY < threshold ? 1 : 0);
+    return static_cast<uint8_t>((log2X << 2) | log2Y);
+}
+
+ContentShadingStats ContentAdaptiveShading::GetStats() const {
+    ContentShadingStats stats = {};
+    stats.framesAnalyzed = framesAnalyzed.load(std::memory_order_relaxed);
+    stats.lastAnalysisMs = lastAnalysisMs.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(publishMutex);
+    stats.blocksX = published.blocksX;
+    stats.blocksY = published.blocksY;
+    return stats;
+}
@@ -0,0 +1,291 @@
+#include "D3D12VrsBackend.h"
+
+#if VRS_BACKEND_D3D
+
+#include "Enums.h"
+#include <cstring>
+
+std::mutex D3D12VrsBackend::retiredMutex;
+std::vector<std::pair<ID3D12Resource *, UINT64>> D3D12VrsBackend::retiredResources;
+std::atomic<int> D3D12VrsBackend::liveBackends(0);
+
+// Constructor
+D3D12VrsBackend::D3D12VrsBackend(IUnityGraphicsD3D12v5 *unityGraphicsD3D12)
+    : unityGraphics(unityGraphicsD3D12), device(unityGraphicsD3D12 ? unityGraphicsD3D12->GetDevice() : nullptr),
+    supported(false), gaze{}, rateImage(nullptr), imageWidth(0), imageHeight(0), rowPitch(0),
+    uploadSlots{}, nextUploadSlot(0), fullUploadPending(true), lastError(0) {
+    liveBackends.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Destructor
+D3D12VrsBackend::~D3D12VrsBackend() {
+    Release();
+
+    // The default context keeps its backend until the device goes, the last one leaves with the device
+    if (liveBackends.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        ReleaseRetiredResources(true);
+    }
+}
+
+bool D3D12VrsBackend::Initialize(float /*tanHalfHorizontalFov*/, float /*tanHalfVerticalFov*/, bool stereo) {
+    D3D12_FEATURE_DATA_D3D12_OPTIONS6 options = {};
+    supported = device && SUCCEEDED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS6, &options, sizeof(options))) &&
+                options.VariableShadingRateTier >= D3D12_VARIABLE_SHADING_RATE_TIER_2;
+    if (!supported) {
+        return false;
+    }
+
+    image.ConfigureDevice(static_cast<int>(options.ShadingRateImageTileSize), options.AdditionalShadingRatesSupported != FALSE);
+    ConfigurePluginEvents();
+
+    gaze = {};
+    gaze.stereo = stereo;
+    return true;
+}
+
+void D3D12VrsBackend::ConfigurePluginEvents() {
+    UnityD3D12PluginEventConfig eventConfig = {};
+    eventConfig.graphicsQueueAccess = kUnityD3D12GraphicsQueueAccess_DontCare;
+    eventConfig.flags = kUnityD3D12EventConfigFlag_SyncWorkerThreads | kUnityD3D12EventConfigFlag_ModifiesCommandBuffersState |
+                        kUnityD3D12EventConfigFlag_EnsurePreviousFrameSubmission;
+    eventConfig.ensureActiveRenderTextureIsBound = true;
+
+    const EventID commandListEvents[] = {
+        EventID::ENABLE_FOVEATED_RENDERING,
+        EventID::DISABLE_FOVEATED_RENDERING,
+        EventID::ENABLE_FOVEATED_RENDERING_LEFT_EYE,
+        EventID::ENABLE_FOVEATED_RENDERING_RIGHT_EYE,
+        EventID::COMMAND_PACKET
+    };
+    for (EventID eventID : commandListEvents) {
+        unityGraphics->ConfigureEvent(static_cast<int>(eventID), &eventConfig);
+    }
+}
+
+bool D3D12VrsBackend::UpdateGaze(const VrsGazeFrame &gazeFrame) {
+    // Rates are rebuilt around the new gaze on the next enable
+    gaze = gazeFrame;
+    return supported;
+}
+
+VrsResult D3D12VrsBackend::Enable(RenderMode mode, const VrsFoveationState &foveation) {
+    UnityGraphicsD3D12RecordingState recordingState;
+    if (!supported || !unityGraphics->CommandRecordingState(&recordingState) || !recordingState.commandList) {
+        return VrsResult::FAILED;
+    }
+
+    ID3D12GraphicsCommandList5 *commandList = nullptr;
+    HRESULT hr = recordingState.commandList->QueryInterface(__uuidof(ID3D12GraphicsCommandList5), reinterpret_cast<void **>(&commandList));
+    if (FAILED(hr)) {
+        lastError = static_cast<int32_t>(hr);
+        return VrsResult::FAILED;
+    }
+
+    ReleaseRetiredResources(false);
+
+    bool changed = image.Update(mode, gaze, foveation);
+    if (image.GetWidth() != imageWidth || image.GetHeight() != imageHeight) {
+        CreateImageResources();
+    }
+
+    if (rateImage && (changed || fullUploadPending) && !UploadImage(commandList)) {
+        // The image still holds the rates of an older gaze or the other eye, shade this pass at full rate
+        commandList->RSSetShadingRateImage(nullptr);
+        commandList->RSSetShadingRate(D3D12_SHADING_RATE_1X1, nullptr);
+        commandList->Release();
+        return VrsResult::FAILED;
+    }
+
+    if (rateImage) {
+        // The image overrides the base and per-primitive rates
+        const D3D12_SHADING_RATE_COMBINER combiners[2] = {D3D12_SHADING_RATE_COMBINER_PASSTHROUGH, D3D12_SHADING_RATE_COMBINER_OVERRIDE};
+        commandList->RSSetShadingRate(D3D12_SHADING_RATE_1X1, combiners);
+        commandList->RSSetShadingRateImage(rateImage);
+    }
+
+    commandList->Release();
+    return rateImage ? VrsResult::APPLIED : VrsResult::FAILED;
+}
+
+VrsResult D3D12VrsBackend::Disable() {
+    UnityGraphicsD3D12RecordingState recordingState;
+    if (!supported || !unityGraphics->CommandRecordingState(&recordingState) || !recordingState.commandList) {
+        return VrsResult::FAILED;
+    }
+
+    ID3D12GraphicsCommandList5 *commandList = nullptr;
+    HRESULT hr = recordingState.commandList->QueryInterface(__uuidof(ID3D12GraphicsCommandList5), reinterpret_cast<void **>(&commandList));
+    if (FAILED(hr)) {
+        lastError = static_cast<int32_t>(hr);
+        return VrsResult::FAILED;
+    }
+
+    commandList->RSSetShadingRateImage(nullptr);
+    commandList->RSSetShadingRate(D3D12_SHADING_RATE_1X1, nullptr);
+    commandList->Release();
+    return VrsResult::APPLIED;
+}
+
+bool D3D12VrsBackend::CreateImageResources() {
+    RetireImageResources();
+
+    imageWidth = image.GetWidth();
+    imageHeight = image.GetHeight();
+    if (imageWidth <= 0 || imageHeight <= 0) {
+        return false;
+    }
+    rowPitch = (static_cast<UINT>(imageWidth) + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1) & ~(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1);
+
+    D3D12_HEAP_PROPERTIES defaultHeap = {};
+    defaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+    D3D12_RESOURCE_DESC imageDesc = {};
+    imageDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    imageDesc.Width = static_cast<UINT64>(imageWidth);
+    imageDesc.Height = static_cast<UINT>(imageHeight);
+    imageDesc.DepthOrArraySize = 1;
+    imageDesc.MipLevels = 1;
+    imageDesc.Format = DXGI_FORMAT_R8_UINT;
+    imageDesc.SampleDesc.Count = 1;
+    imageDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+
+    HRESULT hr = device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &imageDesc, D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE,
+                                                 nullptr, __uuidof(ID3D12Resource), reinterpret_cast<void **>(&rateImage));
+    if (FAILED(hr)) {
+        lastError = static_cast<int32_t>(hr);
+        rateImage = nullptr;
+        return false;
+    }
+
+    D3D12_HEAP_PROPERTIES uploadHeap = {};
+    uploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+    D3D12_RESOURCE_DESC bufferDesc = {};
+    bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    bufferDesc.Width = static_cast<UINT64>(rowPitch) * imageHeight;
+    bufferDesc.Height = 1;
+    bufferDesc.DepthOrArraySize = 1;
+    bufferDesc.MipLevels = 1;
+    bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+    bufferDesc.SampleDesc.Count = 1;
+    bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+    for (UploadSlot &slot : uploadSlots) {
+        slot.fenceValue = 0;
+        hr = device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufferDesc, D3D12_RESOURCE_STATE_GENERIC_READ,
+                                             nullptr, __uuidof(ID3D12Resource), reinterpret_cast<void **>(&slot.buffer));
+        if (FAILED(hr)) {
+            lastError = static_cast<int32_t>(hr);
+            slot.buffer = nullptr;
+            RetireImageResources();
+            return false;
+        }
+    }
+
+    nextUploadSlot = 0;
+    fullUploadPending = true;
+    return true;
+}
+
+bool D3D12VrsBackend::UploadImage(ID3D12GraphicsCommandList5 *commandList) {
+    UploadSlot &slot = uploadSlots[nextUploadSlot];
+    if (slot.fenceValue > unityGraphics->GetFrameFence()->GetCompletedValue()) {
+        // The GPU may still read this buffer, send the whole image with the next enable instead
+        fullUploadPending = true;
+        lastError = static_cast<int32_t>(DXGI_ERROR_WAS_STILL_DRAWING);
+        return false;
+    }
+
+    TileRect rect = fullUploadPending ? TileRect{0, 0, imageWidth, imageHeight} : image.GetDirtyRect();
+
+    uint8_t *mapped = nullptr;
+    D3D12_RANGE readRange = {0, 0};
+    HRESULT hr = slot.buffer->Map(0, &readRange, reinterpret_cast<void **>(&mapped));
+    if (FAILED(hr)) {
+        fullUploadPending = true;
+        lastError = static_cast<int32_t>(hr);
+        return false;
+    }
+    for (int row = rect.beginY; row < rect.endY; ++row) {
+        memcpy(mapped + static_cast<size_t>(row) * rowPitch, image.GetData() + static_cast<size_t>(row) * imageWidth, imageWidth);
+    }
+    slot.buffer->Unmap(0, nullptr);
+
+    D3D12_RESOURCE_BARRIER barrier = {};
+    barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barrier.Transition.pResource = rateImage;
+    barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE;
+    barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+    commandList->ResourceBarrier(1, &barrier);
+
+    // Whole rows, the row range is what changes when gaze moves vertically
+    D3D12_TEXTURE_COPY_LOCATION destination = {};
+    destination.pResource = rateImage;
+    destination.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+    destination.SubresourceIndex = 0;
+
+    D3D12_TEXTURE_COPY_LOCATION source = {};
+    source.pResource = slot.buffer;
+    source.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+    source.PlacedFootprint.Offset = 0;
+    source.PlacedFootprint.Footprint.Format = DXGI_FORMAT_R8_UINT;
+    source.PlacedFootprint.Footprint.Width = static_cast<UINT>(imageWidth);
+    source.PlacedFootprint.Footprint.Height = static_cast<UINT>(imageHeight);
+    source.PlacedFootprint.Footprint.Depth = 1;
+    source.PlacedFootprint.Footprint.RowPitch = rowPitch;
+
+    D3D12_BOX box = {0, static_cast<UINT>(rect.beginY), 0, static_cast<UINT>(imageWidth), static_cast<UINT>(rect.endY), 1};
+    commandList->CopyTextureRegion(&destination, 0, static_cast<UINT>(rect.beginY), 0, &source, &box);
+
+    barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+    barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE;
+    commandList->ResourceBarrier(1, &barrier);
+
+    slot.fenceValue = unityGraphics->GetNextFrameFenceValue();
+    nextUploadSlot = (nextUploadSlot + 1) % UPLOAD_SLOTS;
+    fullUploadPending = false;
+    return true;
+}
+
+void D3D12VrsBackend::RetireImageResources() {
+    UINT64 fenceValue = unityGraphics->GetNextFrameFenceValue();
+    std::lock_guard<std::mutex> lock(retiredMutex);
+    if (rateImage) {
+        retiredResources.emplace_back(rateImage, fenceValue);
+        rateImage = nullptr;
+    }
+    for (UploadSlot &slot : uploadSlots) {
+        if (slot.buffer) {
+            retiredResources.emplace_back(slot.buffer, fenceValue);
+            slot.buffer = nullptr;
+        }
+    }
+    imageWidth = 0;
+    imageHeight = 0;
+}
+
+void D3D12VrsBackend::ReleaseRetiredResources(bool force) {
+    UINT64 completed = force ? ~0ull : unityGraphics->GetFrameFence()->GetCompletedValue();
+    std::lock_guard<std::mutex> lock(retiredMutex);
+    size_t kept = 0;
+    for (size_t i = 0; i < retiredResources.size(); ++i) {
+        if (retiredResources[i].second <= completed) {
+            retiredResources[i].first->Release();
+        } else {
+            retiredResources[kept++] = retiredResources[i];
+        }
+    }
+    retiredResources.resize(kept);
+}
+
+void D3D12VrsBackend::Release() {
+    if (unityGraphics) {
+        // Frames recorded with the image may still be queued, it goes once the GPU passes them
+        RetireImageResources();
+        ReleaseRetiredResources(false);
+    }
+    supported = false;
+}
+
+#endif
@@ -0,0 +1,67 @@
+#include "Foveation.h"
+
+void ResolveShadingRatePreset(ShadingRatePreset preset, FoveationDesc &desc) {
+    // Mirrors the table in Enums.h
+    switch (preset) {
+    case ShadingRatePreset::HIGHEST_PERFORMANCE:
+        desc.innerRate = ShadingRate::X1_PER_PIXEL;
+        desc.middleRate = ShadingRate::X1_PER_2X2_PIXELS;
+        desc.peripheralRate = ShadingRate::X1_PER_4X4_PIXELS;
+        break;
+    case ShadingRatePreset::HIGH_PERFORMANCE:
+        desc.innerRate = ShadingRate::X1_PER_PIXEL;
+        desc.middleRate = ShadingRate::X1_PER_2X2_PIXELS;
+        desc.peripheralRate = ShadingRate::X1_PER_2X2_PIXELS;
+        break;
+    case ShadingRatePreset::BALANCED:
+        desc.innerRate = ShadingRate::X4_PER_PIXEL;
+        desc.middleRate = ShadingRate::X1_PER_PIXEL;
+        desc.peripheralRate = ShadingRate::X1_PER_2X2_PIXELS;
+        break;
+    case ShadingRatePreset::HIGH_QUALITY:
+        desc.innerRate = ShadingRate::X4_PER_PIXEL;
+        desc.middleRate = ShadingRate::X2_PER_PIXEL;
+        desc.peripheralRate = ShadingRate::X1_PER_PIXEL;
+        break;
+    case ShadingRatePreset::HIGHEST_QUALITY:
+        desc.innerRate = ShadingRate::X8_PER_PIXEL;
+        desc.middleRate = ShadingRate::X4_PER_PIXEL;
+        desc.peripheralRate = ShadingRate::X2_PER_PIXEL;
+        break;
+    case ShadingRatePreset::CUSTOM:
+    default:
+        break;
+    }
+}
+
+void ResolveFoveationPatternPreset(ShadingPatternPreset preset, FoveationDesc &desc) {
+    // The driver does not publish its preset geometry, these are close approximations
+    switch (preset) {
+    case ShadingPatternPreset::WIDE:
+        desc.innerRadii = {0.40f, 0.40f};
+        desc.middleRadii = {0.55f, 0.55f};
+        desc.peripheralRadii = {1.0f, 1.0f};
+        break;
+    case ShadingPatternPreset::BALANCED:
+        desc.innerRadii = {0.30f, 0.30f};
+        desc.middleRadii = {0.45f, 0.45f};
+        desc.peripheralRadii = {1.0f, 1.0f};
+        break;
+    case ShadingPatternPreset::NARROW:
+        desc.innerRadii = {0.20f, 0.20f};
+        desc.middleRadii = {0.33f, 0.33f};
+        desc.peripheralRadii = {1.0f, 1.0f};
+        break;
+    case ShadingPatternPreset::CUSTOM:
+    default:
+        break;
+    }
+}
+
+bool IsSameFoveation(const FoveationDesc &lhs, const FoveationDesc &rhs) {
+    return lhs.innerRadii.x == rhs.innerRadii.x && lhs.innerRadii.y == rhs.innerRadii.y &&
+           lhs.middleRadii.x == rhs.middleRadii.x && lhs.middleRadii.y == rhs.middleRadii.y &&
+           lhs.peripheralRadii.x == rhs.peripheralRadii.x && lhs.peripheralRadii.y == rhs.peripheralRadii.y &&
+           lhs.innerRate == rhs.innerRate && lhs.middleRate == rhs.middleRate &&
+           lhs.peripheralRate == rhs.peripheralRate;
+}
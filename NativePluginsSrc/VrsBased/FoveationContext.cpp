@@ -0,0 +1,107 @@
+#include "FoveationContext.h"
+
+// Generations wrap before the handle would turn negative
+static const uint32_t GENERATION_MASK = 0x7FFFFFFu;
+
+// Constructor
+FoveationContext::FoveationContext()
+    : backend(nullptr), tanHalfHorizontalFov(1.0f), tanHalfVerticalFov(1.0f), initialized(false), enabled(true) {
+}
+
+// Destructor
+FoveationContext::~FoveationContext() {
+    vrsManager.Release();
+    if (backend) {
+        backend->Release();
+        delete backend;
+        backend = nullptr;
+    }
+}
+
+// Constructor
+FoveationContextPool::FoveationContextPool()
+    : retiredCount(0) {
+    for (Slot &slot : slots) {
+        slot.id.store(INVALID_FOVEATION_CONTEXT, std::memory_order_relaxed);
+        slot.state.store(static_cast<int>(SlotState::FREE), std::memory_order_relaxed);
+        slot.context = nullptr;
+        slot.generation = 0;
+    }
+}
+
+// Destructor
+FoveationContextPool::~FoveationContextPool() {
+    Clear();
+}
+
+FoveationContextId FoveationContextPool::Acquire() {
+    for (int index = 0; index < MAX_CONTEXTS; ++index) {
+        Slot &slot = slots[index];
+        if (slot.state.load(std::memory_order_acquire) != static_cast<int>(SlotState::FREE)) {
+            continue;
+        }
+
+        slot.context = new FoveationContext();
+        FoveationContextId id = static_cast<FoveationContextId>(((slot.generation & GENERATION_MASK) << SLOT_BITS) | index);
+        slot.state.store(static_cast<int>(SlotState::ACTIVE), std::memory_order_relaxed);
+        slot.id.store(id, std::memory_order_release);
+        return id;
+    }
+    return INVALID_FOVEATION_CONTEXT;
+}
+
+bool FoveationContextPool::Retire(FoveationContextId id) {
+    if (!Get(id)) {
+        return false;
+    }
+
+    Slot &slot = slots[id & (MAX_CONTEXTS - 1)];
+    slot.id.store(INVALID_FOVEATION_CONTEXT, std::memory_order_release);
+    ++slot.generation;
+    slot.state.store(static_cast<int>(SlotState::RETIRED), std::memory_order_release);
+    retiredCount.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+FoveationContext *FoveationContextPool::Get(FoveationContextId id) const {
+    if (id < 0) {
+        return nullptr;
+    }
+    const Slot &slot = slots[id & (MAX_CONTEXTS - 1)];
+    return slot.id.load(std::memory_order_acquire) == id ? slot.context : nullptr;
+}
+
+FoveationContext *FoveationContextPool::GetSlot(int index) const {
+    if (index < 0 || index >= MAX_CONTEXTS) {
+        return nullptr;
+    }
+    const Slot &slot = slots[index];
+    return slot.id.load(std::memory_order_acquire) != INVALID_FOVEATION_CONTEXT ? slot.context : nullptr;
+}
+
+void FoveationContextPool::Reclaim() {
+    if (retiredCount.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+
+    for (Slot &slot : slots) {
+        if (slot.state.load(std::memory_order_acquire) != static_cast<int>(SlotState::RETIRED)) {
+            continue;
+        }
+        delete slot.context;
+        slot.context = nullptr;
+        retiredCount.fetch_sub(1, std::memory_order_relaxed);
+        slot.state.store(static_cast<int>(SlotState::FREE), std::memory_order_release);
+    }
+}
+
+void FoveationContextPool::Clear() {
+    for (Slot &slot : slots) {
+        slot.id.store(INVALID_FOVEATION_CONTEXT, std::memory_order_release);
+        delete slot.context;
+        slot.context = nullptr;
+        slot.generation = 0;
+        slot.state.store(static_cast<int>(SlotState::FREE), std::memory_order_release);
+    }
+    retiredCount.store(0, std::memory_order_release);
+}
@@ -0,0 +1,186 @@
+#include "FoveationGovernor.h"
+#include "ShadingCostModel.h"
+#include "Utils.h"
+#include <cmath>
+
+const float FoveationGovernor::RATE_HYSTERESIS = 0.25f;
+const float FoveationGovernor::UNDER_BUDGET_GAIN = 0.25f;
+const float FoveationGovernor::OVER_BUDGET_GAIN = 1.0f;
+
+// Shading rates from most to least expensive, rates of equal cost share a rung
+static const ShadingRate RATE_LADDER[] = {
+    ShadingRate::X16_PER_PIXEL, ShadingRate::X8_PER_PIXEL, ShadingRate::X4_PER_PIXEL,
+    ShadingRate::X2_PER_PIXEL, ShadingRate::X1_PER_PIXEL, ShadingRate::X1_PER_2X1_PIXELS,
+    ShadingRate::X1_PER_2X2_PIXELS, ShadingRate::X1_PER_4X2_PIXELS, ShadingRate::X1_PER_4X4_PIXELS
+};
+
+// Constructor
+FoveationGovernor::FoveationGovernor()
+    : dirty(false), settings(GetDefaultSettings()), quality(1.0f), smoothedFrameTimeMs(0.0f), hasFrameTime(false),
+    framesSinceAdjustment(0), lastDirection(0), backoff(1), adjustments(0), ladderIndices{-1, -1, -1}, foveation{} {
+    UpdateFoveation();
+}
+
+// Destructor
+FoveationGovernor::~FoveationGovernor() {
+}
+
+FoveationGovernorSettings FoveationGovernor::GetDefaultSettings() {
+    FoveationGovernorSettings defaults = {};
+    defaults.enabled = false;
+    defaults.targetFrameTimeMs = 1000.0f / 90.0f;
+    defaults.hysteresis = 0.05f;
+    defaults.smoothing = 0.1f;
+    defaults.holdFrames = 15;
+    defaults.maxStep = 0.1f;
+
+    ResolveShadingRatePreset(ShadingRatePreset::HIGHEST_PERFORMANCE, defaults.lowestQuality);
+    ResolveFoveationPatternPreset(ShadingPatternPreset::NARROW, defaults.lowestQuality);
+    ResolveShadingRatePreset(ShadingRatePreset::BALANCED, defaults.highestQuality);
+    ResolveFoveationPatternPreset(ShadingPatternPreset::WIDE, defaults.highestQuality);
+    return defaults;
+}
+
+void FoveationGovernor::Configure(const FoveationGovernorSettings &newSettings) {
+    std::lock_guard<std::mutex> lock(mutex);
+    bool wasEnabled = settings.enabled;
+
+    settings = newSettings;
+    settings.targetFrameTimeMs = (std::max)(settings.targetFrameTimeMs, 0.1f);
+    settings.hysteresis = Clamp(settings.hysteresis, 0.0f, 0.5f);
+    settings.smoothing = Clamp(settings.smoothing, 0.01f, 1.0f);
+    settings.holdFrames = (std::max)(settings.holdFrames, 1);
+    settings.maxStep = Clamp(settings.maxStep, 0.001f, 1.0f);
+
+    // Start from the best quality and let the loop settle from there
+    if (settings.enabled && !wasEnabled) {
+        quality = 1.0f;
+        hasFrameTime = false;
+        lastDirection = 0;
+        backoff = 1;
+    }
+    ladderIndices[0] = ladderIndices[1] = ladderIndices[2] = -1;
+    UpdateFoveation();
+}
+
+void FoveationGovernor::SubmitFrameTime(float frameTimeMs) {
+    if (!(frameTimeMs > 0.0f)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!settings.enabled) {
+        return;
+    }
+
+    smoothedFrameTimeMs = hasFrameTime ? smoothedFrameTimeMs + settings.smoothing * (frameTimeMs - smoothedFrameTimeMs) : frameTimeMs;
+    hasFrameTime = true;
+
+    if (++framesSinceAdjustment < settings.holdFrames * backoff) {
+        return;
+    }
+
+    float error = (smoothedFrameTimeMs - settings.targetFrameTimeMs) / settings.targetFrameTimeMs;
+    if (fabsf(error) <= settings.hysteresis) {
+        // Settled, relax the backoff by one step per elapsed hold window
+        if (backoff > 1) {
+            backoff /= 2;
+            framesSinceAdjustment = 0;
+        }
+        return;
+    }
+
+    int direction = error > 0.0f ? -1 : 1;
+    float gain = direction < 0 ? OVER_BUDGET_GAIN : UNDER_BUDGET_GAIN;
+    float step = (std::min)(gain * (fabsf(error) - settings.hysteresis), settings.maxStep);
+    float newQuality = Clamp(quality + direction * step, 0.0f, 1.0f);
+    if (newQuality == quality) {
+        return;
+    }
+
+    if (lastDirection != 0 && direction != lastDirection) {
+        backoff = (std::min)(backoff * 2, MAX_BACKOFF);
+    }
+    lastDirection = direction;
+    quality = newQuality;
+    framesSinceAdjustment = 0;
+    ++adjustments;
+    UpdateFoveation();
+}
+
+bool FoveationGovernor::ConsumeFoveation(FoveationDesc &desc, bool &active) {
+    if (!dirty.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    // Retry on a later event rather than stall the render thread
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return false;
+    }
+    desc = foveation;
+    active = settings.enabled;
+    dirty.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+FoveationGovernorState FoveationGovernor::GetState() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    FoveationGovernorState state = {};
+    state.quality = quality;
+    state.smoothedFrameTimeMs = smoothedFrameTimeMs;
+    state.adjustments = adjustments;
+    state.foveation = foveation;
+    return state;
+}
+
+void FoveationGovernor::UpdateFoveation() {
+    const FoveationDesc &low = settings.lowestQuality;
+    const FoveationDesc &high = settings.highestQuality;
+    auto lerp = [this](const Vector2 &from, const Vector2 &to) {
+        return Vector2{from.x + (to.x - from.x) * quality, from.y + (to.y - from.y) * quality};
+    };
+
+    foveation.innerRadii = lerp(low.innerRadii, high.innerRadii);
+    foveation.middleRadii = lerp(low.middleRadii, high.middleRadii);
+    foveation.peripheralRadii = lerp(low.peripheralRadii, high.peripheralRadii);
+    foveation.innerRate = SelectRate(low.innerRate, high.innerRate, ladderIndices[0]);
+    foveation.middleRate = SelectRate(low.middleRate, high.middleRate, ladderIndices[1]);
+    foveation.peripheralRate = SelectRate(low.peripheralRate, high.peripheralRate, ladderIndices[2]);
+    dirty.store(true, std::memory_order_release);
+}
+
+ShadingRate FoveationGovernor::SelectRate(ShadingRate lowest, ShadingRate highest, int &ladderIndex) const {
+    // CULL is not on the ladder, it can only be used as a fixed rate
+    if (lowest == ShadingRate::CULL || highest == ShadingRate::CULL) {
+        return quality >= 0.5f ? highest : lowest;
+    }
+
+    int cheapest = GetLadderIndex(lowest);
+    int best = GetLadderIndex(highest);
+    float ideal = cheapest + (best - cheapest) * quality;
+
+    if (ladderIndex < 0 || fabsf(ideal - ladderIndex) > 0.5f + RATE_HYSTERESIS) {
+        ladderIndex = static_cast<int>(floorf(ideal + 0.5f));
+    }
+    ladderIndex = Clamp(ladderIndex, (std::min)(cheapest, best), (std::max)(cheapest, best));
+
+    // Keep the exact bound rate at the ends, e.g. 1x2 instead of its 2x1 rung
+    if (ladderIndex == cheapest) {
+        return lowest;
+    }
+    if (ladderIndex == best) {
+        return highest;
+    }
+    return RATE_LADDER[ladderIndex];
+}
+
+int FoveationGovernor::GetLadderIndex(ShadingRate rate) {
+    float cost = GetShadingRateCost(rate);
+    for (int i = 0; i < RATE_LADDER_SIZE; ++i) {
+        if (GetShadingRateCost(RATE_LADDER[i]) <= cost) {
+            return i;
+        }
+    }
+    return RATE_LADDER_SIZE - 1;
+}
@@ -0,0 +1,188 @@
+#include "FoveationImageBuilder.h"
+#include <algorithm>
+
+// Number of ShadingRate values
+static const int SHADING_RATE_COUNT = static_cast<int>(ShadingRate::X1_PER_4X4_PIXELS) + 1;
+
+// Constructor
+FoveationImageBuilder::FoveationImageBuilder()
+    : pendingWidth(0), pendingHeight(0), targetWidth(0), targetHeight(0), tileSize(16), largeRates(false),
+    viewCount(0), tilesX(0), tilesY(0), dirtyRect{0, 0, 0, 0}, contentMerged(false),
+    lastMode(RenderMode::MONO), lastGazeTimestamp(0), lastFoveationVersion(0) {
+}
+
+// Destructor
+FoveationImageBuilder::~FoveationImageBuilder() {
+}
+
+void FoveationImageBuilder::ConfigureRenderTarget(int width, int height) {
+    pendingWidth.store(width, std::memory_order_relaxed);
+    pendingHeight.store(height, std::memory_order_relaxed);
+}
+
+void FoveationImageBuilder::ConfigureDevice(int tile, bool largeRatesSupported) {
+    tileSize = tile > 0 ? tile : 16;
+    largeRates = largeRatesSupported;
+
+    // Force the views to be resized and every texel to be encoded again
+    viewCount = 0;
+}
+
+uint8_t FoveationImageBuilder::EncodeShadingRate(ShadingRate rate, bool largeRatesSupported) {
+    switch (rate) {
+    case ShadingRate::X1_PER_2X1_PIXELS:
+        return (1 << 2) | 0;
+    case ShadingRate::X1_PER_1X2_PIXELS:
+        return (0 << 2) | 1;
+    case ShadingRate::X1_PER_2X2_PIXELS:
+        return (1 << 2) | 1;
+    case ShadingRate::X1_PER_4X2_PIXELS:
+        return largeRatesSupported ? (2 << 2) | 1 : (1 << 2) | 1;
+    case ShadingRate::X1_PER_2X4_PIXELS:
+        return largeRatesSupported ? (1 << 2) | 2 : (1 << 2) | 1;
+    case ShadingRate::X1_PER_4X4_PIXELS:
+        return largeRatesSupported ? (2 << 2) | 2 : (1 << 2) | 1;
+    default:
+        // Supersampling and culling have no rate image equivalent
+        return 0;
+    }
+}
+
+bool FoveationImageBuilder::ApplyTargetSize(int count) {
+    int width = pendingWidth.load(std::memory_order_relaxed);
+    int height = pendingHeight.load(std::memory_order_relaxed);
+    if (width == targetWidth && height == targetHeight && count == viewCount) {
+        return false;
+    }
+
+    targetWidth = width;
+    targetHeight = height;
+    viewCount = count;
+    tilesX = 0;
+    tilesY = 0;
+    for (int view = 0; view < viewCount; ++view) {
+        if (!views[view].Initialize(width / viewCount, height, tileSize)) {
+            tilesX = 0;
+            break;
+        }
+        tilesX += views[view].GetWidth();
+        tilesY = views[view].GetHeight();
+    }
+
+    encoded.assign(static_cast<size_t>(tilesX) * tilesY, 0);
+    merged.assign(encoded.size(), 0);
+    contentMerged = false;
+    return true;
+}
+
+bool FoveationImageBuilder::Update(RenderMode mode, const VrsGazeFrame &gaze, const VrsFoveationState &foveation) {
+    bool resized = ApplyTargetSize(mode == RenderMode::STEREO ? 2 : 1);
+    bool contentChanged = content.Latch();
+    dirtyRect = {tilesX, tilesY, 0, 0};
+    if (encoded.empty()) {
+        return false;
+    }
+
+    // Version 0 is never handed out, so the first update always rebuilds
+    if (!resized && !contentChanged && mode == lastMode && gaze.timestamp == lastGazeTimestamp &&
+        foveation.version == lastFoveationVersion) {
+        return false;
+    }
+    lastMode = mode;
+    lastGazeTimestamp = gaze.timestamp;
+    lastFoveationVersion = foveation.version;
+
+    uint8_t encodeTable[SHADING_RATE_COUNT];
+    for (int rate = 0; rate < SHADING_RATE_COUNT; ++rate) {
+        encodeTable[rate] = EncodeShadingRate(static_cast<ShadingRate>(rate), largeRates);
+    }
+
+    int offsetX = 0;
+    for (int view = 0; view < viewCount; ++view) {
+        // A multi-pass right eye pass reuses the single view with the right eye's gaze
+        int eye = mode == RenderMode::RIGHT_EYE ? 1 : view;
+        ShadingRateImage &image = views[view];
+        image.Update(gaze.positions[eye], foveation.desc);
+
+        const TileRect &rect = image.GetDirtyRect();
+        if (rect.endX > rect.beginX && rect.endY > rect.beginY) {
+            const uint8_t *source = image.GetData();
+            for (int row = rect.beginY; row < rect.endY; ++row) {
+                const uint8_t *sourceRow = source + static_cast<size_t>(row) * image.GetWidth();
+                uint8_t *targetRow = encoded.data() + static_cast<size_t>(row) * tilesX + offsetX;
+                for (int x = rect.beginX; x < rect.endX; ++x) {
+                    targetRow[x] = encodeTable[sourceRow[x] < SHADING_RATE_COUNT ? sourceRow[x] : 0];
+                }
+            }
+
+            dirtyRect.beginX = (std::min)(dirtyRect.beginX, offsetX + rect.beginX);
+            dirtyRect.endX = (std::max)(dirtyRect.endX, offsetX + rect.endX);
+            dirtyRect.beginY = (std::min)(dirtyRect.beginY, rect.beginY);
+            dirtyRect.endY = (std::max)(dirtyRect.endY, rect.endY);
+        }
+        offsetX += image.GetWidth();
+    }
+
+    if (content.IsActive(targetWidth, targetHeight)) {
+        MergeContent();
+    } else if (contentMerged) {
+        // Back to the plain foveation, every texel may differ from the merged image
+        contentMerged = false;
+        dirtyRect = {0, 0, tilesX, tilesY};
+    }
+
+    return dirtyRect.endX > dirtyRect.beginX;
+}
+
+uint8_t FoveationImageBuilder::CombineRates(uint8_t foveation, uint8_t contentRate) const {
+    int log2Width = (std::max)(foveation >> 2, contentRate >> 2);
+    int log2Height = (std::max)(foveation & 3, contentRate & 3);
+    if (!largeRates) {
+        log2Width = (std::min)(log2Width, 1);
+        log2Height = (std::min)(log2Height, 1);
+    }
+
+    // 4x1 and 1x4 do not exist, the long side gives way
+    if (log2Width == 2 && log2Height == 0) {
+        log2Width = 1;
+    } else if (log2Height == 2 && log2Width == 0) {
+        log2Height = 1;
+    }
+    return static_cast<uint8_t>((log2Width << 2) | log2Height);
+}
+
+void FoveationImageBuilder::MergeContent() {
+    // The merged image changes with the content every frame, so only its own changes are uploaded
+    TileRect changed = {tilesX, tilesY, 0, 0};
+    bool wasMerged = contentMerged;
+    int viewWidth = targetWidth / viewCount;
+
+    int offsetX = 0;
+    for (int view = 0; view < viewCount; ++view) {
+        const ShadingRateImage &image = views[view];
+        for (int row = 0; row < tilesY; ++row) {
+            const uint8_t *sourceRow = encoded.data() + static_cast<size_t>(row) * tilesX + offsetX;
+            uint8_t *targetRow = merged.data() + static_cast<size_t>(row) * tilesX + offsetX;
+            int beginY = row * tileSize;
+            int endY = (std::min)(beginY + tileSize, targetHeight);
+
+            for (int column = 0; column < image.GetWidth(); ++column) {
+                int beginX = view * viewWidth + column * tileSize;
+                int endX = (std::min)(beginX + tileSize, (view + 1) * viewWidth);
+                uint8_t contentRate = content.GetCoarsestRate(beginX, beginY, endX, endY, image.GetRegion(column, row));
+                uint8_t texel = CombineRates(sourceRow[column], contentRate);
+                if (texel != targetRow[column] || !wasMerged) {
+                    targetRow[column] = texel;
+                    changed.beginX = (std::min)(changed.beginX, offsetX + column);
+                    changed.endX = (std::max)(changed.endX, offsetX + column + 1);
+                    changed.beginY = (std::min)(changed.beginY, row);
+                    changed.endY = row + 1;
+                }
+            }
+        }
+        offsetX += image.GetWidth();
+    }
+
+    contentMerged = true;
+    dirtyRect = changed.endX > changed.beginX ? changed : TileRect{0, 0, 0, 0};
+}
@@ -0,0 +1,94 @@
+#include "FoveationPresetFile.h"
+#include <cstdio>
+#include <cstring>
+
+static const struct {
+    ShadingRate rate;
+    const char *name;
+} RATE_NAMES[] = {
+    {ShadingRate::CULL, "cull"},
+    {ShadingRate::X16_PER_PIXEL, "16x"},
+    {ShadingRate::X8_PER_PIXEL, "8x"},
+    {ShadingRate::X4_PER_PIXEL, "4x"},
+    {ShadingRate::X2_PER_PIXEL, "2x"},
+    {ShadingRate::X1_PER_PIXEL, "1x1"},
+    {ShadingRate::X1_PER_2X1_PIXELS, "2x1"},
+    {ShadingRate::X1_PER_1X2_PIXELS, "1x2"},
+    {ShadingRate::X1_PER_2X2_PIXELS, "2x2"},
+    {ShadingRate::X1_PER_4X2_PIXELS, "4x2"},
+    {ShadingRate::X1_PER_2X4_PIXELS, "2x4"},
+    {ShadingRate::X1_PER_4X4_PIXELS, "4x4"},
+};
+
+const char *GetShadingRateName(ShadingRate rate) {
+    for (const auto &entry : RATE_NAMES) {
+        if (entry.rate == rate) {
+            return entry.name;
+        }
+    }
+    return "1x1";
+}
+
+bool ParseShadingRateName(const char *name, ShadingRate &rate) {
+    for (const auto &entry : RATE_NAMES) {
+        if (strcmp(entry.name, name) == 0) {
+            rate = entry.rate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReadFoveationPresets(const std::string &path, std::vector<FoveationPresetEntry> &entries) {
+    FILE *file = fopen(path.c_str(), "r");
+    if (!file) {
+        return false;
+    }
+
+    entries.clear();
+    bool valid = true;
+    char line[512];
+    while (valid && fgets(line, sizeof(line), file)) {
+        const char *text = line + strspn(line, " \t");
+        if (*text == '#' || *text == '\n' || *text == '\r' || *text == '\0') {
+            continue;
+        }
+
+        FoveationPresetEntry entry = {};
+        char name[64], innerRate[8], middleRate[8], peripheralRate[8];
+        FoveationDesc &desc = entry.desc;
+        valid = sscanf(text, "%63s %f %f %f %f %f %f %7s %7s %7s %f %f", name,
+                       &desc.innerRadii.x, &desc.innerRadii.y, &desc.middleRadii.x, &desc.middleRadii.y,
+                       &desc.peripheralRadii.x, &desc.peripheralRadii.y, innerRate, middleRate, peripheralRate,
+                       &entry.relativeCost, &entry.weightedPsnr) == 12 &&
+                ParseShadingRateName(innerRate, desc.innerRate) && ParseShadingRateName(middleRate, desc.middleRate) &&
+                ParseShadingRateName(peripheralRate, desc.peripheralRate);
+        if (valid) {
+            entry.name = name;
+            entries.push_back(entry);
+        }
+    }
+    fclose(file);
+    return valid;
+}
+
+bool WriteFoveationPresets(const std::string &path, const std::vector<FoveationPresetEntry> &entries, const std::string &comment) {
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+
+    if (!comment.empty()) {
+        fprintf(file, "# %s\n", comment.c_str());
+    }
+    fprintf(file, "# name inner_rx inner_ry middle_rx middle_ry peripheral_rx peripheral_ry inner_rate middle_rate peripheral_rate cost psnr\n");
+    for (const FoveationPresetEntry &entry : entries) {
+        const FoveationDesc &desc = entry.desc;
+        fprintf(file, "%s %.4f %.4f %.4f %.4f %.4f %.4f %s %s %s %.5f %.3f\n", entry.name.c_str(),
+                desc.innerRadii.x, desc.innerRadii.y, desc.middleRadii.x, desc.middleRadii.y,
+                desc.peripheralRadii.x, desc.peripheralRadii.y, GetShadingRateName(desc.innerRate),
+                GetShadingRateName(desc.middleRate), GetShadingRateName(desc.peripheralRate),
+                entry.relativeCost, entry.weightedPsnr);
+    }
+    return fclose(file) == 0;
+}
@@ -0,0 +1,318 @@
+#include "GazeFilters.h"
+#include <cmath>
+
+static const float TWO_PI = 6.2831853f;
+
+// Seconds between two timestamps, guarded against duplicates and reordering
+static float DeltaSeconds(uint64_t from, uint64_t to) {
+    float dt = to > from ? static_cast<float>(to - from) * 1e-6f : 0.0f;
+    return dt > 1e-4f ? dt : 1e-4f;
+}
+
+// Smoothing factor of a first order low-pass at a cutoff frequency
+static float LowPassAlpha(float cutoff, float dt) {
+    float tau = 1.0f / (TWO_PI * cutoff);
+    return 1.0f / (1.0f + tau / dt);
+}
+
+// DeadZoneFilter
+
+DeadZoneFilter::DeadZoneFilter()
+    : threshold(0.05f), position{0.0f, 0.0f}, initialized(false) {
+}
+
+void DeadZoneFilter::Configure(const GazeFilterSettings &settings) {
+    threshold = settings.deadZoneThreshold;
+}
+
+void DeadZoneFilter::Process(GazeSample &sample) {
+    if (!initialized ||
+        fabsf(position.x - sample.position.x) > threshold ||
+        fabsf(position.y - sample.position.y) > threshold) {
+        position = sample.position;
+        initialized = true;
+    }
+    sample.position = position;
+}
+
+void DeadZoneFilter::Reset() {
+    initialized = false;
+}
+
+// OneEuroFilter
+
+OneEuroFilter::OneEuroFilter()
+    : minCutoff(1.0f), beta(0.5f), derivateCutoff(1.0f),
+    position{0.0f, 0.0f}, derivate{0.0f, 0.0f}, lastTimestamp(0), initialized(false) {
+}
+
+void OneEuroFilter::Configure(const GazeFilterSettings &settings) {
+    minCutoff = settings.oneEuroMinCutoff > 0.0f ? settings.oneEuroMinCutoff : 1.0f;
+    beta = settings.oneEuroBeta;
+    derivateCutoff = settings.oneEuroDerivateCutoff > 0.0f ? settings.oneEuroDerivateCutoff : 1.0f;
+}
+
+void OneEuroFilter::Process(GazeSample &sample) {
+    if (!initialized) {
+        position = sample.position;
+        derivate = {0.0f, 0.0f};
+        lastTimestamp = sample.captureTime;
+        initialized = true;
+        return;
+    }
+
+    float dt = DeltaSeconds(lastTimestamp, sample.captureTime);
+    lastTimestamp = sample.captureTime;
+
+    float derivateAlpha = LowPassAlpha(derivateCutoff, dt);
+    derivate.x += derivateAlpha * ((sample.position.x - position.x) / dt - derivate.x);
+    derivate.y += derivateAlpha * ((sample.position.y - position.y) / dt - derivate.y);
+
+    float alphaX = LowPassAlpha(minCutoff + beta * fabsf(derivate.x), dt);
+    float alphaY = LowPassAlpha(minCutoff + beta * fabsf(derivate.y), dt);
+    position.x += alphaX * (sample.position.x - position.x);
+    position.y += alphaY * (sample.position.y - position.y);
+
+    sample.position = position;
+}
+
+void OneEuroFilter::Reset() {
+    initialized = false;
+}
+
+// KalmanFilter
+
+KalmanFilter::KalmanFilter()
+    : processNoise(50.0f), measurementNoise(1e-4f), axes{}, lastTimestamp(0), initialized(false) {
+}
+
+void KalmanFilter::Configure(const GazeFilterSettings &settings) {
+    processNoise = settings.kalmanProcessNoise;
+    measurementNoise = settings.kalmanMeasurementNoise > 0.0f ? settings.kalmanMeasurementNoise : 1e-4f;
+}
+
+void KalmanFilter::Step(Axis &axis, float measurement, float dt) const {
+    // Predict with white-noise acceleration
+    float dt2 = dt * dt;
+    axis.position += axis.velocity * dt;
+    float p00 = axis.p00 + dt * (2.0f * axis.p01 + dt * axis.p11) + processNoise * dt2 * dt2 * 0.25f;
+    float p01 = axis.p01 + dt * axis.p11 + processNoise * dt2 * dt * 0.5f;
+    float p11 = axis.p11 + processNoise * dt2;
+
+    // Update with the position measurement
+    float innovation = measurement - axis.position;
+    float s = p00 + measurementNoise;
+    float k0 = p00 / s;
+    float k1 = p01 / s;
+
+    axis.position += k0 * innovation;
+    axis.velocity += k1 * innovation;
+    axis.p00 = (1.0f - k0) * p00;
+    axis.p01 = (1.0f - k0) * p01;
+    axis.p11 = p11 - k1 * p01;
+}
+
+void KalmanFilter::Process(GazeSample &sample) {
+    if (!initialized) {
+        axes[0] = {sample.position.x, 0.0f, measurementNoise, 0.0f, 1.0f};
+        axes[1] = {sample.position.y, 0.0f, measurementNoise, 0.0f, 1.0f};
+        lastTimestamp = sample.captureTime;
+        initialized = true;
+        return;
+    }
+
+    float dt = DeltaSeconds(lastTimestamp, sample.captureTime);
+    lastTimestamp = sample.captureTime;
+
+    Step(axes[0], sample.position.x, dt);
+    Step(axes[1], sample.position.y, dt);
+    sample.position = {axes[0].position, axes[1].position};
+}
+
+void KalmanFilter::Reset() {
+    initialized = false;
+}
+
+// FixationClassifier
+
+FixationClassifier::FixationClassifier(GazeFilterType classifierMethod)
+    : method(classifierMethod), saccadeVelocityThreshold(1.5f), pursuitVelocityThreshold(0.1f),
+    dispersionThreshold(0.02f), dispersionWindowUs(100000), window{}, windowCount(0), windowHead(0),
+    state(EyeMovementState::FIXATION) {
+}
+
+void FixationClassifier::Configure(const GazeFilterSettings &settings) {
+    saccadeVelocityThreshold = settings.saccadeVelocityThreshold;
+    pursuitVelocityThreshold = settings.pursuitVelocityThreshold;
+    dispersionThreshold = settings.dispersionThreshold;
+    dispersionWindowUs = static_cast<uint64_t>(fmaxf(settings.dispersionWindowMs, 1.0f) * 1000.0f);
+}
+
+void FixationClassifier::Process(GazeSample &sample) {
+    if (method == GazeFilterType::FIXATION_IDT) {
+        ClassifyByDispersion(sample);
+    } else {
+        ClassifyByVelocity(sample);
+    }
+
+    window[windowHead] = sample;
+    windowHead = (windowHead + 1) % WINDOW_SIZE;
+    if (windowCount < WINDOW_SIZE) {
+        ++windowCount;
+    }
+}
+
+void FixationClassifier::ClassifyByVelocity(const GazeSample &sample) {
+    if (windowCount == 0) {
+        return;
+    }
+
+    const GazeSample &previous = window[(windowHead - 1 + WINDOW_SIZE) % WINDOW_SIZE];
+    float dt = DeltaSeconds(previous.captureTime, sample.captureTime);
+    float dx = sample.position.x - previous.position.x;
+    float dy = sample.position.y - previous.position.y;
+    float speed = sqrtf(dx * dx + dy * dy) / dt;
+
+    if (speed > saccadeVelocityThreshold) {
+        state = EyeMovementState::SACCADE;
+    } else if (speed > pursuitVelocityThreshold) {
+        state = EyeMovementState::PURSUIT;
+    } else {
+        state = EyeMovementState::FIXATION;
+    }
+}
+
+void FixationClassifier::ClassifyByDispersion(const GazeSample &sample) {
+    // Dispersion of the window ending at this sample: (max x - min x) + (max y - min y)
+    Vector2 low = sample.position;
+    Vector2 high = sample.position;
+    for (int age = 0; age < windowCount; ++age) {
+        const GazeSample &older = window[(windowHead - 1 - age + WINDOW_SIZE) % WINDOW_SIZE];
+        if (sample.captureTime - older.captureTime > dispersionWindowUs) {
+            break;
+        }
+        low.x = fminf(low.x, older.position.x);
+        low.y = fminf(low.y, older.position.y);
+        high.x = fmaxf(high.x, older.position.x);
+        high.y = fmaxf(high.y, older.position.y);
+    }
+
+    float dispersion = (high.x - low.x) + (high.y - low.y);
+    state = dispersion <= dispersionThreshold ? EyeMovementState::FIXATION : EyeMovementState::SACCADE;
+}
+
+void FixationClassifier::Reset() {
+    windowCount = 0;
+    windowHead = 0;
+    state = EyeMovementState::FIXATION;
+}
+
+// GazeFilterChain
+
+GazeFilterChain::GazeFilterChain()
+    : velocityClassifier(GazeFilterType::FIXATION_IVT), dispersionClassifier(GazeFilterType::FIXATION_IDT),
+    stages{}, stageCount(0), holdsDeadZone(false), classifier(nullptr) {
+    // Legacy behaviour: a plain dead zone
+    GazeFilterType defaultStage = GazeFilterType::DEAD_ZONE;
+    SetStages(&defaultStage, 1);
+    Configure(GetDefaultSettings());
+}
+
+GazeFilterChain::~GazeFilterChain() {
+}
+
+GazeFilterSettings GazeFilterChain::GetDefaultSettings() {
+    GazeFilterSettings settings = {};
+    settings.deadZoneThreshold = 0.05f;
+    settings.oneEuroMinCutoff = 1.0f;
+    settings.oneEuroBeta = 0.5f;
+    settings.oneEuroDerivateCutoff = 1.0f;
+    settings.kalmanProcessNoise = 50.0f;
+    settings.kalmanMeasurementNoise = 1e-4f;
+    settings.saccadeVelocityThreshold = 1.5f;
+    settings.pursuitVelocityThreshold = 0.1f;
+    settings.dispersionThreshold = 0.02f;
+    settings.dispersionWindowMs = 100.0f;
+    return settings;
+}
+
+GazeFilter *GazeFilterChain::GetFilter(GazeFilterType type) {
+    switch (type) {
+    case GazeFilterType::DEAD_ZONE:
+        return &deadZone;
+    case GazeFilterType::ONE_EURO:
+        return &oneEuro;
+    case GazeFilterType::KALMAN:
+        return &kalman;
+    case GazeFilterType::FIXATION_IVT:
+        return &velocityClassifier;
+    case GazeFilterType::FIXATION_IDT:
+        return &dispersionClassifier;
+    default:
+        return nullptr;
+    }
+}
+
+void GazeFilterChain::SetStages(const GazeFilterType *types, int count) {
+    stageCount = 0;
+    holdsDeadZone = false;
+    classifier = nullptr;
+
+    for (int i = 0; i < count && stageCount < MAX_STAGES; ++i) {
+        GazeFilter *filter = GetFilter(types[i]);
+        bool duplicate = false;
+        for (int j = 0; j < stageCount; ++j) {
+            duplicate = duplicate || stages[j] == filter;
+        }
+        if (!filter || duplicate) {
+            continue;
+        }
+
+        filter->Reset();
+        if (filter == &deadZone) {
+            holdsDeadZone = true;
+            continue;
+        }
+        stages[stageCount++] = filter;
+        if (types[i] == GazeFilterType::FIXATION_IVT || types[i] == GazeFilterType::FIXATION_IDT) {
+            classifier = static_cast<FixationClassifier *>(filter);
+        }
+    }
+}
+
+void GazeFilterChain::Configure(const GazeFilterSettings &settings) {
+    deadZone.Configure(settings);
+    oneEuro.Configure(settings);
+    kalman.Configure(settings);
+    velocityClassifier.Configure(settings);
+    dispersionClassifier.Configure(settings);
+}
+
+void GazeFilterChain::Process(GazeSample &sample) {
+    for (int i = 0; i < stageCount; ++i) {
+        stages[i]->Process(sample);
+    }
+}
+
+void GazeFilterChain::Hold(Vector2 &position, uint64_t timestamp) {
+    if (!holdsDeadZone) {
+        return;
+    }
+
+    GazeSample sample = {};
+    sample.position = position;
+    sample.captureTime = timestamp;
+    deadZone.Process(sample);
+    position = sample.position;
+}
+
+void GazeFilterChain::Reset() {
+    for (int i = 0; i < stageCount; ++i) {
+        stages[i]->Reset();
+    }
+    deadZone.Reset();
+}
+
+EyeMovementState GazeFilterChain::GetState() const {
+    return classifier ? classifier->GetState() : EyeMovementState::FIXATION;
+}
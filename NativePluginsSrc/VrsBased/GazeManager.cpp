@@ -1,89 +1,192 @@
 #include "GazeManager.h"
+#include "Clock.h"
 #include "Utils.h"
 
 // Constructor
 GazeManager::GazeManager()
-    : gazeHandler(nullptr), gazePos{0.0f, 0.0f}, gazeStabilityThreshold(0.05f) {
+    : stereoRequested(false), stereoActive(false), filterConfigDirty(false), pendingFilterStages{}, pendingFilterStageCount(0),
+    pendingFilterSettings(GazeFilterChain::GetDefaultSettings()), eyeMovementState(0),
+    latchTime(0), lastGazeDataTimestamp(0), traceWriter(nullptr) {
+    for (GazeChannel &channel : channels) {
+        channel.sampleCursor = 0;
+        channel.latchedSample = {};
+        channel.gazePos = {0.0f, 0.0f};
+    }
+    for (ViewFrustum &frustum : viewFrusta) {
+        frustum = {-1.0f, 1.0f, 1.0f, -1.0f};
+    }
+    ConfigurePrediction(channels[0].predictor.GetSettings());
 }
 
 // Destructor
 GazeManager::~GazeManager() {
-    Release();
 }
 
-bool GazeManager::Initialize(ID3D11Device *device, float tanHalfHorizontalFov, float tanHalfVerticalFov) {
-    NV_GAZE_HANDLER_INIT_PARAMS gazeInitParams = {};
-    gazeInitParams.version = NV_GAZE_HANDLER_INIT_PARAMS_VER;
-    gazeInitParams.GazeDataDeviceId = 0;
-    gazeInitParams.GazeDataType = NV_GAZE_DATA_MONO;  // Mono mode
-    gazeInitParams.fHorizontalFOV = tanHalfHorizontalFov;
-    gazeInitParams.fVericalFOV = tanHalfVerticalFov;
-    gazeInitParams.ppNvGazeHandler = &gazeHandler;
+void GazeManager::Initialize(float tanHalfHorizontalFov, float tanHalfVerticalFov, bool stereo) {
+    stereoRequested.store(stereo, std::memory_order_relaxed);
 
-    NvAPI_Status status = NvAPI_D3D_InitializeNvGazeHandler(device, &gazeInitParams);
-    return (status == NVAPI_OK);
+    // Symmetric frusta until the application provides per-eye ones
+    for (int eye = 0; eye < EYE_COUNT; ++eye) {
+        viewFrusta[eye] = {-tanHalfHorizontalFov, tanHalfHorizontalFov, tanHalfVerticalFov, -tanHalfVerticalFov};
+    }
 }
 
-void GazeManager::UpdateGazeDirection(const Vector3 &gazeDirNormalized, float tanHalfHorizontalFov, float tanHalfVerticalFov, float stabilityThreshold) {
-    gazeStabilityThreshold = stabilityThreshold;
-
-    Vector2 newGaze = CalculateNormalizedGaze(gazeDirNormalized, tanHalfHorizontalFov, tanHalfVerticalFov);
+void GazeManager::ConfigureViewFrustum(Eye eye, const ViewFrustum &frustum) {
+    // Degenerate frusta would divide by zero when projecting
+    if (frustum.tanRight - frustum.tanLeft > 1e-4f && frustum.tanUp - frustum.tanDown > 1e-4f) {
+        viewFrusta[static_cast<int>(eye) & 1] = frustum;
+    }
+}
 
-    HasGazeChanged(&gazePos, newGaze, gazeStabilityThreshold);
+void GazeManager::ConfigurePrediction(const GazePredictionSettings &settings) {
+    predictionEnabled.store(settings.enabled, std::memory_order_relaxed);
+    predictionLatencyMs.store(Clamp(settings.latencyMs, 0.0f, 200.0f), std::memory_order_relaxed);
+    saccadeVelocityThreshold.store((std::max)(settings.saccadeVelocityThreshold, 0.0f), std::memory_order_relaxed);
+    fixationVelocityThreshold.store((std::max)(settings.fixationVelocityThreshold, 0.0f), std::memory_order_relaxed);
+    maxPredictionDistance.store((std::max)(settings.maxPredictionDistance, 0.0f), std::memory_order_relaxed);
 }
 
-bool GazeManager::RefreshGazeData(ID3D11DeviceContext *deviceContext) {
-    if (gazeHandler) {
-        static unsigned long long gazeTimestamp = 0;
+void GazeManager::ConfigureFilters(const GazeFilterType *types, int count, const GazeFilterSettings &settings) {
+    std::lock_guard<std::mutex> lock(filterConfigMutex);
+    pendingFilterStageCount = Clamp(count, 0, GazeFilterChain::MAX_STAGES);
+    for (int i = 0; i < pendingFilterStageCount; ++i) {
+        pendingFilterStages[i] = types[i];
+    }
+    pendingFilterSettings = settings;
+    filterConfigDirty.store(true, std::memory_order_release);
+}
 
-        NV_FOVEATED_RENDERING_UPDATE_GAZE_DATA_PARAMS gazeDataParams = {};
-        gazeDataParams.version = NV_FOVEATED_RENDERING_UPDATE_GAZE_DATA_PARAMS_VER;
-        gazeDataParams.Timestamp = ++gazeTimestamp;
+void GazeManager::ApplyPendingFilterConfiguration() {
+    if (!filterConfigDirty.load(std::memory_order_acquire)) {
+        return;
+    }
 
-        // Update Gaze Data
-        gazeDataParams.sMonoData.version = NV_FOVEATED_RENDERING_GAZE_DATA_PER_EYE_VER;
-        gazeDataParams.sMonoData.fGazeNormalizedLocation[0] = gazePos.x;
-        gazeDataParams.sMonoData.fGazeNormalizedLocation[1] = gazePos.y;
-        gazeDataParams.sMonoData.GazeDataValidityFlags = NV_GAZE_LOCATION_VALID;
+    // Retry on a later refresh rather than stall the render thread
+    std::unique_lock<std::mutex> lock(filterConfigMutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+        for (GazeChannel &channel : channels) {
+            channel.filterChain.SetStages(pendingFilterStages, pendingFilterStageCount);
+            channel.filterChain.Configure(pendingFilterSettings);
+        }
+        filterConfigDirty.store(false, std::memory_order_relaxed);
+    }
+}
 
-        // Send Gaze Data to NVidia VRS Handler
-        NvAPI_Status status = gazeHandler->UpdateGazeData(deviceContext, &gazeDataParams);
-        return (status == NVAPI_OK);
+void GazeManager::UpdateGazeDirection(const Vector3 &gazeDirNormalized) {
+    // Managed updaters do not report capture time, the sample is as old as its arrival
+    uint64_t now = GetTimestampMicroseconds();
+    for (int eye = 0; eye < EYE_COUNT; ++eye) {
+        PushSample(eye, CalculateNormalizedGaze(gazeDirNormalized, viewFrusta[eye]), now, now, eye == 0);
     }
+}
+
+void GazeManager::UpdateStereoGazeDirection(const Vector3 &leftGazeDir, const Vector3 &rightGazeDir) {
+    uint64_t now = GetTimestampMicroseconds();
+    PushSample(0, CalculateNormalizedGaze(leftGazeDir, viewFrusta[0]), now, now, true);
+    PushSample(1, CalculateNormalizedGaze(rightGazeDir, viewFrusta[1]), now, now, true);
+}
 
-    return false;
+void GazeManager::UpdateGazeScreenPosition(const Vector2 &screenPos, uint64_t captureTime, uint64_t receiveTime) {
+    // Screen trackers report a single point, both eyes look at it
+    Vector2 gaze = {-screenPos.x / 2.0f, screenPos.y / 2.0f};
+    for (int eye = 0; eye < EYE_COUNT; ++eye) {
+        PushSample(eye, gaze, captureTime, receiveTime, eye == 0);
+    }
 }
 
-void GazeManager::CommitGazeData(ID3DNvVRSHelper *vrsHelper, ID3D11DeviceContext *deviceContext) {
-    if (vrsHelper && deviceContext) {
-        NV_VRS_HELPER_LATCH_GAZE_PARAMS latchParams = {};
-        latchParams.version = NV_VRS_HELPER_LATCH_GAZE_PARAMS_VER;
+void GazeManager::PushSample(int eye, const Vector2 &gaze, uint64_t captureTime, uint64_t receiveTime, bool record) {
+    channels[eye].samples.Push(gaze, captureTime, receiveTime);
+    if (record && traceWriter) {
+        traceWriter->RecordGaze(captureTime, static_cast<Eye>(eye), gaze);
+    }
+}
 
-        NvAPI_Status status = vrsHelper->LatchGaze(deviceContext, &latchParams);
+bool GazeManager::RefreshChannel(GazeChannel &channel, const GazePredictionSettings &settings, uint64_t photonTime, uint64_t latchNow) {
+    channel.predictor.Configure(settings);
+
+    // Smooth every sample published since the last latch and feed it to the predictor
+    GazeSample samples[GazeSampleRing::CAPACITY];
+    size_t count = channel.samples.ReadSince(channel.sampleCursor, samples, GazeSampleRing::CAPACITY);
+    for (size_t i = 0; i < count; ++i) {
+        if (&channel == &channels[0]) {
+            latencyStats.Record(LatencyStage::CAPTURE_TO_RECEIVE, samples[i].captureTime, samples[i].receiveTime);
+        }
+        channel.filterChain.Process(samples[i]);
+        channel.predictor.AddSample(samples[i]);
     }
+    if (count > 0) {
+        channel.latchedSample = samples[count - 1];
+        if (&channel == &channels[0]) {
+            latchTime = latchNow;
+            latencyStats.Record(LatencyStage::RECEIVE_TO_LATCH, channel.latchedSample.receiveTime, latchTime);
+        }
+    }
+
+    // Extrapolate to the time the frame reaches the display, then hold small moves of the result
+    channel.gazePos = channel.predictor.Predict(photonTime);
+    channel.filterChain.Hold(channel.gazePos, photonTime);
+    return count > 0;
 }
 
-Vector2 GazeManager::CalculateNormalizedGaze(const Vector3 &gazeDirNormalized, float tanHalfHorizontalFov, float tanHalfVerticalFov) {
-    float normalizedX = (gazeDirNormalized.x / gazeDirNormalized.z) / tanHalfHorizontalFov;
-    float normalizedY = (gazeDirNormalized.y / gazeDirNormalized.z) / tanHalfVerticalFov;
+bool GazeManager::RefreshGazeData(VrsGazeFrame &gazeFrame) {
+    ApplyPendingFilterConfiguration();
+    stereoActive = stereoRequested.load(std::memory_order_acquire);
+
+    GazePredictionSettings settings = {
+        predictionEnabled.load(std::memory_order_relaxed),
+        predictionLatencyMs.load(std::memory_order_relaxed),
+        saccadeVelocityThreshold.load(std::memory_order_relaxed),
+        fixationVelocityThreshold.load(std::memory_order_relaxed),
+        maxPredictionDistance.load(std::memory_order_relaxed)
+    };
+
+    uint64_t now = GetTimestampMicroseconds();
+    uint64_t photonTime = now + static_cast<uint64_t>(settings.latencyMs * 1000.0f);
+    bool latched = RefreshChannel(channels[0], settings, photonTime, now);
+    if (stereoActive) {
+        latched = RefreshChannel(channels[1], settings, photonTime, now) || latched;
+    }
 
-    return {-normalizedX / 2.0f, normalizedY / 2.0f};
+    // Report the more dynamic of the two eyes, a saccade in either eye moves the fovea
+    int state = static_cast<int>(channels[0].filterChain.GetState());
+    if (stereoActive) {
+        state = (std::max)(state, static_cast<int>(channels[1].filterChain.GetState()));
+    }
+    eyeMovementState.store(state, std::memory_order_relaxed);
+
+    // Tag with the capture time of the latched sample, backends only require it to increase
+    lastGazeDataTimestamp = (std::max)(lastGazeDataTimestamp + 1, channels[0].latchedSample.captureTime);
+
+    gazeFrame.positions[0] = channels[0].gazePos;
+    gazeFrame.positions[1] = stereoActive ? channels[1].gazePos : channels[0].gazePos;
+    gazeFrame.stereo = stereoActive;
+    gazeFrame.timestamp = lastGazeDataTimestamp;
+    return latched;
 }
 
-bool GazeManager::HasGazeChanged(Vector2 *current, const Vector2 &newGaze, float threshold) {
-    if (abs(current->x - newGaze.x) <= threshold &&
-        abs(current->y - newGaze.y) <= threshold) {
-        return false;
+void GazeManager::RecordFramePresent() {
+    // Nothing latched yet, or the frame was rendered without gaze
+    if (latchTime == 0) {
+        return;
     }
 
-    current->x = newGaze.x;
-    current->y = newGaze.y;
-    return true;
+    uint64_t presentTime = GetTimestampMicroseconds();
+    latencyStats.Record(LatencyStage::LATCH_TO_PRESENT, latchTime, presentTime);
+    latencyStats.Record(LatencyStage::CAPTURE_TO_PRESENT, channels[0].latchedSample.captureTime, presentTime);
 }
 
-void GazeManager::Release() {
-    if (gazeHandler) {
-        gazeHandler->Release();
-        gazeHandler = nullptr;
+Vector2 GazeManager::GetGazePosition(Eye eye) const {
+    GazeSample sample;
+    if (channels[static_cast<int>(eye) & 1].samples.LatchNewest(sample)) {
+        return sample.position;
     }
+    return {0.0f, 0.0f};
+}
+
+Vector2 GazeManager::CalculateNormalizedGaze(const Vector3 &gazeDirNormalized, const ViewFrustum &frustum) {
+    // Position across the frustum in [0, 1], then centered; x is mirrored as in the NVAPI samples
+    float fractionX = (gazeDirNormalized.x / gazeDirNormalized.z - frustum.tanLeft) / (frustum.tanRight - frustum.tanLeft);
+    float fractionY = (gazeDirNormalized.y / gazeDirNormalized.z - frustum.tanDown) / (frustum.tanUp - frustum.tanDown);
+
+    return {0.5f - fractionX, fractionY - 0.5f};
 }
@@ -0,0 +1,188 @@
+#include "GazePredictor.h"
+#include <cmath>
+
+// Constructor
+GazePredictor::GazePredictor()
+    : settings{false, 30.0f, 1.5f, 0.1f, 0.25f}, history{}, historyCount(0), historyHead(0),
+    state(EyeMovementState::FIXATION), velocity{0.0f, 0.0f}, acceleration{0.0f, 0.0f},
+    saccadeOnset{0.0f, 0.0f}, saccadePeakPosition{0.0f, 0.0f}, saccadePeakSpeed(0.0f), saccadeDecelerating(false) {
+}
+
+// Destructor
+GazePredictor::~GazePredictor() {
+}
+
+void GazePredictor::Configure(const GazePredictionSettings &newSettings) {
+    settings = newSettings;
+}
+
+void GazePredictor::Reset() {
+    historyCount = 0;
+    historyHead = 0;
+    state = EyeMovementState::FIXATION;
+    velocity = {0.0f, 0.0f};
+    acceleration = {0.0f, 0.0f};
+}
+
+const GazeSample &GazePredictor::GetSample(int age) const {
+    return history[(historyHead - 1 - age + HISTORY_SIZE) % HISTORY_SIZE];
+}
+
+void GazePredictor::AddSample(const GazeSample &sample) {
+    // A long gap means tracking was lost, old motion is meaningless
+    if (historyCount > 0 && sample.captureTime - GetSample(0).captureTime > 4 * FIT_WINDOW_US) {
+        Reset();
+    }
+
+    Vector2 previous = historyCount > 0 ? GetSample(0).position : sample.position;
+
+    history[historyHead] = sample;
+    historyHead = (historyHead + 1) % HISTORY_SIZE;
+    if (historyCount < HISTORY_SIZE) {
+        ++historyCount;
+    }
+
+    if (!FitMotion(velocity, acceleration)) {
+        velocity = {0.0f, 0.0f};
+        acceleration = {0.0f, 0.0f};
+    }
+
+    float speed = sqrtf(velocity.x * velocity.x + velocity.y * velocity.y);
+    EyeMovementState previousState = state;
+    if (previousState != EyeMovementState::SACCADE && speed > settings.saccadeVelocityThreshold) {
+        saccadeOnset = previous;
+        saccadePeakSpeed = 0.0f;
+        saccadeDecelerating = false;
+    }
+    UpdateState(speed);
+
+    // Samples from inside the saccade would corrupt the post-saccadic fit
+    if (previousState == EyeMovementState::SACCADE && state != EyeMovementState::SACCADE) {
+        historyCount = 1;
+        velocity = {0.0f, 0.0f};
+        acceleration = {0.0f, 0.0f};
+        state = EyeMovementState::FIXATION;
+    }
+}
+
+void GazePredictor::UpdateState(float speed) {
+    if (speed > settings.saccadeVelocityThreshold) {
+        state = EyeMovementState::SACCADE;
+    } else if (state == EyeMovementState::SACCADE && speed > 0.5f * settings.saccadeVelocityThreshold) {
+        // Hysteresis: stay in saccade until the eye clearly slowed down
+    } else if (speed > settings.fixationVelocityThreshold) {
+        state = EyeMovementState::PURSUIT;
+    } else {
+        state = EyeMovementState::FIXATION;
+    }
+
+    if (state == EyeMovementState::SACCADE) {
+        if (speed >= saccadePeakSpeed) {
+            saccadePeakSpeed = speed;
+            saccadePeakPosition = GetSample(0).position;
+        } else {
+            saccadeDecelerating = true;
+        }
+    }
+}
+
+bool GazePredictor::FitMotion(Vector2 &fitVelocity, Vector2 &fitAcceleration) const {
+    if (historyCount < 3) {
+        return false;
+    }
+
+    // Fit p(t) = p0 + v t + a t^2 / 2 with t relative to the newest sample (in seconds)
+    const GazeSample &newest = GetSample(0);
+    double s[5] = {0.0, 0.0, 0.0, 0.0, 0.0};  // Sums of t^k
+    double bx[3] = {0.0, 0.0, 0.0};
+    double by[3] = {0.0, 0.0, 0.0};
+    int count = 0;
+
+    for (int age = 0; age < historyCount; ++age) {
+        const GazeSample &sample = GetSample(age);
+        if (newest.captureTime - sample.captureTime > FIT_WINDOW_US) {
+            break;
+        }
+
+        double t = -static_cast<double>(newest.captureTime - sample.captureTime) * 1e-6;
+        double tk = 1.0;
+        for (int k = 0; k < 5; ++k) {
+            s[k] += tk;
+            if (k < 3) {
+                bx[k] += tk * sample.position.x;
+                by[k] += tk * sample.position.y;
+            }
+            tk *= t;
+        }
+        ++count;
+    }
+
+    if (count < 3) {
+        return false;
+    }
+
+    // Normal equations, solved with Cramer's rule
+    double m[3][3] = {{s[0], s[1], s[2]}, {s[1], s[2], s[3]}, {s[2], s[3], s[4]}};
+    auto det3 = [](const double a[3][3]) {
+        return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1]) -
+               a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0]) +
+               a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+    };
+
+    double det = det3(m);
+    if (fabs(det) < 1e-18) {
+        return false;
+    }
+
+    double coefficients[2][3];
+    const double *rhs[2] = {bx, by};
+    for (int axis = 0; axis < 2; ++axis) {
+        for (int column = 0; column < 3; ++column) {
+            double replaced[3][3];
+            for (int r = 0; r < 3; ++r) {
+                for (int c = 0; c < 3; ++c) {
+                    replaced[r][c] = (c == column) ? rhs[axis][r] : m[r][c];
+                }
+            }
+            coefficients[axis][column] = det3(replaced) / det;
+        }
+    }
+
+    fitVelocity = {static_cast<float>(coefficients[0][1]), static_cast<float>(coefficients[1][1])};
+    fitAcceleration = {static_cast<float>(2.0 * coefficients[0][2]), static_cast<float>(2.0 * coefficients[1][2])};
+    return true;
+}
+
+Vector2 GazePredictor::Predict(uint64_t targetTime) const {
+    if (historyCount == 0) {
+        return {0.0f, 0.0f};
+    }
+
+    const GazeSample &newest = GetSample(0);
+    if (!settings.enabled || state == EyeMovementState::FIXATION) {
+        return newest.position;
+    }
+
+    float dt = targetTime > newest.captureTime ? static_cast<float>(targetTime - newest.captureTime) * 1e-6f : 0.0f;
+    Vector2 offset = {0.0f, 0.0f};
+
+    if (state == EyeMovementState::SACCADE && saccadeDecelerating) {
+        // Symmetric profile: landing point mirrors the onset around the peak velocity position
+        Vector2 landing = {2.0f * saccadePeakPosition.x - saccadeOnset.x, 2.0f * saccadePeakPosition.y - saccadeOnset.y};
+        offset = {landing.x - newest.position.x, landing.y - newest.position.y};
+    } else if (state == EyeMovementState::SACCADE) {
+        // Still accelerating, the acceleration term would overshoot wildly
+        offset = {velocity.x * dt, velocity.y * dt};
+    } else {
+        offset = {velocity.x * dt + 0.5f * acceleration.x * dt * dt, velocity.y * dt + 0.5f * acceleration.y * dt * dt};
+    }
+
+    float distance = sqrtf(offset.x * offset.x + offset.y * offset.y);
+    if (distance > settings.maxPredictionDistance && distance > 0.0f) {
+        float scale = settings.maxPredictionDistance / distance;
+        offset.x *= scale;
+        offset.y *= scale;
+    }
+
+    return {newest.position.x + offset.x, newest.position.y + offset.y};
+}
@@ -0,0 +1,219 @@
+// Socket headers must come before windows.h pulled in by GazeManager.h
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "GazeReceiver.h"
+#include "Clock.h"
+#include "GazeManager.h"
+
+#ifdef _WIN32
+static const intptr_t INVALID_SOCKET_HANDLE = static_cast<intptr_t>(INVALID_SOCKET);
+static void CloseSocket(intptr_t handle) { closesocket(static_cast<SOCKET>(handle)); }
+#else
+static const intptr_t INVALID_SOCKET_HANDLE = -1;
+static void CloseSocket(intptr_t handle) { close(static_cast<int>(handle)); }
+#endif
+
+// Constructor
+GazeReceiver::GazeReceiver()
+    : gazeManager(nullptr), running(false), socketHandle(INVALID_SOCKET_HANDLE), sizes{}, lastSequence(0),
+    hasSequence(false), packetsReceived(0), packetsRejected(0), batches(0), foreignClockPackets(0) {
+}
+
+// Destructor
+GazeReceiver::~GazeReceiver() {
+    Stop();
+}
+
+bool GazeReceiver::Start(uint16_t port, GazeManager *target) {
+    if (IsRunning() || !target) {
+        return false;
+    }
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        return false;
+    }
+    SOCKET handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle == INVALID_SOCKET) {
+        WSACleanup();
+        return false;
+    }
+    u_long nonBlocking = 1;
+    ioctlsocket(handle, FIONBIO, &nonBlocking);
+#else
+    int handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle < 0) {
+        return false;
+    }
+#endif
+
+    // Room for bursts from 1 kHz trackers while the thread is descheduled
+    int bufferSize = 1 << 20;
+    setsockopt(handle, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char *>(&bufferSize), sizeof(bufferSize));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (bind(handle, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        CloseSocket(static_cast<intptr_t>(handle));
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+
+    socketHandle = static_cast<intptr_t>(handle);
+    gazeManager = target;
+    hasSequence = false;
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&GazeReceiver::Run, this);
+    return true;
+}
+
+void GazeReceiver::Stop() {
+    if (!running.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    // The thread notices the flag within one receive timeout
+    if (thread.joinable()) {
+        thread.join();
+    }
+
+    CloseSocket(socketHandle);
+    socketHandle = INVALID_SOCKET_HANDLE;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+GazeReceiverStats GazeReceiver::GetStats() const {
+    GazeReceiverStats stats = {};
+    stats.packetsReceived = packetsReceived.load(std::memory_order_relaxed);
+    stats.packetsRejected = packetsRejected.load(std::memory_order_relaxed);
+    stats.batches = batches.load(std::memory_order_relaxed);
+    stats.foreignClockPackets = foreignClockPackets.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void GazeReceiver::Run() {
+    while (running.load(std::memory_order_acquire)) {
+        int count = ReceiveBatch(50);
+        if (count <= 0) {
+            continue;
+        }
+
+        batches.fetch_add(1, std::memory_order_relaxed);
+        for (int i = 0; i < count; ++i) {
+            GazePacket packet;
+            if (DecodeGazePacket(buffers[i], sizes[i], packet)) {
+                Consume(packet);
+            } else {
+                packetsRejected.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+#ifdef _WIN32
+int GazeReceiver::ReceiveBatch(int timeoutMs) {
+    SOCKET handle = static_cast<SOCKET>(socketHandle);
+
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(handle, &readSet);
+    timeval timeout = {0, timeoutMs * 1000};
+    if (select(0, &readSet, nullptr, nullptr, &timeout) <= 0) {
+        return 0;
+    }
+
+    // No recvmmsg on Windows: drain the non-blocking socket until it would block
+    int count = 0;
+    while (count < BATCH_SIZE) {
+        int received = recv(handle, reinterpret_cast<char *>(buffers[count]), sizeof(buffers[count]), 0);
+        if (received == SOCKET_ERROR) {
+            // WSAEMSGSIZE: oversized foreign datagram, keep draining
+            if (WSAGetLastError() != WSAEMSGSIZE) {
+                break;
+            }
+            received = sizeof(buffers[count]);
+        }
+        sizes[count++] = static_cast<size_t>(received);
+    }
+    return count;
+}
+#else
+int GazeReceiver::ReceiveBatch(int timeoutMs) {
+    int handle = static_cast<int>(socketHandle);
+
+    pollfd descriptor = {handle, POLLIN, 0};
+    if (poll(&descriptor, 1, timeoutMs) <= 0) {
+        return 0;
+    }
+
+#ifdef __linux__
+    mmsghdr messages[BATCH_SIZE] = {};
+    iovec vectors[BATCH_SIZE];
+    for (int i = 0; i < BATCH_SIZE; ++i) {
+        vectors[i] = {buffers[i], sizeof(buffers[i])};
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int count = recvmmsg(handle, messages, BATCH_SIZE, MSG_DONTWAIT, nullptr);
+    for (int i = 0; i < count; ++i) {
+        // Truncated datagrams are rejected by the decoder through their size
+        sizes[i] = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) ? 0 : messages[i].msg_len;
+    }
+    return count;
+#else
+    int count = 0;
+    while (count < BATCH_SIZE) {
+        ssize_t received = recv(handle, buffers[count], sizeof(buffers[count]), MSG_DONTWAIT);
+        if (received < 0) {
+            break;
+        }
+        sizes[count++] = static_cast<size_t>(received);
+    }
+    return count;
+#endif
+}
+#endif
+
+void GazeReceiver::Consume(const GazePacket &packet) {
+    // Drop stale packets reordered by the network, tolerating sequence wrap-around.
+    // A large backwards jump means the sender restarted.
+    int32_t delta = static_cast<int32_t>(packet.sequence - lastSequence);
+    bool stale = hasSequence && delta <= 0 && delta > -SEQUENCE_RESTART_GAP;
+    if (!packet.valid || stale) {
+        packetsRejected.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    lastSequence = packet.sequence;
+    hasSequence = true;
+    packetsReceived.fetch_add(1, std::memory_order_relaxed);
+
+    // Trust the sender's capture time only if it is on our monotonic clock
+    uint64_t receiveTime = GetTimestampMicroseconds();
+    uint64_t captureTime = packet.captureTimestampUs;
+    if (captureTime == 0 || captureTime > receiveTime || receiveTime - captureTime > MAX_CAPTURE_AGE_US) {
+        captureTime = receiveTime;
+        foreignClockPackets.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    gazeManager->UpdateGazeScreenPosition({packet.x, packet.y}, captureTime, receiveTime);
+}
@@ -0,0 +1,90 @@
+#include "GazeSampleRing.h"
+
+static_assert((GazeSampleRing::CAPACITY & (GazeSampleRing::CAPACITY - 1)) == 0, "Capacity must be a power of two");
+
+// Constructor
+GazeSampleRing::GazeSampleRing()
+    : head(0) {
+    for (Slot &slot : slots) {
+        slot.version.store(0, std::memory_order_relaxed);
+        slot.x.store(0.0f, std::memory_order_relaxed);
+        slot.y.store(0.0f, std::memory_order_relaxed);
+        slot.captureTime.store(0, std::memory_order_relaxed);
+        slot.receiveTime.store(0, std::memory_order_relaxed);
+    }
+}
+
+// Destructor
+GazeSampleRing::~GazeSampleRing() {
+}
+
+void GazeSampleRing::Push(const Vector2 &position, uint64_t captureTime, uint64_t receiveTime) {
+    uint64_t index = head.load(std::memory_order_relaxed);
+    Slot &slot = slots[index & (CAPACITY - 1)];
+
+    slot.version.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.x.store(position.x, std::memory_order_relaxed);
+    slot.y.store(position.y, std::memory_order_relaxed);
+    slot.captureTime.store(captureTime, std::memory_order_relaxed);
+    slot.receiveTime.store(receiveTime, std::memory_order_relaxed);
+
+    slot.version.store(2 * index + 2, std::memory_order_release);
+    head.store(index + 1, std::memory_order_release);
+}
+
+bool GazeSampleRing::LatchNewest(GazeSample &sample) const {
+    for (;;) {
+        uint64_t published = head.load(std::memory_order_acquire);
+        if (published == 0) {
+            return false;
+        }
+
+        // Only fails if the producer lapped the whole ring meanwhile, retry with the new head
+        if (TryRead(published - 1, sample)) {
+            return true;
+        }
+    }
+}
+
+size_t GazeSampleRing::ReadSince(uint64_t &cursor, GazeSample *samples, size_t maxCount) const {
+    uint64_t published = head.load(std::memory_order_acquire);
+
+    // Older samples are gone, and only the newest maxCount are wanted anyway
+    uint64_t first = cursor;
+    if (published - first > CAPACITY) {
+        first = published - CAPACITY;
+    }
+    if (published - first > maxCount) {
+        first = published - maxCount;
+    }
+
+    size_t count = 0;
+    for (uint64_t index = first; index < published; ++index) {
+        if (TryRead(index, samples[count])) {
+            ++count;
+        }
+    }
+
+    cursor = published;
+    return count;
+}
+
+bool GazeSampleRing::TryRead(uint64_t index, GazeSample &sample) const {
+    const Slot &slot = slots[index & (CAPACITY - 1)];
+
+    uint64_t before = slot.version.load(std::memory_order_acquire);
+    if (before != 2 * index + 2) {
+        return false;
+    }
+
+    sample.position.x = slot.x.load(std::memory_order_relaxed);
+    sample.position.y = slot.y.load(std::memory_order_relaxed);
+    sample.captureTime = slot.captureTime.load(std::memory_order_relaxed);
+    sample.receiveTime = slot.receiveTime.load(std::memory_order_relaxed);
+    sample.sequence = index;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.version.load(std::memory_order_relaxed) == before;
+}
@@ -0,0 +1,230 @@
+#include "Instrumentation.h"
+#include "Clock.h"
+#include <cstdio>
+
+static_assert((Instrumentation::TRACE_CAPACITY & (Instrumentation::TRACE_CAPACITY - 1)) == 0, "Capacity must be a power of two");
+
+// Event names in the trace, indexed by TraceScope
+static const char *const SCOPE_NAMES[] = {
+    "HandleEvent",
+    "GazeRefresh",
+    "GazeLatch",
+    "Enable",
+    "Disable"
+};
+static_assert(sizeof(SCOPE_NAMES) / sizeof(SCOPE_NAMES[0]) == static_cast<size_t>(TraceScope::COUNT), "Name every scope");
+
+// Result names in the trace, indexed by VrsResult
+static const char *const RESULT_NAMES[] = {
+    "applied",
+    "skipped",
+    "failed"
+};
+
+// Ring of the current thread and the instance it belongs to
+struct ThreadTraceBuffer {
+    uint64_t instanceId;
+    void *buffer;
+};
+static thread_local ThreadTraceBuffer s_threadBuffer = {0, nullptr};
+static std::atomic<uint64_t> s_nextInstanceId(1);
+
+// Constructor
+Instrumentation::Instrumentation()
+    : lastNativeError(0), tracing(false), instanceId(s_nextInstanceId.fetch_add(1, std::memory_order_relaxed)) {
+    Reset();
+}
+
+// Destructor
+Instrumentation::~Instrumentation() {
+}
+
+Instrumentation::TraceBuffer::TraceBuffer(uint32_t id)
+    : threadId(id), head(0), traceStart(0) {
+    for (Slot &slot : slots) {
+        slot.version.store(0, std::memory_order_relaxed);
+        slot.scopeAndResult.store(0, std::memory_order_relaxed);
+        slot.beginNs.store(0, std::memory_order_relaxed);
+        slot.durationNs.store(0, std::memory_order_relaxed);
+    }
+}
+
+void Instrumentation::TraceBuffer::Push(const TraceEvent &event) {
+    uint64_t index = head.load(std::memory_order_relaxed);
+    Slot &slot = slots[index & (TRACE_CAPACITY - 1)];
+
+    slot.version.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.scopeAndResult.store((static_cast<uint32_t>(event.scope) << 8) | static_cast<uint32_t>(event.result), std::memory_order_relaxed);
+    slot.beginNs.store(event.beginNs, std::memory_order_relaxed);
+    slot.durationNs.store(event.durationNs, std::memory_order_relaxed);
+
+    slot.version.store(2 * index + 2, std::memory_order_release);
+    head.store(index + 1, std::memory_order_release);
+}
+
+bool Instrumentation::TraceBuffer::TryRead(uint64_t index, TraceEvent &event) const {
+    const Slot &slot = slots[index & (TRACE_CAPACITY - 1)];
+
+    uint64_t before = slot.version.load(std::memory_order_acquire);
+    if (before != 2 * index + 2) {
+        return false;
+    }
+
+    uint32_t scopeAndResult = slot.scopeAndResult.load(std::memory_order_relaxed);
+    event.scope = static_cast<TraceScope>(scopeAndResult >> 8);
+    event.result = static_cast<VrsResult>(scopeAndResult & 0xFF);
+    event.beginNs = slot.beginNs.load(std::memory_order_relaxed);
+    event.durationNs = slot.durationNs.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.version.load(std::memory_order_relaxed) == before;
+}
+
+Instrumentation::TraceBuffer *Instrumentation::GetThreadBuffer() {
+    if (s_threadBuffer.instanceId == instanceId) {
+        return static_cast<TraceBuffer *>(s_threadBuffer.buffer);
+    }
+
+    // First event of this thread, the only time recording takes a lock
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffers.emplace_back(new TraceBuffer(static_cast<uint32_t>(buffers.size() + 1)));
+    s_threadBuffer = {instanceId, buffers.back().get()};
+    return buffers.back().get();
+}
+
+void Instrumentation::Record(TraceScope scope, VrsResult result, uint64_t beginNs, uint64_t endNs) {
+    uint64_t durationNs = endNs > beginNs ? endNs - beginNs : 0;
+
+    ScopeCounters &scopeCounters = counters[static_cast<int>(scope)];
+    scopeCounters.calls.fetch_add(1, std::memory_order_relaxed);
+    if (result == VrsResult::FAILED) {
+        scopeCounters.failures.fetch_add(1, std::memory_order_relaxed);
+    } else if (result == VrsResult::SKIPPED) {
+        scopeCounters.skipped.fetch_add(1, std::memory_order_relaxed);
+    }
+    scopeCounters.totalNs.fetch_add(durationNs, std::memory_order_relaxed);
+
+    uint64_t maxNs = scopeCounters.maxNs.load(std::memory_order_relaxed);
+    while (durationNs > maxNs && !scopeCounters.maxNs.compare_exchange_weak(maxNs, durationNs, std::memory_order_relaxed)) {
+    }
+
+    if (tracing.load(std::memory_order_relaxed)) {
+        GetThreadBuffer()->Push({scope, result, beginNs, durationNs});
+    }
+}
+
+void Instrumentation::RecordNativeError(int32_t error) {
+    if (error != 0) {
+        lastNativeError.store(error, std::memory_order_relaxed);
+    }
+}
+
+void Instrumentation::SetTracing(bool enabled) {
+    if (enabled && !tracing.load(std::memory_order_relaxed)) {
+        // Events before this point no longer belong to the trace
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (const std::unique_ptr<TraceBuffer> &buffer : buffers) {
+            buffer->traceStart.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+    }
+    tracing.store(enabled, std::memory_order_relaxed);
+}
+
+InstrumentationStats Instrumentation::GetStats() const {
+    InstrumentationStats stats = {};
+    for (int i = 0; i < static_cast<int>(TraceScope::COUNT); ++i) {
+        stats.scopes[i].calls = counters[i].calls.load(std::memory_order_relaxed);
+        stats.scopes[i].failures = counters[i].failures.load(std::memory_order_relaxed);
+        stats.scopes[i].skipped = counters[i].skipped.load(std::memory_order_relaxed);
+        stats.scopes[i].totalNs = counters[i].totalNs.load(std::memory_order_relaxed);
+        stats.scopes[i].maxNs = counters[i].maxNs.load(std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (const std::unique_ptr<TraceBuffer> &buffer : buffers) {
+            uint64_t recorded = buffer->head.load(std::memory_order_acquire) - buffer->traceStart.load(std::memory_order_relaxed);
+            stats.traceEvents += recorded;
+            stats.traceEventsDropped += recorded > TRACE_CAPACITY ? recorded - TRACE_CAPACITY : 0;
+        }
+    }
+
+    stats.lastNativeError = lastNativeError.load(std::memory_order_relaxed);
+    stats.tracing = tracing.load(std::memory_order_relaxed) ? 1 : 0;
+    return stats;
+}
+
+void Instrumentation::Reset() {
+    for (ScopeCounters &scopeCounters : counters) {
+        scopeCounters.calls.store(0, std::memory_order_relaxed);
+        scopeCounters.failures.store(0, std::memory_order_relaxed);
+        scopeCounters.skipped.store(0, std::memory_order_relaxed);
+        scopeCounters.totalNs.store(0, std::memory_order_relaxed);
+        scopeCounters.maxNs.store(0, std::memory_order_relaxed);
+    }
+    lastNativeError.store(0, std::memory_order_relaxed);
+}
+
+int Instrumentation::WriteChromeTrace(const char *path) const {
+    if (!path) {
+        return -1;
+    }
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        return -1;
+    }
+
+    int events = 0;
+    const char *separator = "";
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (const std::unique_ptr<TraceBuffer> &buffer : buffers) {
+        fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"VrsBased thread %u\"}}",
+                separator, buffer->threadId, buffer->threadId);
+        separator = ",";
+
+        // Events overwritten since the trace started are skipped
+        uint64_t published = buffer->head.load(std::memory_order_acquire);
+        uint64_t first = buffer->traceStart.load(std::memory_order_relaxed);
+        if (published - first > TRACE_CAPACITY) {
+            first = published - TRACE_CAPACITY;
+        }
+
+        TraceEvent event;
+        for (uint64_t index = first; index < published; ++index) {
+            if (!buffer->TryRead(index, event)) {
+                continue;
+            }
+            int scope = static_cast<int>(event.scope);
+            int result = static_cast<int>(event.result);
+            if (scope < 0 || scope >= static_cast<int>(TraceScope::COUNT) || result < 0 || result > static_cast<int>(VrsResult::FAILED)) {
+                continue;
+            }
+
+            // Chrome trace times are microseconds, fractions keep the nanoseconds
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"vrs\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"result\":\"%s\"}}",
+                    SCOPE_NAMES[scope], buffer->threadId, event.beginNs / 1000.0, event.durationNs / 1000.0, RESULT_NAMES[result]);
+            ++events;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    bool failed = ferror(file) != 0;
+    fclose(file);
+    return failed ? -1 : events;
+}
+
+// Constructor
+ScopedTrace::ScopedTrace(Instrumentation *instrumentationPtr, TraceScope traceScope)
+    : instrumentation(instrumentationPtr), scope(traceScope), result(VrsResult::APPLIED), beginNs(GetTimestampNanoseconds()) {
+}
+
+// Destructor
+ScopedTrace::~ScopedTrace() {
+    if (instrumentation) {
+        instrumentation->Record(scope, result, beginNs, GetTimestampNanoseconds());
+    }
+}
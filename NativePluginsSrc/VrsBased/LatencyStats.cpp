@@ -0,0 +1,97 @@
+#include "LatencyStats.h"
+#include <algorithm>
+#include <limits>
+
+// Constructor
+LatencyHistogram::LatencyHistogram() {
+    Reset();
+}
+
+// Destructor
+LatencyHistogram::~LatencyHistogram() {
+}
+
+void LatencyHistogram::Record(uint64_t latencyUs) {
+    // floor(log2(latency + 1)), so 0 us lands in the first bucket
+    int bucket = 0;
+    for (uint64_t value = latencyUs + 1; value > 1 && bucket < BUCKETS - 1; value >>= 1) {
+        ++bucket;
+    }
+
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    sumUs.fetch_add(latencyUs, std::memory_order_relaxed);
+
+    uint64_t current = minUs.load(std::memory_order_relaxed);
+    while (latencyUs < current && !minUs.compare_exchange_weak(current, latencyUs, std::memory_order_relaxed)) {
+    }
+    current = maxUs.load(std::memory_order_relaxed);
+    while (latencyUs > current && !maxUs.compare_exchange_weak(current, latencyUs, std::memory_order_relaxed)) {
+    }
+
+    count.fetch_add(1, std::memory_order_release);
+}
+
+void LatencyHistogram::Reset() {
+    count.store(0, std::memory_order_relaxed);
+    sumUs.store(0, std::memory_order_relaxed);
+    minUs.store((std::numeric_limits<uint64_t>::max)(), std::memory_order_relaxed);
+    maxUs.store(0, std::memory_order_relaxed);
+    for (std::atomic<uint64_t> &bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+LatencySummary LatencyHistogram::Summarize() const {
+    LatencySummary summary = {};
+
+    // Count from the buckets so the percentiles stay consistent with a concurrent writer
+    for (int i = 0; i < BUCKETS; ++i) {
+        summary.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        summary.count += summary.buckets[i];
+    }
+    if (summary.count == 0) {
+        return summary;
+    }
+
+    summary.minUs = minUs.load(std::memory_order_relaxed);
+    summary.maxUs = maxUs.load(std::memory_order_relaxed);
+    summary.meanUs = sumUs.load(std::memory_order_relaxed) / summary.count;
+    summary.p50Us = Quantile(summary, 0.50);
+    summary.p95Us = Quantile(summary, 0.95);
+    summary.p99Us = Quantile(summary, 0.99);
+    return summary;
+}
+
+uint64_t LatencyHistogram::Quantile(const LatencySummary &summary, double quantile) {
+    uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(summary.count - 1)) + 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += summary.buckets[i];
+        if (seen >= rank) {
+            uint64_t upper = (static_cast<uint64_t>(1) << (i + 1)) - 2;
+            return (std::min)((std::max)(upper, summary.minUs), summary.maxUs);
+        }
+    }
+    return summary.maxUs;
+}
+
+void LatencyStats::Record(LatencyStage stage, uint64_t startUs, uint64_t endUs) {
+    if (startUs == 0 || endUs < startUs) {
+        return;
+    }
+    stages[static_cast<int>(stage)].Record(endUs - startUs);
+}
+
+void LatencyStats::Reset() {
+    for (LatencyHistogram &stage : stages) {
+        stage.Reset();
+    }
+}
+
+GazeLatencyStats LatencyStats::Summarize() const {
+    GazeLatencyStats stats = {};
+    for (int i = 0; i < static_cast<int>(LatencyStage::COUNT); ++i) {
+        stats.stages[i] = stages[i].Summarize();
+    }
+    return stats;
+}
@@ -0,0 +1,202 @@
+#include "LodClassifier.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define LOD_CLASSIFIER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Objects closer to the camera plane than this are treated as behind it
+static const float MIN_CLIP_W = 1e-5f;
+
+// Constructor
+LodClassifier::LodClassifier() {
+}
+
+// Destructor
+LodClassifier::~LodClassifier() {
+}
+
+int LodClassifier::Classify(const LodClassifierParams &params, const LodObjectBatch &batch, int32_t *changed, int changedCapacity) {
+    if (batch.count <= 0) {
+        return 0;
+    }
+
+    int chunkCount = (batch.count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (static_cast<int>(chunkChanges.size()) < chunkCount) {
+        chunkChanges.resize(chunkCount);
+    }
+
+    pool.Run(chunkCount, [&](int chunk) {
+        int begin = chunk * CHUNK_SIZE;
+        int end = (std::min)(begin + CHUNK_SIZE, static_cast<int>(batch.count));
+        chunkChanges[chunk].clear();
+        ClassifyRange(params, batch, begin, end, chunkChanges[chunk]);
+    });
+
+    // Merge in chunk order so the changed list stays sorted by index
+    int written = 0;
+    for (int chunk = 0; chunk < chunkCount && written < changedCapacity; ++chunk) {
+        for (const LodChange &change : chunkChanges[chunk]) {
+            if (written == changedCapacity) {
+                break;
+            }
+            batch.lods[change.index] = change.lod;
+            changed[written++] = change.index;
+        }
+    }
+    return written;
+}
+
+void LodClassifier::ClassifyRange(const LodClassifierParams &params, const LodObjectBatch &batch, int begin, int end, std::vector<LodChange> &changes) {
+    const float *m = params.viewProjection;
+
+    // Length of the clip x and y rows, scales a world radius to clip space
+    const float scaleX = sqrtf(m[0] * m[0] + m[4] * m[4] + m[8] * m[8]);
+    const float scaleY = sqrtf(m[1] * m[1] + m[5] * m[5] + m[9] * m[9]);
+
+    // Degenerate ellipses contain nothing
+    const bool fovealEnabled = params.fovealRadii.x > 0.0f && params.fovealRadii.y > 0.0f;
+    const bool midEnabled = params.midFovealRadii.x > 0.0f && params.midFovealRadii.y > 0.0f;
+    const float fovealInvX2 = fovealEnabled ? 1.0f / (params.fovealRadii.x * params.fovealRadii.x) : 0.0f;
+    const float fovealInvY2 = fovealEnabled ? 1.0f / (params.fovealRadii.y * params.fovealRadii.y) : 0.0f;
+    const float midInvX2 = midEnabled ? 1.0f / (params.midFovealRadii.x * params.midFovealRadii.x) : 0.0f;
+    const float midInvY2 = midEnabled ? 1.0f / (params.midFovealRadii.y * params.midFovealRadii.y) : 0.0f;
+
+    // Squared boundary to stay inside a region, to enter it, and for objects without a level
+    const float hysteresis = (std::max)(params.hysteresis, 0.0f);
+    const float stayLimit = (1.0f + hysteresis) * (1.0f + hysteresis);
+    const float enterLimit = (std::max)(1.0f - hysteresis, 0.0f) * (std::max)(1.0f - hysteresis, 0.0f);
+
+    int index = begin;
+#ifdef LOD_CLASSIFIER_SSE2
+    const __m128 m0 = _mm_set1_ps(m[0]), m4 = _mm_set1_ps(m[4]), m8 = _mm_set1_ps(m[8]), m12 = _mm_set1_ps(m[12]);
+    const __m128 m1 = _mm_set1_ps(m[1]), m5 = _mm_set1_ps(m[5]), m9 = _mm_set1_ps(m[9]), m13 = _mm_set1_ps(m[13]);
+    const __m128 m3 = _mm_set1_ps(m[3]), m7 = _mm_set1_ps(m[7]), m11 = _mm_set1_ps(m[11]), m15 = _mm_set1_ps(m[15]);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minW = _mm_set1_ps(MIN_CLIP_W);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 gazeX = _mm_set1_ps(params.gazePos.x);
+    const __m128 gazeY = _mm_set1_ps(params.gazePos.y);
+    const __m128 radiusScaleX = _mm_set1_ps(scaleX);
+    const __m128 radiusScaleY = _mm_set1_ps(scaleY);
+    const __m128 fovealX = _mm_set1_ps(fovealInvX2), fovealY = _mm_set1_ps(fovealInvY2);
+    const __m128 midX = _mm_set1_ps(midInvX2), midY = _mm_set1_ps(midInvY2);
+    const __m128 fovealMask = fovealEnabled ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : zero;
+    const __m128 midMask = midEnabled ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : zero;
+    const __m128 stay = _mm_set1_ps(stayLimit);
+    const __m128 enter = _mm_set1_ps(enterLimit);
+    const __m128 emptyMin = _mm_set1_ps(FLT_MAX);
+    const __m128 emptyMax = _mm_set1_ps(-FLT_MAX);
+    const __m128i zeroi = _mm_setzero_si128();
+    const __m128i twoi = _mm_set1_epi32(2);
+
+    for (; index + 4 <= end; index += 4) {
+        __m128 x = _mm_loadu_ps(batch.positionX + index);
+        __m128 y = _mm_loadu_ps(batch.positionY + index);
+        __m128 z = _mm_loadu_ps(batch.positionZ + index);
+        __m128 r = _mm_loadu_ps(batch.radius + index);
+        __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i *>(batch.lods + index));
+        __m128i coarsest = _mm_loadu_si128(reinterpret_cast<const __m128i *>(batch.coarsestLod + index));
+
+        __m128 clipX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m4, y)), _mm_add_ps(_mm_mul_ps(m8, z), m12));
+        __m128 clipY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, x), _mm_mul_ps(m5, y)), _mm_add_ps(_mm_mul_ps(m9, z), m13));
+        __m128 clipW = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m3, x), _mm_mul_ps(m7, y)), _mm_add_ps(_mm_mul_ps(m11, z), m15));
+        __m128 visible = _mm_cmpgt_ps(clipW, minW);
+        __m128 invW = _mm_div_ps(one, _mm_max_ps(clipW, minW));
+
+        // Distance from the gaze to the nearest point of the projected sphere's bounding box
+        __m128 screenX = _mm_mul_ps(clipX, invW);
+        __m128 screenY = _mm_mul_ps(clipY, invW);
+        __m128 extentX = _mm_mul_ps(_mm_mul_ps(r, radiusScaleX), invW);
+        __m128 extentY = _mm_mul_ps(_mm_mul_ps(r, radiusScaleY), invW);
+        __m128 dx = _mm_sub_ps(_mm_and_ps(_mm_sub_ps(screenX, gazeX), absMask), extentX);
+        __m128 dy = _mm_sub_ps(_mm_and_ps(_mm_sub_ps(screenY, gazeY), absMask), extentY);
+        if (batch.screenMinX) {
+            _mm_storeu_ps(batch.screenMinX + index, _mm_or_ps(_mm_and_ps(visible, _mm_sub_ps(screenX, extentX)), _mm_andnot_ps(visible, emptyMin)));
+            _mm_storeu_ps(batch.screenMaxX + index, _mm_or_ps(_mm_and_ps(visible, _mm_add_ps(screenX, extentX)), _mm_andnot_ps(visible, emptyMax)));
+            _mm_storeu_ps(batch.screenMinY + index, _mm_or_ps(_mm_and_ps(visible, _mm_sub_ps(screenY, extentY)), _mm_andnot_ps(visible, emptyMin)));
+            _mm_storeu_ps(batch.screenMaxY + index, _mm_or_ps(_mm_and_ps(visible, _mm_add_ps(screenY, extentY)), _mm_andnot_ps(visible, emptyMax)));
+        }
+        dx = _mm_max_ps(dx, zero);
+        dy = _mm_max_ps(dy, zero);
+        __m128 dx2 = _mm_mul_ps(dx, dx);
+        __m128 dy2 = _mm_mul_ps(dy, dy);
+        __m128 fovealNorm = _mm_add_ps(_mm_mul_ps(dx2, fovealX), _mm_mul_ps(dy2, fovealY));
+        __m128 midNorm = _mm_add_ps(_mm_mul_ps(dx2, midX), _mm_mul_ps(dy2, midY));
+
+        // Pick the boundary of each region from the current level
+        __m128i unassigned = _mm_cmplt_epi32(current, zeroi);
+        __m128 unassignedMask = _mm_castsi128_ps(unassigned);
+        __m128 inFovealNow = _mm_castsi128_ps(_mm_cmpeq_epi32(current, zeroi));
+        __m128 inMidNow = _mm_castsi128_ps(_mm_andnot_si128(unassigned, _mm_cmplt_epi32(current, twoi)));
+        __m128 fovealLimit = _mm_or_ps(_mm_and_ps(inFovealNow, stay), _mm_andnot_ps(inFovealNow, enter));
+        fovealLimit = _mm_or_ps(_mm_and_ps(unassignedMask, one), _mm_andnot_ps(unassignedMask, fovealLimit));
+        __m128 midLimit = _mm_or_ps(_mm_and_ps(inMidNow, stay), _mm_andnot_ps(inMidNow, enter));
+        midLimit = _mm_or_ps(_mm_and_ps(unassignedMask, one), _mm_andnot_ps(unassignedMask, midLimit));
+
+        __m128 inFoveal = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(fovealNorm, fovealLimit), visible), fovealMask);
+        __m128 inMid = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(midNorm, midLimit), visible), midMask);
+
+        // Masks are -1 where set: 2 outside, 1 in the mid-foveal region, 0 in the foveal region
+        __m128i target = _mm_add_epi32(twoi, _mm_castps_si128(_mm_or_ps(inFoveal, inMid)));
+        target = _mm_add_epi32(target, _mm_castps_si128(inFoveal));
+        __m128i tooFine = _mm_cmpgt_epi32(target, coarsest);
+        target = _mm_or_si128(_mm_and_si128(tooFine, coarsest), _mm_andnot_si128(tooFine, target));
+
+        int changedMask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(target, current))) ^ 0xf;
+        if (changedMask != 0) {
+            alignas(16) int32_t targets[4];
+            _mm_store_si128(reinterpret_cast<__m128i *>(targets), target);
+            for (int lane = 0; lane < 4; ++lane) {
+                if (changedMask & (1 << lane)) {
+                    changes.push_back({index + lane, targets[lane]});
+                }
+            }
+        }
+    }
+#endif
+
+    for (; index < end; ++index) {
+        float x = batch.positionX[index];
+        float y = batch.positionY[index];
+        float z = batch.positionZ[index];
+        float r = batch.radius[index];
+        int32_t current = batch.lods[index];
+
+        float clipX = m[0] * x + m[4] * y + m[8] * z + m[12];
+        float clipY = m[1] * x + m[5] * y + m[9] * z + m[13];
+        float clipW = m[3] * x + m[7] * y + m[11] * z + m[15];
+        bool visible = clipW > MIN_CLIP_W;
+        float invW = 1.0f / (std::max)(clipW, MIN_CLIP_W);
+
+        float screenX = clipX * invW;
+        float screenY = clipY * invW;
+        float extentX = r * scaleX * invW;
+        float extentY = r * scaleY * invW;
+        float dx = (std::max)(fabsf(screenX - params.gazePos.x) - extentX, 0.0f);
+        float dy = (std::max)(fabsf(screenY - params.gazePos.y) - extentY, 0.0f);
+        if (batch.screenMinX) {
+            batch.screenMinX[index] = visible ? screenX - extentX : FLT_MAX;
+            batch.screenMaxX[index] = visible ? screenX + extentX : -FLT_MAX;
+            batch.screenMinY[index] = visible ? screenY - extentY : FLT_MAX;
+            batch.screenMaxY[index] = visible ? screenY + extentY : -FLT_MAX;
+        }
+        float fovealNorm = dx * dx * fovealInvX2 + dy * dy * fovealInvY2;
+        float midNorm = dx * dx * midInvX2 + dy * dy * midInvY2;
+
+        float fovealLimit = current < 0 ? 1.0f : (current == 0 ? stayLimit : enterLimit);
+        float midLimit = current < 0 ? 1.0f : (current < 2 ? stayLimit : enterLimit);
+        bool inFoveal = visible && fovealEnabled && fovealNorm <= fovealLimit;
+        bool inMid = visible && midEnabled && midNorm <= midLimit;
+
+        int32_t target = inFoveal ? 0 : (inMid ? 1 : 2);
+        target = (std::min)(target, batch.coarsestLod[index]);
+        if (target != current) {
+            changes.push_back({index, target});
+        }
+    }
+}
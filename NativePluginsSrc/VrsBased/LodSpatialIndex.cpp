@@ -0,0 +1,444 @@
+#include "LodSpatialIndex.h"
+#include "Utils.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+// Relative slack on the cell tests so float rounding never hides a boundary object
+static const float CELL_TEST_SLACK = 1e-4f;
+
+int32_t LodSpatialIndex::Objects::Append() {
+    size_t size = positionX.size() + 1;
+    Resize(size);
+    return static_cast<int32_t>(size - 1);
+}
+
+void LodSpatialIndex::Objects::Resize(size_t size) {
+    positionX.resize(size);
+    positionY.resize(size);
+    positionZ.resize(size);
+    radius.resize(size);
+    coarsestLod.resize(size);
+    lods.resize(size);
+    screenMinX.resize(size);
+    screenMaxX.resize(size);
+    screenMinY.resize(size);
+    screenMaxY.resize(size);
+    handle.resize(size);
+}
+
+void LodSpatialIndex::Objects::CopySlot(int32_t to, const Objects &other, int32_t from) {
+    positionX[to] = other.positionX[from];
+    positionY[to] = other.positionY[from];
+    positionZ[to] = other.positionZ[from];
+    radius[to] = other.radius[from];
+    coarsestLod[to] = other.coarsestLod[from];
+    lods[to] = other.lods[from];
+    screenMinX[to] = other.screenMinX[from];
+    screenMaxX[to] = other.screenMaxX[from];
+    screenMinY[to] = other.screenMinY[from];
+    screenMaxY[to] = other.screenMaxY[from];
+    handle[to] = other.handle[from];
+}
+
+// Constructor
+LodSpatialIndex::LodSpatialIndex(LodClassifier *classifier)
+    : classifier(classifier), objectCount(0), lastParams{}, hasLastParams(false), fullUpdatePending(false),
+    truncated(false), stats{} {
+    Clear();
+}
+
+// Destructor
+LodSpatialIndex::~LodSpatialIndex() {
+}
+
+void LodSpatialIndex::Insert(const float *x, const float *y, const float *z, const float *r,
+    const int32_t *coarsest, int count, int32_t *handles) {
+    for (int i = 0; i < count; ++i) {
+        int32_t handle;
+        if (!freeHandles.empty()) {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        } else {
+            handle = static_cast<int32_t>(handleSlot.size());
+            handleSlot.push_back(-1);
+            dirty.push_back(0);
+        }
+
+        // New objects start outside the sorted ranges, in the extra objects once classified
+        int32_t slot = objects.Append();
+        extraCell.push_back(-1);
+        extraIndex.push_back(0);
+        objects.positionX[slot] = x[i];
+        objects.positionY[slot] = y[i];
+        objects.positionZ[slot] = z[i];
+        objects.radius[slot] = r[i];
+        objects.coarsestLod[slot] = (std::max)(coarsest[i], 0);
+        objects.lods[slot] = -1;
+        objects.handle[slot] = handle;
+        handleSlot[handle] = slot;
+        MarkDirty(handle);
+        ++objectCount;
+        handles[i] = handle;
+    }
+    stats.objects = objectCount;
+}
+
+void LodSpatialIndex::Update(const int32_t *handles, const float *x, const float *y, const float *z, const float *r, int count) {
+    for (int i = 0; i < count; ++i) {
+        int32_t handle = handles[i];
+        if (handle < 0 || handle >= static_cast<int32_t>(handleSlot.size()) || handleSlot[handle] < 0) {
+            continue;
+        }
+        int32_t slot = handleSlot[handle];
+        objects.positionX[slot] = x[i];
+        objects.positionY[slot] = y[i];
+        objects.positionZ[slot] = z[i];
+        objects.radius[slot] = r[i];
+        MarkDirty(handle);
+    }
+}
+
+void LodSpatialIndex::Remove(const int32_t *handles, int count) {
+    for (int i = 0; i < count; ++i) {
+        int32_t handle = handles[i];
+        if (handle < 0 || handle >= static_cast<int32_t>(handleSlot.size()) || handleSlot[handle] < 0) {
+            continue;
+        }
+        int32_t slot = handleSlot[handle];
+        UnbinExtra(slot);
+
+        // The slot stays as a hole until the next full update, a coarsest level
+        // of -1 keeps the classifier from ever reporting it
+        objects.coarsestLod[slot] = -1;
+        objects.lods[slot] = -1;
+        objects.handle[slot] = -1;
+        handleSlot[handle] = -1;
+        freeHandles.push_back(handle);
+        --objectCount;
+    }
+    stats.objects = objectCount;
+}
+
+void LodSpatialIndex::Clear() {
+    objects.Resize(0);
+    extraCell.clear();
+    extraIndex.clear();
+    handleSlot.clear();
+    dirty.clear();
+    freeHandles.clear();
+    dirtyHandles.clear();
+    objectCount = 0;
+    for (Cell &cell : cells) {
+        cell.begin = 0;
+        cell.end = 0;
+        cell.extra.clear();
+        cell.minX = FLT_MAX;
+        cell.maxX = -FLT_MAX;
+        cell.minY = FLT_MAX;
+        cell.maxY = -FLT_MAX;
+    }
+    hasLastParams = false;
+    stats.objects = 0;
+}
+
+int LodSpatialIndex::Classify(const LodClassifierParams &params, int32_t *changedHandles, int32_t *changedLods, int capacity) {
+    truncated = false;
+    int written;
+    if (!hasLastParams || fullUpdatePending || RequiresFullUpdate(params)) {
+        written = ClassifyAll(params, changedHandles, changedLods, capacity);
+        ++stats.fullUpdates;
+    } else {
+        written = ClassifyCandidates(params, changedHandles, changedLods, capacity);
+        ++stats.incrementalUpdates;
+    }
+
+    // Changes that did not fit were not applied, a full update picks them up again
+    fullUpdatePending = truncated;
+    lastParams = params;
+    hasLastParams = true;
+    return written;
+}
+
+int LodSpatialIndex::ClassifyAll(const LodClassifierParams &params, int32_t *changedHandles, int32_t *changedLods, int capacity) {
+    int slots = static_cast<int>(objects.positionX.size());
+    LodObjectBatch batch = {objects.positionX.data(), objects.positionY.data(), objects.positionZ.data(), objects.radius.data(),
+        objects.coarsestLod.data(), objects.lods.data(), slots,
+        objects.screenMinX.data(), objects.screenMaxX.data(), objects.screenMinY.data(), objects.screenMaxY.data()};
+    int written = ClassifyBatch(params, batch, nullptr, 0, changedHandles, changedLods, capacity);
+
+    // Counting sort of the live slots by cell, objects behind the camera go last
+    candidates.resize(slots);
+    cellOffsets.assign(CELL_COUNT + 2, 0);
+    for (int32_t slot = 0; slot < slots; ++slot) {
+        int cell = objects.coarsestLod[slot] < 0 ? -1 : FindCell(slot);
+        candidates[slot] = objects.coarsestLod[slot] < 0 ? CELL_COUNT + 1 : (cell < 0 ? CELL_COUNT : cell);
+        ++cellOffsets[candidates[slot] + 1];
+    }
+    for (int cell = 0; cell <= CELL_COUNT; ++cell) {
+        cellOffsets[cell + 1] += cellOffsets[cell];
+    }
+
+    // Holes of removed objects are dropped
+    int live = cellOffsets[CELL_COUNT + 1];
+    sorted.Resize(live);
+    for (int cell = 0; cell < CELL_COUNT; ++cell) {
+        cells[cell].begin = cellOffsets[cell];
+        cells[cell].end = cellOffsets[cell + 1];
+    }
+    for (int32_t slot = 0; slot < slots; ++slot) {
+        int cell = candidates[slot];
+        if (cell <= CELL_COUNT) {
+            sorted.CopySlot(cellOffsets[cell]++, objects, slot);
+        }
+    }
+    std::swap(objects, sorted);
+    for (int32_t slot = 0; slot < live; ++slot) {
+        handleSlot[objects.handle[slot]] = slot;
+    }
+    extraCell.assign(live, -1);
+    extraIndex.assign(live, 0);
+
+    for (Cell &cell : cells) {
+        cell.extra.clear();
+        cell.minX = FLT_MAX;
+        cell.maxX = -FLT_MAX;
+        cell.minY = FLT_MAX;
+        cell.maxY = -FLT_MAX;
+        for (int32_t slot = cell.begin; slot < cell.end; ++slot) {
+            cell.minX = (std::min)(cell.minX, objects.screenMinX[slot]);
+            cell.maxX = (std::max)(cell.maxX, objects.screenMaxX[slot]);
+            cell.minY = (std::min)(cell.minY, objects.screenMinY[slot]);
+            cell.maxY = (std::max)(cell.maxY, objects.screenMaxY[slot]);
+        }
+    }
+
+    for (int32_t handle : dirtyHandles) {
+        dirty[handle] = 0;
+    }
+    dirtyHandles.clear();
+
+    stats.candidates = objectCount;
+    stats.cellsVisited = CELL_COUNT;
+    stats.fullUpdate = 1;
+    return written;
+}
+
+int LodSpatialIndex::ClassifyCandidates(const LodClassifierParams &params, int32_t *changedHandles, int32_t *changedLods, int capacity) {
+    // Moved and inserted objects are reprojected and binned into the cell of their new bounds
+    candidates.clear();
+    for (int32_t handle : dirtyHandles) {
+        if (handleSlot[handle] >= 0) {
+            candidates.push_back(handleSlot[handle]);
+        }
+        dirty[handle] = 0;
+    }
+    dirtyHandles.clear();
+
+    int classified = static_cast<int>(candidates.size());
+    int written = ClassifySlots(params, candidates, true, changedHandles, changedLods, capacity);
+    for (int32_t slot : candidates) {
+        UnbinExtra(slot);
+        BinExtra(slot);
+    }
+
+    // Sorted ranges are classified in place, extra objects are gathered
+    candidates.clear();
+    int cellsVisited = 0;
+    for (const Cell &cell : cells) {
+        if ((cell.begin == cell.end && cell.extra.empty()) || !IsBoundaryCell(cell, params)) {
+            continue;
+        }
+        ++cellsVisited;
+
+        int count = cell.end - cell.begin;
+        if (count > 0) {
+            LodObjectBatch batch = {objects.positionX.data() + cell.begin, objects.positionY.data() + cell.begin,
+                objects.positionZ.data() + cell.begin, objects.radius.data() + cell.begin, objects.coarsestLod.data() + cell.begin,
+                objects.lods.data() + cell.begin, count, nullptr, nullptr, nullptr, nullptr};
+            written += ClassifyBatch(params, batch, nullptr, cell.begin, changedHandles + written, changedLods + written, capacity - written);
+            classified += count;
+        }
+        candidates.insert(candidates.end(), cell.extra.begin(), cell.extra.end());
+    }
+    classified += static_cast<int>(candidates.size());
+    written += ClassifySlots(params, candidates, false, changedHandles + written, changedLods + written, capacity - written);
+
+    stats.candidates = classified;
+    stats.cellsVisited = cellsVisited;
+    stats.fullUpdate = 0;
+    return written;
+}
+
+int LodSpatialIndex::ClassifySlots(const LodClassifierParams &params, const std::vector<int32_t> &slots, bool updateBounds,
+    int32_t *changedHandles, int32_t *changedLods, int capacity) {
+    int count = static_cast<int>(slots.size());
+    if (count == 0) {
+        return 0;
+    }
+
+    gathered.Resize(count);
+    for (int i = 0; i < count; ++i) {
+        int32_t slot = slots[i];
+        gathered.positionX[i] = objects.positionX[slot];
+        gathered.positionY[i] = objects.positionY[slot];
+        gathered.positionZ[i] = objects.positionZ[slot];
+        gathered.radius[i] = objects.radius[slot];
+        gathered.coarsestLod[i] = objects.coarsestLod[slot];
+        gathered.lods[i] = objects.lods[slot];
+    }
+
+    LodObjectBatch batch = {gathered.positionX.data(), gathered.positionY.data(), gathered.positionZ.data(), gathered.radius.data(),
+        gathered.coarsestLod.data(), gathered.lods.data(), count, nullptr, nullptr, nullptr, nullptr};
+    if (updateBounds) {
+        batch.screenMinX = gathered.screenMinX.data();
+        batch.screenMaxX = gathered.screenMaxX.data();
+        batch.screenMinY = gathered.screenMinY.data();
+        batch.screenMaxY = gathered.screenMaxY.data();
+    }
+    int written = ClassifyBatch(params, batch, slots.data(), 0, changedHandles, changedLods, capacity);
+
+    for (int i = 0; i < count; ++i) {
+        int32_t slot = slots[i];
+        objects.lods[slot] = gathered.lods[i];
+        if (updateBounds) {
+            objects.screenMinX[slot] = gathered.screenMinX[i];
+            objects.screenMaxX[slot] = gathered.screenMaxX[i];
+            objects.screenMinY[slot] = gathered.screenMinY[i];
+            objects.screenMaxY[slot] = gathered.screenMaxY[i];
+        }
+    }
+    return written;
+}
+
+int LodSpatialIndex::ClassifyBatch(const LodClassifierParams &params, const LodObjectBatch &batch, const int32_t *slots,
+    int32_t firstSlot, int32_t *changedHandles, int32_t *changedLods, int capacity) {
+    capacity = (std::max)((std::min)(capacity, batch.count), 0);
+    changedSlots.resize(capacity);
+    int written = classifier->Classify(params, batch, changedSlots.data(), capacity);
+    if (written == capacity && capacity < batch.count) {
+        truncated = true;
+    }
+
+    for (int i = 0; i < written; ++i) {
+        int32_t index = changedSlots[i];
+        int32_t slot = slots ? slots[index] : firstSlot + index;
+        changedHandles[i] = objects.handle[slot];
+        changedLods[i] = batch.lods[index];
+    }
+    return written;
+}
+
+bool LodSpatialIndex::IsBoundaryCell(const Cell &cell, const LodClassifierParams &params) const {
+    const Vector2 *radii[] = {&params.fovealRadii, &params.midFovealRadii};
+    for (const Vector2 *ellipse : radii) {
+        if (ellipse->x <= 0.0f || ellipse->y <= 0.0f) {
+            continue;
+        }
+        CellRegion previous = ClassifyCell(cell, lastParams.gazePos, *ellipse, params.hysteresis);
+        CellRegion current = ClassifyCell(cell, params.gazePos, *ellipse, params.hysteresis);
+        if (previous == CellRegion::BOUNDARY || current == CellRegion::BOUNDARY || previous != current) {
+            return true;
+        }
+    }
+    return false;
+}
+
+LodSpatialIndex::CellRegion LodSpatialIndex::ClassifyCell(const Cell &cell, const Vector2 &gazePos, const Vector2 &radii, float hysteresis) const {
+    if (cell.minX > cell.maxX) {
+        return CellRegion::OUTSIDE;
+    }
+
+    const float invX2 = 1.0f / (radii.x * radii.x);
+    const float invY2 = 1.0f / (radii.y * radii.y);
+
+    // Nearest point and farthest corner of the cell's bounds from the gaze
+    float nearX = (std::max)((std::max)(cell.minX - gazePos.x, gazePos.x - cell.maxX), 0.0f);
+    float nearY = (std::max)((std::max)(cell.minY - gazePos.y, gazePos.y - cell.maxY), 0.0f);
+    float farX = (std::max)(fabsf(cell.minX - gazePos.x), fabsf(cell.maxX - gazePos.x));
+    float farY = (std::max)(fabsf(cell.minY - gazePos.y), fabsf(cell.maxY - gazePos.y));
+    float nearNorm = nearX * nearX * invX2 + nearY * nearY * invY2;
+    float farNorm = farX * farX * invX2 + farY * farY * invY2;
+
+    // Same limits as LodClassifier: stay inside up to 1 + h, enter within 1 - h
+    hysteresis = (std::max)(hysteresis, 0.0f);
+    float stayLimit = (1.0f + hysteresis) * (1.0f + hysteresis);
+    float enterLimit = (std::max)(1.0f - hysteresis, 0.0f) * (std::max)(1.0f - hysteresis, 0.0f);
+    if (farNorm < enterLimit * (1.0f - CELL_TEST_SLACK)) {
+        return CellRegion::INSIDE;
+    }
+    if (nearNorm > stayLimit * (1.0f + CELL_TEST_SLACK)) {
+        return CellRegion::OUTSIDE;
+    }
+    return CellRegion::BOUNDARY;
+}
+
+int LodSpatialIndex::FindCell(int32_t slot) const {
+    // Objects behind the camera are outside every region until the view changes
+    if (objects.screenMinX[slot] > objects.screenMaxX[slot]) {
+        return -1;
+    }
+
+    // Finest level whose cells (2 / size wide) hold the bounds
+    float extent = (std::max)(objects.screenMaxX[slot] - objects.screenMinX[slot], objects.screenMaxY[slot] - objects.screenMinY[slot]);
+    int size = GRID_SIZE;
+    int levelBase = 0;
+    for (int level = 1; level < GRID_LEVELS && extent * size > 2.0f; ++level) {
+        levelBase += size * size;
+        size /= 2;
+    }
+
+    float centerX = 0.5f * (objects.screenMinX[slot] + objects.screenMaxX[slot]);
+    float centerY = 0.5f * (objects.screenMinY[slot] + objects.screenMaxY[slot]);
+    int cellX = Clamp(static_cast<int>((centerX + 1.0f) * 0.5f * size), 0, size - 1);
+    int cellY = Clamp(static_cast<int>((centerY + 1.0f) * 0.5f * size), 0, size - 1);
+    return levelBase + cellY * size + cellX;
+}
+
+void LodSpatialIndex::BinExtra(int32_t slot) {
+    int index = FindCell(slot);
+    if (index < 0) {
+        return;
+    }
+
+    // Bounds only grow until the next full update, which keeps them conservative
+    Cell &cell = cells[index];
+    extraCell[slot] = index;
+    extraIndex[slot] = static_cast<int32_t>(cell.extra.size());
+    cell.extra.push_back(slot);
+    cell.minX = (std::min)(cell.minX, objects.screenMinX[slot]);
+    cell.maxX = (std::max)(cell.maxX, objects.screenMaxX[slot]);
+    cell.minY = (std::min)(cell.minY, objects.screenMinY[slot]);
+    cell.maxY = (std::max)(cell.maxY, objects.screenMaxY[slot]);
+}
+
+void LodSpatialIndex::UnbinExtra(int32_t slot) {
+    int index = extraCell[slot];
+    if (index < 0) {
+        return;
+    }
+
+    std::vector<int32_t> &extra = cells[index].extra;
+    int32_t position = extraIndex[slot];
+    int32_t last = extra.back();
+    extra[position] = last;
+    extraIndex[last] = position;
+    extra.pop_back();
+    extraCell[slot] = -1;
+}
+
+void LodSpatialIndex::MarkDirty(int32_t handle) {
+    if (!dirty[handle]) {
+        dirty[handle] = 1;
+        dirtyHandles.push_back(handle);
+    }
+}
+
+bool LodSpatialIndex::RequiresFullUpdate(const LodClassifierParams &params) const {
+    return memcmp(params.viewProjection, lastParams.viewProjection, sizeof(params.viewProjection)) != 0 ||
+        params.fovealRadii.x != lastParams.fovealRadii.x || params.fovealRadii.y != lastParams.fovealRadii.y ||
+        params.midFovealRadii.x != lastParams.midFovealRadii.x || params.midFovealRadii.y != lastParams.midFovealRadii.y ||
+        params.hysteresis != lastParams.hysteresis;
+}
@@ -0,0 +1,235 @@
+#include "NvApiVrsBackend.h"
+
+#if VRS_BACKEND_D3D
+
+NvApiVrsBackend *NvApiVrsBackend::Create(ID3D11Device *device) {
+    if (!device) {
+        return nullptr;
+    }
+
+    NvApiVrsBackend *backend = new NvApiVrsBackend(device);
+    if (!backend->nvApiWrapper.Initialize(device)) {
+        delete backend;
+        return nullptr;
+    }
+    backend->nvApiInitialized = true;
+    return backend;
+}
+
+// Constructor
+NvApiVrsBackend::NvApiVrsBackend(ID3D11Device *d3dDevice)
+    : device(d3dDevice), immediateContext(nullptr), nvApiInitialized(false), vrsHelper(nullptr), gazeHandler(nullptr),
+    handlerTanHalfHorizontalFov(1.0f), handlerTanHalfVerticalFov(1.0f), stereoActive(false),
+    enableParams{}, enableParamsVersion(0), enableParamsMode(RenderMode::MONO), enableParamsValid(false),
+    enabled(false), gazeLatched(false), appliedStateValid(false), lastStatus(NVAPI_OK) {
+}
+
+// Destructor
+NvApiVrsBackend::~NvApiVrsBackend() {
+    Release();
+
+    // Unload NVidia API together with the device it was registered for
+    if (nvApiInitialized) {
+        nvApiWrapper.Unload();
+    }
+}
+
+bool NvApiVrsBackend::Initialize(float tanHalfHorizontalFov, float tanHalfVerticalFov, bool stereo) {
+    Release();
+
+    // Every call below goes to the immediate context, fetch it once instead of per event
+    device->GetImmediateContext(&immediateContext);
+
+    NV_VRS_HELPER_INIT_PARAMS vrsInitParams = {};
+    vrsInitParams.version = NV_VRS_HELPER_INIT_PARAMS_VER;
+    vrsInitParams.ppVRSHelper = &vrsHelper;
+
+    NvAPI_Status status = NvAPI_D3D_InitializeVRSHelper(device, &vrsInitParams);
+    if (status != NVAPI_OK) {
+        lastStatus = status;
+        return false;
+    }
+
+    handlerTanHalfHorizontalFov = tanHalfHorizontalFov;
+    handlerTanHalfVerticalFov = tanHalfVerticalFov;
+    return CreateGazeHandler(stereo);
+}
+
+bool NvApiVrsBackend::CreateGazeHandler(bool stereo) {
+    stereoActive = stereo;
+
+    NV_GAZE_HANDLER_INIT_PARAMS gazeInitParams = {};
+    gazeInitParams.version = NV_GAZE_HANDLER_INIT_PARAMS_VER;
+    gazeInitParams.GazeDataDeviceId = 0;
+    gazeInitParams.GazeDataType = stereo ? NV_GAZE_DATA_STEREO : NV_GAZE_DATA_MONO;
+    gazeInitParams.fHorizontalFOV = handlerTanHalfHorizontalFov;
+    gazeInitParams.fVericalFOV = handlerTanHalfVerticalFov;
+    gazeInitParams.ppNvGazeHandler = &gazeHandler;
+
+    NvAPI_Status status = NvAPI_D3D_InitializeNvGazeHandler(device, &gazeInitParams);
+    if (status != NVAPI_OK) {
+        lastStatus = status;
+    }
+    return (status == NVAPI_OK);
+}
+
+bool NvApiVrsBackend::UpdateGaze(const VrsGazeFrame &gaze) {
+    // The handler type is fixed at creation, recreate it when the gaze switches between mono and stereo
+    if (gazeHandler && gaze.stereo != stereoActive) {
+        gazeHandler->Release();
+        gazeHandler = nullptr;
+        CreateGazeHandler(gaze.stereo);
+    }
+    if (!gazeHandler || !vrsHelper) {
+        return false;
+    }
+
+    NV_FOVEATED_RENDERING_UPDATE_GAZE_DATA_PARAMS gazeDataParams = {};
+    gazeDataParams.version = NV_FOVEATED_RENDERING_UPDATE_GAZE_DATA_PARAMS_VER;
+    gazeDataParams.Timestamp = gaze.timestamp;
+
+    // Update Gaze Data
+    NV_FOVEATED_RENDERING_GAZE_DATA_PER_EYE *eyes[2] = {&gazeDataParams.sMonoData, nullptr};
+    if (stereoActive) {
+        eyes[0] = &gazeDataParams.sStereoData.sLeftEye;
+        eyes[1] = &gazeDataParams.sStereoData.sRightEye;
+    }
+    for (int eye = 0; eye < 2 && eyes[eye]; ++eye) {
+        eyes[eye]->version = NV_FOVEATED_RENDERING_GAZE_DATA_PER_EYE_VER;
+        eyes[eye]->fGazeNormalizedLocation[0] = gaze.positions[eye].x;
+        eyes[eye]->fGazeNormalizedLocation[1] = gaze.positions[eye].y;
+        eyes[eye]->GazeDataValidityFlags = NV_GAZE_LOCATION_VALID;
+    }
+
+    // Send Gaze Data to NVidia VRS Handler, then latch it for the following draws
+    NvAPI_Status status = gazeHandler->UpdateGazeData(immediateContext, &gazeDataParams);
+    if (status == NVAPI_OK) {
+        NV_VRS_HELPER_LATCH_GAZE_PARAMS latchParams = {};
+        latchParams.version = NV_VRS_HELPER_LATCH_GAZE_PARAMS_VER;
+        status = vrsHelper->LatchGaze(immediateContext, &latchParams);
+        gazeLatched = gazeLatched || status == NVAPI_OK;
+    }
+    if (status != NVAPI_OK) {
+        lastStatus = status;
+    }
+    return (status == NVAPI_OK);
+}
+
+VrsResult NvApiVrsBackend::Enable(RenderMode mode, const VrsFoveationState &foveation) {
+    if (!vrsHelper) {
+        return VrsResult::FAILED;
+    }
+
+    bool paramsChanged = !enableParamsValid || foveation.version != enableParamsVersion || mode != enableParamsMode;
+    if (paramsChanged) {
+        enableParams = {};
+        enableParams.version = NV_VRS_HELPER_ENABLE_PARAMS_VER;
+        enableParams.RenderMode = ToNvRenderMode(mode);
+        enableParams.ContentType = NV_VRS_CONTENT_TYPE_FOVEATED_RENDERING;
+        enableParams.sFoveatedRenderingDesc.version = NV_FOVEATED_RENDERING_DESC_VER;
+
+        UpdateShadingRatePresetParams(foveation, enableParams);
+        UpdateFoveationPatternPresetParams(foveation, enableParams);
+
+        enableParamsVersion = foveation.version;
+        enableParamsMode = mode;
+        enableParamsValid = true;
+    }
+
+    if (appliedStateValid && enabled && !paramsChanged && !gazeLatched) {
+        return VrsResult::SKIPPED;
+    }
+
+    // Enable VRS with the configured parameters
+    NvAPI_Status status = vrsHelper->Enable(immediateContext, &enableParams);
+    if (status != NVAPI_OK) {
+        lastStatus = status;
+        return VrsResult::FAILED;
+    }
+    enabled = true;
+    gazeLatched = false;
+    appliedStateValid = true;
+    return VrsResult::APPLIED;
+}
+
+VrsResult NvApiVrsBackend::Disable() {
+    if (!vrsHelper) {
+        return VrsResult::FAILED;
+    }
+    if (appliedStateValid && !enabled) {
+        return VrsResult::SKIPPED;
+    }
+
+    NV_VRS_HELPER_DISABLE_PARAMS disableParams = {};
+    disableParams.version = NV_VRS_HELPER_DISABLE_PARAMS_VER;
+
+    NvAPI_Status status = vrsHelper->Disable(immediateContext, &disableParams);
+    if (status != NVAPI_OK) {
+        lastStatus = status;
+        return VrsResult::FAILED;
+    }
+    enabled = false;
+    appliedStateValid = true;
+    return VrsResult::APPLIED;
+}
+
+// NVAPI reserves 0 for an invalid mode, the values do not line up with RenderMode
+NV_VRS_RENDER_MODE NvApiVrsBackend::ToNvRenderMode(RenderMode mode) {
+    switch (mode) {
+        case RenderMode::LEFT_EYE:
+            return NV_VRS_RENDER_MODE_LEFT_EYE;
+        case RenderMode::RIGHT_EYE:
+            return NV_VRS_RENDER_MODE_RIGHT_EYE;
+        case RenderMode::STEREO:
+            return NV_VRS_RENDER_MODE_STEREO;
+        case RenderMode::MONO:
+        default:
+            return NV_VRS_RENDER_MODE_MONO;
+    }
+}
+
+void NvApiVrsBackend::UpdateShadingRatePresetParams(const VrsFoveationState &foveation, NV_VRS_HELPER_ENABLE_PARAMS &enableParams) {
+    enableParams.sFoveatedRenderingDesc.ShadingRatePreset = static_cast<NV_FOVEATED_RENDERING_SHADING_RATE_PRESET>(foveation.ratePreset);
+    if (foveation.ratePreset == ShadingRatePreset::CUSTOM) {
+        auto customShading = &(enableParams.sFoveatedRenderingDesc.ShadingRateCustomPresetDesc);
+        customShading->version = NV_FOVEATED_RENDERING_CUSTOM_SHADING_RATE_PRESET_DESC_VER1;
+        customShading->InnerMostRegionShadingRate = static_cast<NV_PIXEL_SHADING_RATE>(foveation.desc.innerRate);
+        customShading->MiddleRegionShadingRate = static_cast<NV_PIXEL_SHADING_RATE>(foveation.desc.middleRate);
+        customShading->PeripheralRegionShadingRate = static_cast<NV_PIXEL_SHADING_RATE>(foveation.desc.peripheralRate);
+    }
+}
+
+void NvApiVrsBackend::UpdateFoveationPatternPresetParams(const VrsFoveationState &foveation, NV_VRS_HELPER_ENABLE_PARAMS &enableParams) {
+    enableParams.sFoveatedRenderingDesc.FoveationPatternPreset = static_cast<NV_FOVEATED_RENDERING_FOVEATION_PATTERN_PRESET>(foveation.patternPreset);
+    if (foveation.patternPreset == ShadingPatternPreset::CUSTOM) {
+        auto customPattern = &(enableParams.sFoveatedRenderingDesc.FoveationPatternCustomPresetDesc);
+        customPattern->version = NV_FOVEATED_RENDERING_CUSTOM_FOVEATION_PATTERN_PRESET_DESC_VER1;
+        customPattern->fInnermostRadii[0] = foveation.desc.innerRadii.x;
+        customPattern->fInnermostRadii[1] = foveation.desc.innerRadii.y;
+        customPattern->fMiddleRadii[0] = foveation.desc.middleRadii.x;
+        customPattern->fMiddleRadii[1] = foveation.desc.middleRadii.y;
+        customPattern->fPeripheralRadii[0] = foveation.desc.peripheralRadii.x;
+        customPattern->fPeripheralRadii[1] = foveation.desc.peripheralRadii.y;
+    }
+}
+
+void NvApiVrsBackend::Release() {
+    enableParamsValid = false;
+    enabled = false;
+    gazeLatched = false;
+    appliedStateValid = false;
+    if (gazeHandler) {
+        gazeHandler->Release();
+        gazeHandler = nullptr;
+    }
+    if (vrsHelper) {
+        vrsHelper->Release();
+        vrsHelper = nullptr;
+    }
+    if (immediateContext) {
+        immediateContext->Release();
+        immediateContext = nullptr;
+    }
+}
+
+#endif
@@ -7,7 +7,12 @@ bool NvApiWrapper::Initialize(ID3D11Device *device) {
         return false;
     }
 
-    return RegisterDevice(device);
+    // Balance the initialization, callers only unload after success
+    if (!RegisterDevice(device)) {
+        NvAPI_Unload();
+        return false;
+    }
+    return true;
 }
 
 // Register the Direct3D 11 device with NVidia API
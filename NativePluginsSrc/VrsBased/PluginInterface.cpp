@@ -1,16 +1,39 @@
 #include "PluginInterface.h"
+#include "Clock.h"
 #include "Enums.h"
+#include "FoveationPresetFile.h"
+#include "SoftwareVrsBackend.h"
 #include "Utils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if VRS_BACKEND_D3D
+#include "D3D12VrsBackend.h"
+#include "NvApiVrsBackend.h"
 #include <IUnityGraphicsD3D11.h>
+#include <IUnityGraphicsD3D12.h>
+#endif
+
+#if VRS_BACKEND_VULKAN
+#include "VulkanVrsBackend.h"
+#endif
 
 // Singleton instance of PluginInterface
 static PluginInterface* s_pluginInstance = nullptr;
 
 // Constructor
 PluginInterface::PluginInterface()
-    : unityInterfaces(nullptr), unityGraphics(nullptr), device(nullptr), renderEventHandler(nullptr),
-    tanHalfHorizontalFov(1.0f), tanHalfVerticalFov(1.0f) { // Initialize to 1.0f
+    : unityInterfaces(nullptr), unityGraphics(nullptr),
+    contentShadingSettings(ContentAdaptiveShading::GetDefaultSettings()),
+    gazePredictionConfigured(false), gazePredictionSettings{}, gazeFiltersConfigured(false), gazeFilterSettings{},
+    defaultContext(nullptr), renderEventHandler(&contexts, &foveationGovernor, &shadingCostTelemetry, &instrumentation),
+    lodSpatialIndex(&lodClassifier) {
     s_pluginInstance = this;
+
+    // The first context of an empty pool takes the default handle
+    defaultContext = contexts.Get(contexts.Acquire());
+    defaultContext->gazeManager.AttachTraceWriter(&traceWriter);
 }
 
 // Destructor
@@ -36,86 +59,347 @@ void PluginInterface::Unload() {
         unityGraphics = nullptr;
     }
 
-    // Release foveated rendering resources
-    ReleaseFoveatedRendering();
+    gazeReceiver.Stop();
+    sharedGazeReader.Stop();
+    traceWriter.Close();
 
-    if (renderEventHandler) {
-        delete renderEventHandler;
-        renderEventHandler = nullptr;
-    }
+    // Render events have stopped, destroyed contexts can go at once
+    contexts.Reclaim();
 
-    // Unregister NVidia API
-    nvApiWrapper.Unload();
+    // Release foveated rendering resources and the device backends
+    for (int slot = 0; slot < FoveationContextPool::MAX_CONTEXTS; ++slot) {
+        FoveationContext* context = contexts.GetSlot(slot);
+        if (context) {
+            ReleaseContext(*context);
+            DestroyBackend(*context);
+        }
+    }
 
     unityInterfaces = nullptr;
 }
 
 // Handle Unity render events
 void PluginInterface::HandleRenderEvent(int eventID) {
-    if (renderEventHandler && device) {
-        ID3D11DeviceContext* deviceContext = nullptr;
-        device->GetImmediateContext(&deviceContext);
+    contexts.Reclaim();
+    renderEventHandler.HandleEvent(static_cast<EventID>(eventID), DEFAULT_FOVEATION_CONTEXT);
+}
+
+void PluginInterface::HandleRenderEventAndData(int eventID, void* data) {
+    contexts.Reclaim();
+    if (static_cast<EventID>(eventID) != EventID::COMMAND_PACKET) {
+        // Plain events carry their context as data, none addresses the default context
+        renderEventHandler.HandleEvent(static_cast<EventID>(eventID), static_cast<FoveationContextId>(reinterpret_cast<intptr_t>(data)));
+        return;
+    }
+
+    if (data) {
+        renderEventHandler.HandlePacket(*static_cast<const RenderCommandPacket*>(data), DEFAULT_FOVEATION_CONTEXT);
+    }
+}
+
+FoveationContextId PluginInterface::CreateFoveationContext() {
+    FoveationContextId id = contexts.Acquire();
+    FoveationContext* context = contexts.Get(id);
+    if (!context) {
+        return INVALID_FOVEATION_CONTEXT;
+    }
 
-        renderEventHandler->HandleEvent(static_cast<EventID>(eventID), deviceContext, vrsManager.GetVrsHelper());
+    // Contexts created before the device is up get their backend with the other ones
+    ApplyGazeSettings(*context);
+    if (unityGraphics) {
+        CreateBackend(*context);
+    }
+    return id;
+}
+
+bool PluginInterface::DestroyFoveationContext(FoveationContextId id) {
+    FoveationContext* context = contexts.Get(id);
+    if (!context || context == defaultContext) {
+        return false;
+    }
+
+    // Events resolved from here on skip the context, the render thread deletes it with its backend
+    context->initialized.store(false, std::memory_order_release);
+    return contexts.Retire(id);
+}
 
-        // Release the device context after operations
-        deviceContext->Release();
+void PluginInterface::SetFoveationContextEnabled(FoveationContextId id, bool enabled) {
+    FoveationContext* context = contexts.Get(id);
+    if (context) {
+        context->enabled.store(enabled, std::memory_order_relaxed);
     }
 }
 
+bool PluginInterface::IsFoveationContextEnabled(FoveationContextId id) const {
+    FoveationContext* context = contexts.Get(id);
+    return context ? context->enabled.load(std::memory_order_relaxed) : false;
+}
+
 // Initialize foveated rendering
-bool PluginInterface::InitializeFoveatedRendering(float verticalFov, float aspectRatio) {
-    if (device && !vrsManager.Initialize(device)) {
+bool PluginInterface::InitializeFoveatedRendering(FoveationContextId id, float verticalFov, float aspectRatio) {
+    FoveationContext* context = contexts.Get(id);
+    if (!context) {
         return false;
     }
 
     // Calculate tangent of half FOV angles
     const float DEG2RAD = 0.01745329f;
     float halfVerticalFovRad = DEG2RAD * verticalFov / 2.0f;
-    tanHalfVerticalFov = tanf(halfVerticalFovRad);
-    tanHalfHorizontalFov = tanHalfVerticalFov * aspectRatio;
+    context->tanHalfVerticalFov = tanf(halfVerticalFovRad);
+    context->tanHalfHorizontalFov = context->tanHalfVerticalFov * aspectRatio;
+    bool stereo = context->vrsManager.GetRenderMode() != RenderMode::MONO;
 
-    // Initialize Gaze Manager
-    if (!gazeManager.Initialize(device, tanHalfHorizontalFov, tanHalfVerticalFov)) {
+    // Initialize the device backend
+    IVrsBackend* backend = context->backend;
+    if (!backend || !backend->Initialize(context->tanHalfHorizontalFov, context->tanHalfVerticalFov, stereo)) {
         return false;
     }
+    context->vrsManager.Initialize(backend);
 
-    // Initialize Render Event Handler
-    renderEventHandler = new RenderEventHandler(&vrsManager, &gazeManager);
+    // Initialize Gaze Manager
+    context->gazeManager.Initialize(context->tanHalfHorizontalFov, context->tanHalfVerticalFov, stereo);
 
+    // Render events handle the context from here on
+    context->initialized.store(true, std::memory_order_release);
     return true;
 }
 
 // Release foveated rendering resources
-void PluginInterface::ReleaseFoveatedRendering() {
-    gazeManager.Release();
-    vrsManager.Release();
+void PluginInterface::ReleaseFoveatedRendering(FoveationContextId id) {
+    FoveationContext* context = contexts.Get(id);
+    if (context) {
+        ReleaseContext(*context);
+    }
+}
+
+void PluginInterface::ReleaseContext(FoveationContext& context) {
+    context.initialized.store(false, std::memory_order_release);
+    if (context.backend) {
+        context.backend->Release();
+    }
+    context.vrsManager.Release();
+}
+
+VrsBackendType PluginInterface::GetVrsBackendType() const {
+    return defaultContext->backend ? defaultContext->backend->GetType() : VrsBackendType::SOFTWARE;
+}
 
-    if (renderEventHandler) {
-        delete renderEventHandler;
-        renderEventHandler = nullptr;
+void PluginInterface::ConfigureVrsRenderTarget(FoveationContextId id, int width, int height) {
+    FoveationContext* context = contexts.Get(id);
+    if (context && context->backend) {
+        context->backend->ConfigureRenderTarget(width, height);
     }
 }
 
+void* PluginInterface::GetNativeShadingRateImage(FoveationContextId id) const {
+    FoveationContext* context = contexts.Get(id);
+    return context && context->backend ? context->backend->GetNativeShadingRateImage() : nullptr;
+}
+
+void PluginInterface::ConfigureContentShading(const ContentShadingSettings& settings) {
+    contentShadingSettings = settings;
+    for (int slot = 0; slot < FoveationContextPool::MAX_CONTEXTS; ++slot) {
+        FoveationContext* context = contexts.GetSlot(slot);
+        if (context && context->backend) {
+            context->backend->ConfigureContentShading(settings);
+        }
+    }
+}
+
+bool PluginInterface::SubmitContentFrame(const VrsContentFrame& frame) {
+    return defaultContext->backend ? defaultContext->backend->SubmitContentFrame(frame) : false;
+}
+
+ContentShadingStats PluginInterface::GetContentShadingStats() const {
+    return defaultContext->backend ? defaultContext->backend->GetContentShadingStats() : ContentShadingStats{};
+}
+
 // Configuration APIs
+void PluginInterface::SubmitVrsConfiguration(FoveationContextId id, const VrsConfiguration& config) {
+    FoveationContext* context = contexts.Get(id);
+    if (!context) {
+        return;
+    }
+
+    context->vrsManager.SubmitConfiguration(config);
+    if (context == defaultContext) {
+        RecordTraceConfiguration();
+    }
+}
+
+VrsConfiguration PluginInterface::GetVrsConfiguration(FoveationContextId id) const {
+    FoveationContext* context = contexts.Get(id);
+    return context ? context->vrsManager.GetConfiguration() : VrsConfiguration{};
+}
+
+bool PluginInterface::LoadFoveationPreset(const char* path, int index, VrsConfiguration& config) {
+    std::vector<FoveationPresetEntry> entries;
+    if (!ReadFoveationPresets(path, entries) || index < 0 || index >= static_cast<int>(entries.size())) {
+        return false;
+    }
+
+    const FoveationDesc& desc = entries[index].desc;
+    VrsConfiguration loaded = {
+        ShadingRatePreset::CUSTOM,
+        ShadingPatternPreset::CUSTOM,
+        desc.innerRadii,
+        desc.middleRadii,
+        desc.peripheralRadii,
+        desc.innerRate,
+        desc.middleRate,
+        desc.peripheralRate
+    };
+    SubmitVrsConfiguration(DEFAULT_FOVEATION_CONTEXT, loaded);
+    config = defaultContext->vrsManager.GetConfiguration();
+    return true;
+}
+
 void PluginInterface::SetShadingRatePreset(ShadingRatePreset preset) {
-    vrsManager.SetShadingRatePreset(preset);
+    defaultContext->vrsManager.SetShadingRatePreset(preset);
+    RecordTraceConfiguration();
 }
 
 void PluginInterface::SetFoveationPatternPreset(ShadingPatternPreset preset) {
-    vrsManager.SetFoveationPatternPreset(preset);
+    defaultContext->vrsManager.SetFoveationPatternPreset(preset);
+    RecordTraceConfiguration();
 }
 
 void PluginInterface::ConfigureRegionRadii(TargetArea targetArea, float xRadius, float yRadius) {
-    vrsManager.ConfigureRegionRadii(targetArea, xRadius, yRadius);
+    defaultContext->vrsManager.ConfigureRegionRadii(targetArea, xRadius, yRadius);
+    RecordTraceConfiguration();
 }
 
 void PluginInterface::ConfigureShadingRate(TargetArea targetArea, ShadingRate rate) {
-    vrsManager.ConfigureShadingRate(targetArea, rate);
+    defaultContext->vrsManager.ConfigureShadingRate(targetArea, rate);
+    RecordTraceConfiguration();
+}
+
+void PluginInterface::UpdateGazeDirection(FoveationContextId id, const Vector3& gazeDir) {
+    // The gaze ring has a single producer, the receiver owns the default context's while running
+    FoveationContext* context = contexts.Get(id);
+    if (context && (context != defaultContext || !IsNativeGazeRunning())) {
+        context->gazeManager.UpdateGazeDirection(gazeDir);
+    }
+}
+
+void PluginInterface::UpdateStereoGazeDirection(FoveationContextId id, const Vector3& leftGazeDir, const Vector3& rightGazeDir) {
+    FoveationContext* context = contexts.Get(id);
+    if (context && (context != defaultContext || !IsNativeGazeRunning())) {
+        context->gazeManager.UpdateStereoGazeDirection(leftGazeDir, rightGazeDir);
+    }
+}
+
+void PluginInterface::SetRenderMode(FoveationContextId id, RenderMode mode) {
+    FoveationContext* context = contexts.Get(id);
+    if (!context) {
+        return;
+    }
+
+    RenderMode clampedMode = static_cast<RenderMode>(Clamp(static_cast<int>(mode), static_cast<int>(RenderMode::MONO), static_cast<int>(RenderMode::STEREO)));
+    context->vrsManager.SetRenderMode(clampedMode);
+    context->gazeManager.SetStereo(clampedMode != RenderMode::MONO);
+}
+
+void PluginInterface::ConfigureViewFrustum(FoveationContextId id, Eye eye, const ViewFrustum& frustum) {
+    FoveationContext* context = contexts.Get(id);
+    if (context) {
+        context->gazeManager.ConfigureViewFrustum(eye, frustum);
+    }
+}
+
+Vector2 PluginInterface::GetGazePosition(FoveationContextId id, Eye eye) const {
+    FoveationContext* context = contexts.Get(id);
+    return context ? context->gazeManager.GetGazePosition(eye) : Vector2{};
+}
+
+void PluginInterface::ConfigureGazePrediction(const GazePredictionSettings& settings) {
+    gazePredictionConfigured = true;
+    gazePredictionSettings = settings;
+    for (int slot = 0; slot < FoveationContextPool::MAX_CONTEXTS; ++slot) {
+        FoveationContext* context = contexts.GetSlot(slot);
+        if (context) {
+            context->gazeManager.ConfigurePrediction(settings);
+        }
+    }
+}
+
+void PluginInterface::ConfigureGazeFilters(const GazeFilterType* types, int count, const GazeFilterSettings& settings) {
+    gazeFiltersConfigured = true;
+    gazeFilterTypes.assign(types, types + (types ? (std::max)(count, 0) : 0));
+    gazeFilterSettings = settings;
+    for (int slot = 0; slot < FoveationContextPool::MAX_CONTEXTS; ++slot) {
+        FoveationContext* context = contexts.GetSlot(slot);
+        if (context) {
+            context->gazeManager.ConfigureFilters(types, count, settings);
+        }
+    }
+}
+
+void PluginInterface::ApplyGazeSettings(FoveationContext& context) {
+    if (gazePredictionConfigured) {
+        context.gazeManager.ConfigurePrediction(gazePredictionSettings);
+    }
+    if (gazeFiltersConfigured) {
+        context.gazeManager.ConfigureFilters(gazeFilterTypes.data(), static_cast<int>(gazeFilterTypes.size()), gazeFilterSettings);
+    }
+}
+
+EyeMovementState PluginInterface::GetEyeMovementState() const {
+    return defaultContext->gazeManager.GetEyeMovementState();
+}
+
+bool PluginInterface::StartGazeReceiver(uint16_t port) {
+    return !sharedGazeReader.IsRunning() && gazeReceiver.Start(port, &defaultContext->gazeManager);
+}
+
+void PluginInterface::StopGazeReceiver() {
+    gazeReceiver.Stop();
+}
+
+GazeReceiverStats PluginInterface::GetGazeReceiverStats() const {
+    return gazeReceiver.GetStats();
+}
+
+bool PluginInterface::StartSharedGazeReader(const char* name) {
+    return !gazeReceiver.IsRunning() && sharedGazeReader.Start(name, &defaultContext->gazeManager);
+}
+
+void PluginInterface::StopSharedGazeReader() {
+    sharedGazeReader.Stop();
+}
+
+SharedGazeReaderStats PluginInterface::GetSharedGazeReaderStats() const {
+    return sharedGazeReader.GetStats();
+}
+
+bool PluginInterface::IsNativeGazeRunning() const {
+    return gazeReceiver.IsRunning() || sharedGazeReader.IsRunning();
 }
 
-void PluginInterface::UpdateGazeDirection(const Vector3& gazeDir) {
-    gazeManager.UpdateGazeDirection(gazeDir, tanHalfHorizontalFov, tanHalfVerticalFov, 0.05f);
+GazeLatencyStats PluginInterface::GetGazeLatencyStats() const {
+    return defaultContext->gazeManager.GetLatencyStats();
+}
+
+void PluginInterface::ResetGazeLatencyStats() {
+    defaultContext->gazeManager.ResetLatencyStats();
+}
+
+int PluginInterface::UpdateShadingRateImage(int width, int height, int tileSize, unsigned char* buffer, int bufferSize) {
+    if (!shadingRateImage.Matches(width, height, tileSize)) {
+        if (!shadingRateImage.Initialize(width, height, tileSize)) {
+            return 0;
+        }
+    }
+
+    shadingRateImage.Update(defaultContext->gazeManager.GetGazePosition(), defaultContext->vrsManager.GetPublishedFoveationState().desc);
+
+    int size = static_cast<int>(shadingRateImage.GetSize());
+    if (!buffer || bufferSize < size) {
+        return 0;
+    }
+
+    memcpy(buffer, shadingRateImage.GetData(), size);
+    return size;
 }
 
 // Static callback function forwarding to instance method
@@ -127,18 +411,174 @@ void UNITY_INTERFACE_API PluginInterface::OnGraphicsDeviceEvent(UnityGfxDeviceEv
 
 // Internal method to handle graphics device events
 void PluginInterface::HandleGraphicsDeviceEventInternal(UnityGfxDeviceEventType eventType) {
-    switch (eventType) {
-    case kUnityGfxDeviceEventInitialize:
-        if (unityInterfaces) {
-            // Retrieve the Direct3D 11 device from Unity
-            device = unityInterfaces->Get<IUnityGraphicsD3D11>()->GetDevice();
-            nvApiWrapper.Initialize(device);
+    contexts.Reclaim();
+    for (int slot = 0; slot < FoveationContextPool::MAX_CONTEXTS; ++slot) {
+        FoveationContext* context = contexts.GetSlot(slot);
+        if (!context) {
+            continue;
+        }
+
+        switch (eventType) {
+        case kUnityGfxDeviceEventInitialize:
+            if (unityInterfaces) {
+                CreateBackend(*context);
+            }
+            break;
+        case kUnityGfxDeviceEventShutdown:
+            // Backend resources belong to the device being shut down
+            ReleaseContext(*context);
+            DestroyBackend(*context);
+            break;
+        default:
+            break;
         }
+    }
+}
+
+void PluginInterface::CreateBackend(FoveationContext& context) {
+    DestroyBackend(context);
+
+    IVrsBackend* backend = nullptr;
+    switch (unityGraphics->GetRenderer()) {
+#if VRS_BACKEND_D3D
+    case kUnityGfxRendererD3D11:
+        // Null without NVAPI, other vendors have no D3D11 VRS
+        backend = NvApiVrsBackend::Create(unityInterfaces->Get<IUnityGraphicsD3D11>()->GetDevice());
+        break;
+    case kUnityGfxRendererD3D12:
+        backend = new D3D12VrsBackend(unityInterfaces->Get<IUnityGraphicsD3D12v5>());
         break;
-    case kUnityGfxDeviceEventShutdown:
-        // Unload NVidia API upon device shutdown
-        nvApiWrapper.Unload();
-        device = nullptr;
+#endif
+#if VRS_BACKEND_VULKAN
+    case kUnityGfxRendererVulkan:
+        backend = new VulkanVrsBackend(unityInterfaces->Get<IUnityGraphicsVulkan>());
         break;
+#endif
+    case kUnityGfxRendererNull:
+        // Batch mode without graphics, rate maps are only recorded
+        backend = new SoftwareVrsBackend();
+        break;
+    default:
+        break;
+    }
+
+    if (backend) {
+        backend->ConfigureContentShading(contentShadingSettings);
+    }
+    context.backend = backend;
+}
+
+void PluginInterface::DestroyBackend(FoveationContext& context) {
+    if (context.backend) {
+        delete context.backend;
+        context.backend = nullptr;
+    }
+}
+
+void PluginInterface::ConfigureFoveationGovernor(const FoveationGovernorSettings& settings) {
+    foveationGovernor.Configure(settings);
+}
+
+void PluginInterface::SubmitFrameTime(float frameTimeMs) {
+    foveationGovernor.SubmitFrameTime(frameTimeMs);
+}
+
+FoveationGovernorState PluginInterface::GetFoveationGovernorState() const {
+    return foveationGovernor.GetState();
+}
+
+ShadingCostEstimate PluginInterface::QueryShadingCost(int width, int height, int tileSize, const Vector2& gazePos) const {
+    return EstimateShadingCost(width, height, tileSize, gazePos, defaultContext->vrsManager.GetPublishedFoveationState().desc);
+}
+
+void PluginInterface::ConfigureShadingCostTelemetry(int width, int height, int tileSize) {
+    shadingCostTelemetry.Configure(width, height, tileSize);
+}
+
+ShadingCostTelemetryStats PluginInterface::GetShadingCostTelemetry() const {
+    return shadingCostTelemetry.GetStats();
+}
+
+void PluginInterface::ResetShadingCostTelemetry() {
+    shadingCostTelemetry.Reset();
+}
+
+InstrumentationStats PluginInterface::GetInstrumentationStats() const {
+    return instrumentation.GetStats();
+}
+
+void PluginInterface::ResetInstrumentationStats() {
+    instrumentation.Reset();
+}
+
+void PluginInterface::SetInstrumentationTracing(bool enabled) {
+    instrumentation.SetTracing(enabled);
+}
+
+int PluginInterface::WriteInstrumentationTrace(const char* path) const {
+    return instrumentation.WriteChromeTrace(path);
+}
+
+int PluginInterface::ClassifyFoveatedLods(const LodClassifierParams &params, const LodObjectBatch &batch, int32_t *changed, int changedCapacity) {
+    return lodClassifier.Classify(params, batch, changed, changedCapacity);
+}
+
+void PluginInterface::InsertLodObjects(const float *positionX, const float *positionY, const float *positionZ, const float *radius,
+    const int32_t *coarsestLod, int count, int32_t *handles) {
+    lodSpatialIndex.Insert(positionX, positionY, positionZ, radius, coarsestLod, count, handles);
+}
+
+void PluginInterface::UpdateLodObjects(const int32_t *handles, const float *positionX, const float *positionY, const float *positionZ,
+    const float *radius, int count) {
+    lodSpatialIndex.Update(handles, positionX, positionY, positionZ, radius, count);
+}
+
+void PluginInterface::RemoveLodObjects(const int32_t *handles, int count) {
+    lodSpatialIndex.Remove(handles, count);
+}
+
+void PluginInterface::ClearLodObjects() {
+    lodSpatialIndex.Clear();
+}
+
+int PluginInterface::ClassifyLodObjects(const LodClassifierParams &params, int32_t *changedHandles, int32_t *changedLods, int capacity) {
+    return lodSpatialIndex.Classify(params, changedHandles, changedLods, capacity);
+}
+
+LodSpatialIndexStats PluginInterface::GetLodSpatialIndexStats() const {
+    return lodSpatialIndex.GetStats();
+}
+
+bool PluginInterface::StartTraceRecording(const char* path) {
+    if (!traceWriter.Open(path, GetTimestampMicroseconds())) {
+        return false;
+    }
+
+    // A replay starts from the configuration in effect when recording began
+    RecordTraceConfiguration();
+    return true;
+}
+
+void PluginInterface::StopTraceRecording() {
+    traceWriter.Close();
+}
+
+void PluginInterface::RecordTraceFrame(const Vector3& cameraPosition, const Quaternion& cameraRotation, float frameTimeMs) {
+    if (!traceWriter.IsOpen()) {
+        return;
+    }
+
+    uint64_t now = GetTimestampMicroseconds();
+    traceWriter.RecordCameraPose(now, cameraPosition, cameraRotation);
+    traceWriter.RecordFrame(now, frameTimeMs);
+}
+
+TraceWriterStats PluginInterface::GetTraceRecordingStats() const {
+    return traceWriter.GetStats();
+}
+
+void PluginInterface::RecordTraceConfiguration() {
+    if (traceWriter.IsOpen()) {
+        traceWriter.RecordConfiguration(GetTimestampMicroseconds(), defaultContext->vrsManager.GetConfiguration());
     }
 }
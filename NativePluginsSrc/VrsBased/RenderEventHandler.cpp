@@ -1,26 +1,189 @@
 #include "RenderEventHandler.h"
 
-RenderEventHandler::RenderEventHandler(VrsManager *vrsMgr, GazeManager *gazeMgr)
-    : vrsManager(vrsMgr), gazeManager(gazeMgr) {
+RenderEventHandler::RenderEventHandler(FoveationContextPool *contextPool, FoveationGovernor *governor, ShadingCostTelemetry *costTelemetry,
+                                       Instrumentation *instrumentationPtr)
+    : contexts(contextPool), foveationGovernor(governor), shadingCostTelemetry(costTelemetry), instrumentation(instrumentationPtr),
+    deviceOwner(nullptr), governedActive(false), governedDesc{} {
 }
 
 RenderEventHandler::~RenderEventHandler() {
 }
 
-void RenderEventHandler::HandleEvent(EventID eventID, ID3D11DeviceContext *deviceContext, ID3DNvVRSHelper *vrsHelper) {
+FoveationContext *RenderEventHandler::GetActiveContext(FoveationContextId contextId) const {
+    FoveationContext *context = contexts->Get(contextId);
+    return context && context->initialized.load(std::memory_order_acquire) ? context : nullptr;
+}
+
+void RenderEventHandler::HandleEvent(EventID eventID, FoveationContextId contextId) {
+    ScopedTrace trace(instrumentation, TraceScope::HANDLE_EVENT);
+    FoveationContext *context = GetActiveContext(contextId);
+    if (!context) {
+        trace.SetResult(VrsResult::SKIPPED);
+        return;
+    }
+
     switch (eventID) {
         case EventID::ENABLE_FOVEATED_RENDERING:
-            vrsManager->ApplyShadingRatePattern(deviceContext, NV_VRS_RENDER_MODE_MONO);
+            Enable(context->vrsManager.GetRenderMode(), *context);
+            break;
+        case EventID::ENABLE_FOVEATED_RENDERING_LEFT_EYE:
+            Enable(RenderMode::LEFT_EYE, *context);
+            break;
+        case EventID::ENABLE_FOVEATED_RENDERING_RIGHT_EYE:
+            Enable(RenderMode::RIGHT_EYE, *context);
             break;
         case EventID::DISABLE_FOVEATED_RENDERING:
-            vrsManager->RemoveShadingRatePattern(deviceContext);
+            Disable(*context);
             break;
         case EventID::UPDATE_GAZE:
-            if (gazeManager->RefreshGazeData(deviceContext)) {
-                gazeManager->CommitGazeData(vrsHelper, deviceContext);
-            }
+            LatchGaze(*context);
+            break;
+        case EventID::PRESENT_FRAME:
+            PresentFrame();
             break;
         default:
+            trace.SetResult(VrsResult::SKIPPED);
             break;
     }
 }
+
+bool RenderEventHandler::HandlePacket(const RenderCommandPacket &packet, FoveationContextId contextId) {
+    ScopedTrace trace(instrumentation, TraceScope::HANDLE_EVENT);
+    if (packet.version != RENDER_COMMAND_PACKET_VERSION || packet.count < 0 || packet.count > MAX_RENDER_COMMANDS) {
+        trace.SetResult(VrsResult::FAILED);
+        return false;
+    }
+
+    // Operations addressing an unknown context are skipped until the next selection
+    FoveationContext *context = GetActiveContext(contextId);
+    for (int i = 0; i < packet.count; ++i) {
+        const RenderCommand &command = packet.commands[i];
+        RenderCommandOp op = static_cast<RenderCommandOp>(command.op);
+        if (op == RenderCommandOp::SELECT_CONTEXT) {
+            context = GetActiveContext(command.mode);
+            continue;
+        }
+        if (!context) {
+            continue;
+        }
+
+        switch (op) {
+            case RenderCommandOp::LATCH_GAZE:
+                LatchGaze(*context);
+                break;
+            case RenderCommandOp::LATCH_CONFIGURATION:
+                ApplyGovernedFoveation(*context);
+                context->vrsManager.LatchConfiguration();
+                break;
+            case RenderCommandOp::ENABLE: {
+                RenderMode mode = context->vrsManager.GetRenderMode();
+                if (command.mode >= static_cast<int>(RenderMode::MONO) && command.mode <= static_cast<int>(RenderMode::STEREO)) {
+                    mode = static_cast<RenderMode>(command.mode);
+                }
+                Enable(mode, *context);
+                break;
+            }
+            case RenderCommandOp::DISABLE:
+                Disable(*context);
+                break;
+            case RenderCommandOp::PRESENT_FRAME:
+                PresentFrame();
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+void RenderEventHandler::LatchGaze(FoveationContext &context) {
+    VrsGazeFrame gazeFrame;
+    {
+        ScopedTrace trace(instrumentation, TraceScope::GAZE_REFRESH);
+        if (!context.gazeManager.RefreshGazeData(gazeFrame)) {
+            trace.SetResult(VrsResult::SKIPPED);
+        }
+    }
+
+    ScopedTrace trace(instrumentation, TraceScope::GAZE_LATCH);
+    VrsResult result = context.backend && context.backend->UpdateGaze(gazeFrame) ? VrsResult::APPLIED : VrsResult::FAILED;
+    trace.SetResult(result);
+    RecordFailure(result, context.backend);
+}
+
+void RenderEventHandler::Enable(RenderMode mode, FoveationContext &context) {
+    if (!context.enabled.load(std::memory_order_relaxed)) {
+        // The device may still hold the rates of the previously rendered view
+        Disable(context);
+        return;
+    }
+
+    ApplyGovernedFoveation(context);
+    ClaimDevice(context);
+
+    ScopedTrace trace(instrumentation, TraceScope::ENABLE);
+    VrsResult result = context.vrsManager.ApplyShadingRatePattern(mode);
+    trace.SetResult(result);
+    RecordFailure(result, context.backend);
+}
+
+void RenderEventHandler::Disable(FoveationContext &context) {
+    ClaimDevice(context);
+
+    ScopedTrace trace(instrumentation, TraceScope::DISABLE);
+    VrsResult result = context.vrsManager.RemoveShadingRatePattern();
+    trace.SetResult(result);
+    RecordFailure(result, context.backend);
+}
+
+void RenderEventHandler::ClaimDevice(FoveationContext &context) {
+    // Backends of all contexts share the device, the rates of the previously rendered view may still be set.
+    // A deleted backend's address may come back, fresh backends hold no cache to trust.
+    if (context.backend && context.backend != deviceOwner) {
+        context.backend->InvalidateAppliedState();
+        deviceOwner = context.backend;
+    }
+}
+
+void RenderEventHandler::RecordFailure(VrsResult result, IVrsBackend *backend) {
+    if (result == VrsResult::FAILED && backend) {
+        instrumentation->RecordNativeError(backend->GetLastNativeError());
+    }
+}
+
+void RenderEventHandler::PresentFrame() {
+    // Every view of the frame presents together
+    for (int slot = 0; slot < FoveationContextPool::MAX_CONTEXTS; ++slot) {
+        FoveationContext *presented = contexts->GetSlot(slot);
+        if (presented && presented->initialized.load(std::memory_order_acquire)) {
+            presented->gazeManager.RecordFramePresent();
+        }
+    }
+
+    // The cost log follows the main view, the governor regulates on it
+    FoveationContext *mainView = GetActiveContext(DEFAULT_FOVEATION_CONTEXT);
+    if (mainView) {
+        const VrsFoveationState &foveation = mainView->vrsManager.GetFoveationState();
+        shadingCostTelemetry->RecordFrame(foveation.ratePreset, foveation.patternPreset, mainView->gazeManager.GetRenderedGazePosition(), foveation.desc);
+    }
+}
+
+void RenderEventHandler::ApplyGovernedFoveation(FoveationContext &context) {
+    if (&context != contexts->Get(DEFAULT_FOVEATION_CONTEXT)) {
+        return;
+    }
+
+    FoveationDesc desc;
+    bool active;
+    if (foveationGovernor->ConsumeFoveation(desc, active)) {
+        governedActive = active;
+        governedDesc = desc;
+    }
+
+    // Both calls return at once while the context already follows the decision
+    if (governedActive) {
+        context.vrsManager.SetFoveationOverride(governedDesc);
+    } else {
+        context.vrsManager.ClearFoveationOverride();
+    }
+}
@@ -0,0 +1,269 @@
+#include "ShadingCostModel.h"
+#include "Utils.h"
+#include <cmath>
+
+float GetShadingRateCost(ShadingRate rate) {
+    switch (rate) {
+    case ShadingRate::CULL:
+        return 0.0f;
+    case ShadingRate::X16_PER_PIXEL:
+        return 16.0f;
+    case ShadingRate::X8_PER_PIXEL:
+        return 8.0f;
+    case ShadingRate::X4_PER_PIXEL:
+        return 4.0f;
+    case ShadingRate::X2_PER_PIXEL:
+        return 2.0f;
+    case ShadingRate::X1_PER_2X1_PIXELS:
+    case ShadingRate::X1_PER_1X2_PIXELS:
+        return 1.0f / 2.0f;
+    case ShadingRate::X1_PER_2X2_PIXELS:
+        return 1.0f / 4.0f;
+    case ShadingRate::X1_PER_4X2_PIXELS:
+    case ShadingRate::X1_PER_2X4_PIXELS:
+        return 1.0f / 8.0f;
+    case ShadingRate::X1_PER_4X4_PIXELS:
+        return 1.0f / 16.0f;
+    case ShadingRate::X1_PER_PIXEL:
+    default:
+        return 1.0f;
+    }
+}
+
+// Antiderivative of sqrt(1 - x^2) on [-1, 1]
+static double CircleIntegral(double x) {
+    return 0.5 * (x * sqrt((std::max)(1.0 - x * x, 0.0)) + asin(Clamp(x, -1.0, 1.0)));
+}
+
+// Area of the unit disk inside [x0, x1] x [y0, y1].
+// Between consecutive breakpoints (where the disk boundary meets y0 or y1) the
+// upper and lower bounds each follow either a rectangle edge or the circle.
+static double ClippedUnitDiskArea(double x0, double x1, double y0, double y1) {
+    x0 = (std::max)(x0, -1.0);
+    x1 = (std::min)(x1, 1.0);
+    if (x0 >= x1 || y0 >= y1) {
+        return 0.0;
+    }
+
+    double points[6] = {x0, x1};
+    int count = 2;
+    for (double y : {y0, y1}) {
+        if (fabs(y) < 1.0) {
+            double x = sqrt(1.0 - y * y);
+            if (x > x0 && x < x1) points[count++] = x;
+            if (-x > x0 && -x < x1) points[count++] = -x;
+        }
+    }
+
+    // At most six breakpoints, an insertion sort keeps the bounds visible to the compiler
+    for (int i = 1; i < count; ++i) {
+        double point = points[i];
+        int j = i;
+        for (; j > 0 && points[j - 1] > point; --j) {
+            points[j] = points[j - 1];
+        }
+        points[j] = point;
+    }
+
+    double area = 0.0;
+    for (int i = 0; i + 1 < count; ++i) {
+        double from = points[i];
+        double to = points[i + 1];
+        double middle = 0.5 * (from + to);
+        double half = sqrt((std::max)(1.0 - middle * middle, 0.0));
+        if ((std::min)(y1, half) <= (std::max)(y0, -half)) {
+            continue;
+        }
+
+        double circle = CircleIntegral(to) - CircleIntegral(from);
+        area += y1 < half ? y1 * (to - from) : circle;
+        area -= y0 > -half ? y0 * (to - from) : -circle;
+    }
+    return area;
+}
+
+// Pixel area of an ellipse in normalized gaze space clipped to the render target
+static double ClippedEllipseArea(int width, int height, const Vector2 &gazePos, const Vector2 &radii) {
+    if (radii.x <= 0.0f || radii.y <= 0.0f) {
+        return 0.0;
+    }
+
+    // Unit disk coordinates of the screen rectangle [-0.5, 0.5]^2
+    double x0 = (-0.5 - gazePos.x) / radii.x;
+    double x1 = (0.5 - gazePos.x) / radii.x;
+    double y0 = (-0.5 - gazePos.y) / radii.y;
+    double y1 = (0.5 - gazePos.y) / radii.y;
+    return ClippedUnitDiskArea(x0, x1, y0, y1) * radii.x * radii.y * width * height;
+}
+
+// Tile columns of a row whose centers lie inside the ellipse, end is exclusive.
+// Must stay in sync with ShadingRateImage::ComputeEllipseSpans.
+static void GetEllipseSpan(int row, int tilesX, float tilesPerUnitX, float rowStep, const Vector2 &gazePos, const Vector2 &radii,
+                           int &first, int &last) {
+    float offset = (gazePos.x + 0.5f) * tilesPerUnitX - 0.5f;
+    if (radii.x <= 0.0f || radii.y <= 0.0f) {
+        first = last = 0;
+        return;
+    }
+
+    float dy = (0.5f - gazePos.y) - (row + 0.5f) * rowStep;
+    float t = 1.0f - dy * dy / (radii.y * radii.y);
+    float half = radii.x * tilesPerUnitX * sqrtf((std::max)(t, 0.0f));
+    first = Clamp(static_cast<int>(ceilf(offset - half)), 0, tilesX);
+    last = Clamp(static_cast<int>(floorf(offset + half)) + 1, 0, tilesX);
+    if (t < 0.0f || last < first) {
+        last = first;
+    }
+}
+
+ShadingCostEstimate EstimateShadingCost(int width, int height, int tileSize, const Vector2 &gazePos, const FoveationDesc &desc) {
+    ShadingCostEstimate estimate = {};
+    if (width <= 0 || height <= 0) {
+        return estimate;
+    }
+    tileSize = (std::max)(tileSize, 1);
+
+    double pixels = static_cast<double>(width) * height;
+    estimate.pixels = static_cast<uint64_t>(width) * height;
+
+    // Exact regions, nested ellipses assumed as in every preset
+    double innerArea = ClippedEllipseArea(width, height, gazePos, desc.innerRadii);
+    double middleArea = (std::max)(ClippedEllipseArea(width, height, gazePos, desc.middleRadii) - innerArea, 0.0);
+    estimate.analyticCoverage[0] = static_cast<float>(innerArea / pixels);
+    estimate.analyticCoverage[1] = static_cast<float>(middleArea / pixels);
+    estimate.analyticCoverage[2] = static_cast<float>((std::max)(1.0 - (innerArea + middleArea) / pixels, 0.0));
+
+    // Tile correction: walk the tile rows once, counting the pixels of partial edge tiles exactly
+    int tilesX = (width + tileSize - 1) / tileSize;
+    int tilesY = (height + tileSize - 1) / tileSize;
+    float tilesPerUnitX = static_cast<float>(width) / tileSize;
+    float rowStep = static_cast<float>(tileSize) / height;
+    double tileInner = 0.0;
+    double tileMiddle = 0.0;
+    for (int row = 0; row < tilesY; ++row) {
+        int innerFirst, innerLast, middleFirst, middleLast;
+        GetEllipseSpan(row, tilesX, tilesPerUnitX, rowStep, gazePos, desc.innerRadii, innerFirst, innerLast);
+        GetEllipseSpan(row, tilesX, tilesPerUnitX, rowStep, gazePos, desc.middleRadii, middleFirst, middleLast);
+
+        auto columnPixels = [&](int first, int last) {
+            return first < last ? (std::min)(last * tileSize, width) - first * tileSize : 0;
+        };
+        int overlapFirst = (std::max)(innerFirst, middleFirst);
+        int overlapLast = (std::min)(innerLast, middleLast);
+        int innerPixels = columnPixels(innerFirst, innerLast);
+        int middlePixels = columnPixels(middleFirst, middleLast) - columnPixels(overlapFirst, overlapLast);
+
+        int rowHeight = (std::min)((row + 1) * tileSize, height) - row * tileSize;
+        tileInner += static_cast<double>(innerPixels) * rowHeight;
+        tileMiddle += static_cast<double>(middlePixels) * rowHeight;
+    }
+    double tilePeripheral = (std::max)(pixels - tileInner - tileMiddle, 0.0);
+    estimate.regionCoverage[0] = static_cast<float>(tileInner / pixels);
+    estimate.regionCoverage[1] = static_cast<float>(tileMiddle / pixels);
+    estimate.regionCoverage[2] = static_cast<float>(tilePeripheral / pixels);
+
+    estimate.invocations = tileInner * GetShadingRateCost(desc.innerRate) + tileMiddle * GetShadingRateCost(desc.middleRate) +
+                           tilePeripheral * GetShadingRateCost(desc.peripheralRate);
+    estimate.relativeCost = static_cast<float>(estimate.invocations / pixels);
+    estimate.savedFraction = 1.0f - estimate.relativeCost;
+    return estimate;
+}
+
+// Constructor
+ShadingCostTelemetry::ShadingCostTelemetry()
+    : targetWidth(0), targetHeight(0), targetTileSize(16), resetPending(true), frames(0), lastFrameVersion(0),
+    lastPixels(0), lastInvocations(0.0) {
+    for (int i = 0; i < 3; ++i) {
+        lastRegionCoverage[i].store(0.0f, std::memory_order_relaxed);
+        lastAnalyticCoverage[i].store(0.0f, std::memory_order_relaxed);
+    }
+}
+
+// Destructor
+ShadingCostTelemetry::~ShadingCostTelemetry() {
+}
+
+void ShadingCostTelemetry::Configure(int width, int height, int tileSize) {
+    targetWidth.store((std::max)(width, 0), std::memory_order_relaxed);
+    targetHeight.store((std::max)(height, 0), std::memory_order_relaxed);
+    targetTileSize.store(Clamp(tileSize, 1, 64), std::memory_order_relaxed);
+}
+
+void ShadingCostTelemetry::RecordFrame(ShadingRatePreset ratePreset, ShadingPatternPreset patternPreset, const Vector2 &gazePos,
+                                       const FoveationDesc &desc) {
+    if (resetPending.exchange(false, std::memory_order_acquire)) {
+        frames.store(0, std::memory_order_relaxed);
+        for (Accumulator &preset : presets) {
+            preset.frames.store(0, std::memory_order_relaxed);
+            preset.relativeCostSum.store(0.0, std::memory_order_relaxed);
+            preset.savedFractionSum.store(0.0, std::memory_order_relaxed);
+        }
+    }
+
+    int width = targetWidth.load(std::memory_order_relaxed);
+    int height = targetHeight.load(std::memory_order_relaxed);
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    ShadingCostEstimate estimate = EstimateShadingCost(width, height, targetTileSize.load(std::memory_order_relaxed), gazePos, desc);
+
+    // Single writer, plain load and store are enough for the sums
+    int rateIndex = Clamp(static_cast<int>(ratePreset), 1, RATE_PRESETS) - 1;
+    int patternIndex = Clamp(static_cast<int>(patternPreset), 1, PATTERN_PRESETS) - 1;
+    Accumulator &preset = presets[rateIndex * PATTERN_PRESETS + patternIndex];
+    preset.relativeCostSum.store(preset.relativeCostSum.load(std::memory_order_relaxed) + estimate.relativeCost, std::memory_order_relaxed);
+    preset.savedFractionSum.store(preset.savedFractionSum.load(std::memory_order_relaxed) + estimate.savedFraction, std::memory_order_relaxed);
+    preset.frames.fetch_add(1, std::memory_order_release);
+
+    uint64_t version = lastFrameVersion.load(std::memory_order_relaxed);
+    lastFrameVersion.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    lastPixels.store(estimate.pixels, std::memory_order_relaxed);
+    for (int i = 0; i < 3; ++i) {
+        lastRegionCoverage[i].store(estimate.regionCoverage[i], std::memory_order_relaxed);
+        lastAnalyticCoverage[i].store(estimate.analyticCoverage[i], std::memory_order_relaxed);
+    }
+    lastInvocations.store(estimate.invocations, std::memory_order_relaxed);
+    lastFrameVersion.store(version + 2, std::memory_order_release);
+
+    frames.fetch_add(1, std::memory_order_relaxed);
+}
+
+ShadingCostTelemetryStats ShadingCostTelemetry::GetStats() const {
+    ShadingCostTelemetryStats stats = {};
+    stats.frames = frames.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < RATE_PRESETS * PATTERN_PRESETS; ++i) {
+        uint64_t count = presets[i].frames.load(std::memory_order_acquire);
+        stats.presets[i].frames = count;
+        if (count > 0) {
+            stats.presets[i].meanRelativeCost = presets[i].relativeCostSum.load(std::memory_order_relaxed) / count;
+            stats.presets[i].meanSavedFraction = presets[i].savedFractionSum.load(std::memory_order_relaxed) / count;
+        }
+    }
+
+    // Retry while the render thread is publishing a frame
+    ShadingCostEstimate &last = stats.lastFrame;
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        uint64_t before = lastFrameVersion.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        last.pixels = lastPixels.load(std::memory_order_relaxed);
+        for (int i = 0; i < 3; ++i) {
+            last.regionCoverage[i] = lastRegionCoverage[i].load(std::memory_order_relaxed);
+            last.analyticCoverage[i] = lastAnalyticCoverage[i].load(std::memory_order_relaxed);
+        }
+        last.invocations = lastInvocations.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (lastFrameVersion.load(std::memory_order_relaxed) == before) {
+            break;
+        }
+    }
+    if (last.pixels > 0) {
+        last.relativeCost = static_cast<float>(last.invocations / static_cast<double>(last.pixels));
+        last.savedFraction = 1.0f - last.relativeCost;
+    }
+    return stats;
+}
@@ -0,0 +1,227 @@
+#include "ShadingRateImage.h"
+#include "Utils.h"
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define SHADING_RATE_IMAGE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Constructor
+ShadingRateImage::ShadingRateImage()
+    : targetWidth(0), targetHeight(0), tileSize(0), tilesX(0), tilesY(0),
+    lastDesc{}, valid(false), dirtyRect{0, 0, 0, 0} {
+}
+
+// Destructor
+ShadingRateImage::~ShadingRateImage() {
+}
+
+bool ShadingRateImage::Initialize(int width, int height, int tile) {
+    if (width <= 0 || height <= 0 || tile <= 0) {
+        return false;
+    }
+
+    targetWidth = width;
+    targetHeight = height;
+    tileSize = tile;
+    tilesX = (width + tile - 1) / tile;
+    tilesY = (height + tile - 1) / tile;
+
+    // Pad span arrays to a multiple of four rows for the SIMD path
+    size_t paddedRows = (static_cast<size_t>(tilesY) + 3) & ~static_cast<size_t>(3);
+    for (RowSpans *spans : {&currentSpans, &previousSpans}) {
+        spans->innerBegin.assign(paddedRows, 0);
+        spans->innerEnd.assign(paddedRows, 0);
+        spans->middleBegin.assign(paddedRows, 0);
+        spans->middleEnd.assign(paddedRows, 0);
+    }
+
+    tiles.assign(static_cast<size_t>(tilesX) * tilesY, 0);
+    Invalidate();
+    return true;
+}
+
+void ShadingRateImage::Invalidate() {
+    valid = false;
+}
+
+int ShadingRateImage::Update(const Vector2 &gazePos, const FoveationDesc &desc) {
+    dirtyRect = {tilesX, tilesY, 0, 0};
+    if (tiles.empty()) {
+        return 0;
+    }
+
+    std::swap(currentSpans, previousSpans);
+    ComputeEllipseSpans(gazePos, desc.innerRadii, currentSpans.innerBegin.data(), currentSpans.innerEnd.data());
+    ComputeEllipseSpans(gazePos, desc.middleRadii, currentSpans.middleBegin.data(), currentSpans.middleEnd.data());
+
+    // Rates or geometry changed underneath the spans, everything must be rewritten
+    bool fullRebuild = !valid || !IsSameFoveation(desc, lastDesc);
+    lastDesc = desc;
+    valid = true;
+
+    int written = 0;
+    for (int row = 0; row < tilesY; ++row) {
+        if (fullRebuild) {
+            FillRow(row, 0, tilesX, desc);
+            written += tilesX;
+            MarkDirty(row, 0, tilesX);
+            continue;
+        }
+
+        // A tile changes class only between the old and new position of a span edge
+        int edges[4][2] = {
+            {previousSpans.innerBegin[row], currentSpans.innerBegin[row]},
+            {previousSpans.innerEnd[row], currentSpans.innerEnd[row]},
+            {previousSpans.middleBegin[row], currentSpans.middleBegin[row]},
+            {previousSpans.middleEnd[row], currentSpans.middleEnd[row]}
+        };
+
+        std::pair<int, int> intervals[4];
+        int count = 0;
+        for (auto &edge : edges) {
+            if (edge[0] != edge[1]) {
+                intervals[count++] = {(std::min)(edge[0], edge[1]), (std::max)(edge[0], edge[1])};
+            }
+        }
+
+        // At most four intervals, an insertion sort keeps the bounds visible to the compiler
+        for (int i = 1; i < count; ++i) {
+            std::pair<int, int> interval = intervals[i];
+            int j = i;
+            for (; j > 0 && interval < intervals[j - 1]; --j) {
+                intervals[j] = intervals[j - 1];
+            }
+            intervals[j] = interval;
+        }
+
+        // Merge overlapping intervals so no tile is written twice
+        for (int i = 0; i < count;) {
+            int from = intervals[i].first;
+            int to = intervals[i].second;
+            for (++i; i < count && intervals[i].first <= to; ++i) {
+                to = (std::max)(to, intervals[i].second);
+            }
+
+            FillRow(row, from, to, desc);
+            written += to - from;
+            MarkDirty(row, from, to);
+        }
+    }
+
+    if (written == 0) {
+        dirtyRect = {0, 0, 0, 0};
+    }
+    return written;
+}
+
+void ShadingRateImage::MarkDirty(int row, int from, int to) {
+    dirtyRect.beginX = (std::min)(dirtyRect.beginX, from);
+    dirtyRect.endX = (std::max)(dirtyRect.endX, to);
+    dirtyRect.beginY = (std::min)(dirtyRect.beginY, row);
+    dirtyRect.endY = row + 1;
+}
+
+void ShadingRateImage::ComputeEllipseSpans(const Vector2 &gazePos, const Vector2 &radii, int32_t *begin, int32_t *end) const {
+    // Tile column of a normalized x: tx = (x + 0.5) * tilesPerUnitX - 0.5
+    const float tilesPerUnitX = static_cast<float>(targetWidth) / tileSize;
+    const float rowStep = static_cast<float>(tileSize) / targetHeight;
+    const float offset = (gazePos.x + 0.5f) * tilesPerUnitX - 0.5f;
+    const int rows = static_cast<int>(currentSpans.innerBegin.size());
+
+    // Degenerate ellipse covers nothing
+    if (radii.x <= 0.0f || radii.y <= 0.0f) {
+        int column = Clamp(static_cast<int>(ceilf(offset)), 0, tilesX);
+        std::fill(begin, begin + rows, column);
+        std::fill(end, end + rows, column);
+        return;
+    }
+
+    const float invRadiusY2 = 1.0f / (radii.y * radii.y);
+    const float radiusX = radii.x;
+
+    int row = 0;
+#ifdef SHADING_RATE_IMAGE_SSE2
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 scale = _mm_set1_ps(radiusX * tilesPerUnitX);
+    const __m128 center = _mm_set1_ps(offset);
+    const __m128 invRy2 = _mm_set1_ps(invRadiusY2);
+    const __m128 step = _mm_set1_ps(rowStep);
+    const __m128 lane = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+    const __m128 top = _mm_set1_ps(0.5f - gazePos.y);
+    const __m128i maxColumn = _mm_set1_epi32(tilesX);
+    const __m128i zeroi = _mm_setzero_si128();
+
+    for (; row < rows; row += 4) {
+        // dy = tileCenterY - gazeY, rows grow downwards while y grows upwards
+        __m128 rowIndex = _mm_add_ps(_mm_set1_ps(static_cast<float>(row)), lane);
+        __m128 dy = _mm_sub_ps(top, _mm_mul_ps(rowIndex, step));
+        __m128 t = _mm_sub_ps(one, _mm_mul_ps(_mm_mul_ps(dy, dy), invRy2));
+        __m128 inside = _mm_cmpge_ps(t, zero);
+        __m128 half = _mm_mul_ps(scale, _mm_sqrt_ps(_mm_max_ps(t, zero)));
+
+        // floor() for SSE2: truncate, then subtract one where truncation rounded up
+        __m128 left = _mm_sub_ps(center, half);
+        __m128 right = _mm_add_ps(center, half);
+        __m128i negLeft = _mm_cvttps_epi32(_mm_sub_ps(zero, left));
+        negLeft = _mm_add_epi32(negLeft, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(negLeft), _mm_sub_ps(zero, left))));
+        __m128i first = _mm_sub_epi32(zeroi, negLeft);  // ceil(left)
+        __m128i last = _mm_cvttps_epi32(right);
+        last = _mm_add_epi32(last, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(last), right)));
+        last = _mm_add_epi32(last, _mm_set1_epi32(1));  // floor(right) + 1
+
+        // Clamp to [0, tilesX] and zero rows the ellipse does not reach
+        __m128i firstBelow = _mm_cmplt_epi32(first, zeroi);
+        first = _mm_andnot_si128(firstBelow, first);
+        __m128i firstAbove = _mm_cmpgt_epi32(first, maxColumn);
+        first = _mm_or_si128(_mm_and_si128(firstAbove, maxColumn), _mm_andnot_si128(firstAbove, first));
+        __m128i lastBelow = _mm_cmplt_epi32(last, zeroi);
+        last = _mm_andnot_si128(lastBelow, last);
+        __m128i lastAbove = _mm_cmpgt_epi32(last, maxColumn);
+        last = _mm_or_si128(_mm_and_si128(lastAbove, maxColumn), _mm_andnot_si128(lastAbove, last));
+
+        // Empty spans collapse onto their begin so they stay near the gaze column
+        __m128i insideMask = _mm_castps_si128(inside);
+        insideMask = _mm_andnot_si128(_mm_cmplt_epi32(last, first), insideMask);
+        last = _mm_or_si128(_mm_and_si128(insideMask, last), _mm_andnot_si128(insideMask, first));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(begin + row), first);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(end + row), last);
+    }
+#endif
+
+    for (; row < rows; ++row) {
+        float dy = (0.5f - gazePos.y) - (row + 0.5f) * rowStep;
+        float t = 1.0f - dy * dy * invRadiusY2;
+        float half = radiusX * tilesPerUnitX * sqrtf((std::max)(t, 0.0f));
+        int first = Clamp(static_cast<int>(ceilf(offset - half)), 0, tilesX);
+        int last = Clamp(static_cast<int>(floorf(offset + half)) + 1, 0, tilesX);
+        if (t < 0.0f || last < first) {
+            last = first;
+        }
+        begin[row] = first;
+        end[row] = last;
+    }
+}
+
+void ShadingRateImage::FillRow(int row, int from, int to, const FoveationDesc &desc) {
+    uint8_t *line = tiles.data() + static_cast<size_t>(row) * tilesX;
+
+    // Paint outermost first so inner regions win where ellipses overlap
+    memset(line + from, static_cast<int>(desc.peripheralRate), to - from);
+
+    int middleFrom = (std::max)(from, static_cast<int>(currentSpans.middleBegin[row]));
+    int middleTo = (std::min)(to, static_cast<int>(currentSpans.middleEnd[row]));
+    if (middleFrom < middleTo) {
+        memset(line + middleFrom, static_cast<int>(desc.middleRate), middleTo - middleFrom);
+    }
+
+    int innerFrom = (std::max)(from, static_cast<int>(currentSpans.innerBegin[row]));
+    int innerTo = (std::min)(to, static_cast<int>(currentSpans.innerEnd[row]));
+    if (innerFrom < innerTo) {
+        memset(line + innerFrom, static_cast<int>(desc.innerRate), innerTo - innerFrom);
+    }
+}
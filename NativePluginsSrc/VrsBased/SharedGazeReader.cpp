@@ -0,0 +1,123 @@
+#include "SharedGazeReader.h"
+#include "../../GazeTracking/SharedGazeRing.h"
+#include "Clock.h"
+#include "GazeManager.h"
+#include <chrono>
+
+// Constructor
+SharedGazeReader::SharedGazeReader()
+    : gazeManager(nullptr), ring(nullptr), running(false), samplesRead(0), samplesInvalid(0), samplesDropped(0),
+    wakeups(0), foreignClockSamples(0), attachments(0) {
+}
+
+// Destructor
+SharedGazeReader::~SharedGazeReader() {
+    Stop();
+}
+
+bool SharedGazeReader::Start(const char *name, GazeManager *target) {
+    if (IsRunning() || !target || !name || !name[0]) {
+        return false;
+    }
+
+    // The publisher may start later, the thread attaches once the ring exists
+    ring = new SharedGazeRing();
+    mappingName = name;
+    gazeManager = target;
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&SharedGazeReader::Run, this);
+    return true;
+}
+
+void SharedGazeReader::Stop() {
+    if (!running.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    // The thread notices the flag within one wait timeout
+    if (thread.joinable()) {
+        thread.join();
+    }
+
+    delete ring;
+    ring = nullptr;
+}
+
+SharedGazeReaderStats SharedGazeReader::GetStats() const {
+    SharedGazeReaderStats stats = {};
+    stats.samplesRead = samplesRead.load(std::memory_order_relaxed);
+    stats.samplesInvalid = samplesInvalid.load(std::memory_order_relaxed);
+    stats.samplesDropped = samplesDropped.load(std::memory_order_relaxed);
+    stats.wakeups = wakeups.load(std::memory_order_relaxed);
+    stats.foreignClockSamples = foreignClockSamples.load(std::memory_order_relaxed);
+    stats.attachments = attachments.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SharedGazeReader::Run() {
+    SharedGazeRecord records[SharedGazeRing::CAPACITY];
+    uint64_t cursor = 0;
+    bool attached = false;
+    int idleMs = 0;
+
+    while (running.load(std::memory_order_acquire)) {
+        if (!attached) {
+            if (!ring->OpenReader(mappingName)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_TIMEOUT_MS));
+                continue;
+            }
+
+            // Start from the next sample, older ones are stale for the current frame
+            attached = true;
+            cursor = ring->GetPublishedCount();
+            idleMs = 0;
+            attachments.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // A writer that recreated the ring in place starts counting from zero again
+        if (ring->GetPublishedCount() < cursor) {
+            cursor = 0;
+        }
+
+        if (!ring->WaitForData(cursor, WAIT_TIMEOUT_MS)) {
+            // A restarted writer may have mapped a new ring, reattach after a quiet period
+            idleMs += WAIT_TIMEOUT_MS;
+            if (idleMs >= REATTACH_AFTER_MS) {
+                ring->Close();
+                attached = false;
+            }
+            continue;
+        }
+        idleMs = 0;
+
+        uint64_t previous = cursor;
+        size_t count = ring->ReadSince(cursor, records, SharedGazeRing::CAPACITY);
+        samplesDropped.fetch_add(cursor - previous - count, std::memory_order_relaxed);
+        wakeups.fetch_add(1, std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            Consume(records[i]);
+        }
+    }
+
+    ring->Close();
+}
+
+void SharedGazeReader::Consume(const SharedGazeRecord &record) {
+    if (!(record.flags & SHARED_GAZE_VALID)) {
+        samplesInvalid.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    samplesRead.fetch_add(1, std::memory_order_relaxed);
+
+    // Publishers on this host stamp with the same steady clock, anything else falls back to the read time
+    uint64_t receiveTime = GetTimestampMicroseconds();
+    uint64_t captureTime = record.captureTimestampUs;
+    if (captureTime == 0 || captureTime > receiveTime || receiveTime - captureTime > MAX_CAPTURE_AGE_US) {
+        captureTime = receiveTime;
+        foreignClockSamples.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Ring coordinates are [0, 1] from the top-left, trackers report [-1, 1] with x mirrored and +y up
+    Vector2 screenPos = {1.0f - 2.0f * record.x, 1.0f - 2.0f * record.y};
+    gazeManager->UpdateGazeScreenPosition(screenPos, captureTime, receiveTime);
+}
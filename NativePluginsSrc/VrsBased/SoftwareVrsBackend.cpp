@@ -0,0 +1,60 @@
+#include "SoftwareVrsBackend.h"
+
+// Tile size of the recorded image, matches common D3D12 and Vulkan hardware
+static const int SOFTWARE_TILE_SIZE = 16;
+
+// Constructor
+SoftwareVrsBackend::SoftwareVrsBackend()
+    : gaze{}, enabled(false), enables(0), disables(0), gazeUpdates(0), imageUpdates(0), tilesWritten(0) {
+    image.ConfigureDevice(SOFTWARE_TILE_SIZE, true);
+}
+
+// Destructor
+SoftwareVrsBackend::~SoftwareVrsBackend() {
+}
+
+bool SoftwareVrsBackend::Initialize(float /*tanHalfHorizontalFov*/, float /*tanHalfVerticalFov*/, bool stereo) {
+    gaze = {};
+    gaze.stereo = stereo;
+    enabled = false;
+    return true;
+}
+
+bool SoftwareVrsBackend::UpdateGaze(const VrsGazeFrame &gazeFrame) {
+    gaze = gazeFrame;
+    gazeUpdates.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+VrsResult SoftwareVrsBackend::Enable(RenderMode mode, const VrsFoveationState &foveation) {
+    bool changed = image.Update(mode, gaze, foveation);
+    if (changed) {
+        const TileRect &rect = image.GetDirtyRect();
+        imageUpdates.fetch_add(1, std::memory_order_relaxed);
+        tilesWritten.fetch_add(static_cast<uint64_t>(rect.endX - rect.beginX) * (rect.endY - rect.beginY), std::memory_order_relaxed);
+    }
+    bool wasEnabled = enabled;
+    enabled = true;
+    enables.fetch_add(1, std::memory_order_relaxed);
+    return (changed || !wasEnabled) ? VrsResult::APPLIED : VrsResult::SKIPPED;
+}
+
+VrsResult SoftwareVrsBackend::Disable() {
+    enabled = false;
+    disables.fetch_add(1, std::memory_order_relaxed);
+    return VrsResult::APPLIED;
+}
+
+void SoftwareVrsBackend::Release() {
+    enabled = false;
+}
+
+SoftwareVrsBackendStats SoftwareVrsBackend::GetStats() const {
+    SoftwareVrsBackendStats stats = {};
+    stats.enables = enables.load(std::memory_order_relaxed);
+    stats.disables = disables.load(std::memory_order_relaxed);
+    stats.gazeUpdates = gazeUpdates.load(std::memory_order_relaxed);
+    stats.imageUpdates = imageUpdates.load(std::memory_order_relaxed);
+    stats.tilesWritten = tilesWritten.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,313 @@
+#include "TemporalFoveation.h"
+#include "Clock.h"
+#include "Utils.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define TEMPORAL_FOVEATION_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Reprojected view depth below which a point counts as behind the previous camera
+static const float MIN_SOURCE_DEPTH = 1e-4f;
+
+static Vector3 Rotate(const Quaternion &q, const Vector3 &v) {
+    // v + 2w(u x v) + 2u x (u x v)
+    Vector3 t = {2.0f * (q.y * v.z - q.z * v.y), 2.0f * (q.z * v.x - q.x * v.z), 2.0f * (q.x * v.y - q.y * v.x)};
+    return {v.x + q.w * t.x + (q.y * t.z - q.z * t.y),
+            v.y + q.w * t.y + (q.z * t.x - q.x * t.z),
+            v.z + q.w * t.z + (q.x * t.y - q.y * t.x)};
+}
+
+// Refresh slot of a tile, spreads neighbouring tiles over different frames
+static uint32_t GetRefreshPhase(int column, int row) {
+    uint32_t hash = static_cast<uint32_t>(column) * 0x9E3779B1u ^ static_cast<uint32_t>(row) * 0x85EBCA77u;
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6Du;
+    return hash ^ (hash >> 12);
+}
+
+// Constructor
+TemporalFoveation::TemporalFoveation()
+    : settings(GetDefaultSettings()), historyValid(false), width(0), height(0), tileSize(0), tilesX(0), tilesY(0),
+    previousPose{}, reprojection{}, stats{} {
+}
+
+// Destructor
+TemporalFoveation::~TemporalFoveation() {
+}
+
+TemporalFoveationSettings TemporalFoveation::GetDefaultSettings() {
+    TemporalFoveationSettings defaults = {};
+    defaults.enabled = false;
+    defaults.reuseMiddle = false;
+    defaults.depthTolerance = 0.02f;
+    defaults.disocclusionBudget = 0.05f;
+    defaults.errorBudget = 8.0f;
+    defaults.refreshInterval = 4;
+    return defaults;
+}
+
+void TemporalFoveation::Configure(const TemporalFoveationSettings &temporalSettings) {
+    settings = temporalSettings;
+    settings.depthTolerance = (std::max)(settings.depthTolerance, 0.0f);
+    settings.disocclusionBudget = Clamp(settings.disocclusionBudget, 0.0f, 1.0f);
+    settings.errorBudget = (std::max)(settings.errorBudget, 0.0f);
+    settings.refreshInterval = (std::max)(settings.refreshInterval, 1);
+}
+
+void TemporalFoveation::Reset() {
+    historyValid = false;
+}
+
+TemporalFoveation::Reprojection TemporalFoveation::ComputeReprojection(const VrsCameraPose &current, const VrsCameraPose &previous,
+    int width, int height) {
+    // previous = inverse(previousRotation) * (currentRotation * current + currentPosition - previousPosition)
+    Quaternion inverse = {-previous.rotation.x, -previous.rotation.y, -previous.rotation.z, previous.rotation.w};
+    Reprojection result = {};
+    const Vector3 axes[3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    for (int column = 0; column < 3; ++column) {
+        Vector3 axis = Rotate(inverse, Rotate(current.rotation, axes[column]));
+        result.rotation[column] = axis.x;
+        result.rotation[3 + column] = axis.y;
+        result.rotation[6 + column] = axis.z;
+    }
+    Vector3 offset = Rotate(inverse, {current.position.x - previous.position.x, current.position.y - previous.position.y,
+        current.position.z - previous.position.z});
+    result.translation[0] = offset.x;
+    result.translation[1] = offset.y;
+    result.translation[2] = offset.z;
+
+    // Rows go down the image while view space y goes up
+    const ViewFrustum &frustum = previous.frustum;
+    result.scaleX = width / (frustum.tanRight - frustum.tanLeft);
+    result.offsetX = -frustum.tanLeft * result.scaleX;
+    result.scaleY = -height / (frustum.tanUp - frustum.tanDown);
+    result.offsetY = frustum.tanUp * height / (frustum.tanUp - frustum.tanDown);
+    return result;
+}
+
+void TemporalFoveation::ReprojectRow(const float *depthRow, int y, float *outX, float *outY, float *outDepth) const {
+    // View direction of the pixel centers with unit z, so view position = depth * direction
+    const ViewFrustum &frustum = previousPose.frustum;
+    const float stepX = (frustum.tanRight - frustum.tanLeft) / width;
+    const float dirY = frustum.tanUp - (y + 0.5f) * (frustum.tanUp - frustum.tanDown) / height;
+    const float *m = reprojection.rotation;
+    const float *t = reprojection.translation;
+
+    // Rotated direction = column x * dirX + (column y * dirY + column z), the second part is constant along the row
+    const float baseX = m[1] * dirY + m[2];
+    const float baseY = m[4] * dirY + m[5];
+    const float baseZ = m[7] * dirY + m[8];
+
+    int x = 0;
+#ifdef TEMPORAL_FOVEATION_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minDepth = _mm_set1_ps(MIN_SOURCE_DEPTH);
+    const __m128 maxDepth = _mm_set1_ps(FLT_MAX);
+    const __m128 behind = _mm_set1_ps(-1.0f);
+    const __m128 step = _mm_set1_ps(stepX);
+    const __m128 lane = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    for (; x + 4 <= width; x += 4) {
+        __m128 dirX = _mm_add_ps(_mm_set1_ps(frustum.tanLeft), _mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lane), step));
+        __m128 depth = _mm_loadu_ps(depthRow + x);
+
+        // Sky keeps unit depth and no translation, only the rotation moves it
+        __m128 geometry = _mm_and_ps(_mm_cmpgt_ps(depth, zero), _mm_cmple_ps(depth, maxDepth));
+        __m128 scale = _mm_or_ps(_mm_and_ps(geometry, depth), _mm_andnot_ps(geometry, one));
+        __m128 px = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[0]), dirX), _mm_set1_ps(baseX)), scale);
+        __m128 py = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[3]), dirX), _mm_set1_ps(baseY)), scale);
+        __m128 pz = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[6]), dirX), _mm_set1_ps(baseZ)), scale);
+        px = _mm_add_ps(px, _mm_and_ps(geometry, _mm_set1_ps(t[0])));
+        py = _mm_add_ps(py, _mm_and_ps(geometry, _mm_set1_ps(t[1])));
+        pz = _mm_add_ps(pz, _mm_and_ps(geometry, _mm_set1_ps(t[2])));
+
+        // Points behind the previous camera get a finite divisor and are flagged by a negative depth
+        __m128 inFront = _mm_cmpgt_ps(pz, minDepth);
+        __m128 divisor = _mm_or_ps(_mm_and_ps(inFront, pz), _mm_andnot_ps(inFront, one));
+        __m128 u = _mm_div_ps(px, divisor);
+        __m128 v = _mm_div_ps(py, divisor);
+        _mm_storeu_ps(outX + x, _mm_add_ps(_mm_mul_ps(u, _mm_set1_ps(reprojection.scaleX)), _mm_set1_ps(reprojection.offsetX)));
+        _mm_storeu_ps(outY + x, _mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(reprojection.scaleY)), _mm_set1_ps(reprojection.offsetY)));
+        __m128 sourceDepth = _mm_and_ps(geometry, pz);
+        _mm_storeu_ps(outDepth + x, _mm_or_ps(_mm_and_ps(inFront, sourceDepth), _mm_andnot_ps(inFront, behind)));
+    }
+#endif
+
+    for (; x < width; ++x) {
+        float dirX = frustum.tanLeft + (x + 0.5f) * stepX;
+        float depth = depthRow[x];
+        bool geometry = depth > 0.0f && depth <= FLT_MAX;
+        float scale = geometry ? depth : 1.0f;
+        float px = (m[0] * dirX + baseX) * scale + (geometry ? t[0] : 0.0f);
+        float py = (m[3] * dirX + baseY) * scale + (geometry ? t[1] : 0.0f);
+        float pz = (m[6] * dirX + baseZ) * scale + (geometry ? t[2] : 0.0f);
+        bool inFront = pz > MIN_SOURCE_DEPTH;
+        float divisor = inFront ? pz : 1.0f;
+        outX[x] = px / divisor * reprojection.scaleX + reprojection.offsetX;
+        outY[x] = py / divisor * reprojection.scaleY + reprojection.offsetY;
+        outDepth[x] = inFront ? (geometry ? pz : 0.0f) : -1.0f;
+    }
+}
+
+void TemporalFoveation::AccumulateRow(int y, const float *outX, const float *outY, const float *outDepth) {
+    const float centerY = y + 0.5f;
+    const int rowOffset = (y / tileSize) * tilesX;
+    for (int x = 0; x < width; ++x) {
+        int tile = rowOffset + x / tileSize;
+        float sourceX = outX[x];
+        float sourceY = outY[x];
+        float depth = outDepth[x];
+
+        // Comparisons are written so NaN coordinates fail them
+        bool visible = depth >= 0.0f && sourceX >= 0.0f && sourceX < width && sourceY >= 0.0f && sourceY < height;
+        if (visible) {
+            float previous = previousDepth[static_cast<size_t>(sourceY) * width + static_cast<size_t>(sourceX)];
+            visible = depth > 0.0f ? fabsf(previous - depth) <= settings.depthTolerance * depth : previous <= 0.0f;
+        }
+        if (!visible) {
+            ++disoccludedPixels[tile];
+            continue;
+        }
+
+        float dx = sourceX - (x + 0.5f);
+        float dy = sourceY - centerY;
+        motionSums[tile] += sqrtf(dx * dx + dy * dy);
+    }
+}
+
+bool TemporalFoveation::Process(const VrsDepthFrame &depth, const VrsCameraPose &pose, const ShadingRateImage &regions) {
+    if (!depth.depth || depth.width <= 0 || depth.height <= 0 || depth.rowPitch < depth.width * static_cast<int>(sizeof(float)) ||
+        !regions.Matches(depth.width, depth.height, regions.GetTileSize())) {
+        return false;
+    }
+
+    uint64_t start = GetTimestampNanoseconds();
+
+    if (width != depth.width || height != depth.height || tileSize != regions.GetTileSize()) {
+        width = depth.width;
+        height = depth.height;
+        tileSize = regions.GetTileSize();
+        tilesX = regions.GetWidth();
+        tilesY = regions.GetHeight();
+        size_t tiles = static_cast<size_t>(tilesX) * tilesY;
+        tileMask.assign(tiles, TEMPORAL_TILE_SHADE);
+        accumulatedMotion.assign(tiles, 0.0f);
+        disoccludedPixels.resize(tiles);
+        motionSums.resize(tiles);
+        previousDepth.resize(static_cast<size_t>(width) * height);
+        currentDepth.resize(previousDepth.size());
+        sourceX.resize(width);
+        sourceY.resize(width);
+        sourceDepth.resize(width);
+        historyValid = false;
+    }
+
+    for (int y = 0; y < height; ++y) {
+        memcpy(currentDepth.data() + static_cast<size_t>(y) * width,
+            reinterpret_cast<const uint8_t *>(depth.depth) + static_cast<size_t>(y) * depth.rowPitch, width * sizeof(float));
+    }
+
+    // Reuse needs a history seen through the same frustum
+    const ViewFrustum &previousFrustum = previousPose.frustum;
+    bool reuse = settings.enabled && historyValid && previousFrustum.tanLeft == pose.frustum.tanLeft &&
+        previousFrustum.tanRight == pose.frustum.tanRight && previousFrustum.tanUp == pose.frustum.tanUp &&
+        previousFrustum.tanDown == pose.frustum.tanDown;
+
+    std::fill(disoccludedPixels.begin(), disoccludedPixels.end(), 0u);
+    std::fill(motionSums.begin(), motionSums.end(), 0.0f);
+    if (reuse) {
+        reprojection = ComputeReprojection(pose, previousPose, width, height);
+        for (int y = 0; y < height; ++y) {
+            ReprojectRow(currentDepth.data() + static_cast<size_t>(y) * width, y, sourceX.data(), sourceY.data(), sourceDepth.data());
+            AccumulateRow(y, sourceX.data(), sourceY.data(), sourceDepth.data());
+        }
+    }
+
+    stats.tilesReused = 0;
+    stats.tilesDisoccluded = 0;
+    stats.tilesOverBudget = 0;
+    stats.tilesRefreshed = 0;
+    const uint32_t interval = static_cast<uint32_t>(settings.refreshInterval);
+    const uint32_t slot = static_cast<uint32_t>(stats.framesProcessed % interval);
+    for (int row = 0; row < tilesY; ++row) {
+        int pixelsY = (std::min)(tileSize, height - row * tileSize);
+        for (int column = 0; column < tilesX; ++column) {
+            size_t tile = static_cast<size_t>(row) * tilesX + column;
+            TargetArea area = regions.GetRegion(column, row);
+            bool eligible = reuse && (area == TargetArea::PERIPHERAL || (settings.reuseMiddle && area == TargetArea::MIDDLE));
+            tileMask[tile] = TEMPORAL_TILE_SHADE;
+            if (!eligible) {
+                accumulatedMotion[tile] = 0.0f;
+                continue;
+            }
+
+            int pixels = (std::min)(tileSize, width - column * tileSize) * pixelsY;
+            uint32_t disoccluded = disoccludedPixels[tile];
+            float motion = accumulatedMotion[tile];
+            if (disoccluded > settings.disocclusionBudget * pixels) {
+                ++stats.tilesDisoccluded;
+            } else if ((motion += motionSums[tile] / (pixels - disoccluded)) > settings.errorBudget) {
+                ++stats.tilesOverBudget;
+            } else if (GetRefreshPhase(column, row) % interval == slot) {
+                ++stats.tilesRefreshed;
+            } else {
+                tileMask[tile] = TEMPORAL_TILE_REUSE;
+                accumulatedMotion[tile] = motion;
+                ++stats.tilesReused;
+                continue;
+            }
+            accumulatedMotion[tile] = 0.0f;
+        }
+    }
+
+    // The processed frame becomes the history of the next one
+    std::swap(previousDepth, currentDepth);
+    previousPose = pose;
+    historyValid = true;
+
+    stats.framesProcessed++;
+    stats.tilesX = tilesX;
+    stats.tilesY = tilesY;
+    stats.lastProcessMs = (GetTimestampNanoseconds() - start) / 1e6f;
+    return true;
+}
+
+void TemporalFoveation::ResolveReusedTiles(const uint8_t *previousColor, int previousPitch, uint8_t *color, int pitch) const {
+    if (!previousColor || !color || !historyValid) {
+        return;
+    }
+
+    // Scratch of the resolve, the classification scratch belongs to Process
+    std::vector<float> rowX(width), rowY(width), rowDepth(width);
+    for (int row = 0; row < tilesY; ++row) {
+        const uint8_t *mask = tileMask.data() + static_cast<size_t>(row) * tilesX;
+        if (std::find(mask, mask + tilesX, TEMPORAL_TILE_REUSE) == mask + tilesX) {
+            continue;
+        }
+
+        int endY = (std::min)(height, (row + 1) * tileSize);
+        for (int y = row * tileSize; y < endY; ++y) {
+            ReprojectRow(previousDepth.data() + static_cast<size_t>(y) * width, y, rowX.data(), rowY.data(), rowDepth.data());
+            uint32_t *target = reinterpret_cast<uint32_t *>(color + static_cast<size_t>(y) * pitch);
+            for (int column = 0; column < tilesX; ++column) {
+                if (mask[column] != TEMPORAL_TILE_REUSE) {
+                    continue;
+                }
+                int endX = (std::min)(width, (column + 1) * tileSize);
+                for (int x = column * tileSize; x < endX; ++x) {
+                    // Behind the previous camera the pixel keeps its own position
+                    bool inFront = rowDepth[x] >= 0.0f;
+                    int sourceX = inFront ? static_cast<int>(Clamp(rowX[x], 0.0f, width - 1.0f)) : x;
+                    int sourceY = inFront ? static_cast<int>(Clamp(rowY[x], 0.0f, height - 1.0f)) : y;
+                    memcpy(target + x, previousColor + static_cast<size_t>(sourceY) * previousPitch + sourceX * 4, 4);
+                }
+            }
+        }
+    }
+}
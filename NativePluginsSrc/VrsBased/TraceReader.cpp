@@ -0,0 +1,282 @@
+#include "TraceReader.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Constructor
+TraceReader::TraceReader()
+    : data(nullptr), size(0),
+#ifdef _WIN32
+    fileHandle(nullptr), mappingHandle(nullptr),
+#else
+    fileDescriptor(-1),
+#endif
+    header(nullptr), recordCount(0), indexed(false), currentChunk(0), cursor(nullptr), chunkEnd(nullptr), state{} {
+}
+
+// Destructor
+TraceReader::~TraceReader() {
+    Close();
+}
+
+bool TraceReader::Open(const char *path) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    fileHandle = file;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(TraceFileHeader))) {
+        Close();
+        return false;
+    }
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    data = mappingHandle ? static_cast<const uint8_t *>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    fileDescriptor = open(path, O_RDONLY);
+    struct stat status;
+    if (fileDescriptor < 0 || fstat(fileDescriptor, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(TraceFileHeader))) {
+        Close();
+        return false;
+    }
+    void *mapping = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    data = mapping == MAP_FAILED ? nullptr : static_cast<const uint8_t *>(mapping);
+    size = static_cast<size_t>(status.st_size);
+    if (data) {
+        madvise(mapping, size, MADV_SEQUENTIAL);
+    }
+#endif
+    if (!data) {
+        Close();
+        return false;
+    }
+
+    header = reinterpret_cast<const TraceFileHeader *>(data);
+    if (memcmp(header->magic, TRACE_FILE_MAGIC, sizeof(header->magic)) != 0 || header->version != TRACE_FORMAT_VERSION) {
+        Close();
+        return false;
+    }
+
+    // Trust the footer only if its index is consistent with the file
+    indexed = false;
+    if (size >= sizeof(TraceFileHeader) + sizeof(TraceFileFooter)) {
+        TraceFileFooter footer;
+        memcpy(&footer, data + size - sizeof(footer), sizeof(footer));
+        uint64_t indexBytes = static_cast<uint64_t>(footer.chunkCount) * sizeof(TraceIndexEntry);
+        if (footer.magic == TRACE_FOOTER_MAGIC && footer.indexOffset >= sizeof(TraceFileHeader) &&
+            footer.indexOffset + indexBytes + sizeof(footer) == size) {
+            chunks.resize(footer.chunkCount);
+            if (indexBytes > 0) {
+                memcpy(chunks.data(), data + footer.indexOffset, static_cast<size_t>(indexBytes));
+            }
+            indexed = std::all_of(chunks.begin(), chunks.end(), [this](const TraceIndexEntry &entry) { return IsValidChunk(entry.offset); });
+        }
+    }
+    if (!indexed) {
+        RebuildIndex();
+    }
+
+    recordCount = 0;
+    for (const TraceIndexEntry &entry : chunks) {
+        recordCount += entry.recordCount;
+    }
+    SeekChunk(0);
+    return true;
+}
+
+void TraceReader::Close() {
+#ifdef _WIN32
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle) {
+        CloseHandle(fileHandle);
+    }
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#else
+    if (data) {
+        munmap(const_cast<uint8_t *>(data), size);
+    }
+    if (fileDescriptor >= 0) {
+        close(fileDescriptor);
+    }
+    fileDescriptor = -1;
+#endif
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+    chunks.clear();
+    recordCount = 0;
+    cursor = nullptr;
+    chunkEnd = nullptr;
+}
+
+bool TraceReader::IsValidChunk(uint64_t offset) const {
+    if (offset < sizeof(TraceFileHeader) || offset + sizeof(TraceChunkHeader) > size) {
+        return false;
+    }
+    TraceChunkHeader chunk;
+    memcpy(&chunk, data + offset, sizeof(chunk));
+    return chunk.magic == TRACE_CHUNK_MAGIC && offset + sizeof(chunk) + chunk.payloadBytes <= size;
+}
+
+void TraceReader::RebuildIndex() {
+    chunks.clear();
+    uint64_t offset = sizeof(TraceFileHeader);
+    while (IsValidChunk(offset)) {
+        TraceChunkHeader chunk;
+        memcpy(&chunk, data + offset, sizeof(chunk));
+        chunks.push_back({offset, chunk.firstTime, chunk.recordCount, 0});
+        offset += sizeof(chunk) + chunk.payloadBytes;
+    }
+}
+
+void TraceReader::SeekChunk(size_t chunk) {
+    currentChunk = chunk;
+    state = {};
+    if (chunk >= chunks.size()) {
+        cursor = chunkEnd = nullptr;
+        return;
+    }
+
+    TraceChunkHeader chunkHeader;
+    memcpy(&chunkHeader, data + chunks[chunk].offset, sizeof(chunkHeader));
+    cursor = data + chunks[chunk].offset + sizeof(chunkHeader);
+    chunkEnd = cursor + chunkHeader.payloadBytes;
+}
+
+void TraceReader::Seek(int64_t time) {
+    // Last chunk starting at or before time
+    auto after = std::upper_bound(chunks.begin(), chunks.end(), time,
+        [](int64_t value, const TraceIndexEntry &entry) { return value < entry.firstTime; });
+    SeekChunk(after == chunks.begin() ? 0 : static_cast<size_t>(after - chunks.begin()) - 1);
+
+    // Skip the records before time, the reader state is rebuilt from the chunk start
+    const uint8_t *recordStart = cursor;
+    size_t chunk = currentChunk;
+    TraceCodecState recordState = state;
+    TraceRecord record;
+    while (Next(record)) {
+        if (record.time >= time) {
+            SeekChunk(chunk);
+            cursor = recordStart;
+            state = recordState;
+            return;
+        }
+        recordStart = cursor;
+        chunk = currentChunk;
+        recordState = state;
+    }
+}
+
+bool TraceReader::Next(TraceRecord &record) {
+    while (cursor == chunkEnd) {
+        if (currentChunk + 1 >= chunks.size()) {
+            return false;
+        }
+        SeekChunk(currentChunk + 1);
+    }
+
+    const uint8_t *end = chunkEnd;
+    uint8_t tag = *cursor++;
+    uint64_t value;
+    if (!TraceGetVarint(cursor, end, value)) {
+        cursor = chunkEnd = nullptr;
+        return false;
+    }
+    state.time += TraceUnZigZag(value);
+
+    record = {};
+    record.type = static_cast<TraceRecordType>(tag & 7);
+    record.time = state.time;
+    int extra = (tag >> 3) & 3;
+    bool valid = true;
+    switch (record.type) {
+    case TraceRecordType::CAMERA_POSE: {
+        float *axes[3] = {&record.position.x, &record.position.y, &record.position.z};
+        for (int axis = 0; axis < 3 && valid; ++axis) {
+            valid = TraceGetVarint(cursor, end, value);
+            state.position[axis] = static_cast<int32_t>(state.position[axis] + TraceUnZigZag(value));
+            *axes[axis] = state.position[axis] * TRACE_POSITION_QUANTUM;
+        }
+        float q[4];
+        float sum = 0.0f;
+        for (int i = 0, component = 0; i < 4 && valid; ++i) {
+            if (i == extra) {
+                continue;
+            }
+            valid = TraceGetVarint(cursor, end, value);
+            state.rotation[component] = static_cast<int32_t>(state.rotation[component] + TraceUnZigZag(value));
+            q[i] = state.rotation[component++] / TRACE_ROTATION_SCALE;
+            sum += q[i] * q[i];
+        }
+        q[extra] = sqrtf((std::max)(1.0f - sum, 0.0f));
+        record.rotation = {q[0], q[1], q[2], q[3]};
+        break;
+    }
+    case TraceRecordType::GAZE: {
+        int eye = extra & 1;
+        record.eye = eye ? Eye::RIGHT : Eye::LEFT;
+        float *axes[2] = {&record.gaze.x, &record.gaze.y};
+        for (int axis = 0; axis < 2 && valid; ++axis) {
+            valid = TraceGetVarint(cursor, end, value);
+            state.gaze[eye][axis] = static_cast<int32_t>(state.gaze[eye][axis] + TraceUnZigZag(value));
+            *axes[axis] = state.gaze[eye][axis] / TRACE_GAZE_SCALE;
+        }
+        break;
+    }
+    case TraceRecordType::FRAME:
+        valid = TraceGetVarint(cursor, end, value);
+        record.frameTimeMs = value / 1000.0f;
+        break;
+    case TraceRecordType::CONFIGURATION: {
+        const size_t bytes = 2 + 6 * sizeof(float) + 3;
+        valid = static_cast<size_t>(end - cursor) >= bytes;
+        if (valid) {
+            VrsConfiguration &config = record.configuration;
+            config.shadingRatePreset = static_cast<ShadingRatePreset>(cursor[0]);
+            config.foveationPatternPreset = static_cast<ShadingPatternPreset>(cursor[1]);
+            float radii[6];
+            memcpy(radii, cursor + 2, sizeof(radii));
+            config.innerRadii = {radii[0], radii[1]};
+            config.middleRadii = {radii[2], radii[3]};
+            config.peripheralRadii = {radii[4], radii[5]};
+            config.innerRate = static_cast<ShadingRate>(cursor[2 + sizeof(radii)]);
+            config.middleRate = static_cast<ShadingRate>(cursor[3 + sizeof(radii)]);
+            config.peripheralRate = static_cast<ShadingRate>(cursor[4 + sizeof(radii)]);
+            cursor += bytes;
+        }
+        break;
+    }
+    default:
+        valid = false;
+        break;
+    }
+
+    // A corrupt record ends the trace, the decoder state could not be trusted after it
+    if (!valid) {
+        cursor = chunkEnd = nullptr;
+        currentChunk = chunks.size();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,223 @@
+#include "TraceWriter.h"
+#include <cmath>
+#include <cstring>
+
+// Round to the nearest quantization step
+static int32_t Quantize(float value, float scale) {
+    return static_cast<int32_t>(lrintf(value * scale));
+}
+
+// Constructor
+TraceWriter::TraceWriter()
+    : open(false), file(nullptr), startTime(0), fileBytes(0), chunk{}, state{}, records(0) {
+}
+
+// Destructor
+TraceWriter::~TraceWriter() {
+    Close();
+}
+
+bool TraceWriter::Open(const char *path, uint64_t start) {
+    Close();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    file = path ? fopen(path, "wb") : nullptr;
+    if (!file) {
+        return false;
+    }
+
+    TraceFileHeader header = {};
+    memcpy(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_FORMAT_VERSION;
+    header.startTime = start;
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    startTime = start;
+    fileBytes = sizeof(header);
+    payload.clear();
+    payload.reserve(TRACE_CHUNK_BYTES + MAX_RECORD_BYTES);
+    chunk = {};
+    state = {};
+    index.clear();
+    records = 0;
+    open.store(true, std::memory_order_release);
+    return true;
+}
+
+void TraceWriter::Close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) {
+        return;
+    }
+    open.store(false, std::memory_order_release);
+    FlushChunk();
+
+    TraceFileFooter footer = {};
+    footer.indexOffset = fileBytes;
+    footer.chunkCount = static_cast<uint32_t>(index.size());
+    footer.magic = TRACE_FOOTER_MAGIC;
+    if (!index.empty()) {
+        fwrite(index.data(), sizeof(TraceIndexEntry), index.size(), file);
+    }
+    fwrite(&footer, sizeof(footer), 1, file);
+    fclose(file);
+    file = nullptr;
+}
+
+uint8_t *TraceWriter::BeginRecord(TraceRecordType type, int extra, uint64_t time, size_t &used) {
+    int64_t relative = static_cast<int64_t>(time - startTime);
+    if (chunk.recordCount > 0 && relative - chunk.firstTime > TRACE_CHUNK_SPAN) {
+        FlushChunk();
+    }
+    if (chunk.recordCount == 0) {
+        chunk.firstTime = relative;
+    }
+    chunk.lastTime = relative;
+
+    size_t offset = payload.size();
+    payload.resize(offset + MAX_RECORD_BYTES);
+    uint8_t *out = payload.data() + offset;
+    out[0] = static_cast<uint8_t>(static_cast<int>(type) | (extra << 3));
+    used = 1 + TracePutVarint(out + 1, TraceZigZag(relative - state.time));
+    state.time = relative;
+    return out;
+}
+
+void TraceWriter::EndRecord(size_t used) {
+    payload.resize(payload.size() - MAX_RECORD_BYTES + used);
+    ++chunk.recordCount;
+    ++records;
+    if (payload.size() >= TRACE_CHUNK_BYTES) {
+        FlushChunk();
+    }
+}
+
+void TraceWriter::FlushChunk() {
+    if (chunk.recordCount == 0) {
+        return;
+    }
+
+    chunk.magic = TRACE_CHUNK_MAGIC;
+    chunk.payloadBytes = static_cast<uint32_t>(payload.size());
+    TraceIndexEntry entry = {fileBytes, chunk.firstTime, chunk.recordCount, 0};
+    index.push_back(entry);
+    fwrite(&chunk, sizeof(chunk), 1, file);
+    fwrite(payload.data(), 1, payload.size(), file);
+    fileBytes += sizeof(chunk) + payload.size();
+
+    payload.clear();
+    chunk = {};
+    state = {};
+}
+
+void TraceWriter::RecordCameraPose(uint64_t time, const Vector3 &position, const Quaternion &rotation) {
+    if (!open.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // Smallest three: drop the largest component, its sign is made positive
+    float q[4] = {rotation.x, rotation.y, rotation.z, rotation.w};
+    float length = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    int largest = 0;
+    for (int i = 1; i < 4; ++i) {
+        if (fabsf(q[i]) > fabsf(q[largest])) {
+            largest = i;
+        }
+    }
+    float scale = (q[largest] < 0.0f ? -1.0f : 1.0f) / (length > 0.0f ? length : 1.0f);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) {
+        return;
+    }
+    size_t used;
+    uint8_t *out = BeginRecord(TraceRecordType::CAMERA_POSE, largest, time, used);
+    const float axes[3] = {position.x, position.y, position.z};
+    for (int axis = 0; axis < 3; ++axis) {
+        int32_t value = Quantize(axes[axis], 1.0f / TRACE_POSITION_QUANTUM);
+        used += TracePutVarint(out + used, TraceZigZag(static_cast<int64_t>(value) - state.position[axis]));
+        state.position[axis] = value;
+    }
+    for (int i = 0, component = 0; i < 4; ++i) {
+        if (i == largest) {
+            continue;
+        }
+        int32_t value = Quantize(q[i] * scale, TRACE_ROTATION_SCALE);
+        used += TracePutVarint(out + used, TraceZigZag(static_cast<int64_t>(value) - state.rotation[component]));
+        state.rotation[component++] = value;
+    }
+    EndRecord(used);
+}
+
+void TraceWriter::RecordGaze(uint64_t time, Eye eye, const Vector2 &gaze) {
+    if (!open.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) {
+        return;
+    }
+    int e = eye == Eye::RIGHT ? 1 : 0;
+    size_t used;
+    uint8_t *out = BeginRecord(TraceRecordType::GAZE, e, time, used);
+    const float axes[2] = {gaze.x, gaze.y};
+    for (int axis = 0; axis < 2; ++axis) {
+        int32_t value = Quantize(axes[axis], TRACE_GAZE_SCALE);
+        used += TracePutVarint(out + used, TraceZigZag(static_cast<int64_t>(value) - state.gaze[e][axis]));
+        state.gaze[e][axis] = value;
+    }
+    EndRecord(used);
+}
+
+void TraceWriter::RecordFrame(uint64_t time, float frameTimeMs) {
+    if (!open.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) {
+        return;
+    }
+    size_t used;
+    uint8_t *out = BeginRecord(TraceRecordType::FRAME, 0, time, used);
+    used += TracePutVarint(out + used, static_cast<uint64_t>(lrintf((frameTimeMs > 0.0f ? frameTimeMs : 0.0f) * 1000.0f)));
+    EndRecord(used);
+}
+
+void TraceWriter::RecordConfiguration(uint64_t time, const VrsConfiguration &config) {
+    if (!open.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) {
+        return;
+    }
+    size_t used;
+    uint8_t *out = BeginRecord(TraceRecordType::CONFIGURATION, 0, time, used);
+    out[used++] = static_cast<uint8_t>(config.shadingRatePreset);
+    out[used++] = static_cast<uint8_t>(config.foveationPatternPreset);
+    const float radii[6] = {config.innerRadii.x, config.innerRadii.y, config.middleRadii.x, config.middleRadii.y,
+        config.peripheralRadii.x, config.peripheralRadii.y};
+    memcpy(out + used, radii, sizeof(radii));
+    used += sizeof(radii);
+    out[used++] = static_cast<uint8_t>(config.innerRate);
+    out[used++] = static_cast<uint8_t>(config.middleRate);
+    out[used++] = static_cast<uint8_t>(config.peripheralRate);
+    EndRecord(used);
+}
+
+TraceWriterStats TraceWriter::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    TraceWriterStats stats = {};
+    stats.records = records;
+    stats.bytes = fileBytes;
+    stats.chunks = static_cast<uint32_t>(index.size());
+    stats.recording = file ? 1 : 0;
+    return stats;
+}
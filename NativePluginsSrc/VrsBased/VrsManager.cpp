@@ -2,17 +2,32 @@
 #include "Utils.h"
 #include "Enums.h"
 
+// Configuration used until the scripting thread submits one
+static const VrsConfiguration DEFAULT_CONFIGURATION = {
+    ShadingRatePreset::HIGHEST_PERFORMANCE,
+    ShadingPatternPreset::NARROW,
+    { 0.25f, 0.25f },
+    { 0.33f, 0.33f },
+    { 1.0f, 1.0f },
+    ShadingRate::X1_PER_PIXEL,
+    ShadingRate::X1_PER_1X2_PIXELS,
+    ShadingRate::X1_PER_2X2_PIXELS
+};
+
 // Constructor
 VrsManager::VrsManager()
-    : vrsHelper(nullptr),
-    shadingRatePreset(NV_FOVEATED_RENDERING_SHADING_RATE_PRESET_HIGHEST_PERFORMANCE),
-    foveationPatternPreset(NV_FOVEATED_RENDERING_FOVEATION_PATTERN_PRESET_NARROW),
-    innerRegionRadii{ 0.25f, 0.25f },
-    middleRegionRadii{ 0.33f, 0.33f },
-    peripheralRegionRadii{ 1.0f, 1.0f },
-    innerShadingRate(NV_PIXEL_X1_PER_RASTER_PIXEL),
-    middleShadingRate(NV_PIXEL_X1_PER_1X2_RASTER_PIXELS),
-    peripheralShadingRate(NV_PIXEL_X1_PER_2X2_RASTER_PIXELS) {
+    : backend(nullptr),
+    pendingConfig(DEFAULT_CONFIGURATION),
+    pendingVersion(1),
+    renderMode(static_cast<int>(RenderMode::MONO)),
+    activeConfig(DEFAULT_CONFIGURATION),
+    activeConfigVersion(0),
+    stateDirty(true),
+    activeState(ResolveConfiguration(DEFAULT_CONFIGURATION)),
+    overrideActive(false),
+    overrideDesc{},
+    publishedOverrideActive(false),
+    publishedOverride{} {
 }
 
 // Destructor
@@ -20,128 +35,207 @@ VrsManager::~VrsManager() {
     Release();
 }
 
-bool VrsManager::Initialize(ID3D11Device* device) {
-    NV_VRS_HELPER_INIT_PARAMS vrsInitParams = {};
-    vrsInitParams.version = NV_VRS_HELPER_INIT_PARAMS_VER;
-    vrsInitParams.ppVRSHelper = &vrsHelper;
+bool VrsManager::Initialize(IVrsBackend* vrsBackend) {
+    backend = vrsBackend;
+    return backend != nullptr;
+}
 
-    NvAPI_Status status = NvAPI_D3D_InitializeVRSHelper(device, &vrsInitParams);
-    return (status == NVAPI_OK);
+static Vector2 ClampRadii(const Vector2& radii) {
+    return {Clamp(radii.x, 0.01f, 10.0f), Clamp(radii.y, 0.01f, 10.0f)};
 }
 
-void VrsManager::SetShadingRatePreset(ShadingRatePreset preset) {
-    shadingRatePreset = static_cast<NV_FOVEATED_RENDERING_SHADING_RATE_PRESET>(Clamp(
-        static_cast<int>(preset),
-        static_cast<int>(NV_FOVEATED_RENDERING_SHADING_RATE_PRESET_HIGHEST_PERFORMANCE),
-        static_cast<int>(NV_FOVEATED_RENDERING_SHADING_RATE_PRESET_CUSTOM)
+static ShadingRate ClampShadingRate(ShadingRate rate) {
+    return static_cast<ShadingRate>(Clamp(
+        static_cast<int>(rate),
+        static_cast<int>(ShadingRate::CULL),
+        static_cast<int>(ShadingRate::X1_PER_4X4_PIXELS)
     ));
 }
 
-void VrsManager::SetFoveationPatternPreset(ShadingPatternPreset preset) {
-    foveationPatternPreset = static_cast<NV_FOVEATED_RENDERING_FOVEATION_PATTERN_PRESET>(Clamp(
-        static_cast<int>(preset),
-        static_cast<int>(NV_FOVEATED_RENDERING_FOVEATION_PATTERN_PRESET_WIDE),
-        static_cast<int>(NV_FOVEATED_RENDERING_FOVEATION_PATTERN_PRESET_CUSTOM)
+VrsConfiguration VrsManager::SanitizeConfiguration(const VrsConfiguration& config) {
+    VrsConfiguration sanitized;
+    sanitized.shadingRatePreset = static_cast<ShadingRatePreset>(Clamp(
+        static_cast<int>(config.shadingRatePreset),
+        static_cast<int>(ShadingRatePreset::HIGHEST_PERFORMANCE),
+        static_cast<int>(ShadingRatePreset::CUSTOM)
     ));
+    sanitized.foveationPatternPreset = static_cast<ShadingPatternPreset>(Clamp(
+        static_cast<int>(config.foveationPatternPreset),
+        static_cast<int>(ShadingPatternPreset::WIDE),
+        static_cast<int>(ShadingPatternPreset::CUSTOM)
+    ));
+    sanitized.innerRadii = ClampRadii(config.innerRadii);
+    sanitized.middleRadii = ClampRadii(config.middleRadii);
+    sanitized.peripheralRadii = ClampRadii(config.peripheralRadii);
+    sanitized.innerRate = ClampShadingRate(config.innerRate);
+    sanitized.middleRate = ClampShadingRate(config.middleRate);
+    sanitized.peripheralRate = ClampShadingRate(config.peripheralRate);
+    return sanitized;
+}
+
+void VrsManager::PublishPendingConfiguration() {
+    pendingVersion.fetch_add(1, std::memory_order_release);
+}
+
+void VrsManager::SubmitConfiguration(const VrsConfiguration& config) {
+    VrsConfiguration sanitized = SanitizeConfiguration(config);
+
+    std::lock_guard<std::mutex> lock(configMutex);
+    pendingConfig = sanitized;
+    PublishPendingConfiguration();
+}
+
+VrsConfiguration VrsManager::GetConfiguration() const {
+    std::lock_guard<std::mutex> lock(configMutex);
+    return pendingConfig;
+}
+
+void VrsManager::SetShadingRatePreset(ShadingRatePreset preset) {
+    std::lock_guard<std::mutex> lock(configMutex);
+    VrsConfiguration config = pendingConfig;
+    config.shadingRatePreset = preset;
+    pendingConfig = SanitizeConfiguration(config);
+    PublishPendingConfiguration();
+}
+
+void VrsManager::SetFoveationPatternPreset(ShadingPatternPreset preset) {
+    std::lock_guard<std::mutex> lock(configMutex);
+    VrsConfiguration config = pendingConfig;
+    config.foveationPatternPreset = preset;
+    pendingConfig = SanitizeConfiguration(config);
+    PublishPendingConfiguration();
 }
 
 void VrsManager::ConfigureRegionRadii(TargetArea targetArea, float xRadius, float yRadius) {
-    float clampedX = Clamp(xRadius, 0.01f, 10.0f);
-    float clampedY = Clamp(yRadius, 0.01f, 10.0f);
+    Vector2 clampedRadii = ClampRadii({xRadius, yRadius});
 
+    std::lock_guard<std::mutex> lock(configMutex);
     switch (targetArea) {
     case TargetArea::INNER:
-        innerRegionRadii[0] = clampedX;
-        innerRegionRadii[1] = clampedY;
+        pendingConfig.innerRadii = clampedRadii;
         break;
     case TargetArea::MIDDLE:
-        middleRegionRadii[0] = clampedX;
-        middleRegionRadii[1] = clampedY;
+        pendingConfig.middleRadii = clampedRadii;
         break;
     case TargetArea::PERIPHERAL:
     default:
-        peripheralRegionRadii[0] = clampedX;
-        peripheralRegionRadii[1] = clampedY;
+        pendingConfig.peripheralRadii = clampedRadii;
         break;
     }
+    PublishPendingConfiguration();
 }
 
 void VrsManager::ConfigureShadingRate(TargetArea targetArea, ShadingRate rate) {
-    NV_PIXEL_SHADING_RATE clampedRate = static_cast<NV_PIXEL_SHADING_RATE>(Clamp(
-        static_cast<int>(rate),
-        static_cast<int>(NV_PIXEL_X0_CULL_RASTER_PIXELS),
-        static_cast<int>(NV_PIXEL_X1_PER_4X4_RASTER_PIXELS)
-    ));
+    ShadingRate clampedRate = ClampShadingRate(rate);
 
+    std::lock_guard<std::mutex> lock(configMutex);
     switch (targetArea) {
     case TargetArea::INNER:
-        innerShadingRate = clampedRate;
+        pendingConfig.innerRate = clampedRate;
         break;
     case TargetArea::MIDDLE:
-        middleShadingRate = clampedRate;
+        pendingConfig.middleRate = clampedRate;
         break;
     case TargetArea::PERIPHERAL:
     default:
-        peripheralShadingRate = clampedRate;
+        pendingConfig.peripheralRate = clampedRate;
         break;
     }
+    PublishPendingConfiguration();
 }
 
-void VrsManager::ApplyShadingRatePattern(ID3D11DeviceContext* deviceContext, NV_VRS_RENDER_MODE renderMode) {
-    if (vrsHelper && deviceContext) {
-        NV_VRS_HELPER_ENABLE_PARAMS enableParams = {};
-        enableParams.version = NV_VRS_HELPER_ENABLE_PARAMS_VER;
-        enableParams.RenderMode = renderMode;
-        enableParams.ContentType = NV_VRS_CONTENT_TYPE_FOVEATED_RENDERING;
-        enableParams.sFoveatedRenderingDesc.version = NV_FOVEATED_RENDERING_DESC_VER;
+VrsFoveationState VrsManager::ResolveConfiguration(const VrsConfiguration& config) {
+    VrsFoveationState state = {};
+    state.ratePreset = config.shadingRatePreset;
+    state.patternPreset = config.foveationPatternPreset;
+    state.desc.innerRadii = config.innerRadii;
+    state.desc.middleRadii = config.middleRadii;
+    state.desc.peripheralRadii = config.peripheralRadii;
+    state.desc.innerRate = config.innerRate;
+    state.desc.middleRate = config.middleRate;
+    state.desc.peripheralRate = config.peripheralRate;
+
+    ResolveShadingRatePreset(config.shadingRatePreset, state.desc);
+    ResolveFoveationPatternPreset(config.foveationPatternPreset, state.desc);
+    return state;
+}
+
+void VrsManager::LatchConfiguration() {
+    uint64_t latestVersion = pendingVersion.load(std::memory_order_acquire);
+    if (latestVersion != activeConfigVersion) {
+        // Keep the current configuration for one more enable rather than stall the render thread
+        std::unique_lock<std::mutex> lock(configMutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            activeConfig = pendingConfig;
+            activeConfigVersion = pendingVersion.load(std::memory_order_relaxed);
+            stateDirty = true;
+        }
+    }
+
+    if (!stateDirty) {
+        return;
+    }
+    stateDirty = false;
 
-        UpdateShadingRatePresetParams(enableParams);
-        UpdateFoveationPatternPresetParams(enableParams);
+    VrsFoveationState state;
+    if (overrideActive) {
+        state = {ShadingRatePreset::CUSTOM, ShadingPatternPreset::CUSTOM, overrideDesc, 0};
+    } else {
+        state = ResolveConfiguration(activeConfig);
+    }
 
-        // Enable VRS with the configured parameters
-        NvAPI_Status status = vrsHelper->Enable(deviceContext, &enableParams);
-        // Handle errors if needed (e.g., log or attempt recovery)
+    // Edits that resolve to the same foveation, e.g. custom values under a fixed preset, keep the version
+    bool changed = activeState.version == 0 || state.ratePreset != activeState.ratePreset ||
+                   state.patternPreset != activeState.patternPreset || !IsSameFoveation(state.desc, activeState.desc);
+    if (changed) {
+        state.version = activeState.version + 1;
+        activeState = state;
     }
 }
 
-void VrsManager::RemoveShadingRatePattern(ID3D11DeviceContext* deviceContext) {
-    if (vrsHelper && deviceContext) {
-        NV_VRS_HELPER_DISABLE_PARAMS disableParams = {};
-        disableParams.version = NV_VRS_HELPER_DISABLE_PARAMS_VER;
+VrsResult VrsManager::ApplyShadingRatePattern(RenderMode mode) {
+    LatchConfiguration();
+    return backend ? backend->Enable(mode, activeState) : VrsResult::FAILED;
+}
+
+VrsResult VrsManager::RemoveShadingRatePattern() {
+    return backend ? backend->Disable() : VrsResult::FAILED;
+}
 
-        NvAPI_Status status = vrsHelper->Disable(deviceContext, &disableParams);
-        // Handle errors if needed (e.g., log or attempt recovery)
+VrsFoveationState VrsManager::GetPublishedFoveationState() const {
+    {
+        std::lock_guard<std::mutex> lock(publishedOverrideMutex);
+        if (publishedOverrideActive) {
+            return publishedOverride;
+        }
     }
+    return ResolveConfiguration(GetConfiguration());
 }
 
-void VrsManager::UpdateShadingRatePresetParams(NV_VRS_HELPER_ENABLE_PARAMS& enableParams) {
-    enableParams.sFoveatedRenderingDesc.ShadingRatePreset = shadingRatePreset;
-    if (shadingRatePreset == NV_FOVEATED_RENDERING_SHADING_RATE_PRESET_CUSTOM) {
-        auto customShading = &(enableParams.sFoveatedRenderingDesc.ShadingRateCustomPresetDesc);
-        customShading->version = NV_FOVEATED_RENDERING_CUSTOM_SHADING_RATE_PRESET_DESC_VER1;
-        customShading->InnerMostRegionShadingRate = innerShadingRate;
-        customShading->MiddleRegionShadingRate = middleShadingRate;
-        customShading->PeripheralRegionShadingRate = peripheralShadingRate;
+void VrsManager::SetFoveationOverride(const FoveationDesc& desc) {
+    if (overrideActive && IsSameFoveation(desc, overrideDesc)) {
+        return;
     }
+    overrideDesc = desc;
+    overrideActive = true;
+    stateDirty = true;
+
+    std::lock_guard<std::mutex> lock(publishedOverrideMutex);
+    publishedOverride = {ShadingRatePreset::CUSTOM, ShadingPatternPreset::CUSTOM, desc, 0};
+    publishedOverrideActive = true;
 }
 
-void VrsManager::UpdateFoveationPatternPresetParams(NV_VRS_HELPER_ENABLE_PARAMS& enableParams) {
-    enableParams.sFoveatedRenderingDesc.FoveationPatternPreset = foveationPatternPreset;
-    if (foveationPatternPreset == NV_FOVEATED_RENDERING_FOVEATION_PATTERN_PRESET_CUSTOM) {
-        auto customPattern = &(enableParams.sFoveatedRenderingDesc.FoveationPatternCustomPresetDesc);
-        customPattern->version = NV_FOVEATED_RENDERING_CUSTOM_FOVEATION_PATTERN_PRESET_DESC_VER1;
-        customPattern->fInnermostRadii[0] = innerRegionRadii[0];
-        customPattern->fInnermostRadii[1] = innerRegionRadii[1];
-        customPattern->fMiddleRadii[0] = middleRegionRadii[0];
-        customPattern->fMiddleRadii[1] = middleRegionRadii[1];
-        customPattern->fPeripheralRadii[0] = peripheralRegionRadii[0];
-        customPattern->fPeripheralRadii[1] = peripheralRegionRadii[1];
+void VrsManager::ClearFoveationOverride() {
+    if (!overrideActive) {
+        return;
     }
+    overrideActive = false;
+    stateDirty = true;
+
+    std::lock_guard<std::mutex> lock(publishedOverrideMutex);
+    publishedOverrideActive = false;
 }
 
 void VrsManager::Release() {
-    if (vrsHelper) {
-        vrsHelper->Release();
-        vrsHelper = nullptr;
-    }
+    backend = nullptr;
 }
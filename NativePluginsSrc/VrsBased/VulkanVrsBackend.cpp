@@ -0,0 +1,370 @@
+#include "VulkanVrsBackend.h"
+
+#if VRS_BACKEND_VULKAN
+
+#include "Enums.h"
+#include "Utils.h"
+#include <cstdint>
+#include <cstring>
+
+// Preferred attachment texel size, clamped to what the device supports
+static const int PREFERRED_TILE_SIZE = 16;
+
+std::mutex VulkanVrsBackend::retiredMutex;
+std::vector<VulkanVrsBackend::ImageResources> VulkanVrsBackend::retiredResources;
+std::atomic<int> VulkanVrsBackend::liveBackends(0);
+
+// Constructor
+VulkanVrsBackend::VulkanVrsBackend(IUnityGraphicsVulkan *unityGraphicsVulkan)
+    : unityGraphics(unityGraphicsVulkan), vulkan{}, vk{}, supported(false), gaze{}, current{}, nextUploadSlot(0),
+    fullUploadPending(true), lastFrameNumber(0), lastError(VK_SUCCESS) {
+    if (unityGraphics) {
+        vulkan = unityGraphics->Instance();
+    }
+    liveBackends.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Destructor
+VulkanVrsBackend::~VulkanVrsBackend() {
+    Release();
+
+    // The default context keeps its backend until the device goes, the last one leaves with the device
+    if (liveBackends.fetch_sub(1, std::memory_order_acq_rel) == 1 && vk.DestroyImage) {
+        ReleaseRetiredResources(0, true);
+    }
+}
+
+bool VulkanVrsBackend::Initialize(float /*tanHalfHorizontalFov*/, float /*tanHalfVerticalFov*/, bool stereo) {
+    supported = unityGraphics && vulkan.device && LoadFunctions() && QuerySupport();
+    if (!supported) {
+        return false;
+    }
+
+    ConfigurePluginEvents();
+
+    gaze = {};
+    gaze.stereo = stereo;
+    return true;
+}
+
+bool VulkanVrsBackend::LoadFunctions() {
+    PFN_vkGetInstanceProcAddr getInstanceProcAddr = vulkan.getInstanceProcAddr;
+    if (!getInstanceProcAddr) {
+        return false;
+    }
+
+    vk.GetDeviceProcAddr = reinterpret_cast<PFN_vkGetDeviceProcAddr>(getInstanceProcAddr(vulkan.instance, "vkGetDeviceProcAddr"));
+    vk.GetPhysicalDeviceFeatures2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2>(getInstanceProcAddr(vulkan.instance, "vkGetPhysicalDeviceFeatures2"));
+    vk.GetPhysicalDeviceProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceProperties2>(getInstanceProcAddr(vulkan.instance, "vkGetPhysicalDeviceProperties2"));
+    vk.GetPhysicalDeviceMemoryProperties = reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties>(getInstanceProcAddr(vulkan.instance, "vkGetPhysicalDeviceMemoryProperties"));
+    if (!vk.GetDeviceProcAddr || !vk.GetPhysicalDeviceFeatures2 || !vk.GetPhysicalDeviceProperties2 || !vk.GetPhysicalDeviceMemoryProperties) {
+        return false;
+    }
+
+    VkDevice device = vulkan.device;
+    vk.CreateImage = reinterpret_cast<PFN_vkCreateImage>(vk.GetDeviceProcAddr(device, "vkCreateImage"));
+    vk.DestroyImage = reinterpret_cast<PFN_vkDestroyImage>(vk.GetDeviceProcAddr(device, "vkDestroyImage"));
+    vk.CreateImageView = reinterpret_cast<PFN_vkCreateImageView>(vk.GetDeviceProcAddr(device, "vkCreateImageView"));
+    vk.DestroyImageView = reinterpret_cast<PFN_vkDestroyImageView>(vk.GetDeviceProcAddr(device, "vkDestroyImageView"));
+    vk.CreateBuffer = reinterpret_cast<PFN_vkCreateBuffer>(vk.GetDeviceProcAddr(device, "vkCreateBuffer"));
+    vk.DestroyBuffer = reinterpret_cast<PFN_vkDestroyBuffer>(vk.GetDeviceProcAddr(device, "vkDestroyBuffer"));
+    vk.GetImageMemoryRequirements = reinterpret_cast<PFN_vkGetImageMemoryRequirements>(vk.GetDeviceProcAddr(device, "vkGetImageMemoryRequirements"));
+    vk.GetBufferMemoryRequirements = reinterpret_cast<PFN_vkGetBufferMemoryRequirements>(vk.GetDeviceProcAddr(device, "vkGetBufferMemoryRequirements"));
+    vk.AllocateMemory = reinterpret_cast<PFN_vkAllocateMemory>(vk.GetDeviceProcAddr(device, "vkAllocateMemory"));
+    vk.FreeMemory = reinterpret_cast<PFN_vkFreeMemory>(vk.GetDeviceProcAddr(device, "vkFreeMemory"));
+    vk.BindImageMemory = reinterpret_cast<PFN_vkBindImageMemory>(vk.GetDeviceProcAddr(device, "vkBindImageMemory"));
+    vk.BindBufferMemory = reinterpret_cast<PFN_vkBindBufferMemory>(vk.GetDeviceProcAddr(device, "vkBindBufferMemory"));
+    vk.MapMemory = reinterpret_cast<PFN_vkMapMemory>(vk.GetDeviceProcAddr(device, "vkMapMemory"));
+    vk.CmdPipelineBarrier = reinterpret_cast<PFN_vkCmdPipelineBarrier>(vk.GetDeviceProcAddr(device, "vkCmdPipelineBarrier"));
+    vk.CmdCopyBufferToImage = reinterpret_cast<PFN_vkCmdCopyBufferToImage>(vk.GetDeviceProcAddr(device, "vkCmdCopyBufferToImage"));
+
+    // Only resolves when Unity enabled VK_KHR_fragment_shading_rate on its device
+    vk.CmdSetFragmentShadingRateKHR = reinterpret_cast<PFN_vkCmdSetFragmentShadingRateKHR>(vk.GetDeviceProcAddr(device, "vkCmdSetFragmentShadingRateKHR"));
+
+    return vk.CreateImage && vk.DestroyImage && vk.CreateImageView && vk.DestroyImageView && vk.CreateBuffer && vk.DestroyBuffer &&
+           vk.GetImageMemoryRequirements && vk.GetBufferMemoryRequirements && vk.AllocateMemory && vk.FreeMemory &&
+           vk.BindImageMemory && vk.BindBufferMemory && vk.MapMemory && vk.CmdPipelineBarrier && vk.CmdCopyBufferToImage &&
+           vk.CmdSetFragmentShadingRateKHR;
+}
+
+bool VulkanVrsBackend::QuerySupport() {
+    VkPhysicalDeviceFragmentShadingRateFeaturesKHR rateFeatures = {};
+    rateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR;
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &rateFeatures;
+    vk.GetPhysicalDeviceFeatures2(vulkan.physicalDevice, &features);
+    if (!rateFeatures.attachmentFragmentShadingRate) {
+        return false;
+    }
+
+    VkPhysicalDeviceFragmentShadingRatePropertiesKHR rateProperties = {};
+    rateProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_PROPERTIES_KHR;
+    VkPhysicalDeviceProperties2 properties = {};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &rateProperties;
+    vk.GetPhysicalDeviceProperties2(vulkan.physicalDevice, &properties);
+
+    // Square texels, D3D12 hardware uses 8 or 16 and Vulkan drivers report the same range
+    const VkExtent2D &minTexel = rateProperties.minFragmentShadingRateAttachmentTexelSize;
+    const VkExtent2D &maxTexel = rateProperties.maxFragmentShadingRateAttachmentTexelSize;
+    int tileSize = Clamp(PREFERRED_TILE_SIZE, static_cast<int>((std::max)(minTexel.width, minTexel.height)),
+                         static_cast<int>((std::min)(maxTexel.width, maxTexel.height)));
+    bool largeRates = rateProperties.maxFragmentSize.width >= 4 && rateProperties.maxFragmentSize.height >= 4;
+
+    image.ConfigureDevice(tileSize, largeRates);
+    return true;
+}
+
+void VulkanVrsBackend::ConfigurePluginEvents() {
+    UnityVulkanPluginEventConfig eventConfig = {};
+    eventConfig.renderPassPrecondition = kUnityVulkanRenderPass_EnsureOutside;
+    eventConfig.graphicsQueueAccess = kUnityVulkanGraphicsQueueAccess_DontCare;
+    eventConfig.flags = kUnityVulkanEventConfigFlag_EnsurePreviousFrameSubmission | kUnityVulkanEventConfigFlag_ModifiesCommandBuffersState;
+
+    const EventID copyEvents[] = {
+        EventID::ENABLE_FOVEATED_RENDERING,
+        EventID::ENABLE_FOVEATED_RENDERING_LEFT_EYE,
+        EventID::ENABLE_FOVEATED_RENDERING_RIGHT_EYE,
+        EventID::COMMAND_PACKET
+    };
+    for (EventID eventID : copyEvents) {
+        unityGraphics->ConfigureEvent(static_cast<int>(eventID), &eventConfig);
+    }
+}
+
+bool VulkanVrsBackend::UpdateGaze(const VrsGazeFrame &gazeFrame) {
+    // Rates are rebuilt around the new gaze on the next enable
+    gaze = gazeFrame;
+    return supported;
+}
+
+VrsResult VulkanVrsBackend::Enable(RenderMode mode, const VrsFoveationState &foveation) {
+    UnityVulkanRecordingState recordingState;
+    if (!supported || !unityGraphics->CommandRecordingState(&recordingState, kUnityVulkanGraphicsQueueAccess_DontCare)) {
+        return VrsResult::FAILED;
+    }
+
+    ReleaseRetiredResources(recordingState.safeFrameNumber, false);
+    lastFrameNumber = recordingState.currentFrameNumber;
+
+    bool changed = image.Update(mode, gaze, foveation);
+    if (image.GetWidth() != current.width || image.GetHeight() != current.height) {
+        if (current.image) {
+            current.retiredFrame = recordingState.currentFrameNumber;
+            std::lock_guard<std::mutex> lock(retiredMutex);
+            retiredResources.push_back(current);
+        }
+        current = {};
+        if (!CreateImageResources(current)) {
+            DestroyImageResources(current);
+            current = {};
+        }
+        nextUploadSlot = 0;
+        fullUploadPending = true;
+    }
+
+    if (!current.image) {
+        return VrsResult::FAILED;
+    }
+    if (changed || fullUploadPending) {
+        return UploadImage(recordingState) ? VrsResult::APPLIED : VrsResult::FAILED;
+    }
+    return VrsResult::SKIPPED;
+}
+
+bool VulkanVrsBackend::Check(VkResult result) {
+    if (result != VK_SUCCESS) {
+        lastError = static_cast<int32_t>(result);
+        return false;
+    }
+    return true;
+}
+
+void *VulkanVrsBackend::GetNativeShadingRateImage() const {
+    // Non-dispatchable handles are pointers on 64-bit platforms and 64-bit integers elsewhere
+    return (void *)(uintptr_t)current.image;
+}
+
+bool VulkanVrsBackend::AllocateMemory(const VkMemoryRequirements &requirements, VkMemoryPropertyFlags properties, VkDeviceMemory &memory) {
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vk.GetPhysicalDeviceMemoryProperties(vulkan.physicalDevice, &memoryProperties);
+
+    for (uint32_t type = 0; type < memoryProperties.memoryTypeCount; ++type) {
+        if ((requirements.memoryTypeBits & (1u << type)) &&
+            (memoryProperties.memoryTypes[type].propertyFlags & properties) == properties) {
+            VkMemoryAllocateInfo allocateInfo = {};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocateInfo.allocationSize = requirements.size;
+            allocateInfo.memoryTypeIndex = type;
+            return Check(vk.AllocateMemory(vulkan.device, &allocateInfo, nullptr, &memory));
+        }
+    }
+    return false;
+}
+
+bool VulkanVrsBackend::CreateImageResources(ImageResources &resources) {
+    resources.width = image.GetWidth();
+    resources.height = image.GetHeight();
+    if (resources.width <= 0 || resources.height <= 0) {
+        return false;
+    }
+
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = VK_FORMAT_R8_UINT;
+    imageInfo.extent = {static_cast<uint32_t>(resources.width), static_cast<uint32_t>(resources.height), 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (!Check(vk.CreateImage(vulkan.device, &imageInfo, nullptr, &resources.image))) {
+        resources.image = VK_NULL_HANDLE;
+        return false;
+    }
+
+    VkMemoryRequirements requirements;
+    vk.GetImageMemoryRequirements(vulkan.device, resources.image, &requirements);
+    if (!AllocateMemory(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, resources.memory) ||
+        !Check(vk.BindImageMemory(vulkan.device, resources.image, resources.memory, 0))) {
+        return false;
+    }
+
+    VkImageViewCreateInfo viewInfo = {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = resources.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R8_UINT;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.layerCount = 1;
+    if (!Check(vk.CreateImageView(vulkan.device, &viewInfo, nullptr, &resources.view))) {
+        resources.view = VK_NULL_HANDLE;
+        return false;
+    }
+
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = static_cast<VkDeviceSize>(resources.width) * resources.height;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    for (UploadSlot &slot : resources.uploadSlots) {
+        if (!Check(vk.CreateBuffer(vulkan.device, &bufferInfo, nullptr, &slot.buffer))) {
+            slot.buffer = VK_NULL_HANDLE;
+            return false;
+        }
+
+        vk.GetBufferMemoryRequirements(vulkan.device, slot.buffer, &requirements);
+        void *mapped = nullptr;
+        if (!AllocateMemory(requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, slot.memory) ||
+            !Check(vk.BindBufferMemory(vulkan.device, slot.buffer, slot.memory, 0)) ||
+            !Check(vk.MapMemory(vulkan.device, slot.memory, 0, VK_WHOLE_SIZE, 0, &mapped))) {
+            return false;
+        }
+        slot.mapped = static_cast<uint8_t *>(mapped);
+    }
+    return true;
+}
+
+bool VulkanVrsBackend::UploadImage(const UnityVulkanRecordingState &recordingState) {
+    UploadSlot &slot = current.uploadSlots[nextUploadSlot];
+    if (slot.frameNumber > recordingState.safeFrameNumber) {
+        // The GPU may still read this buffer, send the whole image with the next enable instead
+        fullUploadPending = true;
+        return false;
+    }
+
+    TileRect rect = fullUploadPending ? TileRect{0, 0, current.width, current.height} : image.GetDirtyRect();
+    size_t offset = static_cast<size_t>(rect.beginY) * current.width;
+    memcpy(slot.mapped + offset, image.GetData() + offset, static_cast<size_t>(rect.endY - rect.beginY) * current.width);
+
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = current.initialized ? VK_ACCESS_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR : 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = current.initialized ? VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR : VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = current.image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    vk.CmdPipelineBarrier(recordingState.commandBuffer,
+                          current.initialized ? VK_PIPELINE_STAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                          VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    // Whole rows, the row range is what changes when gaze moves vertically
+    VkBufferImageCopy region = {};
+    region.bufferOffset = offset;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {0, rect.beginY, 0};
+    region.imageExtent = {static_cast<uint32_t>(current.width), static_cast<uint32_t>(rect.endY - rect.beginY), 1};
+    vk.CmdCopyBufferToImage(recordingState.commandBuffer, slot.buffer, current.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR;
+    vk.CmdPipelineBarrier(recordingState.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR,
+                          0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    slot.frameNumber = recordingState.currentFrameNumber;
+    current.initialized = true;
+    nextUploadSlot = (nextUploadSlot + 1) % UPLOAD_SLOTS;
+    fullUploadPending = false;
+    return true;
+}
+
+void VulkanVrsBackend::DestroyImageResources(ImageResources &resources) {
+    for (UploadSlot &slot : resources.uploadSlots) {
+        if (slot.buffer) {
+            vk.DestroyBuffer(vulkan.device, slot.buffer, nullptr);
+        }
+        if (slot.memory) {
+            // Freeing host-visible memory also unmaps it
+            vk.FreeMemory(vulkan.device, slot.memory, nullptr);
+        }
+    }
+    if (resources.view) {
+        vk.DestroyImageView(vulkan.device, resources.view, nullptr);
+    }
+    if (resources.image) {
+        vk.DestroyImage(vulkan.device, resources.image, nullptr);
+    }
+    if (resources.memory) {
+        vk.FreeMemory(vulkan.device, resources.memory, nullptr);
+    }
+}
+
+void VulkanVrsBackend::ReleaseRetiredResources(unsigned long long safeFrameNumber, bool force) {
+    std::lock_guard<std::mutex> lock(retiredMutex);
+    size_t kept = 0;
+    for (size_t i = 0; i < retiredResources.size(); ++i) {
+        if (force || retiredResources[i].retiredFrame <= safeFrameNumber) {
+            DestroyImageResources(retiredResources[i]);
+        } else {
+            retiredResources[kept++] = retiredResources[i];
+        }
+    }
+    retiredResources.resize(kept);
+}
+
+void VulkanVrsBackend::Release() {
+    if (supported && current.image) {
+        // Frames recorded with the attachment may still be queued, it goes once Unity reports them done
+        current.retiredFrame = lastFrameNumber;
+        std::lock_guard<std::mutex> lock(retiredMutex);
+        retiredResources.push_back(current);
+    }
+    current = {};
+    supported = false;
+}
+
+#endif
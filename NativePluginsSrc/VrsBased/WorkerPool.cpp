@@ -0,0 +1,84 @@
+#include "WorkerPool.h"
+#include "Utils.h"
+
+// Constructor
+WorkerPool::WorkerPool(int workerCount)
+    : workerCount(workerCount), currentJob(nullptr), currentJobCount(0), nextJob(0),
+    busyWorkers(0), generation(0), stopping(false) {
+    if (this->workerCount < 0) {
+        int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+        this->workerCount = Clamp(hardwareThreads - 1, 0, 15);
+    }
+}
+
+// Destructor
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::Run(int jobCount, const std::function<void(int)> &job) {
+    if (jobCount <= 1 || workerCount == 0) {
+        for (int index = 0; index < jobCount; ++index) {
+            job(index);
+        }
+        return;
+    }
+
+    if (threads.empty()) {
+        threads.reserve(workerCount);
+        for (int worker = 0; worker < workerCount; ++worker) {
+            threads.emplace_back(&WorkerPool::WorkerLoop, this);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentJob = &job;
+        currentJobCount = jobCount;
+        nextJob.store(0, std::memory_order_relaxed);
+        busyWorkers = workerCount;
+        ++generation;
+    }
+    wakeCondition.notify_all();
+
+    RunJobs();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return busyWorkers == 0; });
+    currentJob = nullptr;
+}
+
+void WorkerPool::WorkerLoop() {
+    uint64_t seenGeneration = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wakeCondition.wait(lock, [&] { return stopping || generation != seenGeneration; });
+        if (stopping) {
+            return;
+        }
+        seenGeneration = generation;
+
+        lock.unlock();
+        RunJobs();
+        lock.lock();
+
+        if (--busyWorkers == 0) {
+            doneCondition.notify_one();
+        }
+    }
+}
+
+void WorkerPool::RunJobs() {
+    // currentJob and currentJobCount are published under the mutex before the run starts
+    for (int index = nextJob.fetch_add(1, std::memory_order_relaxed); index < currentJobCount;
+        index = nextJob.fetch_add(1, std::memory_order_relaxed)) {
+        (*currentJob)(index);
+    }
+}
@@ -2,7 +2,6 @@
 #include "PluginInterface.h"
 #include "Vector.h"
 #include <IUnityGraphics.h>
-#include <IUnityGraphicsD3D11.h>
 #include <IUnityInterface.h>
 #include <string>
 
@@ -39,19 +38,88 @@ UnityRenderingEvent UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetRenderEventFun
     };
 }
 
+// GetRenderEventAndDataFunc: Render event function taking a RenderCommandPacket with COMMAND_PACKET
+UnityRenderingEventAndData UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetRenderEventAndDataFunc() {
+    return [](int eventID, void *data) {
+        if (s_plugin) {
+            s_plugin->HandleRenderEventAndData(eventID, data);
+        }
+    };
+}
+
 // VRS APIs exposed to Unity
 
 bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API InitializeFoveatedRendering(float verticalFov, float aspectRatio) {
     if (s_plugin) {
-        return s_plugin->InitializeFoveatedRendering(verticalFov, aspectRatio);
+        return s_plugin->InitializeFoveatedRendering(DEFAULT_FOVEATION_CONTEXT, verticalFov, aspectRatio);
     }
     return false;
 }
 
 void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ReleaseFoveatedRendering() {
     if (s_plugin) {
-        s_plugin->ReleaseFoveatedRendering();
+        s_plugin->ReleaseFoveatedRendering(DEFAULT_FOVEATION_CONTEXT);
+    }
+}
+
+VrsBackendType UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetVrsBackendType() {
+    if (s_plugin) {
+        return s_plugin->GetVrsBackendType();
+    }
+    return VrsBackendType::SOFTWARE;
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ConfigureVrsRenderTarget(int width, int height) {
+    if (s_plugin) {
+        s_plugin->ConfigureVrsRenderTarget(DEFAULT_FOVEATION_CONTEXT, width, height);
+    }
+}
+
+void* UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetNativeShadingRateImage() {
+    if (s_plugin) {
+        return s_plugin->GetNativeShadingRateImage(DEFAULT_FOVEATION_CONTEXT);
+    }
+    return nullptr;
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ConfigureContentShading(const ContentShadingSettings *settings) {
+    if (s_plugin && settings) {
+        s_plugin->ConfigureContentShading(*settings);
+    }
+}
+
+// Pixels of the previous frame as read back by the engine, e.g. an AsyncGPUReadback buffer
+int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SubmitContentFrame(const void *pixels, int width, int height, int rowPitch, int format, int bottomUp) {
+    if (s_plugin && pixels) {
+        VrsContentFrame frame = {static_cast<const uint8_t *>(pixels), width, height, rowPitch, static_cast<ContentPixelFormat>(format), bottomUp != 0};
+        return s_plugin->SubmitContentFrame(frame) ? 1 : 0;
+    }
+    return 0;
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetContentShadingStats(ContentShadingStats *stats) {
+    if (s_plugin && stats) {
+        *stats = s_plugin->GetContentShadingStats();
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SubmitVrsConfiguration(const VrsConfiguration *config) {
+    if (s_plugin && config) {
+        s_plugin->SubmitVrsConfiguration(DEFAULT_FOVEATION_CONTEXT, *config);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetVrsConfiguration(VrsConfiguration *config) {
+    if (s_plugin && config) {
+        *config = s_plugin->GetVrsConfiguration(DEFAULT_FOVEATION_CONTEXT);
+    }
+}
+
+bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API LoadFoveationPreset(const char *path, int index, VrsConfiguration *config) {
+    if (s_plugin && path && config) {
+        return s_plugin->LoadFoveationPreset(path, index, *config);
     }
+    return false;
 }
 
 void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SetShadingRatePreset(ShadingRatePreset preset) {
@@ -80,7 +148,358 @@ void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ConfigureShadingRate(TargetArea
 
 void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UpdateGazeDirection(Vector3 gazeDir) {
     if (s_plugin) {
-        s_plugin->UpdateGazeDirection(gazeDir);
+        s_plugin->UpdateGazeDirection(DEFAULT_FOVEATION_CONTEXT, gazeDir);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ConfigureGazePrediction(bool enabled, float latencyMs, float saccadeVelocityThreshold,
+                                                                         float fixationVelocityThreshold, float maxPredictionDistance) {
+    if (s_plugin) {
+        GazePredictionSettings settings = {enabled, latencyMs, saccadeVelocityThreshold, fixationVelocityThreshold, maxPredictionDistance};
+        s_plugin->ConfigureGazePrediction(settings);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ConfigureGazeFilters(const GazeFilterType *types, int count, GazeFilterSettings settings) {
+    if (s_plugin && (types || count == 0)) {
+        s_plugin->ConfigureGazeFilters(types, count, settings);
+    }
+}
+
+EyeMovementState UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetEyeMovementState() {
+    if (s_plugin) {
+        return s_plugin->GetEyeMovementState();
+    }
+    return EyeMovementState::FIXATION;
+}
+
+Vector2 UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetGazePosition() {
+    if (s_plugin) {
+        return s_plugin->GetGazePosition(DEFAULT_FOVEATION_CONTEXT, Eye::LEFT);
+    }
+    return {0.0f, 0.0f};
+}
+
+Vector2 UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetEyeGazePosition(Eye eye) {
+    if (s_plugin) {
+        return s_plugin->GetGazePosition(DEFAULT_FOVEATION_CONTEXT, eye);
+    }
+    return {0.0f, 0.0f};
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UpdateStereoGazeDirection(Vector3 leftGazeDir, Vector3 rightGazeDir) {
+    if (s_plugin) {
+        s_plugin->UpdateStereoGazeDirection(DEFAULT_FOVEATION_CONTEXT, leftGazeDir, rightGazeDir);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SetRenderMode(RenderMode mode) {
+    if (s_plugin) {
+        s_plugin->SetRenderMode(DEFAULT_FOVEATION_CONTEXT, mode);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ConfigureViewFrustum(Eye eye, float tanLeft, float tanRight, float tanUp, float tanDown) {
+    if (s_plugin) {
+        s_plugin->ConfigureViewFrustum(DEFAULT_FOVEATION_CONTEXT, eye, {tanLeft, tanRight, tanUp, tanDown});
+    }
+}
+
+// Foveation contexts, one per camera or view; the APIs above act on the default context
+
+int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API CreateFoveationContext() {
+    if (s_plugin) {
+        return s_plugin->CreateFoveationContext();
+    }
+    return INVALID_FOVEATION_CONTEXT;
+}
+
+bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API DestroyFoveationContext(int context) {
+    if (s_plugin) {
+        return s_plugin->DestroyFoveationContext(context);
+    }
+    return false;
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SetFoveationContextEnabled(int context, bool enabled) {
+    if (s_plugin) {
+        s_plugin->SetFoveationContextEnabled(context, enabled);
+    }
+}
+
+bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API IsFoveationContextEnabled(int context) {
+    if (s_plugin) {
+        return s_plugin->IsFoveationContextEnabled(context);
+    }
+    return false;
+}
+
+bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API InitializeContextFoveatedRendering(int context, float verticalFov, float aspectRatio) {
+    if (s_plugin) {
+        return s_plugin->InitializeFoveatedRendering(context, verticalFov, aspectRatio);
+    }
+    return false;
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ReleaseContextFoveatedRendering(int context) {
+    if (s_plugin) {
+        s_plugin->ReleaseFoveatedRendering(context);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ConfigureContextRenderTarget(int context, int width, int height) {
+    if (s_plugin) {
+        s_plugin->ConfigureVrsRenderTarget(context, width, height);
+    }
+}
+
+void* UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetContextShadingRateImage(int context) {
+    if (s_plugin) {
+        return s_plugin->GetNativeShadingRateImage(context);
+    }
+    return nullptr;
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SubmitContextConfiguration(int context, const VrsConfiguration *config) {
+    if (s_plugin && config) {
+        s_plugin->SubmitVrsConfiguration(context, *config);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetContextConfiguration(int context, VrsConfiguration *config) {
+    if (s_plugin && config) {
+        *config = s_plugin->GetVrsConfiguration(context);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SetContextRenderMode(int context, RenderMode mode) {
+    if (s_plugin) {
+        s_plugin->SetRenderMode(context, mode);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ConfigureContextViewFrustum(int context, Eye eye, float tanLeft, float tanRight, float tanUp, float tanDown) {
+    if (s_plugin) {
+        s_plugin->ConfigureViewFrustum(context, eye, {tanLeft, tanRight, tanUp, tanDown});
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UpdateContextGazeDirection(int context, Vector3 gazeDir) {
+    if (s_plugin) {
+        s_plugin->UpdateGazeDirection(context, gazeDir);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UpdateContextStereoGazeDirection(int context, Vector3 leftGazeDir, Vector3 rightGazeDir) {
+    if (s_plugin) {
+        s_plugin->UpdateStereoGazeDirection(context, leftGazeDir, rightGazeDir);
+    }
+}
+
+Vector2 UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetContextGazePosition(int context, Eye eye) {
+    if (s_plugin) {
+        return s_plugin->GetGazePosition(context, eye);
+    }
+    return {0.0f, 0.0f};
+}
+
+bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API StartGazeReceiver(int port) {
+    if (s_plugin && port > 0 && port < 65536) {
+        return s_plugin->StartGazeReceiver(static_cast<uint16_t>(port));
+    }
+    return false;
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API StopGazeReceiver() {
+    if (s_plugin) {
+        s_plugin->StopGazeReceiver();
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetGazeReceiverStats(GazeReceiverStats *stats) {
+    if (s_plugin && stats) {
+        *stats = s_plugin->GetGazeReceiverStats();
+    }
+}
+
+bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API StartSharedGazeReader(const char *name) {
+    if (s_plugin && name) {
+        return s_plugin->StartSharedGazeReader(name);
+    }
+    return false;
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API StopSharedGazeReader() {
+    if (s_plugin) {
+        s_plugin->StopSharedGazeReader();
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetSharedGazeReaderStats(SharedGazeReaderStats *stats) {
+    if (s_plugin && stats) {
+        *stats = s_plugin->GetSharedGazeReaderStats();
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetGazeLatencyStats(GazeLatencyStats *stats) {
+    if (s_plugin && stats) {
+        *stats = s_plugin->GetGazeLatencyStats();
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ResetGazeLatencyStats() {
+    if (s_plugin) {
+        s_plugin->ResetGazeLatencyStats();
+    }
+}
+
+int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UpdateShadingRateImage(int width, int height, int tileSize, unsigned char *buffer, int bufferSize) {
+    if (s_plugin) {
+        return s_plugin->UpdateShadingRateImage(width, height, tileSize, buffer, bufferSize);
+    }
+    return 0;
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ConfigureFoveationGovernor(const FoveationGovernorSettings *settings) {
+    if (s_plugin && settings) {
+        s_plugin->ConfigureFoveationGovernor(*settings);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SubmitFrameTime(float frameTimeMs) {
+    if (s_plugin) {
+        s_plugin->SubmitFrameTime(frameTimeMs);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetFoveationGovernorState(FoveationGovernorState *state) {
+    if (s_plugin && state) {
+        *state = s_plugin->GetFoveationGovernorState();
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API QueryShadingCost(int width, int height, int tileSize, float gazeX, float gazeY, ShadingCostEstimate *estimate) {
+    if (s_plugin && estimate) {
+        *estimate = s_plugin->QueryShadingCost(width, height, tileSize, {gazeX, gazeY});
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ConfigureShadingCostTelemetry(int width, int height, int tileSize) {
+    if (s_plugin) {
+        s_plugin->ConfigureShadingCostTelemetry(width, height, tileSize);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetShadingCostTelemetry(ShadingCostTelemetryStats *stats) {
+    if (s_plugin && stats) {
+        *stats = s_plugin->GetShadingCostTelemetry();
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ResetShadingCostTelemetry() {
+    if (s_plugin) {
+        s_plugin->ResetShadingCostTelemetry();
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetInstrumentationStats(InstrumentationStats *stats) {
+    if (s_plugin && stats) {
+        *stats = s_plugin->GetInstrumentationStats();
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ResetInstrumentationStats() {
+    if (s_plugin) {
+        s_plugin->ResetInstrumentationStats();
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SetInstrumentationTracing(bool enabled) {
+    if (s_plugin) {
+        s_plugin->SetInstrumentationTracing(enabled);
+    }
+}
+
+int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API WriteInstrumentationTrace(const char *path) {
+    if (s_plugin) {
+        return s_plugin->WriteInstrumentationTrace(path);
+    }
+    return -1;
+}
+
+int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ClassifyFoveatedLods(const LodClassifierParams *params,
+    const float *positionX, const float *positionY, const float *positionZ, const float *radius,
+    const int32_t *coarsestLod, int32_t *lods, int count, int32_t *changed, int changedCapacity) {
+    if (s_plugin && params && positionX && positionY && positionZ && radius && coarsestLod && lods && changed) {
+        LodObjectBatch batch = {positionX, positionY, positionZ, radius, coarsestLod, lods, count, nullptr, nullptr, nullptr, nullptr};
+        return s_plugin->ClassifyFoveatedLods(*params, batch, changed, changedCapacity);
+    }
+    return 0;
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API InsertLodObjects(const float *positionX, const float *positionY, const float *positionZ,
+    const float *radius, const int32_t *coarsestLod, int count, int32_t *handles) {
+    if (s_plugin && positionX && positionY && positionZ && radius && coarsestLod && handles) {
+        s_plugin->InsertLodObjects(positionX, positionY, positionZ, radius, coarsestLod, count, handles);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UpdateLodObjects(const int32_t *handles, const float *positionX, const float *positionY,
+    const float *positionZ, const float *radius, int count) {
+    if (s_plugin && handles && positionX && positionY && positionZ && radius) {
+        s_plugin->UpdateLodObjects(handles, positionX, positionY, positionZ, radius, count);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API RemoveLodObjects(const int32_t *handles, int count) {
+    if (s_plugin && handles) {
+        s_plugin->RemoveLodObjects(handles, count);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ClearLodObjects() {
+    if (s_plugin) {
+        s_plugin->ClearLodObjects();
+    }
+}
+
+int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API ClassifyLodObjects(const LodClassifierParams *params, int32_t *changedHandles,
+    int32_t *changedLods, int capacity) {
+    if (s_plugin && params && changedHandles && changedLods) {
+        return s_plugin->ClassifyLodObjects(*params, changedHandles, changedLods, capacity);
+    }
+    return 0;
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetLodSpatialIndexStats(LodSpatialIndexStats *stats) {
+    if (s_plugin && stats) {
+        *stats = s_plugin->GetLodSpatialIndexStats();
+    }
+}
+
+bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API StartTraceRecording(const char *path) {
+    if (s_plugin && path) {
+        return s_plugin->StartTraceRecording(path);
+    }
+    return false;
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API StopTraceRecording() {
+    if (s_plugin) {
+        s_plugin->StopTraceRecording();
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API RecordTraceFrame(const Vector3 *cameraPosition, const Quaternion *cameraRotation,
+    float frameTimeMs) {
+    if (s_plugin && cameraPosition && cameraRotation) {
+        s_plugin->RecordTraceFrame(*cameraPosition, *cameraRotation, frameTimeMs);
+    }
+}
+
+void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetTraceRecordingStats(TraceWriterStats *stats) {
+    if (s_plugin && stats) {
+        *stats = s_plugin->GetTraceRecordingStats();
     }
 }
 }
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Enums.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Color buffer of the previous frame, as read back by the engine
+struct VrsContentFrame {
+    const uint8_t *pixels;
+    int width;
+    int height;
+    int rowPitch;               // Bytes between two rows
+    ContentPixelFormat format;
+    bool bottomUp;              // Rows are stored bottom row first (OpenGL-style readback)
+};
+
+struct ContentShadingSettings {
+    bool enabled;
+    float threshold;            // RMS luma difference of neighbouring pixels (8-bit code values) a halved rate may hide, inner region
+    float middleScale;          // Threshold multiplier in the middle region
+    float peripheralScale;      // Threshold multiplier outside the middle region
+};
+
+// Counters of the content analysis
+struct ContentShadingStats {
+    uint64_t framesAnalyzed;
+    float lastAnalysisMs;
+    int32_t blocksX;            // Block grid of the last analyzed frame
+    int32_t blocksY;
+};
+
+// Measures per 8x8 pixel block how much detail the previous frame had in
+// each direction: the RMS luma difference of horizontal and vertical
+// neighbours (gradient energy). Halving the rate along an axis blends those
+// neighbours, so the difference estimates the error a coarser rate makes;
+// quartering it makes about 2.13 times the error (Yang et al., "Visually
+// Lossless Content and Motion Adaptive Shading"). Luma is taken from the
+// gamma-encoded color, which is close to perceptually uniform.
+//
+// Frames are analyzed on the submitting thread with an SSE2 kernel and
+// published as a whole; the render thread merges the latest block grid into
+// the foveation rates, never making a rate finer than foveation chose.
+class ContentAdaptiveShading {
+public:
+    // Block size of the analysis in pixels, shading-rate tiles are multiples of it
+    static const int BLOCK_SIZE = 8;
+
+    ContentAdaptiveShading();
+    ~ContentAdaptiveShading();
+
+    // Replace the settings, safe from any thread
+    void Configure(const ContentShadingSettings &settings);
+    ContentShadingSettings GetSettings() const;
+
+    // Analyze a frame and publish its block grid, safe from any thread
+    bool Analyze(const VrsContentFrame &frame);
+
+    // Adopt the latest published grid, returns true if settings or grid changed since the last latch (render thread)
+    bool Latch();
+
+    // Whether merging is enabled and a grid of this size was latched (render thread)
+    bool IsActive(int width, int height) const;
+
+    // Coarsest rate the content allows in a pixel rectangle of a foveation region: log2 of the coarse
+    // width in bits 2-3 and of the height in bits 0-1, the shading-rate image encoding (render thread)
+    uint8_t GetCoarsestRate(int beginX, int beginY, int endX, int endY, TargetArea area) const;
+
+    ContentShadingStats GetStats() const;
+
+    static ContentShadingSettings GetDefaultSettings();
+
+private:
+    // Gradient energy of a frame, errors are RMS luma differences in 1/256 code values
+    struct BlockGrid {
+        int width;
+        int height;
+        int blocksX;
+        int blocksY;
+        std::vector<uint16_t> errorX;
+        std::vector<uint16_t> errorY;
+    };
+
+    // Luma of one pixel row, the row is padded by repeating its last pixel
+    static void ComputeLumaRow(const uint8_t *pixels, int width, ContentPixelFormat format, uint8_t *luma);
+
+    // Accumulate squared neighbour differences of a row into per block sums
+    static void AccumulateRow(const uint8_t *luma, const uint8_t *nextLuma, int width, uint32_t *sumX, uint32_t *sumY);
+
+    // Written by the analyzing thread, published under publishMutex
+    mutable std::mutex publishMutex;
+    BlockGrid published;
+    uint64_t publishedVersion;
+    ContentShadingSettings settings;
+    uint64_t settingsVersion;
+
+    // Scratch of the analyzing thread
+    std::mutex analyzeMutex;
+    BlockGrid scratch;
+    std::vector<uint8_t> lumaRows[2];
+    std::vector<uint32_t> sumX;
+    std::vector<uint32_t> sumY;
+
+    // Render thread state
+    BlockGrid latched;
+    uint64_t latchedVersion;
+    uint64_t latchedSettingsVersion;
+    ContentShadingSettings latchedSettings;
+
+    std::atomic<uint64_t> framesAnalyzed;
+    std::atomic<float> lastAnalysisMs;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "VrsBackend.h"
+
+#if VRS_BACKEND_D3D
+
+#include "FoveationImageBuilder.h"
+#include <IUnityGraphicsD3D12.h>
+#include <d3d12.h>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Direct3D 12 VRS tier 2. The foveation is rasterized into an R8_UINT
+// shading-rate image on the CPU, changed rows are copied through a ring of
+// upload buffers and the image is bound on Unity's current command list.
+class D3D12VrsBackend : public IVrsBackend {
+public:
+    // Upload buffers in flight, two enables per frame (multi-pass stereo) over three frames
+    static const int UPLOAD_SLOTS = 6;
+
+    explicit D3D12VrsBackend(IUnityGraphicsD3D12v5 *unityGraphicsD3D12);
+    ~D3D12VrsBackend();
+
+    VrsBackendType GetType() const override { return VrsBackendType::D3D12; }
+    bool Initialize(float tanHalfHorizontalFov, float tanHalfVerticalFov, bool stereo) override;
+    void ConfigureRenderTarget(int width, int height) override { image.ConfigureRenderTarget(width, height); }
+    bool UpdateGaze(const VrsGazeFrame &gaze) override;
+    VrsResult Enable(RenderMode mode, const VrsFoveationState &foveation) override;
+    VrsResult Disable() override;
+    void *GetNativeShadingRateImage() const override { return rateImage; }
+    void ConfigureContentShading(const ContentShadingSettings &settings) override { image.ConfigureContentShading(settings); }
+    bool SubmitContentFrame(const VrsContentFrame &frame) override { return image.SubmitContentFrame(frame); }
+    ContentShadingStats GetContentShadingStats() const override { return image.GetContentStats(); }
+    int32_t GetLastNativeError() const override { return lastError; }
+    void Release() override;
+
+private:
+    // Upload buffer and the frame fence value after which the GPU no longer reads it
+    struct UploadSlot {
+        ID3D12Resource *buffer;
+        UINT64 fenceValue;
+    };
+
+    // Let Unity hand out its command list during the enable and disable events
+    void ConfigurePluginEvents();
+
+    // Recreate the image and upload buffers for the builder size
+    bool CreateImageResources();
+
+    // Retire the image and upload buffers, they are released once the GPU is done with them
+    void RetireImageResources();
+
+    // Release retired resources of every backend the GPU no longer uses, all of them if force is set
+    void ReleaseRetiredResources(bool force);
+
+    // Copy the changed rows of the image into the shading-rate image, false leaves the image unchanged
+    bool UploadImage(ID3D12GraphicsCommandList5 *commandList);
+
+    IUnityGraphicsD3D12v5 *unityGraphics;
+    ID3D12Device *device;
+    bool supported;
+
+    FoveationImageBuilder image;
+    VrsGazeFrame gaze;
+
+    ID3D12Resource *rateImage;
+    int imageWidth;
+    int imageHeight;
+    UINT rowPitch;
+    UploadSlot uploadSlots[UPLOAD_SLOTS];
+    int nextUploadSlot;
+    bool fullUploadPending;
+    int32_t lastError;
+
+    // Resources replaced or released while frames using them may still be in flight. Shared by the backends
+    // of the device, a context deletes its backend before the GPU is done with its last frames.
+    static std::mutex retiredMutex;
+    static std::vector<std::pair<ID3D12Resource *, UINT64>> retiredResources;
+    static std::atomic<int> liveBackends;
+};
+
+#endif
@@ -4,7 +4,50 @@
 enum class EventID {
     ENABLE_FOVEATED_RENDERING,
     DISABLE_FOVEATED_RENDERING,
-    UPDATE_GAZE
+    UPDATE_GAZE,
+    PRESENT_FRAME,
+    ENABLE_FOVEATED_RENDERING_LEFT_EYE,   // Multi-pass stereo, left eye pass
+    ENABLE_FOVEATED_RENDERING_RIGHT_EYE,  // Multi-pass stereo, right eye pass
+    COMMAND_PACKET                        // RenderCommandPacket passed through IssuePluginEventAndData
+};
+
+// Operations of a RenderCommandPacket
+enum class RenderCommandOp {
+    LATCH_GAZE,            // Same as UPDATE_GAZE
+    LATCH_CONFIGURATION,   // Adopt the submitted configuration, and on the default context the governor's foveation, now
+    ENABLE,                // Foveate the views of the command's mode
+    DISABLE,               // Same as DISABLE_FOVEATED_RENDERING
+    PRESENT_FRAME,         // Same as PRESENT_FRAME
+    SELECT_CONTEXT         // Run the following operations on the foveation context in the command's mode field
+};
+
+// Views Foveated by ENABLE_FOVEATED_RENDERING
+enum class RenderMode {
+    MONO,       // Single view, one gaze point
+    LEFT_EYE,   // Left eye only
+    RIGHT_EYE,  // Right eye only
+    STEREO      // Both eyes in one pass (double-wide or single-pass instanced)
+};
+
+// Eyes of a Stereo View
+enum class Eye {
+    LEFT,
+    RIGHT
+};
+
+// Graphics APIs Served by a VRS Backend
+enum class VrsBackendType {
+    SOFTWARE,      // No device, rate maps are only built and recorded
+    NVAPI_D3D11,   // NVIDIA VRS helper on Direct3D 11
+    D3D12,         // Direct3D 12 VRS tier 2 shading-rate image
+    VULKAN         // VK_KHR_fragment_shading_rate attachment
+};
+
+// Outcome of a Backend Operation
+enum class VrsResult {
+    APPLIED,   // Device state was changed
+    SKIPPED,   // Nothing to change, the device already matches
+    FAILED     // The device rejected the change, see IVrsBackend::GetLastNativeError
 };
 
 // Target Areas for Foveated Rendering
@@ -49,3 +92,44 @@ enum class ShadingRate {
     X1_PER_2X4_PIXELS,  // 1 shading pass / 8 pixels
     X1_PER_4X4_PIXELS   // 1 shading pass / 16 pixels
 };
+
+// Eye Movement States Reported by the Gaze Filter Chain
+enum class EyeMovementState {
+    FIXATION,
+    PURSUIT,
+    SACCADE
+};
+
+// Stages of the Gaze Filter Chain
+enum class GazeFilterType {
+    DEAD_ZONE,        // Ignore movements below a threshold (legacy behaviour)
+    ONE_EURO,         // Adaptive low-pass, smooth at rest and responsive in motion
+    KALMAN,           // Constant-velocity Kalman filter
+    FIXATION_IVT,     // Velocity-threshold fixation/saccade classifier
+    FIXATION_IDT      // Dispersion-threshold fixation/saccade classifier
+};
+
+// Stages of the Motion-to-Photon Latency Accounting
+enum class LatencyStage {
+    CAPTURE_TO_RECEIVE,  // Tracker capture until the plugin received the sample
+    RECEIVE_TO_LATCH,    // Plugin receipt until the render thread latched the sample
+    LATCH_TO_PRESENT,    // Render thread latch until the frame was submitted for present
+    CAPTURE_TO_PRESENT,  // End to end, tracker capture until present
+    COUNT
+};
+
+// Instrumented Plugin Operations
+enum class TraceScope {
+    HANDLE_EVENT,    // One render event or command packet
+    GAZE_REFRESH,    // Filter and predict the gaze of the frame
+    GAZE_LATCH,      // Hand the gaze to the backend
+    ENABLE,          // Backend enable
+    DISABLE,         // Backend disable
+    COUNT
+};
+
+// Pixel Layouts of a Content Frame
+enum class ContentPixelFormat {
+    RGBA8,   // Four bytes per pixel, red first
+    BGRA8    // Four bytes per pixel, blue first
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Enums.h"
+#include "Vector.h"
+
+// Platform-neutral description of the foveation regions.
+// Gaze and radii share the normalized screen space used by NVAPI:
+// the screen spans [-0.5, 0.5] on both axes, +y pointing up.
+struct FoveationDesc {
+    Vector2 innerRadii;
+    Vector2 middleRadii;
+    Vector2 peripheralRadii;
+
+    ShadingRate innerRate;
+    ShadingRate middleRate;
+    ShadingRate peripheralRate;
+};
+
+// Resolve the per-region shading rates of a preset (CUSTOM keeps the rates already in desc)
+void ResolveShadingRatePreset(ShadingRatePreset preset, FoveationDesc &desc);
+
+// Resolve the region radii of a pattern preset (CUSTOM keeps the radii already in desc)
+void ResolveFoveationPatternPreset(ShadingPatternPreset preset, FoveationDesc &desc);
+
+// Check whether two descriptions produce the same classification
+bool IsSameFoveation(const FoveationDesc &lhs, const FoveationDesc &rhs);
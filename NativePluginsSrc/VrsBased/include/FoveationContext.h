@@ -0,0 +1,81 @@
+#pragma once
+
+#include "GazeManager.h"
+#include "VrsBackend.h"
+#include "VrsManager.h"
+#include <atomic>
+#include <cstdint>
+
+// Handle of a foveation context: slot in the low bits, slot generation above,
+// so a handle of a destroyed context never addresses its slot's next context
+typedef int32_t FoveationContextId;
+
+// Context of the single-view API, exists from plugin load to unload
+static const FoveationContextId DEFAULT_FOVEATION_CONTEXT = 0;
+static const FoveationContextId INVALID_FOVEATION_CONTEXT = -1;
+
+// Foveation of one camera or view. Every context has its own backend
+// instance on the shared device, so views of different sizes keep their own
+// shading-rate images, plus its own FOV, gaze mapping, configuration and
+// enabled state.
+struct FoveationContext {
+    FoveationContext();
+    ~FoveationContext();
+
+    VrsManager vrsManager;
+    GazeManager gazeManager;
+    IVrsBackend *backend;                   // Created for the current device, null if the renderer has no VRS support
+    float tanHalfHorizontalFov;
+    float tanHalfVerticalFov;
+    std::atomic<bool> initialized;          // Between InitializeFoveatedRendering and its release
+    std::atomic<bool> enabled;              // Enable events foveate, otherwise they return to full-rate shading
+};
+
+// Fixed array of context slots addressed by FoveationContextId. Contexts are
+// created and destroyed by the scripting thread and looked up lock-free by
+// any thread. A destroyed context is only retired: its handle stops
+// resolving at once, and the render thread deletes it at its next reclaim,
+// so a render event that already resolved it finishes safely.
+class FoveationContextPool {
+public:
+    static const int SLOT_BITS = 4;
+    static const int MAX_CONTEXTS = 1 << SLOT_BITS;
+
+    FoveationContextPool();
+    ~FoveationContextPool();
+
+    // Create a context in a free slot, INVALID_FOVEATION_CONTEXT if every slot is taken (scripting thread)
+    FoveationContextId Acquire();
+
+    // Retire a context, returns false for unknown handles (scripting thread)
+    bool Retire(FoveationContextId id);
+
+    // Context of a handle, null if it was never issued or its context was retired (any thread)
+    FoveationContext *Get(FoveationContextId id) const;
+
+    // Context of a slot, null if the slot holds none, for visiting every context (any thread)
+    FoveationContext *GetSlot(int slot) const;
+
+    // Delete retired contexts together with their backends (render thread)
+    void Reclaim();
+
+    // Delete every context, including the default one (plugin teardown)
+    void Clear();
+
+private:
+    enum class SlotState {
+        FREE,
+        ACTIVE,
+        RETIRED
+    };
+
+    struct Slot {
+        std::atomic<FoveationContextId> id;     // INVALID_FOVEATION_CONTEXT unless active
+        std::atomic<int> state;                 // SlotState
+        FoveationContext *context;
+        uint32_t generation;
+    };
+
+    Slot slots[MAX_CONTEXTS];
+    std::atomic<int> retiredCount;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Foveation.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+// Settings of the frame-time governor
+struct FoveationGovernorSettings {
+    bool enabled;
+    float targetFrameTimeMs;
+    float hysteresis;            // Relative dead band around the target, no adjustment inside it
+    float smoothing;             // Weight of a new frame time in the moving average, (0, 1]
+    int holdFrames;              // Minimum frames between two adjustments
+    float maxStep;               // Largest quality change per adjustment
+    FoveationDesc lowestQuality;   // Cheapest foveation the governor may use
+    FoveationDesc highestQuality;  // Best foveation the governor may use
+};
+
+// Observable state of the governor
+struct FoveationGovernorState {
+    float quality;               // 0 at lowestQuality, 1 at highestQuality
+    float smoothedFrameTimeMs;
+    uint64_t adjustments;
+    FoveationDesc foveation;     // Foveation currently requested
+};
+
+// Closed-loop controller trading foveation quality for frame time.
+// Frame times are smoothed and compared to the target; outside the dead band
+// the quality is stepped proportionally to the error, fast when over budget
+// and slowly when under budget. Radii follow the quality continuously while
+// shading rates move along a ladder with their own hysteresis, and every
+// reversal of direction doubles the hold time, so the pattern does not pump.
+//
+// Frame times and settings come from the scripting thread, the render thread
+// picks up the resulting foveation without ever blocking.
+class FoveationGovernor {
+public:
+    FoveationGovernor();
+    ~FoveationGovernor();
+
+    // Replace the settings, quality is kept within the new bounds
+    void Configure(const FoveationGovernorSettings &newSettings);
+
+    // Feed the duration of the last frame
+    void SubmitFrameTime(float frameTimeMs);
+
+    // Take the latest foveation if it changed since the last call (render thread).
+    // active tells whether the governor drives foveation at all.
+    bool ConsumeFoveation(FoveationDesc &desc, bool &active);
+
+    FoveationGovernorState GetState() const;
+
+    // Defaults, disabled, 11.1 ms target (90 Hz) between NARROW/HIGHEST_PERFORMANCE and WIDE/BALANCED
+    static FoveationGovernorSettings GetDefaultSettings();
+
+private:
+    static const int RATE_LADDER_SIZE = 9;
+    static const float RATE_HYSTERESIS;
+    static const float UNDER_BUDGET_GAIN;
+    static const float OVER_BUDGET_GAIN;
+    static const int MAX_BACKOFF = 8;
+
+    // Rebuild the requested foveation from the quality
+    void UpdateFoveation();
+
+    // Pick a region rate between the bounds with hysteresis around the current ladder position
+    ShadingRate SelectRate(ShadingRate lowest, ShadingRate highest, int &ladderIndex) const;
+
+    // Ladder position of a rate, higher is cheaper
+    static int GetLadderIndex(ShadingRate rate);
+
+    mutable std::mutex mutex;
+    std::atomic<bool> dirty;
+
+    FoveationGovernorSettings settings;
+    float quality;
+    float smoothedFrameTimeMs;
+    bool hasFrameTime;
+    int framesSinceAdjustment;
+    int lastDirection;
+    int backoff;
+    uint64_t adjustments;
+    int ladderIndices[3];
+    FoveationDesc foveation;
+};
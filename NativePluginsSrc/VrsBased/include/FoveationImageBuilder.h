@@ -0,0 +1,88 @@
+#pragma once
+
+#include "ContentAdaptiveShading.h"
+#include "Enums.h"
+#include "Foveation.h"
+#include "ShadingRateImage.h"
+#include "VrsBackend.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Encoded shading-rate image shared by the image-based backends (D3D12 tier 2,
+// VK_KHR_fragment_shading_rate, software). Texels use the encoding both APIs
+// agree on: log2 of the coarse width in bits 2-3, log2 of the height in bits 0-1.
+// Stereo targets are double-wide, each half is foveated around its own eye.
+// With content-adaptive shading enabled, tiles whose previous-frame content
+// has little detail are coarsened further than their foveation region asks.
+class FoveationImageBuilder {
+public:
+    FoveationImageBuilder();
+    ~FoveationImageBuilder();
+
+    // Request a render target size, picked up by the next update (any thread)
+    void ConfigureRenderTarget(int width, int height);
+
+    // Tile size of the device and whether it supports the 2x4, 4x2 and 4x4 rates
+    void ConfigureDevice(int tileSize, bool largeRatesSupported);
+
+    // Content-adaptive rate settings, safe from any thread
+    void ConfigureContentShading(const ContentShadingSettings &settings) { content.Configure(settings); }
+
+    // Analyze the previous frame's color, it must match the render target size to be merged (any thread)
+    bool SubmitContentFrame(const VrsContentFrame &frame) { return content.Analyze(frame); }
+
+    ContentShadingStats GetContentStats() const { return content.GetStats(); }
+
+    // Rebuild the tiles affected by gaze, foveation or content, returns true if any texel changed (render thread).
+    // Returns early when mode, gaze timestamp, foveation version and content match the previous update.
+    bool Update(RenderMode mode, const VrsGazeFrame &gaze, const VrsFoveationState &foveation);
+
+    // Encoded image, one byte per tile, rows are GetWidth() bytes apart
+    int GetWidth() const { return tilesX; }
+    int GetHeight() const { return tilesY; }
+    int GetTileSize() const { return tileSize; }
+    const uint8_t *GetData() const { return contentMerged ? merged.data() : encoded.data(); }
+
+    // Tiles rewritten by the last update, empty if endX <= beginX
+    const TileRect &GetDirtyRect() const { return dirtyRect; }
+
+    // Encoded texel of a shading rate, rates without a coarse equivalent shade at 1x1
+    static uint8_t EncodeShadingRate(ShadingRate rate, bool largeRatesSupported);
+
+private:
+    // Resize the views for the pending target and view count, returns true if they were recreated
+    bool ApplyTargetSize(int viewCount);
+
+    // Coarsen the foveation texels by the content's limits into merged, and set the dirty rectangle to what changed
+    void MergeContent();
+
+    // Texel with the coarser width and height of two texels, restricted to the device's rates
+    uint8_t CombineRates(uint8_t foveation, uint8_t content) const;
+
+    std::atomic<int> pendingWidth;
+    std::atomic<int> pendingHeight;
+    int targetWidth;
+    int targetHeight;
+    int tileSize;
+    bool largeRates;
+
+    // One rate image per side by side view
+    ShadingRateImage views[2];
+    int viewCount;
+    int tilesX;
+    int tilesY;
+
+    std::vector<uint8_t> encoded;
+    TileRect dirtyRect;
+
+    // Foveation texels coarsened by the content, used instead of encoded while content merging is active
+    ContentAdaptiveShading content;
+    std::vector<uint8_t> merged;
+    bool contentMerged;
+
+    // Inputs of the previous update
+    RenderMode lastMode;
+    uint64_t lastGazeTimestamp;
+    uint64_t lastFoveationVersion;
+};
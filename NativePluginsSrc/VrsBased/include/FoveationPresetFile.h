@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Foveation.h"
+#include <string>
+#include <vector>
+
+// One foveation configuration of a preset file
+struct FoveationPresetEntry {
+    std::string name;           // No whitespace
+    FoveationDesc desc;
+    float relativeCost;         // Shading cost relative to full-rate shading, as estimated when the file was written
+    float weightedPsnr;         // Acuity-weighted PSNR in dB, as estimated when the file was written
+};
+
+// Text file of custom foveation configurations, one per line:
+//   name inner_rx inner_ry middle_rx middle_ry peripheral_rx peripheral_ry inner_rate middle_rate peripheral_rate cost psnr
+// Rates are written as "1x1", "2x2", "4x4", "2x" (supersampling), "cull" and so on.
+// Lines starting with '#' are comments. Written by the PresetOptimizer benchmark tool.
+
+// Read every entry, returns false if the file cannot be opened or a line is malformed
+bool ReadFoveationPresets(const std::string &path, std::vector<FoveationPresetEntry> &entries);
+
+// Write entries after a comment header, returns false if the file cannot be written
+bool WriteFoveationPresets(const std::string &path, const std::vector<FoveationPresetEntry> &entries, const std::string &comment);
+
+// Short name of a shading rate in preset files
+const char *GetShadingRateName(ShadingRate rate);
+
+// Shading rate of a short name, returns false for unknown names
+bool ParseShadingRateName(const char *name, ShadingRate &rate);
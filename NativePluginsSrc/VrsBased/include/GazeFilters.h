@@ -0,0 +1,176 @@
+#pragma once
+
+#include "Enums.h"
+#include "GazeSampleRing.h"
+#include "Vector.h"
+#include <cstdint>
+
+// Tunables of every filter stage, unused stages ignore their fields
+struct GazeFilterSettings {
+    // DEAD_ZONE
+    float deadZoneThreshold;
+
+    // ONE_EURO
+    float oneEuroMinCutoff;       // Hz
+    float oneEuroBeta;
+    float oneEuroDerivateCutoff;  // Hz
+
+    // KALMAN
+    float kalmanProcessNoise;      // Acceleration variance, (units/s^2)^2
+    float kalmanMeasurementNoise;  // Position variance, units^2
+
+    // FIXATION_IVT
+    float saccadeVelocityThreshold;  // Normalized gaze units per second
+    float pursuitVelocityThreshold;
+
+    // FIXATION_IDT
+    float dispersionThreshold;  // Normalized gaze units
+    float dispersionWindowMs;
+};
+
+// Single stage of the chain, processes samples in place
+class GazeFilter {
+public:
+    virtual ~GazeFilter() {}
+
+    virtual void Configure(const GazeFilterSettings &settings) = 0;
+    virtual void Process(GazeSample &sample) = 0;
+    virtual void Reset() = 0;
+};
+
+// Holds position until it moves further than a threshold
+class DeadZoneFilter : public GazeFilter {
+public:
+    DeadZoneFilter();
+
+    void Configure(const GazeFilterSettings &settings) override;
+    void Process(GazeSample &sample) override;
+    void Reset() override;
+
+private:
+    float threshold;
+    Vector2 position;
+    bool initialized;
+};
+
+// One Euro filter (Casiez et al.): cutoff rises with speed to trade jitter for lag
+class OneEuroFilter : public GazeFilter {
+public:
+    OneEuroFilter();
+
+    void Configure(const GazeFilterSettings &settings) override;
+    void Process(GazeSample &sample) override;
+    void Reset() override;
+
+private:
+    float minCutoff;
+    float beta;
+    float derivateCutoff;
+
+    Vector2 position;
+    Vector2 derivate;
+    uint64_t lastTimestamp;
+    bool initialized;
+};
+
+// Constant-velocity Kalman filter, both axes treated independently
+class KalmanFilter : public GazeFilter {
+public:
+    KalmanFilter();
+
+    void Configure(const GazeFilterSettings &settings) override;
+    void Process(GazeSample &sample) override;
+    void Reset() override;
+
+private:
+    struct Axis {
+        float position, velocity;
+        float p00, p01, p11;  // Symmetric covariance
+    };
+
+    void Step(Axis &axis, float measurement, float dt) const;
+
+    float processNoise;
+    float measurementNoise;
+
+    Axis axes[2];
+    uint64_t lastTimestamp;
+    bool initialized;
+};
+
+// Fixation/saccade classifier, either by velocity (I-VT) or dispersion (I-DT).
+// Does not alter samples, the result is read through GetState().
+class FixationClassifier : public GazeFilter {
+public:
+    explicit FixationClassifier(GazeFilterType method);
+
+    void Configure(const GazeFilterSettings &settings) override;
+    void Process(GazeSample &sample) override;
+    void Reset() override;
+
+    EyeMovementState GetState() const { return state; }
+
+private:
+    static const int WINDOW_SIZE = 64;
+
+    void ClassifyByVelocity(const GazeSample &sample);
+    void ClassifyByDispersion(const GazeSample &sample);
+
+    GazeFilterType method;
+    float saccadeVelocityThreshold;
+    float pursuitVelocityThreshold;
+    float dispersionThreshold;
+    uint64_t dispersionWindowUs;
+
+    GazeSample window[WINDOW_SIZE];
+    int windowCount;
+    int windowHead;
+
+    EyeMovementState state;
+};
+
+// Ordered chain of gaze filters. All stages are preallocated, configuring the
+// order only rewires pointers, so processing never allocates. The dead zone is
+// held out of the sample path: the predictor fits the smoothed samples, and the
+// dead zone holds the predicted position instead.
+class GazeFilterChain {
+public:
+    static const int MAX_STAGES = 8;
+
+    GazeFilterChain();
+    ~GazeFilterChain();
+
+    // Select stage order, unknown types are skipped and stages may not repeat
+    void SetStages(const GazeFilterType *types, int count);
+
+    // Apply tunables to every stage
+    void Configure(const GazeFilterSettings &settings);
+
+    // Run the sample through the smoothing and classifying stages
+    void Process(GazeSample &sample);
+
+    // Hold the predicted position in the dead zone, if the chain has one
+    void Hold(Vector2 &position, uint64_t timestamp);
+
+    // Reset state of every stage
+    void Reset();
+
+    // Movement state of the last classifier in the chain, FIXATION if there is none
+    EyeMovementState GetState() const;
+
+    static GazeFilterSettings GetDefaultSettings();
+
+private:
+    GazeFilter *GetFilter(GazeFilterType type);
+
+    DeadZoneFilter deadZone;
+    OneEuroFilter oneEuro;
+    KalmanFilter kalman;
+    FixationClassifier velocityClassifier;
+    FixationClassifier dispersionClassifier;
+
+    GazeFilter *stages[MAX_STAGES];
+    int stageCount;
+    bool holdsDeadZone;
+    FixationClassifier *classifier;
+};
@@ -1,39 +1,139 @@
 #pragma once
 
 #include "Enums.h"
+#include "GazeFilters.h"
+#include "GazePredictor.h"
+#include "GazeSampleRing.h"
+#include "LatencyStats.h"
+#include "TraceWriter.h"
 #include "Vector.h"
-#include <d3d11.h>
-#include <nvapi.h>
+#include "VrsBackend.h"
+#include <atomic>
+#include <mutex>
 
-// Manages gaze data updates and interactions with NVidia VRS Gaze Handler
+// Tangents of the half-angles of a possibly asymmetric view frustum,
+// left and down are negative for a frustum containing the view axis
+struct ViewFrustum {
+    float tanLeft;
+    float tanRight;
+    float tanUp;
+    float tanDown;
+};
+
+// Manages gaze data updates and hands the latched gaze to the VRS backend.
+// Gaze is produced on the scripting thread and handed to the render thread
+// through lock-free GazeSampleRings, so neither side ever blocks.
+// Every eye owns its own ring, filter chain and predictor; mono rendering
+// uses the left eye channel only.
 class GazeManager {
 public:
+    static const int EYE_COUNT = 2;
+
     GazeManager();
     ~GazeManager();
 
-    // Initialize the gaze handler with specified FOVs
-    bool Initialize(ID3D11Device *device, float tanHalfHorizontalFov, float tanHalfVerticalFov);
+    // Reset the view frusta to the specified FOVs, stereo selects per-eye gaze data
+    void Initialize(float tanHalfHorizontalFov, float tanHalfVerticalFov, bool stereo);
+
+    // Switch between mono and per-eye gaze data, applied on the next refresh
+    void SetStereo(bool stereo) { stereoRequested.store(stereo, std::memory_order_release); }
+
+    // Configure the frustum of one eye, used to map gaze directions into that view (producer thread)
+    void ConfigureViewFrustum(Eye eye, const ViewFrustum &frustum);
+
+    // Configure latency compensation, applied on the next refresh
+    void ConfigurePrediction(const GazePredictionSettings &settings);
+
+    // Configure the filter chain, applied on the next refresh
+    void ConfigureFilters(const GazeFilterType *types, int count, const GazeFilterSettings &settings);
+
+    // Update combined gaze direction in view space, projected into every view (producer thread)
+    void UpdateGazeDirection(const Vector3 &gazeDirNormalized);
+
+    // Update the gaze direction of each eye in its view space (producer thread)
+    void UpdateStereoGazeDirection(const Vector3 &leftGazeDir, const Vector3 &rightGazeDir);
+
+    // Update gaze from tracker screen coordinates ([-1, 1], x mirrored) captured and received at the given times (producer thread)
+    void UpdateGazeScreenPosition(const Vector2 &screenPos, uint64_t captureTime, uint64_t receiveTime);
+
+    // Record every published sample into a session trace, null detaches
+    void AttachTraceWriter(TraceWriter *writer) { traceWriter = writer; }
+
+    // Latch new gaze samples, filter them and predict gaze at photon time for the backend (render thread).
+    // Returns false if no sample arrived since the last refresh, the prediction is still advanced.
+    bool RefreshGazeData(VrsGazeFrame &gazeFrame);
 
-    // Update normalized gaze direction
-    void UpdateGazeDirection(const Vector3 &gazeDirNormalized, float tanHalfHorizontalFov, float tanHalfVerticalFov, float stabilityThreshold);
+    // Account the latched sample against the frame being presented (render thread)
+    void RecordFramePresent();
 
-    // Refresh gaze data in the NVidia VRS system
-    bool RefreshGazeData(ID3D11DeviceContext *deviceContext);
+    // Snapshot of the motion-to-photon latency accounting, safe from any thread
+    GazeLatencyStats GetLatencyStats() const { return latencyStats.Summarize(); }
 
-    // Commit gaze data to the VRS Helper
-    void CommitGazeData(ID3DNvVRSHelper *vrsHelper, ID3D11DeviceContext *deviceContext);
+    // Clear the latency accounting, safe from any thread
+    void ResetLatencyStats() { latencyStats.Reset(); }
 
-    // Release gaze handler resources
-    void Release();
+    // Newest published normalized gaze location of an eye, safe from any thread
+    Vector2 GetGazePosition(Eye eye = Eye::LEFT) const;
+
+    // Eye movement state reported by the filter chain classifier, safe from any thread
+    EyeMovementState GetEyeMovementState() const { return static_cast<EyeMovementState>(eyeMovementState.load(std::memory_order_relaxed)); }
+
+    // Gaze sent to the driver by the last refresh (render thread)
+    const Vector2 &GetRenderedGazePosition(Eye eye = Eye::LEFT) const { return channels[static_cast<int>(eye)].gazePos; }
+
+    // Sample latched by the last refresh (render thread)
+    const GazeSample &GetLatchedSample() const { return channels[0].latchedSample; }
 
 private:
-    // Calculate normalized gaze location based on direction and offset
-    Vector2 CalculateNormalizedGaze(const Vector3 &gazeDirNormalized, float tanHalfHorizontalFov, float tanHalfVerticalFov);
+    // Gaze path of one eye
+    struct GazeChannel {
+        GazeSampleRing samples;
+        GazeFilterChain filterChain;
+        GazePredictor predictor;
+        uint64_t sampleCursor;
+        GazeSample latchedSample;
+        Vector2 gazePos;
+    };
+
+    // Calculate normalized gaze location of a direction inside a view frustum
+    static Vector2 CalculateNormalizedGaze(const Vector3 &gazeDirNormalized, const ViewFrustum &frustum);
+
+    // Publish a sample of one eye and, if record is set, write it into the session trace (producer thread).
+    // A single gaze published to both eyes is recorded once, as the left eye.
+    void PushSample(int eye, const Vector2 &gaze, uint64_t captureTime, uint64_t receiveTime, bool record);
+
+    // Pick up filter configuration if the scripting thread changed it, never blocks
+    void ApplyPendingFilterConfiguration();
+
+    // Latch, filter and predict the gaze of one eye, false if no new sample arrived (render thread)
+    bool RefreshChannel(GazeChannel &channel, const GazePredictionSettings &settings, uint64_t photonTime, uint64_t latchNow);
+
+    std::atomic<bool> stereoRequested;
+    bool stereoActive;
+
+    // View frusta, written by the producer thread
+    ViewFrustum viewFrusta[EYE_COUNT];
+
+    // Filter configuration, written by the scripting thread
+    std::mutex filterConfigMutex;
+    std::atomic<bool> filterConfigDirty;
+    GazeFilterType pendingFilterStages[GazeFilterChain::MAX_STAGES];
+    int pendingFilterStageCount;
+    GazeFilterSettings pendingFilterSettings;
+    std::atomic<int> eyeMovementState;
+
+    // Prediction settings, written by the scripting thread
+    std::atomic<bool> predictionEnabled;
+    std::atomic<float> predictionLatencyMs;
+    std::atomic<float> saccadeVelocityThreshold;
+    std::atomic<float> fixationVelocityThreshold;
+    std::atomic<float> maxPredictionDistance;
 
-    // Check if gaze has changed beyond the threshold
-    bool HasGazeChanged(Vector2 *current, const Vector2 &newGaze, float threshold);
+    // Render thread state
+    GazeChannel channels[EYE_COUNT];
+    uint64_t latchTime;
+    uint64_t lastGazeDataTimestamp;
 
-    ID3DNvGazeHandler *gazeHandler;
-    Vector2 gazePos;
-    float gazeStabilityThreshold;
+    LatencyStats latencyStats;
+    TraceWriter *traceWriter;
 };
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// Fixed-size binary gaze packet sent by trackers over UDP, little-endian.
+// Coordinates use the tracker convention: [-1, 1] screen space, x mirrored, +y up.
+struct GazePacket {
+    uint32_t magic;               // GAZE_PACKET_MAGIC
+    uint32_t sequence;            // Incremented by the sender for every packet
+    uint64_t captureTimestampUs;  // Sender clock at frame capture
+    float x;
+    float y;
+    uint8_t valid;                // Non-zero if the tracker sees the eyes
+    uint8_t reserved[3];
+    float confidence;             // [0, 1]
+};
+
+static const uint32_t GAZE_PACKET_MAGIC = 0x315A4746;  // "FGZ1"
+static_assert(sizeof(GazePacket) == 32, "GazePacket layout must match the senders");
+
+// Decode a datagram without allocating, returns false for foreign or truncated packets
+inline bool DecodeGazePacket(const void *data, size_t size, GazePacket &packet) {
+    if (size != sizeof(GazePacket)) {
+        return false;
+    }
+    memcpy(&packet, data, sizeof(GazePacket));
+    return packet.magic == GAZE_PACKET_MAGIC;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Enums.h"
+#include "GazeSampleRing.h"
+#include "Vector.h"
+#include <cstdint>
+
+// Settings of the gaze prediction stage
+struct GazePredictionSettings {
+    bool enabled;
+    float latencyMs;                  // Expected time from latch to photons
+    float saccadeVelocityThreshold;   // Normalized gaze units per second
+    float fixationVelocityThreshold;  // Below this speed gaze is not extrapolated
+    float maxPredictionDistance;      // Upper bound of the extrapolated offset
+};
+
+// Extrapolates gaze to the expected photon time from the recent sample history.
+// Smooth pursuit uses a quadratic (velocity and acceleration) fit, saccades
+// predict their landing point assuming a symmetric velocity profile: once the
+// peak velocity is passed the remaining travel mirrors the travel so far.
+class GazePredictor {
+public:
+    GazePredictor();
+    ~GazePredictor();
+
+    // Replace the settings, history is kept
+    void Configure(const GazePredictionSettings &newSettings);
+
+    // Append a sample, samples must arrive in capture time order
+    void AddSample(const GazeSample &sample);
+
+    // Predicted gaze at targetTime (microseconds), falls back to newest sample if disabled
+    Vector2 Predict(uint64_t targetTime) const;
+
+    // Forget history, e.g. after tracking was lost
+    void Reset();
+
+    EyeMovementState GetState() const { return state; }
+    const GazePredictionSettings &GetSettings() const { return settings; }
+
+private:
+    static const int HISTORY_SIZE = 16;
+    static const uint64_t FIT_WINDOW_US = 60000;
+
+    // Least squares fit of position, velocity and acceleration at the newest sample
+    bool FitMotion(Vector2 &velocity, Vector2 &acceleration) const;
+
+    // Update fixation/pursuit/saccade state from the latest velocity
+    void UpdateState(float speed);
+
+    const GazeSample &GetSample(int age) const;
+
+    GazePredictionSettings settings;
+
+    GazeSample history[HISTORY_SIZE];
+    int historyCount;
+    int historyHead;
+
+    EyeMovementState state;
+    Vector2 velocity;
+    Vector2 acceleration;
+
+    // Saccade tracking
+    Vector2 saccadeOnset;
+    Vector2 saccadePeakPosition;
+    float saccadePeakSpeed;
+    bool saccadeDecelerating;
+};
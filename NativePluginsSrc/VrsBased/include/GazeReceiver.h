@@ -0,0 +1,66 @@
+#pragma once
+
+#include "GazePacket.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+class GazeManager;
+
+// Counters of the gaze receiver, readable from any thread
+struct GazeReceiverStats {
+    uint64_t packetsReceived;
+    uint64_t packetsRejected;     // Foreign, truncated, invalid or out-of-order
+    uint64_t batches;             // Wake-ups of the receive thread that returned data
+    uint64_t foreignClockPackets; // Capture time not on the plugin clock, receive time used instead
+};
+
+// Native UDP endpoint for binary gaze packets. A background thread receives
+// datagrams in batches (recvmmsg where available), decodes them in place and
+// pushes valid samples straight into the GazeManager, bypassing managed code.
+// While running it is the only gaze producer of the GazeManager.
+class GazeReceiver {
+public:
+    static const int BATCH_SIZE = 32;
+    static const int32_t SEQUENCE_RESTART_GAP = 1024;
+    static const uint64_t MAX_CAPTURE_AGE_US = 1000000;
+
+    GazeReceiver();
+    ~GazeReceiver();
+
+    // Bind the UDP port and start the receive thread
+    bool Start(uint16_t port, GazeManager *target);
+
+    // Stop the receive thread and close the socket
+    void Stop();
+
+    bool IsRunning() const { return running.load(std::memory_order_acquire); }
+
+    GazeReceiverStats GetStats() const;
+
+private:
+    // Receive thread body
+    void Run();
+
+    // Wait up to timeoutMs and receive up to BATCH_SIZE datagrams, returns number of packets
+    int ReceiveBatch(int timeoutMs);
+
+    // Validate and forward one decoded packet
+    void Consume(const GazePacket &packet);
+
+    GazeManager *gazeManager;
+    std::thread thread;
+    std::atomic<bool> running;
+    intptr_t socketHandle;
+
+    // Receive thread state
+    unsigned char buffers[BATCH_SIZE][64];
+    size_t sizes[BATCH_SIZE];
+    uint32_t lastSequence;
+    bool hasSequence;
+
+    std::atomic<uint64_t> packetsReceived;
+    std::atomic<uint64_t> packetsRejected;
+    std::atomic<uint64_t> batches;
+    std::atomic<uint64_t> foreignClockPackets;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Vector.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Single gaze measurement in normalized NVAPI gaze space
+struct GazeSample {
+    Vector2 position;
+    uint64_t captureTime;  // Microseconds when the tracker captured the sample, see Clock.h
+    uint64_t receiveTime;  // Microseconds when the plugin received it
+    uint64_t sequence;     // Monotonic index assigned by the ring
+};
+
+// Lock-free single-producer ring of timestamped gaze samples.
+// Every slot is guarded by its own seqlock, so the producer never waits and
+// overwrites the oldest samples, while readers never block and detect torn
+// or overwritten slots. Readers do not modify the ring, any number may read.
+class GazeSampleRing {
+public:
+    static const size_t CAPACITY = 64;
+
+    GazeSampleRing();
+    ~GazeSampleRing();
+
+    // Publish a sample (producer thread only)
+    void Push(const Vector2 &position, uint64_t captureTime, uint64_t receiveTime);
+
+    // Read the newest complete sample, returns false if nothing was published yet
+    bool LatchNewest(GazeSample &sample) const;
+
+    // Read samples published after cursor (oldest first) and advance cursor,
+    // samples overwritten before they could be read are skipped
+    size_t ReadSince(uint64_t &cursor, GazeSample *samples, size_t maxCount) const;
+
+    // Number of samples published so far
+    uint64_t GetPublishedCount() const { return head.load(std::memory_order_acquire); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> version;  // 2n + 1 while sample n is written, 2n + 2 once complete
+        std::atomic<float> x;
+        std::atomic<float> y;
+        std::atomic<uint64_t> captureTime;
+        std::atomic<uint64_t> receiveTime;
+    };
+
+    // Try to read sample n, fails if the slot holds another sample or is being written
+    bool TryRead(uint64_t index, GazeSample &sample) const;
+
+    Slot slots[CAPACITY];
+    std::atomic<uint64_t> head;
+};
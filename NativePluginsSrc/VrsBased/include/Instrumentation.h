@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Enums.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Counters of one instrumented scope, times in nanoseconds
+struct ScopeStats {
+    uint64_t calls;
+    uint64_t failures;
+    uint64_t skipped;
+    uint64_t totalNs;
+    uint64_t maxNs;
+};
+
+// Snapshot of every scope, indexed by TraceScope
+struct InstrumentationStats {
+    ScopeStats scopes[static_cast<int>(TraceScope::COUNT)];
+    uint64_t traceEvents;          // Events recorded since tracing was started
+    uint64_t traceEventsDropped;   // Of those, overwritten before they could be written out
+    int32_t lastNativeError;       // Latest backend failure, see IVrsBackend::GetLastNativeError
+    int32_t tracing;               // Non-zero while trace events are recorded
+};
+
+// Hot-path counters with an optional event trace. Counters are relaxed
+// atomics and always on. While tracing, every scope is also written to a
+// ring owned by the recording thread; like GazeSampleRing each slot is a
+// seqlock, so recording never locks or waits and a dump can run meanwhile.
+class Instrumentation {
+public:
+    // Trace events kept per thread
+    static const size_t TRACE_CAPACITY = 4096;
+
+    Instrumentation();
+    ~Instrumentation();
+
+    // Account one finished scope (any thread)
+    void Record(TraceScope scope, VrsResult result, uint64_t beginNs, uint64_t endNs);
+
+    // Remember the native status of a failed backend call
+    void RecordNativeError(int32_t error);
+
+    // Start or stop recording trace events, starting drops the previous trace
+    void SetTracing(bool enabled);
+
+    // Take a snapshot of all counters
+    InstrumentationStats GetStats() const;
+
+    // Clear the scope counters, the trace is kept
+    void Reset();
+
+    // Write the trace as Chrome trace JSON (chrome://tracing, Perfetto), returns the number of events or -1
+    int WriteChromeTrace(const char *path) const;
+
+private:
+    struct ScopeCounters {
+        std::atomic<uint64_t> calls;
+        std::atomic<uint64_t> failures;
+        std::atomic<uint64_t> skipped;
+        std::atomic<uint64_t> totalNs;
+        std::atomic<uint64_t> maxNs;
+    };
+
+    struct TraceEvent {
+        TraceScope scope;
+        VrsResult result;
+        uint64_t beginNs;
+        uint64_t durationNs;
+    };
+
+    // Single-writer ring of one thread
+    struct TraceBuffer {
+        struct Slot {
+            std::atomic<uint64_t> version;  // 2n + 1 while event n is written, 2n + 2 once complete
+            std::atomic<uint32_t> scopeAndResult;
+            std::atomic<uint64_t> beginNs;
+            std::atomic<uint64_t> durationNs;
+        };
+
+        explicit TraceBuffer(uint32_t id);
+
+        void Push(const TraceEvent &event);
+        bool TryRead(uint64_t index, TraceEvent &event) const;
+
+        uint32_t threadId;
+        std::atomic<uint64_t> head;
+        std::atomic<uint64_t> traceStart;   // First index of the current trace
+        Slot slots[TRACE_CAPACITY];
+    };
+
+    // Ring of the calling thread, registered on first use
+    TraceBuffer *GetThreadBuffer();
+
+    ScopeCounters counters[static_cast<int>(TraceScope::COUNT)];
+    std::atomic<int32_t> lastNativeError;
+    std::atomic<bool> tracing;
+
+    // Distinguishes instances in the per-thread buffer cache
+    uint64_t instanceId;
+
+    mutable std::mutex buffersMutex;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+};
+
+// Times a scope and records it with its result when it ends
+class ScopedTrace {
+public:
+    ScopedTrace(Instrumentation *instrumentation, TraceScope scope);
+    ~ScopedTrace();
+
+    void SetResult(VrsResult scopeResult) { result = scopeResult; }
+
+private:
+    Instrumentation *instrumentation;
+    TraceScope scope;
+    VrsResult result;
+    uint64_t beginNs;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Enums.h"
+#include <atomic>
+#include <cstdint>
+
+// Snapshot of one latency stage, all times in microseconds.
+// Percentiles are resolved to the upper bound of their log2 bucket.
+struct LatencySummary {
+    uint64_t count;
+    uint64_t minUs;
+    uint64_t maxUs;
+    uint64_t meanUs;
+    uint64_t p50Us;
+    uint64_t p95Us;
+    uint64_t p99Us;
+    uint64_t buckets[32];  // Bucket i counts latencies in [2^i - 1, 2^(i+1) - 1)
+};
+
+// Snapshot of every stage, indexed by LatencyStage
+struct GazeLatencyStats {
+    LatencySummary stages[static_cast<int>(LatencyStage::COUNT)];
+};
+
+// Lock-free log2 histogram of latencies. Recording is wait-free and safe
+// from any thread, snapshots may be taken concurrently.
+class LatencyHistogram {
+public:
+    static const int BUCKETS = 32;
+
+    LatencyHistogram();
+    ~LatencyHistogram();
+
+    // Record one latency
+    void Record(uint64_t latencyUs);
+
+    // Clear all counters
+    void Reset();
+
+    // Take a snapshot with derived statistics
+    LatencySummary Summarize() const;
+
+private:
+    // Upper bound of the bucket holding the given quantile
+    static uint64_t Quantile(const LatencySummary &summary, double quantile);
+
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sumUs;
+    std::atomic<uint64_t> minUs;
+    std::atomic<uint64_t> maxUs;
+    std::atomic<uint64_t> buckets[BUCKETS];
+};
+
+// Per-stage latency accounting of the gaze path
+class LatencyStats {
+public:
+    // Record a stage, latencies from reversed clocks are dropped
+    void Record(LatencyStage stage, uint64_t startUs, uint64_t endUs);
+
+    // Clear every stage
+    void Reset();
+
+    // Take a snapshot of every stage
+    GazeLatencyStats Summarize() const;
+
+private:
+    LatencyHistogram stages[static_cast<int>(LatencyStage::COUNT)];
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Vector.h"
+#include "WorkerPool.h"
+#include <cstdint>
+#include <vector>
+
+// View and foveation an object batch is classified against
+struct LodClassifierParams {
+    float viewProjection[16];   // Column-major world to clip matrix, as Unity's Matrix4x4
+    Vector2 gazePos;            // Normalized screen coordinates [-1, 1], y up
+    Vector2 fovealRadii;        // LOD 0 ellipse in normalized screen coordinates
+    Vector2 midFovealRadii;     // LOD 1 ellipse
+    float hysteresis;           // Relative margin an object has to cross a boundary by to change level
+};
+
+// Object batch in structure-of-arrays layout, one entry per LODGroup
+struct LodObjectBatch {
+    const float *positionX;     // World-space bounding sphere centers
+    const float *positionY;
+    const float *positionZ;
+    const float *radius;        // World-space bounding sphere radii, 0 classifies by the center only
+    const int32_t *coarsestLod; // Last level each object may use
+    int32_t *lods;              // Current level of each object, -1 if none was assigned yet
+    int32_t count;
+    float *screenMinX;          // Optional projected bounds in normalized screen coordinates, null to skip.
+    float *screenMaxX;          // Objects behind the camera get an empty box (min > max)
+    float *screenMinY;
+    float *screenMaxY;
+};
+
+// Classifies LODGroups against the foveal and mid-foveal ellipses.
+// Objects are projected four at a time with SSE2 and split into chunks across
+// a worker pool. An object is in a region when its projected bounding sphere
+// touches the ellipse; to leave its current region it has to move out by the
+// hysteresis margin, and to enter a finer one it has to move in by it.
+class LodClassifier {
+public:
+    // Objects per worker job
+    static const int CHUNK_SIZE = 4096;
+
+    LodClassifier();
+    ~LodClassifier();
+
+    // Classify every object of the batch and update lods in place. The indices of the
+    // objects whose level changed are written to changed, up to changedCapacity; changes
+    // that do not fit are left out of lods so the next call reports them again.
+    // Returns the number of indices written. Not reentrant.
+    int Classify(const LodClassifierParams &params, const LodObjectBatch &batch, int32_t *changed, int changedCapacity);
+
+private:
+    // Level change found by a worker
+    struct LodChange {
+        int32_t index;
+        int32_t lod;
+    };
+
+    // Classify objects [begin, end) and append the changed ones
+    static void ClassifyRange(const LodClassifierParams &params, const LodObjectBatch &batch, int begin, int end, std::vector<LodChange> &changes);
+
+    WorkerPool pool;
+    std::vector<std::vector<LodChange>> chunkChanges;
+};
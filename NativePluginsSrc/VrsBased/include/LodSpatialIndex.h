@@ -0,0 +1,153 @@
+#pragma once
+
+#include "LodClassifier.h"
+#include <cstdint>
+#include <vector>
+
+// Work done by the last LodSpatialIndex update
+struct LodSpatialIndexStats {
+    int32_t objects;             // Objects in the index
+    int32_t candidates;          // Objects reclassified by the last update
+    int32_t cellsVisited;        // Grid cells in the boundary band of the last update
+    int32_t fullUpdate;          // Non-zero if the last update reclassified every object
+    uint64_t fullUpdates;        // Updates that reclassified every object
+    uint64_t incrementalUpdates; // Updates that only reclassified candidates
+};
+
+// Loose screen-space grid over the foveated LOD objects.
+// Objects are binned by the center of their projected bounds into the finest
+// grid level whose cells are at least as large as the bounds, so near objects
+// do not blow up the bounds of a fine cell. A full update reprojects every
+// object and sorts the object arrays by cell, so each cell is a contiguous
+// range the classifier runs on in place. While the view, ellipses and
+// hysteresis stay the same, an update only reclassifies objects that moved or
+// were inserted, and the cells that straddle a region boundary for the
+// previous or the new gaze; every other object keeps its level by construction.
+// Handles stay valid across updates and are reused after removal. Main thread only.
+class LodSpatialIndex {
+public:
+    // Cells per axis of the finest grid level over the normalized screen, halved per coarser level
+    static const int GRID_SIZE = 32;
+    static const int GRID_LEVELS = 6;
+    static const int CELL_COUNT = (GRID_SIZE * GRID_SIZE * 4 - 1) / 3;  // 32^2 + 16^2 + ... + 1
+
+    explicit LodSpatialIndex(LodClassifier *classifier);
+    ~LodSpatialIndex();
+
+    // Insert objects with world-space bounding spheres, their handles are written to handles
+    void Insert(const float *positionX, const float *positionY, const float *positionZ, const float *radius,
+        const int32_t *coarsestLod, int count, int32_t *handles);
+
+    // Move objects, they are reclassified by the next update
+    void Update(const int32_t *handles, const float *positionX, const float *positionY, const float *positionZ,
+        const float *radius, int count);
+
+    // Remove objects, their handles may be handed out again
+    void Remove(const int32_t *handles, int count);
+
+    // Remove every object
+    void Clear();
+
+    // Reclassify the objects that may have changed level and write the handles and new
+    // levels of the changed ones, up to capacity. Returns the number written.
+    int Classify(const LodClassifierParams &params, int32_t *changedHandles, int32_t *changedLods, int capacity);
+
+    // Work done by the last update
+    LodSpatialIndexStats GetStats() const { return stats; }
+
+private:
+    // Where a cell's objects lie relative to one ellipse
+    enum class CellRegion {
+        INSIDE,     // Inside even when entering the region
+        OUTSIDE,    // Outside even when staying in the region
+        BOUNDARY    // Depends on the object's level
+    };
+
+    // Objects of a cell and the bounds of their projections
+    struct Cell {
+        int32_t begin;                  // Slots sorted into the cell by the last full update
+        int32_t end;
+        std::vector<int32_t> extra;     // Slots binned since, moved or inserted objects
+        float minX, maxX, minY, maxY;
+    };
+
+    // Object arrays indexed by slot
+    struct Objects {
+        std::vector<float> positionX, positionY, positionZ, radius;
+        std::vector<int32_t> coarsestLod, lods;     // Removed slots have a coarsest level of -1
+        std::vector<float> screenMinX, screenMaxX, screenMinY, screenMaxY;
+        std::vector<int32_t> handle;
+
+        // Append a slot, returns its index
+        int32_t Append();
+
+        // Resize every array
+        void Resize(size_t size);
+
+        // Copy slot from of other into slot to
+        void CopySlot(int32_t to, const Objects &other, int32_t from);
+    };
+
+    // Reproject every object and sort the slots by cell
+    int ClassifyAll(const LodClassifierParams &params, int32_t *changedHandles, int32_t *changedLods, int capacity);
+
+    // Reclassify moved objects and the cells in the boundary band
+    int ClassifyCandidates(const LodClassifierParams &params, int32_t *changedHandles, int32_t *changedLods, int capacity);
+
+    // Classify the given slots through the gather arrays, bounds are written back if updateBounds is set
+    int ClassifySlots(const LodClassifierParams &params, const std::vector<int32_t> &slots, bool updateBounds,
+        int32_t *changedHandles, int32_t *changedLods, int capacity);
+
+    // Classify a batch and write the handles of the changed objects, slots maps batch indices
+    // to slots, otherwise they start at firstSlot. Sets truncated if changes did not fit.
+    int ClassifyBatch(const LodClassifierParams &params, const LodObjectBatch &batch, const int32_t *slots, int32_t firstSlot,
+        int32_t *changedHandles, int32_t *changedLods, int capacity);
+
+    // Whether the cell's objects may change level when the gaze moves from the previous to the new one
+    bool IsBoundaryCell(const Cell &cell, const LodClassifierParams &params) const;
+
+    // Classify a cell's bounds against an ellipse scaled by the enter and stay limits
+    CellRegion ClassifyCell(const Cell &cell, const Vector2 &gazePos, const Vector2 &radii, float hysteresis) const;
+
+    // Cell of a slot's projected bounds, -1 behind the camera
+    int FindCell(int32_t slot) const;
+
+    // Add a slot to the extra objects of the cell of its bounds
+    void BinExtra(int32_t slot);
+
+    // Take a slot out of the extra objects of its cell
+    void UnbinExtra(int32_t slot);
+
+    // Mark an object for the next update
+    void MarkDirty(int32_t handle);
+
+    // Whether the view or foveation differ from the last update in anything but the gaze
+    bool RequiresFullUpdate(const LodClassifierParams &params) const;
+
+    LodClassifier *classifier;
+
+    Objects objects;
+    Objects sorted;                     // Scratch for the sort of a full update
+    std::vector<int32_t> extraCell;     // Cell whose extra objects hold the slot, -1 if none
+    std::vector<int32_t> extraIndex;    // Position in that list
+
+    std::vector<int32_t> handleSlot;    // Slot of each handle, -1 if free
+    std::vector<uint8_t> dirty;         // Moved or inserted since the last update, by handle
+    std::vector<int32_t> freeHandles;
+    std::vector<int32_t> dirtyHandles;
+    int32_t objectCount;
+
+    Cell cells[CELL_COUNT];
+    std::vector<int32_t> cellOffsets;
+
+    // Objects gathered for the classifier
+    std::vector<int32_t> candidates;
+    Objects gathered;
+    std::vector<int32_t> changedSlots;
+
+    LodClassifierParams lastParams;
+    bool hasLastParams;
+    bool fullUpdatePending;
+    bool truncated;
+    LodSpatialIndexStats stats;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "VrsBackend.h"
+
+#if VRS_BACKEND_D3D
+
+#include "NvApiWrapper.h"
+#include <d3d11.h>
+#include <nvapi.h>
+
+// NVIDIA VRS helper and gaze handler on Direct3D 11. The driver owns the rate
+// surfaces and implements the presets, so presets are passed through untouched.
+// Rates stay set on the immediate context until Disable, so an enable that
+// brings neither new parameters nor a newly latched gaze is skipped, as long
+// as no other backend on the device applied rates in between.
+class NvApiVrsBackend : public IVrsBackend {
+public:
+    // Create the backend if NVAPI is available for the device, null otherwise
+    static NvApiVrsBackend *Create(ID3D11Device *device);
+
+    ~NvApiVrsBackend();
+
+    VrsBackendType GetType() const override { return VrsBackendType::NVAPI_D3D11; }
+    bool Initialize(float tanHalfHorizontalFov, float tanHalfVerticalFov, bool stereo) override;
+    void ConfigureRenderTarget(int /*width*/, int /*height*/) override {}
+    bool UpdateGaze(const VrsGazeFrame &gaze) override;
+    VrsResult Enable(RenderMode mode, const VrsFoveationState &foveation) override;
+    VrsResult Disable() override;
+    int32_t GetLastNativeError() const override { return lastStatus; }
+    void Release() override;
+    void InvalidateAppliedState() override { appliedStateValid = false; }
+
+private:
+    // Constructor, use Create
+    explicit NvApiVrsBackend(ID3D11Device *device);
+
+    // Create the NVidia gaze handler for mono or per-eye gaze data
+    bool CreateGazeHandler(bool stereo);
+
+    // Internal helper methods
+    static NV_VRS_RENDER_MODE ToNvRenderMode(RenderMode mode);
+    static void UpdateShadingRatePresetParams(const VrsFoveationState &foveation, NV_VRS_HELPER_ENABLE_PARAMS &enableParams);
+    static void UpdateFoveationPatternPresetParams(const VrsFoveationState &foveation, NV_VRS_HELPER_ENABLE_PARAMS &enableParams);
+
+    ID3D11Device *device;
+    ID3D11DeviceContext *immediateContext;   // Held from Initialize to Release
+    NvApiWrapper nvApiWrapper;
+    bool nvApiInitialized;                   // Unload only balances a successful initialization
+    ID3DNvVRSHelper *vrsHelper;
+    ID3DNvGazeHandler *gazeHandler;
+
+    float handlerTanHalfHorizontalFov;
+    float handlerTanHalfVerticalFov;
+    bool stereoActive;
+
+    // Parameters of the last enable, rebuilt when the foveation version or mode changes
+    NV_VRS_HELPER_ENABLE_PARAMS enableParams;
+    uint64_t enableParamsVersion;
+    RenderMode enableParamsMode;
+    bool enableParamsValid;
+
+    // Rates are set on the context, and whether gaze was latched since they were
+    bool enabled;
+    bool gazeLatched;
+
+    // Enabled describes the device, false until this backend applied once or after another backend did
+    bool appliedStateValid;
+
+    // Latest NvAPI_Status other than NVAPI_OK
+    int32_t lastStatus;
+};
+
+#endif
@@ -6,10 +6,10 @@
 // Wrapper class for NVidia API initialization and device registration
 class NvApiWrapper {
 public:
-    // Initializes NVidia API and registers the Direct3D 11 device
+    // Initializes NVidia API and registers the Direct3D 11 device, nothing stays loaded on failure
     bool Initialize(ID3D11Device *device);
 
-    // Unloads NVidia API
+    // Unloads NVidia API, only after a successful Initialize
     void Unload();
 
 private:
@@ -1,17 +1,28 @@
 #pragma once
 
 #include "Enums.h"
+#include "FoveationContext.h"
+#include "FoveationGovernor.h"
+#include "GazeReceiver.h"
 #include "GazeManager.h"
-#include "NvApiWrapper.h"
+#include "Instrumentation.h"
+#include "LodClassifier.h"
+#include "LodSpatialIndex.h"
 #include "RenderEventHandler.h"
+#include "ShadingCostModel.h"
+#include "ShadingRateImage.h"
+#include "SharedGazeReader.h"
+#include "TraceWriter.h"
 #include "Vector.h"
+#include "VrsBackend.h"
 #include "VrsManager.h"
 #include <IUnityGraphics.h>
-#include <IUnityGraphicsD3D11.h>
 #include <IUnityInterface.h>
-#include <d3d11.h>
+#include <vector>
 
-// Manages Unity plugin lifecycle and interactions
+// Manages Unity plugin lifecycle and interactions. Every camera or view is
+// foveated through its own context; calls without a context argument act on
+// the default context, which serves the single-view API.
 class PluginInterface {
 public:
     PluginInterface();
@@ -23,21 +34,121 @@ public:
     // Unload and clean up plugin components
     void Unload();
 
-    // Handle Unity render events
+    // Handle Unity render events on the default context
     void HandleRenderEvent(int eventID);
 
-    // Initialize foveated rendering
-    bool InitializeFoveatedRendering(float verticalFov, float aspectRatio);
+    // Handle Unity render events issued with data, COMMAND_PACKET carries a RenderCommandPacket,
+    // other events carry the FoveationContextId they address
+    void HandleRenderEventAndData(int eventID, void *data);
 
-    // Release foveated rendering resources
-    void ReleaseFoveatedRendering();
+    // Create a context for another camera or view, INVALID_FOVEATION_CONTEXT if none is left
+    FoveationContextId CreateFoveationContext();
+
+    // Destroy a context, its resources are released on the render thread; the default context cannot be destroyed
+    bool DestroyFoveationContext(FoveationContextId context);
+
+    // Enabled contexts foveate on enable events, disabled ones shade at full rate
+    void SetFoveationContextEnabled(FoveationContextId context, bool enabled);
+    bool IsFoveationContextEnabled(FoveationContextId context) const;
+
+    // Initialize foveated rendering of a context for its view's FOV
+    bool InitializeFoveatedRendering(FoveationContextId context, float verticalFov, float aspectRatio);
+
+    // Release foveated rendering resources of a context
+    void ReleaseFoveatedRendering(FoveationContextId context);
+
+    // Graphics API the foveation is applied with
+    VrsBackendType GetVrsBackendType() const;
+
+    // Render target size for backends that build their own shading-rate image
+    void ConfigureVrsRenderTarget(FoveationContextId context, int width, int height);
+
+    // Native shading-rate image of image-based backends for engine-side binding, null otherwise
+    void *GetNativeShadingRateImage(FoveationContextId context) const;
+
+    // Content-adaptive rates from the previous frame's color, image-based backends only.
+    // Settings apply to every context, frames and stats to the default context.
+    void ConfigureContentShading(const ContentShadingSettings &settings);
+    bool SubmitContentFrame(const VrsContentFrame &frame);
+    ContentShadingStats GetContentShadingStats() const;
 
     // Configuration APIs
+    void SubmitVrsConfiguration(FoveationContextId context, const VrsConfiguration &config);
+    VrsConfiguration GetVrsConfiguration(FoveationContextId context) const;
+
+    // Submit entry index of a preset file as a CUSTOM configuration, config receives it as submitted
+    bool LoadFoveationPreset(const char *path, int index, VrsConfiguration &config);
     void SetShadingRatePreset(ShadingRatePreset preset);
     void SetFoveationPatternPreset(ShadingPatternPreset preset);
     void ConfigureRegionRadii(TargetArea targetArea, float xRadius, float yRadius);
     void ConfigureShadingRate(TargetArea targetArea, ShadingRate rate);
-    void UpdateGazeDirection(const Vector3 &gazeDir);
+    void UpdateGazeDirection(FoveationContextId context, const Vector3 &gazeDir);
+
+    // Stereo and multi-view, per-eye gaze and asymmetric frusta
+    void UpdateStereoGazeDirection(FoveationContextId context, const Vector3 &leftGazeDir, const Vector3 &rightGazeDir);
+    void SetRenderMode(FoveationContextId context, RenderMode mode);
+    void ConfigureViewFrustum(FoveationContextId context, Eye eye, const ViewFrustum &frustum);
+    Vector2 GetGazePosition(FoveationContextId context, Eye eye) const;
+
+    // Gaze filtering and prediction describe the tracker, every context shares them
+    void ConfigureGazePrediction(const GazePredictionSettings &settings);
+    void ConfigureGazeFilters(const GazeFilterType *types, int count, const GazeFilterSettings &settings);
+    EyeMovementState GetEyeMovementState() const;
+
+    // Native gaze receiver of the default context, replaces its UpdateGazeDirection while running
+    bool StartGazeReceiver(uint16_t port);
+    void StopGazeReceiver();
+    GazeReceiverStats GetGazeReceiverStats() const;
+
+    // Native reader of the tracker tools' shared-memory ring, excludes the gaze receiver and vice versa
+    bool StartSharedGazeReader(const char *name);
+    void StopSharedGazeReader();
+    SharedGazeReaderStats GetSharedGazeReaderStats() const;
+
+    // Motion-to-photon latency accounting, frames are closed by the PRESENT_FRAME event
+    GazeLatencyStats GetGazeLatencyStats() const;
+    void ResetGazeLatencyStats();
+
+    // Build the CPU shading-rate image for a render target, returns number of tiles written to buffer
+    int UpdateShadingRateImage(int width, int height, int tileSize, unsigned char *buffer, int bufferSize);
+
+    // Frame-time governor, adjusts foveation within the configured bounds
+    void ConfigureFoveationGovernor(const FoveationGovernorSettings &settings);
+    void SubmitFrameTime(float frameTimeMs);
+    FoveationGovernorState GetFoveationGovernorState() const;
+
+    // Estimate the shading work of the current foveation for a render target and gaze
+    ShadingCostEstimate QueryShadingCost(int width, int height, int tileSize, const Vector2 &gazePos) const;
+
+    // Per-frame shading cost log, frames are recorded by the PRESENT_FRAME event
+    void ConfigureShadingCostTelemetry(int width, int height, int tileSize);
+    ShadingCostTelemetryStats GetShadingCostTelemetry() const;
+    void ResetShadingCostTelemetry();
+
+    // Hot-path counters and Chrome trace of the render-thread work
+    InstrumentationStats GetInstrumentationStats() const;
+    void ResetInstrumentationStats();
+    void SetInstrumentationTracing(bool enabled);
+    int WriteInstrumentationTrace(const char *path) const;
+
+    // Foveated LOD levels of an object batch, returns the number of changed objects written (main thread)
+    int ClassifyFoveatedLods(const LodClassifierParams &params, const LodObjectBatch &batch, int32_t *changed, int changedCapacity);
+
+    // Persistent foveated LOD objects, only objects that may change level are reclassified (main thread)
+    void InsertLodObjects(const float *positionX, const float *positionY, const float *positionZ, const float *radius,
+        const int32_t *coarsestLod, int count, int32_t *handles);
+    void UpdateLodObjects(const int32_t *handles, const float *positionX, const float *positionY, const float *positionZ,
+        const float *radius, int count);
+    void RemoveLodObjects(const int32_t *handles, int count);
+    void ClearLodObjects();
+    int ClassifyLodObjects(const LodClassifierParams &params, int32_t *changedHandles, int32_t *changedLods, int capacity);
+    LodSpatialIndexStats GetLodSpatialIndexStats() const;
+
+    // Session trace of gaze, camera, frame times and configuration changes for offline replay
+    bool StartTraceRecording(const char *path);
+    void StopTraceRecording();
+    void RecordTraceFrame(const Vector3 &cameraPosition, const Quaternion &cameraRotation, float frameTimeMs);
+    TraceWriterStats GetTraceRecordingStats() const;
 
 private:
     // Callback for graphics device events
@@ -46,20 +157,51 @@ private:
     // Internal method to handle graphics device events
     void HandleGraphicsDeviceEventInternal(UnityGfxDeviceEventType eventType);
 
+    // Create a backend of a context for Unity's renderer, none if the renderer has no VRS support
+    void CreateBackend(FoveationContext &context);
+
+    // Destroy the backend of a context together with the device it was created for
+    void DestroyBackend(FoveationContext &context);
+
+    // Release the rate state of a context, it stays usable after another initialization
+    void ReleaseContext(FoveationContext &context);
+
+    // Hand the shared gaze filtering and prediction to a context
+    void ApplyGazeSettings(FoveationContext &context);
+
+    // A native gaze producer owns the default context's gaze ring
+    bool IsNativeGazeRunning() const;
+
+    // Record the pending configuration into the session trace after a change
+    void RecordTraceConfiguration();
+
     // Unity Graphics Interface
     IUnityInterfaces *unityInterfaces;
     IUnityGraphics *unityGraphics;
-    ID3D11Device *device;
 
-    // Managers
-    VrsManager vrsManager;
-    GazeManager gazeManager;
-    RenderEventHandler *renderEventHandler;
+    // Content-adaptive settings, handed to every backend created for a new device or context
+    ContentShadingSettings contentShadingSettings;
+
+    // Gaze settings shared by all contexts, handed to every new context once configured
+    bool gazePredictionConfigured;
+    GazePredictionSettings gazePredictionSettings;
+    bool gazeFiltersConfigured;
+    std::vector<GazeFilterType> gazeFilterTypes;
+    GazeFilterSettings gazeFilterSettings;
 
-    // NVidia API Wrapper
-    NvApiWrapper nvApiWrapper;
+    // Foveation contexts, the default one exists for the lifetime of the plugin
+    FoveationContextPool contexts;
+    FoveationContext *defaultContext;
 
-    // FOV related
-    float tanHalfHorizontalFov;
-    float tanHalfVerticalFov;
+    // Managers
+    FoveationGovernor foveationGovernor;
+    GazeReceiver gazeReceiver;
+    SharedGazeReader sharedGazeReader;
+    RenderEventHandler renderEventHandler;
+    ShadingRateImage shadingRateImage;
+    ShadingCostTelemetry shadingCostTelemetry;
+    Instrumentation instrumentation;
+    LodClassifier lodClassifier;
+    LodSpatialIndex lodSpatialIndex;
+    TraceWriter traceWriter;
 };
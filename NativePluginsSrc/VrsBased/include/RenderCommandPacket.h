@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Enums.h"
+#include <cstdint>
+
+// Version expected in RenderCommandPacket::version
+static const uint32_t RENDER_COMMAND_PACKET_VERSION = 1;
+
+// Operations per packet
+static const int MAX_RENDER_COMMANDS = 8;
+
+// One operation of a packet
+struct RenderCommand {
+    int32_t op;     // RenderCommandOp
+    int32_t mode;   // RenderMode of ENABLE, -1 for the configured render mode; FoveationContextId of SELECT_CONTEXT
+};
+
+// Operations run in order by a single COMMAND_PACKET event, so several
+// operations cost one round-trip through the render thread. The packet is
+// read when the render thread reaches the event, the issuer keeps it alive
+// and unchanged until then. Operations start on the default foveation
+// context, SELECT_CONTEXT switches the following ones to another context.
+struct RenderCommandPacket {
+    uint32_t version;
+    int32_t count;
+    RenderCommand commands[MAX_RENDER_COMMANDS];
+};
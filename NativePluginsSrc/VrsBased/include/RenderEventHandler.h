@@ -1,20 +1,62 @@
 #pragma once
 
 #include "Enums.h"
-#include "GazeManager.h"
-#include "VrsManager.h"
-#include <d3d11.h>
+#include "FoveationContext.h"
+#include "FoveationGovernor.h"
+#include "Instrumentation.h"
+#include "RenderCommandPacket.h"
+#include "ShadingCostModel.h"
+#include "VrsBackend.h"
 
-// Handles render events from Unity and interacts with VrsManager and GazeManager
+// Handles render events from Unity on the foveation context they address.
+// Events of contexts that are unknown or not initialized are skipped.
 class RenderEventHandler {
 public:
-    RenderEventHandler(VrsManager *vrsMgr, GazeManager *gazeMgr);
+    RenderEventHandler(FoveationContextPool *contextPool, FoveationGovernor *governor, ShadingCostTelemetry *costTelemetry,
+                       Instrumentation *instrumentation);
     ~RenderEventHandler();
 
     // Handle specific render event based on EventID
-    void HandleEvent(EventID eventID, ID3D11DeviceContext *deviceContext, ID3DNvVRSHelper *vrsHelper);
+    void HandleEvent(EventID eventID, FoveationContextId contextId);
+
+    // Run the operations of a packet in order, starting on a context, false if the packet is malformed
+    bool HandlePacket(const RenderCommandPacket &packet, FoveationContextId contextId);
 
 private:
-    VrsManager *vrsManager;
-    GazeManager *gazeManager;
+    // Context of a handle if foveated rendering was initialized for it
+    FoveationContext *GetActiveContext(FoveationContextId contextId) const;
+
+    // Refresh the gaze and hand it to the backend
+    void LatchGaze(FoveationContext &context);
+
+    // Enable the views in mode, disabled contexts return to full-rate shading
+    void Enable(RenderMode mode, FoveationContext &context);
+
+    // Return to full-rate shading
+    void Disable(FoveationContext &context);
+
+    // Make the context's backend the one that last set device rates, invalidating its cache if another one did
+    void ClaimDevice(FoveationContext &context);
+
+    // Record the native status of a failed backend call
+    void RecordFailure(VrsResult result, IVrsBackend *backend);
+
+    // Close the frame for the latency accounting of every context and the shading cost of the default one
+    void PresentFrame();
+
+    // Pick up the foveation chosen by the governor before VRS is re-enabled. The governor regulates the
+    // main view, only the default context follows it; other contexts keep their own configuration.
+    void ApplyGovernedFoveation(FoveationContext &context);
+
+    FoveationContextPool *contexts;
+    FoveationGovernor *foveationGovernor;
+    ShadingCostTelemetry *shadingCostTelemetry;
+    Instrumentation *instrumentation;
+
+    // Backend that last enabled or disabled rates, only compared, never dereferenced
+    const IVrsBackend *deviceOwner;
+
+    // Latest governor decision, the governor hands each decision out once
+    bool governedActive;
+    FoveationDesc governedDesc;
 };
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Enums.h"
+#include "Foveation.h"
+#include "Vector.h"
+#include <atomic>
+#include <cstdint>
+
+// Shading work of one frame for a render target, gaze and foveation
+struct ShadingCostEstimate {
+    uint64_t pixels;             // Render target pixels
+    float regionCoverage[3];     // Fraction of pixels in the inner, middle and peripheral region, snapped to tiles
+    float analyticCoverage[3];   // Same for the exact ellipses, before snapping to tiles
+    double invocations;          // Pixel shader invocations per frame
+    float relativeCost;          // Invocations per pixel, 1 for full-rate shading
+    float savedFraction;         // Work saved relative to 1x1 shading, negative when supersampling
+};
+
+// Pixel shader invocations per pixel of a shading rate, 1 for X1_PER_PIXEL
+float GetShadingRateCost(ShadingRate rate);
+
+// Estimate the shading work of a frame in O(tile rows).
+// Region areas are evaluated analytically as ellipses clipped to the screen,
+// then corrected to the tile grid the hardware applies rates on: a tile takes
+// the rate of the innermost ellipse containing its center, as in ShadingRateImage.
+ShadingCostEstimate EstimateShadingCost(int width, int height, int tileSize, const Vector2 &gazePos, const FoveationDesc &desc);
+
+// Accumulated savings of the frames rendered with one preset combination
+struct PresetSavings {
+    uint64_t frames;
+    double meanRelativeCost;
+    double meanSavedFraction;
+};
+
+// Snapshot of the per-frame shading cost log
+struct ShadingCostTelemetryStats {
+    uint64_t frames;
+    ShadingCostEstimate lastFrame;
+    // Indexed by (ShadingRatePreset - 1) * PATTERN_PRESETS + (ShadingPatternPreset - 1)
+    PresetSavings presets[static_cast<int>(ShadingRatePreset::MAX) * static_cast<int>(ShadingPatternPreset::MAX)];
+};
+
+// Logs the estimated shading cost of every presented frame per preset combination.
+// Frames are recorded by the render thread only, snapshots and resets are safe from any thread.
+class ShadingCostTelemetry {
+public:
+    static const int RATE_PRESETS = static_cast<int>(ShadingRatePreset::MAX);
+    static const int PATTERN_PRESETS = static_cast<int>(ShadingPatternPreset::MAX);
+
+    ShadingCostTelemetry();
+    ~ShadingCostTelemetry();
+
+    // Set the render target the frames are estimated for, a width of 0 disables logging
+    void Configure(int width, int height, int tileSize);
+
+    // Estimate and log a presented frame (render thread)
+    void RecordFrame(ShadingRatePreset ratePreset, ShadingPatternPreset patternPreset, const Vector2 &gazePos, const FoveationDesc &desc);
+
+    // Clear the log, applied by the next recorded frame
+    void Reset() { resetPending.store(true, std::memory_order_release); }
+
+    ShadingCostTelemetryStats GetStats() const;
+
+private:
+    struct Accumulator {
+        std::atomic<uint64_t> frames;
+        std::atomic<double> relativeCostSum;
+        std::atomic<double> savedFractionSum;
+    };
+
+    std::atomic<int> targetWidth;
+    std::atomic<int> targetHeight;
+    std::atomic<int> targetTileSize;
+    std::atomic<bool> resetPending;
+
+    std::atomic<uint64_t> frames;
+    Accumulator presets[RATE_PRESETS * PATTERN_PRESETS];
+
+    // Last frame, published with a seqlock so readers never see a torn estimate
+    std::atomic<uint64_t> lastFrameVersion;
+    std::atomic<uint64_t> lastPixels;
+    std::atomic<float> lastRegionCoverage[3];
+    std::atomic<float> lastAnalyticCoverage[3];
+    std::atomic<double> lastInvocations;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Foveation.h"
+#include "Vector.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Rectangle in tile units, end is exclusive
+struct TileRect {
+    int beginX, beginY;
+    int endX, endY;
+};
+
+// Builds an explicit per-tile shading-rate image (one ShadingRate per tile)
+// from gaze and foveation regions. Suitable as a D3D12/Vulkan tier-2 VRS source.
+//
+// Each tile row is described by the tile spans covered by the inner and middle
+// ellipses. Spans are evaluated four rows at a time with SSE2 and, when gaze
+// moves, only the columns between the old and new span edges are rewritten.
+class ShadingRateImage {
+public:
+    ShadingRateImage();
+    ~ShadingRateImage();
+
+    // Resize the image for a render target, tileSize is usually 8 or 16
+    bool Initialize(int targetWidth, int targetHeight, int tileSize);
+
+    // Rebuild the tiles affected by a gaze or foveation change, returns number of rewritten tiles
+    int Update(const Vector2 &gazePos, const FoveationDesc &desc);
+
+    // Check whether the image was initialized for these dimensions
+    bool Matches(int width, int height, int tile) const {
+        return targetWidth == width && targetHeight == height && tileSize == tile;
+    }
+
+    // Force a full rebuild on next update
+    void Invalidate();
+
+    // Tile grid accessors
+    int GetWidth() const { return tilesX; }
+    int GetHeight() const { return tilesY; }
+    int GetTileSize() const { return tileSize; }
+    const uint8_t *GetData() const { return tiles.data(); }
+    size_t GetSize() const { return tiles.size(); }
+
+    // Bounding rectangle of the tiles rewritten by the last update
+    const TileRect &GetDirtyRect() const { return dirtyRect; }
+
+    // Foveation region of a tile after the last update
+    TargetArea GetRegion(int column, int row) const {
+        if (column >= currentSpans.innerBegin[row] && column < currentSpans.innerEnd[row]) {
+            return TargetArea::INNER;
+        }
+        if (column >= currentSpans.middleBegin[row] && column < currentSpans.middleEnd[row]) {
+            return TargetArea::MIDDLE;
+        }
+        return TargetArea::PERIPHERAL;
+    }
+
+private:
+    // Tile columns covered by the inner and middle ellipses of a row, end is exclusive
+    struct RowSpans {
+        std::vector<int32_t> innerBegin, innerEnd;
+        std::vector<int32_t> middleBegin, middleEnd;
+    };
+
+    // Compute spans of an ellipse for every tile row
+    void ComputeEllipseSpans(const Vector2 &gazePos, const Vector2 &radii, int32_t *begin, int32_t *end) const;
+
+    // Rewrite columns [from, to) of a row from the current spans
+    void FillRow(int row, int from, int to, const FoveationDesc &desc);
+
+    // Grow the dirty rectangle by columns [from, to) of a row
+    void MarkDirty(int row, int from, int to);
+
+    int targetWidth;
+    int targetHeight;
+    int tileSize;
+    int tilesX;
+    int tilesY;
+
+    std::vector<uint8_t> tiles;
+    RowSpans currentSpans;
+    RowSpans previousSpans;
+
+    FoveationDesc lastDesc;
+    bool valid;
+    TileRect dirtyRect;
+};
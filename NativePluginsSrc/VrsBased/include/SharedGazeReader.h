@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+class GazeManager;
+class SharedGazeRing;
+struct SharedGazeRecord;
+
+// Counters of the shared-memory gaze reader, readable from any thread
+struct SharedGazeReaderStats {
+    uint64_t samplesRead;
+    uint64_t samplesInvalid;       // Published while the tracker lost the eyes
+    uint64_t samplesDropped;       // Overwritten in the ring before the reader got to them
+    uint64_t wakeups;              // Waits of the reader thread that returned data
+    uint64_t foreignClockSamples;  // Capture time not on the plugin clock, read time used instead
+    uint64_t attachments;          // Times the reader mapped a ring, more than one after tracker restarts
+};
+
+// Reader of the SharedGazeRing published by the GazeTracking tools (BeamSDK,
+// synthetic and replay sources). A background thread sleeps on the ring's wake
+// primitive and pushes every valid sample straight into the GazeManager with
+// its capture time. The reader attaches once the publisher is up and again
+// after it restarts. While running it is the only gaze producer of the
+// GazeManager. The plugin build compiles GazeTracking/SharedGazeRing.cpp.
+class SharedGazeReader {
+public:
+    static const int WAIT_TIMEOUT_MS = 50;
+    static const int REATTACH_AFTER_MS = 1000;
+    static const uint64_t MAX_CAPTURE_AGE_US = 1000000;
+
+    SharedGazeReader();
+    ~SharedGazeReader();
+
+    // Start the reader thread on the ring of the given mapping name
+    bool Start(const char *name, GazeManager *target);
+
+    // Stop the reader thread and unmap the ring
+    void Stop();
+
+    bool IsRunning() const { return running.load(std::memory_order_acquire); }
+
+    SharedGazeReaderStats GetStats() const;
+
+private:
+    // Reader thread body
+    void Run();
+
+    // Validate and forward one record
+    void Consume(const SharedGazeRecord &record);
+
+    GazeManager *gazeManager;
+    SharedGazeRing *ring;
+    std::string mappingName;
+    std::thread thread;
+    std::atomic<bool> running;
+
+    std::atomic<uint64_t> samplesRead;
+    std::atomic<uint64_t> samplesInvalid;
+    std::atomic<uint64_t> samplesDropped;
+    std::atomic<uint64_t> wakeups;
+    std::atomic<uint64_t> foreignClockSamples;
+    std::atomic<uint64_t> attachments;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "FoveationImageBuilder.h"
+#include "VrsBackend.h"
+#include <atomic>
+#include <cstdint>
+
+// Counters of a software backend
+struct SoftwareVrsBackendStats {
+    uint64_t enables;
+    uint64_t disables;
+    uint64_t gazeUpdates;
+    uint64_t imageUpdates;    // Enables that changed at least one tile
+    uint64_t tilesWritten;    // Tiles rewritten over all image updates
+};
+
+// Device-less backend. Builds the same rate image a D3D12 or Vulkan device
+// would receive and keeps it for inspection, so the foveation pipeline can be
+// exercised and benchmarked without a GPU. Used for renderers without VRS.
+class SoftwareVrsBackend : public IVrsBackend {
+public:
+    SoftwareVrsBackend();
+    ~SoftwareVrsBackend();
+
+    VrsBackendType GetType() const override { return VrsBackendType::SOFTWARE; }
+    bool Initialize(float tanHalfHorizontalFov, float tanHalfVerticalFov, bool stereo) override;
+    void ConfigureRenderTarget(int width, int height) override { image.ConfigureRenderTarget(width, height); }
+    void ConfigureContentShading(const ContentShadingSettings &settings) override { image.ConfigureContentShading(settings); }
+    bool SubmitContentFrame(const VrsContentFrame &frame) override { return image.SubmitContentFrame(frame); }
+    ContentShadingStats GetContentShadingStats() const override { return image.GetContentStats(); }
+    bool UpdateGaze(const VrsGazeFrame &gaze) override;
+    VrsResult Enable(RenderMode mode, const VrsFoveationState &foveation) override;
+    VrsResult Disable() override;
+    void Release() override;
+
+    // Rate image recorded by the last enable (render thread)
+    const FoveationImageBuilder &GetImage() const { return image; }
+
+    // Whether rates are currently applied (render thread)
+    bool IsEnabled() const { return enabled; }
+
+    // Snapshot of the counters, safe from any thread
+    SoftwareVrsBackendStats GetStats() const;
+
+private:
+    FoveationImageBuilder image;
+    VrsGazeFrame gaze;
+    bool enabled;
+
+    std::atomic<uint64_t> enables;
+    std::atomic<uint64_t> disables;
+    std::atomic<uint64_t> gazeUpdates;
+    std::atomic<uint64_t> imageUpdates;
+    std::atomic<uint64_t> tilesWritten;
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "GazeManager.h"
+#include "ShadingRateImage.h"
+#include "Vector.h"
+#include <cstdint>
+#include <vector>
+
+// Linear view depth of a frame, distance along the view axis in world units.
+// Zero, negative or infinite depth marks pixels without geometry (sky),
+// which are reprojected by camera rotation only.
+struct VrsDepthFrame {
+    const float *depth;
+    int width;
+    int height;
+    int rowPitch;               // Bytes between two rows, rows are stored top row first
+};
+
+// World-space camera of a frame, +z forward and +y up in camera space
+struct VrsCameraPose {
+    Vector3 position;
+    Quaternion rotation;
+    ViewFrustum frustum;
+};
+
+struct TemporalFoveationSettings {
+    bool enabled;
+    bool reuseMiddle;           // Also reuse middle region tiles, otherwise only peripheral tiles
+    float depthTolerance;       // Relative depth difference still taken as the same surface
+    float disocclusionBudget;   // Fraction of a tile's pixels that may be disoccluded and the tile still reused
+    float errorBudget;          // Mean screen motion in pixels a tile may accumulate across reuses
+    int32_t refreshInterval;    // Reused tiles are reshaded at least every this many frames, staggered across tiles
+};
+
+// Counters of the temporal reuse classification, tile counts are of the last frame
+struct TemporalFoveationStats {
+    uint64_t framesProcessed;
+    int32_t tilesX;
+    int32_t tilesY;
+    int32_t tilesReused;
+    int32_t tilesDisoccluded;   // Eligible tiles reshaded because too many pixels disoccluded
+    int32_t tilesOverBudget;    // Eligible tiles reshaded because their accumulated motion exceeded the budget
+    int32_t tilesRefreshed;     // Eligible tiles reshaded by the staggered schedule
+    float lastProcessMs;
+};
+
+// Decides per shading-rate tile whether the previous frame's pixels can be
+// reprojected instead of shading the tile again. Every pixel is unprojected
+// with its depth, moved by the camera motion since the previous frame and
+// projected into the previous view (four pixels at a time with SSE2). A pixel
+// is disoccluded if it lands off screen or on a previous depth that differs
+// by more than the tolerance.
+//
+// Only tiles of the coarse foveation regions are eligible. An eligible tile
+// is reshaded when too many of its pixels disoccluded, when the mean motion
+// it accumulated since its last shading exceeds the error budget, or when
+// its slot of the staggered refresh schedule comes up; tiles are spread over
+// the slots by a hash so the refresh cost is level across frames.
+//
+// The tile mask holds one byte per tile, TEMPORAL_TILE_SHADE or
+// TEMPORAL_TILE_REUSE. ResolveReusedTiles is the CPU reference of the
+// reprojection pass a GPU backend runs for the reused tiles. The class keeps
+// the previous depth and camera as history and is not thread-safe; its owner
+// calls it from one thread at a time.
+class TemporalFoveation {
+public:
+    // Tile mask values
+    enum : uint8_t {
+        TEMPORAL_TILE_REUSE = 0,
+        TEMPORAL_TILE_SHADE = 1
+    };
+
+    TemporalFoveation();
+    ~TemporalFoveation();
+
+    // Replace the settings, applied from the next processed frame
+    void Configure(const TemporalFoveationSettings &settings);
+    TemporalFoveationSettings GetSettings() const { return settings; }
+
+    // Classify the tiles of a frame against the history, then keep the frame as history.
+    // The shading-rate image sets the tile grid and regions and must match the depth size.
+    bool Process(const VrsDepthFrame &depth, const VrsCameraPose &pose, const ShadingRateImage &regions);
+
+    // Drop the history, the next frame reshades every tile
+    void Reset();
+
+    // Tile mask of the last processed frame, row major
+    const uint8_t *GetTileMask() const { return tileMask.data(); }
+    int GetTilesX() const { return tilesX; }
+    int GetTilesY() const { return tilesY; }
+
+    // Copy the reprojected previous color (RGBA8) into the reused tiles of the last processed frame,
+    // other tiles are left untouched. Pixels without a valid source take the nearest on-screen texel.
+    void ResolveReusedTiles(const uint8_t *previousColor, int previousPitch, uint8_t *color, int pitch) const;
+
+    TemporalFoveationStats GetStats() const { return stats; }
+
+    static TemporalFoveationSettings GetDefaultSettings();
+
+private:
+    // Camera motion from the current view into the previous one: previous = rotation * current + translation,
+    // plus the previous frustum mapped to pixel coordinates
+    struct Reprojection {
+        float rotation[9];
+        float translation[3];
+        float scaleX, offsetX;      // Previous pixel x = u * scaleX + offsetX, u = x / z
+        float scaleY, offsetY;      // Previous pixel y = v * scaleY + offsetY, v = y / z
+    };
+
+    // Reproject one pixel row of the last processed depth into previous pixel coordinates. The source depth
+    // is the previous view depth of geometry, zero for sky and negative behind the previous camera.
+    void ReprojectRow(const float *depthRow, int y, float *sourceX, float *sourceY, float *sourceDepth) const;
+
+    // Test a reprojected row against the previous depth, accumulating disoccluded pixels and motion per tile
+    void AccumulateRow(int y, const float *sourceX, const float *sourceY, const float *sourceDepth);
+
+    static Reprojection ComputeReprojection(const VrsCameraPose &current, const VrsCameraPose &previous, int width, int height);
+
+    TemporalFoveationSettings settings;
+    bool historyValid;
+
+    int width;
+    int height;
+    int tileSize;
+    int tilesX;
+    int tilesY;
+    std::vector<uint8_t> tileMask;
+
+    // Depth of the last processed frame (the history of the next one) and of the frame being processed,
+    // tightly packed and swapped after processing
+    std::vector<float> previousDepth;
+    std::vector<float> currentDepth;
+    VrsCameraPose previousPose;
+    Reprojection reprojection;      // Last processed frame into the frame before it, kept for the resolve
+
+    // Per tile state
+    std::vector<float> accumulatedMotion;
+    std::vector<uint32_t> disoccludedPixels;
+    std::vector<float> motionSums;
+
+    // Row scratch
+    std::vector<float> sourceX;
+    std::vector<float> sourceY;
+    std::vector<float> sourceDepth;
+
+    TemporalFoveationStats stats;
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Enums.h"
+#include "Vector.h"
+#include "VrsManager.h"
+#include <cstddef>
+#include <cstdint>
+
+// Compact binary trace of a playtest session (.vrstrace).
+//
+//   TraceFileHeader
+//   TraceChunkHeader, payload     repeated
+//   TraceIndexEntry               one per chunk
+//   TraceFileFooter
+//
+// A payload is a sequence of records: a tag byte (type in the low three bits,
+// eye or rotation axis in the next two), a zigzag varint time delta in
+// microseconds, then the type's fields. Poses and gaze are quantized and
+// delta encoded against the previous record of their kind in the chunk;
+// every chunk starts from a zero state, so a reader can start at any chunk.
+// The index and footer are written on close; a file without them (crashed
+// session) is still read by walking the chunk headers. All fields are
+// little endian.
+
+static const char TRACE_FILE_MAGIC[8] = {'V', 'R', 'S', 'T', 'R', 'A', 'C', 'E'};
+static const uint32_t TRACE_FORMAT_VERSION = 1;
+static const uint32_t TRACE_CHUNK_MAGIC = 0x4b4e4843;   // "CHNK"
+static const uint32_t TRACE_FOOTER_MAGIC = 0x58444e49;  // "INDX"
+
+// Quantization steps
+static const float TRACE_POSITION_QUANTUM = 1e-4f;              // Metres, 0.1 mm
+static const float TRACE_ROTATION_SCALE = 32767.0f * 1.41421356f; // Smallest-three components span [-1/sqrt2, 1/sqrt2]
+static const float TRACE_GAZE_SCALE = 65536.0f;                  // Steps per unit of normalized gaze space
+
+// Chunks are closed at this payload size or time span, the span bounds the seek granularity
+static const size_t TRACE_CHUNK_BYTES = 64 * 1024;
+static const int64_t TRACE_CHUNK_SPAN = 1000000;
+
+enum class TraceRecordType {
+    CAMERA_POSE = 1,    // World-space camera position and rotation
+    GAZE = 2,           // Gaze sample of one eye in normalized NVAPI gaze space, at its capture time, mono gaze as left only
+    FRAME = 3,          // Frame presented with its frame time
+    CONFIGURATION = 4   // VrsConfiguration in effect from here on
+};
+
+#pragma pack(push, 1)
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t startTime;         // Microseconds of the recording clock that record times are relative to
+};
+
+struct TraceChunkHeader {
+    uint32_t magic;
+    uint32_t payloadBytes;
+    uint32_t recordCount;
+    uint32_t reserved;
+    int64_t firstTime;          // Time of the first record
+    int64_t lastTime;           // Time of the last record
+};
+
+struct TraceIndexEntry {
+    uint64_t offset;            // File offset of the chunk header
+    int64_t firstTime;
+    uint32_t recordCount;
+    uint32_t reserved;
+};
+
+struct TraceFileFooter {
+    uint64_t indexOffset;
+    uint32_t chunkCount;
+    uint32_t magic;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(TraceFileHeader) == 24, "Trace header layout");
+static_assert(sizeof(TraceChunkHeader) == 32, "Trace chunk header layout");
+static_assert(sizeof(TraceIndexEntry) == 24, "Trace index layout");
+static_assert(sizeof(TraceFileFooter) == 16, "Trace footer layout");
+
+// Decoded record
+struct TraceRecord {
+    TraceRecordType type;
+    int64_t time;               // Microseconds since TraceFileHeader::startTime
+    Vector3 position;           // CAMERA_POSE
+    Quaternion rotation;        // CAMERA_POSE
+    Eye eye;                    // GAZE
+    Vector2 gaze;               // GAZE
+    float frameTimeMs;          // FRAME
+    VrsConfiguration configuration;  // CONFIGURATION
+};
+
+// Predictors of the delta coding, reset at every chunk
+struct TraceCodecState {
+    int64_t time;
+    int32_t position[3];
+    int32_t rotation[3];
+    int32_t gaze[2][2];
+};
+
+// Varint and zigzag helpers shared by the writer and the reader
+
+inline uint64_t TraceZigZag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t TraceUnZigZag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Append a LEB128 varint, returns the bytes written (at most 10)
+inline size_t TracePutVarint(uint8_t *out, uint64_t value) {
+    size_t used = 0;
+    while (value >= 0x80) {
+        out[used++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[used++] = static_cast<uint8_t>(value);
+    return used;
+}
+
+// Read a LEB128 varint, returns false on a truncated or overlong value
+inline bool TraceGetVarint(const uint8_t *&cursor, const uint8_t *end, uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+        uint8_t byte = *cursor++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "TraceFormat.h"
+#include <vector>
+
+// Memory-mapped reader of a .vrstrace file, see TraceFormat.h.
+// Records are decoded straight from the mapping one at a time, so a trace of
+// any length replays in constant memory beyond the chunk index.
+class TraceReader {
+public:
+    TraceReader();
+    ~TraceReader();
+
+    // Map a trace and load its index, rebuilt from the chunk headers if the footer is missing
+    bool Open(const char *path);
+
+    // Unmap the trace
+    void Close();
+
+    // Recording clock time the record times are relative to
+    uint64_t GetStartTime() const { return header ? header->startTime : 0; }
+
+    // Number of chunks and records, and the time of the last chunk's first record
+    size_t GetChunkCount() const { return chunks.size(); }
+    uint64_t GetRecordCount() const { return recordCount; }
+    int64_t GetLastChunkTime() const { return chunks.empty() ? 0 : chunks.back().firstTime; }
+
+    // Whether the index was read from the footer rather than rebuilt
+    bool HasIndex() const { return indexed; }
+
+    // Continue at the first record at or after time, from the chunk that starts last before it
+    void Seek(int64_t time);
+
+    // Rewind to the first record
+    void Rewind() { SeekChunk(0); }
+
+    // Decode the next record, returns false at the end of the trace or on a corrupt chunk
+    bool Next(TraceRecord &record);
+
+private:
+    // Start decoding a chunk
+    void SeekChunk(size_t chunk);
+
+    // Walk the chunk headers after a session that ended without a footer
+    void RebuildIndex();
+
+    // Whether a chunk header at offset lies inside the file with its payload
+    bool IsValidChunk(uint64_t offset) const;
+
+    const uint8_t *data;
+    size_t size;
+#ifdef _WIN32
+    void *fileHandle;
+    void *mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+
+    const TraceFileHeader *header;
+    std::vector<TraceIndexEntry> chunks;
+    uint64_t recordCount;
+    bool indexed;
+
+    // Decoding position
+    size_t currentChunk;
+    const uint8_t *cursor;
+    const uint8_t *chunkEnd;
+    TraceCodecState state;
+};
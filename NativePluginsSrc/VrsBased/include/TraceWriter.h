@@ -0,0 +1,66 @@
+#pragma once
+
+#include "TraceFormat.h"
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+// Size of the trace recorded so far
+struct TraceWriterStats {
+    uint64_t records;
+    uint64_t bytes;             // Written to the file, the open chunk excluded
+    uint32_t chunks;
+    int32_t recording;          // Non-zero while a trace is open
+};
+
+// Records a session into a .vrstrace file, see TraceFormat.h.
+// Records are encoded into an in-memory chunk under a mutex; a full chunk is
+// written out by whichever thread filled it. While no trace is open every
+// record call returns after a single atomic load. Times are microseconds of
+// the clock in Clock.h.
+class TraceWriter {
+public:
+    TraceWriter();
+    ~TraceWriter();
+
+    // Create the file, record times are taken relative to startTime
+    bool Open(const char *path, uint64_t startTime);
+
+    // Write the open chunk, the index and the footer and close the file
+    void Close();
+
+    bool IsOpen() const { return open.load(std::memory_order_acquire); }
+
+    void RecordCameraPose(uint64_t time, const Vector3 &position, const Quaternion &rotation);
+    void RecordGaze(uint64_t time, Eye eye, const Vector2 &gaze);
+    void RecordFrame(uint64_t time, float frameTimeMs);
+    void RecordConfiguration(uint64_t time, const VrsConfiguration &config);
+
+    TraceWriterStats GetStats() const;
+
+private:
+    // Largest encoded record
+    static const size_t MAX_RECORD_BYTES = 64;
+
+    // Start a record of a type in the chunk, returns the write position (mutex held)
+    uint8_t *BeginRecord(TraceRecordType type, int extra, uint64_t time, size_t &used);
+
+    // Account a finished record and close the chunk if it is full (mutex held)
+    void EndRecord(size_t used);
+
+    // Write the open chunk to the file (mutex held)
+    void FlushChunk();
+
+    mutable std::mutex mutex;
+    std::atomic<bool> open;
+    FILE *file;
+    uint64_t startTime;
+    uint64_t fileBytes;
+
+    std::vector<uint8_t> payload;
+    TraceChunkHeader chunk;
+    TraceCodecState state;
+    std::vector<TraceIndexEntry> index;
+    uint64_t records;
+};
@@ -4,5 +4,6 @@
 
 template<typename T>
 inline T Clamp(const T &input, const T &lower, const T &upper) {
-    return max(min(input, upper), lower);
+    // Parenthesized to stay immune to the min/max macros from windows.h
+    return (std::max)((std::min)(input, upper), lower);
 }
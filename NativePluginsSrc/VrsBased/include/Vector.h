@@ -7,3 +7,7 @@ struct Vector2 {
 struct Vector3 {
     float x, y, z;
 };
+
+struct Quaternion {
+    float x, y, z, w;
+};
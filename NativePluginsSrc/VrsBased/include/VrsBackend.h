@@ -0,0 +1,86 @@
+#pragma once
+
+#include "ContentAdaptiveShading.h"
+#include "Enums.h"
+#include "Foveation.h"
+#include "Vector.h"
+#include <cstdint>
+
+// Platform backends compiled into this build, the build system may override either
+#ifndef VRS_BACKEND_D3D
+#ifdef _WIN32
+#define VRS_BACKEND_D3D 1
+#else
+#define VRS_BACKEND_D3D 0
+#endif
+#endif
+
+#ifndef VRS_BACKEND_VULKAN
+#define VRS_BACKEND_VULKAN 1
+#endif
+
+// Foveation handed to a backend. The presets travel with the resolved
+// regions and rates for drivers that implement presets themselves.
+struct VrsFoveationState {
+    ShadingRatePreset ratePreset;
+    ShadingPatternPreset patternPreset;
+    FoveationDesc desc;
+    uint64_t version;     // Changes whenever presets, regions or rates change
+};
+
+// Gaze handed to a backend, normalized NVAPI space per eye (mono copies the left eye)
+struct VrsGazeFrame {
+    Vector2 positions[2];
+    bool stereo;
+    uint64_t timestamp;   // Strictly increasing from one update to the next
+};
+
+// Graphics API side of foveated rendering. Configuration, gaze filtering,
+// prediction and telemetry stay platform-neutral; a backend only turns the
+// resolved foveation and gaze into rate state on one device.
+// Every method except GetType and ConfigureRenderTarget runs on the render thread.
+class IVrsBackend {
+public:
+    virtual ~IVrsBackend() {}
+
+    // Graphics API served by this backend
+    virtual VrsBackendType GetType() const = 0;
+
+    // Create device resources for a view with the given tangents of the half FOV angles
+    virtual bool Initialize(float tanHalfHorizontalFov, float tanHalfVerticalFov, bool stereo) = 0;
+
+    // Size of the render target foveated by image-based backends, safe from any thread
+    virtual void ConfigureRenderTarget(int width, int height) = 0;
+
+    // Hand the latest gaze to the device
+    virtual bool UpdateGaze(const VrsGazeFrame &gaze) = 0;
+
+    // Apply rate state for the views in mode
+    virtual VrsResult Enable(RenderMode mode, const VrsFoveationState &foveation) = 0;
+
+    // Return to full-rate shading
+    virtual VrsResult Disable() = 0;
+
+    // Another backend on the same device set rates since this one last did, so state cached by this
+    // backend no longer describes the device and its next Enable or Disable must reach it
+    virtual void InvalidateAppliedState() {}
+
+    // Native status of the latest failure (NvAPI_Status, HRESULT, VkResult), 0 if none
+    virtual int32_t GetLastNativeError() const { return 0; }
+
+    // Native rate resource for engine-side binding (ID3D12Resource*, VkImage), null if there is none
+    virtual void *GetNativeShadingRateImage() const { return nullptr; }
+
+    // Content-adaptive rate settings, safe from any thread. Backends without a rate image ignore them.
+    virtual void ConfigureContentShading(const ContentShadingSettings & /*settings*/) {}
+
+    // Previous frame's color for content-adaptive rates, safe from any thread. Image-based backends
+    // analyze it with the CPU kernel; a backend may instead measure the content on its device.
+    virtual bool SubmitContentFrame(const VrsContentFrame & /*frame*/) { return false; }
+
+    // Counters of the content analysis, zero if the backend has none
+    virtual ContentShadingStats GetContentShadingStats() const { return ContentShadingStats{}; }
+
+    // Release device resources
+    virtual void Release() = 0;
+};
@@ -1,17 +1,48 @@
 #pragma once
 
 #include "Enums.h"
-#include <d3d11.h>
-#include <nvapi.h>
+#include "Foveation.h"
+#include "VrsBackend.h"
+#include "Vector.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+// Complete VRS configuration, submitted by the scripting thread in one call
+struct VrsConfiguration {
+    ShadingRatePreset shadingRatePreset;
+    ShadingPatternPreset foveationPatternPreset;
 
-// Manages VRS configurations and interactions
+    // Custom radii for foveation regions
+    Vector2 innerRadii;
+    Vector2 middleRadii;
+    Vector2 peripheralRadii;
+
+    // Custom shading rates for foveation regions
+    ShadingRate innerRate;
+    ShadingRate middleRate;
+    ShadingRate peripheralRate;
+};
+
+// Manages VRS configurations and hands them to the active backend.
+// The scripting thread edits a pending configuration that is published as a
+// whole under a new version. The render thread adopts the latest version at
+// the next enable and resolves it once, so the backend never sees a
+// half-applied configuration and gets an unchanged state version while
+// nothing changed.
 class VrsManager {
 public:
     VrsManager();
     ~VrsManager();
 
-    // Initialize VRS helper with the Direct3D device
-    bool Initialize(ID3D11Device *device);
+    // Attach the backend that applies the configuration
+    bool Initialize(IVrsBackend *vrsBackend);
+
+    // Replace the whole configuration (scripting thread)
+    void SubmitConfiguration(const VrsConfiguration &config);
+
+    // Last submitted configuration (scripting thread)
+    VrsConfiguration GetConfiguration() const;
 
     // Configure shading rate preset
     void SetShadingRatePreset(ShadingRatePreset preset);
@@ -25,36 +56,69 @@ public:
     // Configure shading rate for a specific target area
     void ConfigureShadingRate(TargetArea targetArea, ShadingRate rate);
 
-    // Apply shading rate pattern to the device context
-    void ApplyShadingRatePattern(ID3D11DeviceContext *deviceContext, NV_VRS_RENDER_MODE renderMode);
+    // Apply shading rate pattern for the views in mode (render thread)
+    VrsResult ApplyShadingRatePattern(RenderMode mode);
+
+    // Remove shading rate pattern (render thread)
+    VrsResult RemoveShadingRatePattern();
 
-    // Remove shading rate pattern from the device context
-    void RemoveShadingRatePattern(ID3D11DeviceContext *deviceContext);
+    // Adopt the latest configuration and resolve the state if anything changed (render thread)
+    void LatchConfiguration();
 
-    // Release VRS helper resources
+    // Detach the backend
     void Release();
 
-    // Getter for vrsHelper
-    ID3DNvVRSHelper *GetVrsHelper() const { return vrsHelper; }
+    // Getter for backend
+    IVrsBackend *GetBackend() const { return backend; }
+
+    // Foveation applied by the last enable (render thread)
+    const VrsFoveationState &GetFoveationState() const { return activeState; }
+
+    // Foveation of the last submitted configuration, or of the governor override while one is active (any thread)
+    VrsFoveationState GetPublishedFoveationState() const;
+
+    // Views foveated by ApplyShadingRatePattern when no explicit mode is given
+    void SetRenderMode(RenderMode mode) { renderMode.store(static_cast<int>(mode), std::memory_order_relaxed); }
+    RenderMode GetRenderMode() const { return static_cast<RenderMode>(renderMode.load(std::memory_order_relaxed)); }
+
+    // Take regions and rates from desc instead of the configured presets, applied on the next enable (render thread)
+    void SetFoveationOverride(const FoveationDesc &desc);
+
+    // Return to the configured presets (render thread)
+    void ClearFoveationOverride();
 
 private:
-    // Internal helper methods
-    void UpdateShadingRatePresetParams(NV_VRS_HELPER_ENABLE_PARAMS &enableParams);
-    void UpdateFoveationPatternPresetParams(NV_VRS_HELPER_ENABLE_PARAMS &enableParams);
+    // Clamp every field to its valid range
+    static VrsConfiguration SanitizeConfiguration(const VrsConfiguration &config);
 
-    ID3DNvVRSHelper *vrsHelper;
+    // Resolve presets and custom values into the state handed to the backend
+    static VrsFoveationState ResolveConfiguration(const VrsConfiguration &config);
 
-    // Configuration presets
-    NV_FOVEATED_RENDERING_SHADING_RATE_PRESET shadingRatePreset;
-    NV_FOVEATED_RENDERING_FOVEATION_PATTERN_PRESET foveationPatternPreset;
+    // Publish the pending configuration under a new version, configMutex must be held
+    void PublishPendingConfiguration();
 
-    // Custom radii for foveation regions
-    float innerRegionRadii[2];
-    float middleRegionRadii[2];
-    float peripheralRegionRadii[2];
+    IVrsBackend *backend;
 
-    // Custom shading rates for foveation regions
-    NV_PIXEL_SHADING_RATE innerShadingRate;
-    NV_PIXEL_SHADING_RATE middleShadingRate;
-    NV_PIXEL_SHADING_RATE peripheralShadingRate;
+    // Written by the scripting thread
+    mutable std::mutex configMutex;
+    VrsConfiguration pendingConfig;
+    std::atomic<uint64_t> pendingVersion;
+
+    // Written by the scripting thread, read by the render thread
+    std::atomic<int> renderMode;
+
+    // Render thread state
+    VrsConfiguration activeConfig;
+    uint64_t activeConfigVersion;
+    bool stateDirty;
+    VrsFoveationState activeState;
+
+    // Foveation set by the frame-time governor
+    bool overrideActive;
+    FoveationDesc overrideDesc;
+
+    // Override as seen by other threads
+    mutable std::mutex publishedOverrideMutex;
+    bool publishedOverrideActive;
+    VrsFoveationState publishedOverride;
 };
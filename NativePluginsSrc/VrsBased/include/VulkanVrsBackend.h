@@ -0,0 +1,136 @@
+#pragma once
+
+#include "VrsBackend.h"
+
+#if VRS_BACKEND_VULKAN
+
+#include "FoveationImageBuilder.h"
+#ifndef VK_NO_PROTOTYPES
+#define VK_NO_PROTOTYPES
+#endif
+#include <vulkan/vulkan.h>
+#include <IUnityGraphicsVulkan.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// VK_KHR_fragment_shading_rate attachment. The rate image is rebuilt on the
+// CPU and its changed rows are copied into an R8_UINT attachment on Unity's
+// command buffer. Unity's own render passes cannot reference a plugin
+// attachment, so the image is exposed through GetNativeShadingRateImage for
+// the render pipeline to attach (VkFragmentShadingRateAttachmentInfoKHR).
+class VulkanVrsBackend : public IVrsBackend {
+public:
+    // Staging buffers in flight, two enables per frame (multi-pass stereo) over three frames
+    static const int UPLOAD_SLOTS = 6;
+
+    explicit VulkanVrsBackend(IUnityGraphicsVulkan *unityGraphicsVulkan);
+    ~VulkanVrsBackend();
+
+    VrsBackendType GetType() const override { return VrsBackendType::VULKAN; }
+    bool Initialize(float tanHalfHorizontalFov, float tanHalfVerticalFov, bool stereo) override;
+    void ConfigureRenderTarget(int width, int height) override { image.ConfigureRenderTarget(width, height); }
+    bool UpdateGaze(const VrsGazeFrame &gaze) override;
+    VrsResult Enable(RenderMode mode, const VrsFoveationState &foveation) override;
+    VrsResult Disable() override { return VrsResult::SKIPPED; }
+    void *GetNativeShadingRateImage() const override;
+    void ConfigureContentShading(const ContentShadingSettings &settings) override { image.ConfigureContentShading(settings); }
+    bool SubmitContentFrame(const VrsContentFrame &frame) override { return image.SubmitContentFrame(frame); }
+    ContentShadingStats GetContentShadingStats() const override { return image.GetContentStats(); }
+    int32_t GetLastNativeError() const override { return lastError; }
+    void Release() override;
+
+private:
+    // Device entry points, loaded through Unity's instance
+    struct VulkanFunctions {
+        PFN_vkGetDeviceProcAddr GetDeviceProcAddr;
+        PFN_vkGetPhysicalDeviceFeatures2 GetPhysicalDeviceFeatures2;
+        PFN_vkGetPhysicalDeviceProperties2 GetPhysicalDeviceProperties2;
+        PFN_vkGetPhysicalDeviceMemoryProperties GetPhysicalDeviceMemoryProperties;
+        PFN_vkCreateImage CreateImage;
+        PFN_vkDestroyImage DestroyImage;
+        PFN_vkCreateImageView CreateImageView;
+        PFN_vkDestroyImageView DestroyImageView;
+        PFN_vkCreateBuffer CreateBuffer;
+        PFN_vkDestroyBuffer DestroyBuffer;
+        PFN_vkGetImageMemoryRequirements GetImageMemoryRequirements;
+        PFN_vkGetBufferMemoryRequirements GetBufferMemoryRequirements;
+        PFN_vkAllocateMemory AllocateMemory;
+        PFN_vkFreeMemory FreeMemory;
+        PFN_vkBindImageMemory BindImageMemory;
+        PFN_vkBindBufferMemory BindBufferMemory;
+        PFN_vkMapMemory MapMemory;
+        PFN_vkCmdPipelineBarrier CmdPipelineBarrier;
+        PFN_vkCmdCopyBufferToImage CmdCopyBufferToImage;
+        PFN_vkCmdSetFragmentShadingRateKHR CmdSetFragmentShadingRateKHR;
+    };
+
+    // Staging buffer and the frame that last read it
+    struct UploadSlot {
+        VkBuffer buffer;
+        VkDeviceMemory memory;
+        uint8_t *mapped;
+        unsigned long long frameNumber;
+    };
+
+    // Attachment image with its staging buffers, retired together when the size changes
+    struct ImageResources {
+        VkImage image;
+        VkImageView view;
+        VkDeviceMemory memory;
+        UploadSlot uploadSlots[UPLOAD_SLOTS];
+        int width;
+        int height;
+        bool initialized;                    // Left the undefined layout
+        unsigned long long retiredFrame;
+    };
+
+    // Load the entry points, false if the device lacks the extension
+    bool LoadFunctions();
+
+    // Check attachment support and pick the tile size
+    bool QuerySupport();
+
+    // Move out of Unity's render pass during the enable events so the image can be copied
+    void ConfigurePluginEvents();
+
+    // Remember a failed result, returns true on VK_SUCCESS
+    bool Check(VkResult result);
+
+    // Allocate memory of a type with the given properties
+    bool AllocateMemory(const VkMemoryRequirements &requirements, VkMemoryPropertyFlags properties, VkDeviceMemory &memory);
+
+    // Create the attachment and staging buffers for the builder size
+    bool CreateImageResources(ImageResources &resources);
+
+    // Destroy all handles of a resource set
+    void DestroyImageResources(ImageResources &resources);
+
+    // Destroy retired resource sets of every backend the GPU no longer uses, all of them if force is set
+    void ReleaseRetiredResources(unsigned long long safeFrameNumber, bool force);
+
+    // Copy the changed rows of the image into the attachment
+    bool UploadImage(const UnityVulkanRecordingState &recordingState);
+
+    IUnityGraphicsVulkan *unityGraphics;
+    UnityVulkanInstance vulkan;
+    VulkanFunctions vk;
+    bool supported;
+
+    FoveationImageBuilder image;
+    VrsGazeFrame gaze;
+
+    ImageResources current;
+    int nextUploadSlot;
+    bool fullUploadPending;
+    unsigned long long lastFrameNumber;      // Last frame recorded with the attachment
+    int32_t lastError;
+
+    // Resource sets replaced or released while frames using them may still be in flight. Shared by the
+    // backends of the device, a context deletes its backend before the GPU is done with its last frames.
+    static std::mutex retiredMutex;
+    static std::vector<ImageResources> retiredResources;
+    static std::atomic<int> liveBackends;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent pool of worker threads for data-parallel jobs.
+// The calling thread takes part in every run, so a pool without workers
+// simply runs the jobs inline. Runs are not reentrant: one thread at a time.
+class WorkerPool {
+public:
+    // A worker count of -1 leaves one hardware thread for Unity's main thread
+    explicit WorkerPool(int workerCount = -1);
+    ~WorkerPool();
+
+    // Number of threads besides the caller that take jobs
+    int GetWorkerCount() const { return workerCount; }
+
+    // Run job(0) .. job(jobCount - 1) across the workers and return once all are done.
+    // The workers are started by the first run that has more than one job.
+    void Run(int jobCount, const std::function<void(int)> &job);
+
+private:
+    // Wait for runs until the pool is destroyed
+    void WorkerLoop();
+
+    // Take jobs of the current run until none are left
+    void RunJobs();
+
+    int workerCount;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+    const std::function<void(int)> *currentJob;
+    int currentJobCount;
+    std::atomic<int> nextJob;
+    int busyWorkers;       // Workers that have not finished the current run
+    uint64_t generation;   // Incremented for every run
+    bool stopping;
+};
@@ -70,6 +70,9 @@ namespace GazeTracking
                     try
                     {
                         byte[] receivedBytes = _udpClient.Receive(ref _remoteEndPoint);
+                        if (ParseBinaryPacket(receivedBytes))
+                            continue;
+
                         string receivedData = Encoding.UTF8.GetString(receivedBytes);
 
                         if (showDebug)
@@ -96,6 +99,22 @@ namespace GazeTracking
             }
         }
 
+        // Binary packet layout, see NativePluginsSrc/VrsBased/include/GazePacket.h
+        private const int GazePacketSize = 32;
+        private const uint GazePacketMagic = 0x315A4746;
+
+        private bool ParseBinaryPacket(byte[] data)
+        {
+            if (data.Length != GazePacketSize || BitConverter.ToUInt32(data, 0) != GazePacketMagic)
+                return false;
+
+            // Invalid samples keep the previous coordinates
+            if (data[24] != 0)
+                gazeCoordinates = new Vector2(BitConverter.ToSingle(data, 16), BitConverter.ToSingle(data, 20));
+
+            return true;
+        }
+
         private void ParseCoordinates(string data)
         {
             try
@@ -1,4 +1,5 @@
 using UnityEngine;
+using System;
 using System.Linq;
 using GazeTracking;
 using FoveatedRenderingVRS;
@@ -28,6 +29,30 @@ public class FoveatedLODController : MonoBehaviour
     [Tooltip("If false, do not override the gaze center (when VRS is also on).")]
     public bool overrideGaze = true;
 
+    [Header("Native Classifier")]
+    [Tooltip("Classify the LOD groups in the native plugin, falls back to the managed loop when it is missing")]
+    public bool useNativeClassifier = true;
+
+    [Tooltip("Relative margin an object has to cross an ellipse boundary by before its LOD changes")]
+    [Range(0f, 0.5f)]
+    public float lodHysteresis = 0.05f;
+
+    [Tooltip("Pass LOD groups whose transform changed to the native index every frame")]
+    public bool trackMovingGroups = false;
+
+    // LOD group bounds in structure-of-arrays layout, staging for the native spatial index
+    private float[] positionX;
+    private float[] positionY;
+    private float[] positionZ;
+    private float[] boundsRadius;
+    private int[] coarsestLods;
+    private int[] lodHandles;
+    private int[] movedHandles;
+    private LODGroup[] groupsByHandle;
+    private int[] changedHandles;
+    private int[] changedLods;
+    private LodClassifierParams classifierParams;
+
     private ZoneVisualizer zoneVisualizer;
     private VrsGazeUpdater gazeUpdater;
     private bool pluginGazeActive;
@@ -39,6 +64,7 @@ public class FoveatedLODController : MonoBehaviour
 #else
         lodGroups = FindObjectsOfType<LODGroup>();
 #endif
+        RefreshLODGroupBounds();
 
         // Attempt to find a GazeUpdater from VRS
         gazeUpdater = FindObjectOfType<VrsGazeUpdater>();
@@ -83,6 +109,79 @@ public class FoveatedLODController : MonoBehaviour
         }
     }
 
+    void OnDestroy()
+    {
+        // The native index outlives the scene, leave it empty for the next controller
+        if (useNativeClassifier && lodHandles != null)
+        {
+            VrsPluginApi.ClearLodObjects();
+        }
+    }
+
+    /// <summary>
+    /// Insert the LOD groups into the native spatial index, call again after adding or removing groups.
+    /// </summary>
+    public void RefreshLODGroupBounds()
+    {
+        int count = lodGroups.Length;
+        positionX = new float[count];
+        positionY = new float[count];
+        positionZ = new float[count];
+        boundsRadius = new float[count];
+        coarsestLods = new int[count];
+        lodHandles = new int[count];
+        movedHandles = new int[count];
+        changedHandles = new int[count];
+        changedLods = new int[count];
+
+        for (int i = 0; i < count; i++)
+        {
+            CaptureBounds(lodGroups[i], i);
+            coarsestLods[i] = Mathf.Min(2, lodGroups[i].lodCount - 1);
+            lodGroups[i].transform.hasChanged = false;
+        }
+
+        if (!useNativeClassifier) return;
+
+        try
+        {
+            VrsPluginApi.ClearLodObjects();
+            VrsPluginApi.InsertLodObjects(positionX, positionY, positionZ, boundsRadius, coarsestLods, count, lodHandles);
+        }
+        catch (Exception e) when (e is DllNotFoundException || e is EntryPointNotFoundException)
+        {
+            Debug.LogWarning("FoveatedLODController: native classifier not available, using the managed loop.");
+            useNativeClassifier = false;
+            return;
+        }
+
+        int maxHandle = -1;
+        for (int i = 0; i < count; i++)
+        {
+            maxHandle = Mathf.Max(maxHandle, lodHandles[i]);
+        }
+        groupsByHandle = new LODGroup[maxHandle + 1];
+        for (int i = 0; i < count; i++)
+        {
+            groupsByHandle[lodHandles[i]] = lodGroups[i];
+        }
+    }
+
+    /// <summary>
+    /// Write the world-space bounding sphere of a LOD group into the staging arrays.
+    /// </summary>
+    private void CaptureBounds(LODGroup group, int index)
+    {
+        Transform groupTransform = group.transform;
+        Vector3 center = groupTransform.TransformPoint(group.localReferencePoint);
+        Vector3 scale = groupTransform.lossyScale;
+
+        positionX[index] = center.x;
+        positionY[index] = center.y;
+        positionZ[index] = center.z;
+        boundsRadius[index] = 0.5f * group.size * Mathf.Max(Mathf.Abs(scale.x), Mathf.Abs(scale.y), Mathf.Abs(scale.z));
+    }
+
     /// <summary>
     /// Convert mouse pos to normalized [-1..1] screen coords
     /// </summary>
@@ -101,6 +200,12 @@ public class FoveatedLODController : MonoBehaviour
     {
         if (Camera.main == null) return;
 
+        if (useNativeClassifier)
+        {
+            UpdateLODGroupsNative(Camera.main, gazePos);
+            return;
+        }
+
         foreach (LODGroup group in lodGroups)
         {
             // Convert object pos to normalized [-1..1] coords
@@ -134,6 +239,52 @@ public class FoveatedLODController : MonoBehaviour
         }
     }
 
+    /// <summary>
+    /// Let the native spatial index reclassify the LODGroups that may have changed level and only
+    /// touch those whose level did.
+    /// </summary>
+    private void UpdateLODGroupsNative(Camera camera, Vector2 gazePos)
+    {
+        if (trackMovingGroups)
+        {
+            UpdateMovedLODGroups();
+        }
+
+        classifierParams.viewProjection = camera.projectionMatrix * camera.worldToCameraMatrix;
+        classifierParams.gazePos = gazePos;
+        classifierParams.fovealRadii = fovealRadii;
+        classifierParams.midFovealRadii = midFovealRadii;
+        classifierParams.hysteresis = lodHysteresis;
+
+        int changed = VrsPluginApi.ClassifyLodObjects(ref classifierParams, changedHandles, changedLods, changedHandles.Length);
+        for (int i = 0; i < changed; i++)
+        {
+            groupsByHandle[changedHandles[i]].ForceLOD(changedLods[i]);
+        }
+    }
+
+    /// <summary>
+    /// Send the bounds of LOD groups whose transform changed since the last frame to the native index.
+    /// </summary>
+    private void UpdateMovedLODGroups()
+    {
+        int moved = 0;
+        for (int i = 0; i < lodGroups.Length; i++)
+        {
+            Transform groupTransform = lodGroups[i].transform;
+            if (!groupTransform.hasChanged) continue;
+
+            groupTransform.hasChanged = false;
+            CaptureBounds(lodGroups[i], moved);
+            movedHandles[moved++] = lodHandles[i];
+        }
+
+        if (moved > 0)
+        {
+            VrsPluginApi.UpdateLodObjects(movedHandles, positionX, positionY, positionZ, boundsRadius, moved);
+        }
+    }
+
     /// <summary>
     /// Returns true if (dx, dy) is within the ellipse defined by 'radii'.
     /// ellipse eq: (dx^2 / rx^2) + (dy^2 / ry^2) <= 1
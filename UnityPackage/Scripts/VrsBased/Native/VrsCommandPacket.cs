@@ -0,0 +1,95 @@
+﻿using System;
+using System.Runtime.InteropServices;
+using UnityEngine.Rendering;
+
+namespace FoveatedRenderingVRS
+{
+    /// <summary>
+    /// Render-thread operations packed into one COMMAND_PACKET event, mirrors RenderCommandPacket in RenderCommandPacket.h.
+    /// The plugin reads the packet when the render thread reaches the event, so keep it unchanged and alive
+    /// as long as command buffers that issue it may still execute.
+    /// </summary>
+    public sealed class VrsCommandPacket : IDisposable
+    {
+        public const int MAX_COMMANDS = 8;
+
+        private const int VERSION = 1;
+        private const int HEADER_SIZE = 8;    // version, count
+        private const int COMMAND_SIZE = 8;   // op, mode
+
+        private IntPtr data;
+        private int count;
+
+        public VrsCommandPacket()
+        {
+            data = Marshal.AllocHGlobal(HEADER_SIZE + MAX_COMMANDS * COMMAND_SIZE);
+            Marshal.WriteInt32(data, 0, VERSION);
+            Clear();
+        }
+
+        ~VrsCommandPacket()
+        {
+            Dispose();
+        }
+
+        /// <summary>
+        /// Unmanaged packet to pass to IssuePluginEventAndData.
+        /// </summary>
+        public IntPtr Data => data;
+
+        public int Count => count;
+
+        /// <summary>
+        /// Appends an operation, mode only applies to ENABLE where -1 picks the configured render mode,
+        /// and to SELECT_CONTEXT where it is the context. Operations start on the default context.
+        /// </summary>
+        public VrsCommandPacket Add(VrsRenderCommandOp op, int mode = -1)
+        {
+            if (data == IntPtr.Zero || count >= MAX_COMMANDS)
+            {
+                throw new InvalidOperationException("VrsCommandPacket: packet is full or disposed.");
+            }
+
+            int offset = HEADER_SIZE + count * COMMAND_SIZE;
+            Marshal.WriteInt32(data, offset, (int)op);
+            Marshal.WriteInt32(data, offset + 4, mode);
+            count++;
+            Marshal.WriteInt32(data, 4, count);
+            return this;
+        }
+
+        public VrsCommandPacket Enable(VrsRenderMode mode)
+        {
+            return Add(VrsRenderCommandOp.ENABLE, (int)mode);
+        }
+
+        public VrsCommandPacket SelectContext(int context)
+        {
+            return Add(VrsRenderCommandOp.SELECT_CONTEXT, context);
+        }
+
+        public void Clear()
+        {
+            count = 0;
+            Marshal.WriteInt32(data, 4, count);
+        }
+
+        /// <summary>
+        /// Records the packet into a command buffer.
+        /// </summary>
+        public void Issue(CommandBuffer cmd)
+        {
+            cmd.IssuePluginEventAndData(VrsPluginApi.GetRenderEventAndDataFunc(), (int)FoveatedEventID.COMMAND_PACKET, data);
+        }
+
+        public void Dispose()
+        {
+            if (data != IntPtr.Zero)
+            {
+                Marshal.FreeHGlobal(data);
+                data = IntPtr.Zero;
+            }
+            GC.SuppressFinalize(this);
+        }
+    }
+}
@@ -1,4 +1,5 @@
 ﻿using UnityEngine;
+using UnityEngine.Rendering;
 using System;
 using System.Runtime.InteropServices;
 
@@ -12,6 +13,11 @@ namespace FoveatedRenderingVRS
         [DllImport(LIBRARY_NAME)]
         public static extern IntPtr GetRenderEventFunc();
 
+        // Takes a VrsCommandPacket as data with FoveatedEventID.COMMAND_PACKET, the foveation context of
+        // plain events otherwise (see IssueContextEvent)
+        [DllImport(LIBRARY_NAME)]
+        public static extern IntPtr GetRenderEventAndDataFunc();
+
         // Foveated Rendering APIs
         [DllImport(LIBRARY_NAME)]
         public static extern bool InitializeFoveatedRendering(float verticalFov, float aspectRatio);
@@ -19,8 +25,44 @@ namespace FoveatedRenderingVRS
         [DllImport(LIBRARY_NAME)]
         public static extern void ReleaseFoveatedRendering();
 
+        // Graphics API backend picked for Unity's renderer
+        [DllImport(LIBRARY_NAME)]
+        public static extern VrsBackendType GetVrsBackendType();
+
+        // Render target size for backends that build their own shading-rate image (D3D12, Vulkan, software)
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ConfigureVrsRenderTarget(int width, int height);
+
+        // ID3D12Resource* or VkImage of the shading-rate image, for render pipelines that attach it themselves
+        [DllImport(LIBRARY_NAME)]
+        public static extern IntPtr GetNativeShadingRateImage();
+
+        // Content-adaptive rates, tiles with little detail in the previous frame are shaded coarser (D3D12, Vulkan, software)
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ConfigureContentShading(ref ContentShadingSettings settings);
+
+        // Previous frame's color at render target size, returns 0 if the backend cannot use it
+        [DllImport(LIBRARY_NAME)]
+        public static extern int SubmitContentFrame(byte[] pixels, int width, int height, int rowPitch, ContentPixelFormat format, int bottomUp);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void GetContentShadingStats(out ContentShadingStats stats);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void SetRenderMode(VrsRenderMode mode);
+
+        // Replaces presets, radii and rates at once, the render thread picks them up together
         [DllImport(LIBRARY_NAME)]
-        public static extern void SetRenderMode(RenderMode mode);
+        public static extern void SubmitVrsConfiguration(ref VrsConfiguration config);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void GetVrsConfiguration(out VrsConfiguration config);
+
+        // Submits an entry of a preset file written by the PresetOptimizer tool under the CUSTOM presets,
+        // config receives the submitted configuration. False if the file or entry cannot be read.
+        [DllImport(LIBRARY_NAME)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool LoadFoveationPreset([MarshalAs(UnmanagedType.LPStr)] string path, int index, out VrsConfiguration config);
 
         [DllImport(LIBRARY_NAME)]
         public static extern void SetFoveationPatternPreset(ShadingPatternPreset preset);
@@ -36,5 +78,209 @@ namespace FoveatedRenderingVRS
 
         [DllImport(LIBRARY_NAME)]
         public static extern void UpdateGazeDirection(Vector3 gazeDir);
+
+        // Per-eye gaze directions in view space, ignored while the gaze receiver runs
+        [DllImport(LIBRARY_NAME)]
+        public static extern void UpdateStereoGazeDirection(Vector3 leftGazeDir, Vector3 rightGazeDir);
+
+        // Asymmetric per-eye projection, tangents of the frustum half angles (left and down are negative)
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ConfigureViewFrustum(Eye eye, float tanLeft, float tanRight, float tanUp, float tanDown);
+
+        // Gaze latency compensation (velocities in normalized gaze units per second)
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ConfigureGazePrediction([MarshalAs(UnmanagedType.I1)] bool enabled, float latencyMs, float saccadeVelocityThreshold,
+                                                          float fixationVelocityThreshold, float maxPredictionDistance);
+
+        // Gaze filter chain, stages run in the given order
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ConfigureGazeFilters(GazeFilterType[] types, int count, GazeFilterSettings settings);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern EyeMovementState GetEyeMovementState();
+
+        // Normalized gaze location in NVAPI space ([-0.5, 0.5], +y up)
+        [DllImport(LIBRARY_NAME)]
+        public static extern Vector2 GetGazePosition();
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern Vector2 GetEyeGazePosition(Eye eye);
+
+        // Native binary gaze receiver, UpdateGazeDirection is ignored while it runs
+        [DllImport(LIBRARY_NAME)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool StartGazeReceiver(int port);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void StopGazeReceiver();
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void GetGazeReceiverStats(out GazeReceiverStats stats);
+
+        // Native reader of the shared-memory ring published by the GazeTracking tools (BeamSDK), attaches once
+        // the publisher runs. UpdateGazeDirection is ignored while it runs, the gaze receiver cannot run alongside.
+        [DllImport(LIBRARY_NAME)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool StartSharedGazeReader([MarshalAs(UnmanagedType.LPStr)] string name);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void StopSharedGazeReader();
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void GetSharedGazeReaderStats(out SharedGazeReaderStats stats);
+
+        // Motion-to-photon latency, frames are closed by FoveatedEventID.PRESENT_FRAME
+        [DllImport(LIBRARY_NAME)]
+        public static extern void GetGazeLatencyStats(out GazeLatencyStats stats);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ResetGazeLatencyStats();
+
+        // Shading Rate Image (one ShadingRate byte per tile, row-major, top row first)
+        [DllImport(LIBRARY_NAME)]
+        public static extern int UpdateShadingRateImage(int width, int height, int tileSize, byte[] buffer, int bufferSize);
+
+        // Frame-time governor, the default context follows it from the next ENABLE_FOVEATED_RENDERING event
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ConfigureFoveationGovernor(ref FoveationGovernorSettings settings);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void SubmitFrameTime(float frameTimeMs);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void GetFoveationGovernorState(out FoveationGovernorState state);
+
+        // Shading cost of the current foveation for a render target and gaze in NVAPI space
+        [DllImport(LIBRARY_NAME)]
+        public static extern void QueryShadingCost(int width, int height, int tileSize, float gazeX, float gazeY, out ShadingCostEstimate estimate);
+
+        // Per-frame shading cost log, recorded on FoveatedEventID.PRESENT_FRAME, a width of 0 disables it
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ConfigureShadingCostTelemetry(int width, int height, int tileSize);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void GetShadingCostTelemetry(out ShadingCostTelemetryStats stats);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ResetShadingCostTelemetry();
+
+        // Render-thread instrumentation, WriteInstrumentationTrace returns the number of events written or -1
+        [DllImport(LIBRARY_NAME)]
+        public static extern void GetInstrumentationStats(out InstrumentationStats stats);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ResetInstrumentationStats();
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void SetInstrumentationTracing([MarshalAs(UnmanagedType.I1)] bool enabled);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern int WriteInstrumentationTrace([MarshalAs(UnmanagedType.LPStr)] string path);
+
+        // Foveated LOD levels of a batch of LODGroups in structure-of-arrays layout. lods holds the current
+        // levels (-1 for none) and is updated in place, the indices of the changed groups are written to
+        // changed and their number returned.
+        [DllImport(LIBRARY_NAME)]
+        public static extern int ClassifyFoveatedLods(ref LodClassifierParams parameters,
+            float[] positionX, float[] positionY, float[] positionZ, float[] radius,
+            int[] coarsestLod, int[] lods, int count, int[] changed, int changedCapacity);
+
+        // Persistent LOD objects in a screen-space grid, ClassifyLodObjects only reclassifies moved objects and
+        // objects near an ellipse boundary while the camera stays put, and writes the changed handles and levels
+        [DllImport(LIBRARY_NAME)]
+        public static extern void InsertLodObjects(float[] positionX, float[] positionY, float[] positionZ, float[] radius,
+            int[] coarsestLod, int count, int[] handles);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void UpdateLodObjects(int[] handles, float[] positionX, float[] positionY, float[] positionZ,
+            float[] radius, int count);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void RemoveLodObjects(int[] handles, int count);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ClearLodObjects();
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern int ClassifyLodObjects(ref LodClassifierParams parameters, int[] changedHandles, int[] changedLods, int capacity);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void GetLodSpatialIndexStats(out LodSpatialIndexStats stats);
+
+        // Session trace of gaze, camera poses, frame times and configuration changes (.vrstrace), replayed
+        // offline by CameraRouteBenchmark. Gaze and configuration changes are recorded natively, the camera
+        // pose and frame time are recorded once per frame by RecordTraceFrame.
+        [DllImport(LIBRARY_NAME)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool StartTraceRecording([MarshalAs(UnmanagedType.LPStr)] string path);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void StopTraceRecording();
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void RecordTraceFrame(ref Vector3 cameraPosition, ref Quaternion cameraRotation, float frameTimeMs);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void GetTraceRecordingStats(out TraceWriterStats stats);
+
+        // Foveation contexts, one per camera or view with its own FOV, render target, configuration and gaze.
+        // The APIs above act on the default context 0, gaze filtering and prediction apply to every context.
+        // The governor and the shading cost log follow the default context only. VrsSecondaryCamera drives one.
+        // CreateFoveationContext returns -1 once all contexts are in use.
+        [DllImport(LIBRARY_NAME)]
+        public static extern int CreateFoveationContext();
+
+        // The context is released on the render thread, the default context cannot be destroyed
+        [DllImport(LIBRARY_NAME)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool DestroyFoveationContext(int context);
+
+        // Enable events on a disabled context shade its view at full rate
+        [DllImport(LIBRARY_NAME)]
+        public static extern void SetFoveationContextEnabled(int context, [MarshalAs(UnmanagedType.I1)] bool enabled);
+
+        [DllImport(LIBRARY_NAME)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool IsFoveationContextEnabled(int context);
+
+        [DllImport(LIBRARY_NAME)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool InitializeContextFoveatedRendering(int context, float verticalFov, float aspectRatio);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ReleaseContextFoveatedRendering(int context);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ConfigureContextRenderTarget(int context, int width, int height);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern IntPtr GetContextShadingRateImage(int context);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void SubmitContextConfiguration(int context, ref VrsConfiguration config);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void GetContextConfiguration(int context, out VrsConfiguration config);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void SetContextRenderMode(int context, VrsRenderMode mode);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void ConfigureContextViewFrustum(int context, Eye eye, float tanLeft, float tanRight, float tanUp, float tanDown);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void UpdateContextGazeDirection(int context, Vector3 gazeDir);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern void UpdateContextStereoGazeDirection(int context, Vector3 leftGazeDir, Vector3 rightGazeDir);
+
+        [DllImport(LIBRARY_NAME)]
+        public static extern Vector2 GetContextGazePosition(int context, Eye eye);
+
+        // Records a plain event addressed to a context, command packets select theirs with VrsCommandPacket.SelectContext
+        public static void IssueContextEvent(CommandBuffer cmd, FoveatedEventID eventID, int context)
+        {
+            cmd.IssuePluginEventAndData(GetRenderEventAndDataFunc(), (int)eventID, new IntPtr(context));
+        }
     }
 }
\ No newline at end of file
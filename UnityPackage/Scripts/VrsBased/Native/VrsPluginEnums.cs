@@ -1,4 +1,4 @@
-namespace FoveatedRenderingVRS
+﻿namespace FoveatedRenderingVRS
 {
 
     /// <summary>
@@ -8,7 +8,55 @@ namespace FoveatedRenderingVRS
     {
         ENABLE_FOVEATED_RENDERING,
         DISABLE_FOVEATED_RENDERING,
-        UPDATE_GAZE
+        UPDATE_GAZE,
+        PRESENT_FRAME,  // Issue at the end of the frame to close motion-to-photon accounting
+        ENABLE_FOVEATED_RENDERING_LEFT_EYE,   // Multi-pass stereo, left eye pass
+        ENABLE_FOVEATED_RENDERING_RIGHT_EYE,  // Multi-pass stereo, right eye pass
+        COMMAND_PACKET                        // VrsCommandPacket, issue with IssuePluginEventAndData
+    };
+
+    /// <summary>
+    /// Operations of a VrsCommandPacket.
+    /// </summary>
+    public enum VrsRenderCommandOp
+    {
+        LATCH_GAZE,            // Same as UPDATE_GAZE
+        LATCH_CONFIGURATION,   // Adopt the submitted configuration, and on the default context the governor's foveation, now
+        ENABLE,                // Foveate the views of the command's mode
+        DISABLE,               // Same as DISABLE_FOVEATED_RENDERING
+        PRESENT_FRAME,         // Same as PRESENT_FRAME
+        SELECT_CONTEXT         // Run the following operations on the foveation context in mode
+    };
+
+    /// <summary>
+    /// Views foveated by ENABLE_FOVEATED_RENDERING.
+    /// </summary>
+    public enum VrsRenderMode
+    {
+        MONO,       // Single view, one gaze point
+        LEFT_EYE,   // Left eye only
+        RIGHT_EYE,  // Right eye only
+        STEREO      // Both eyes in one pass (double-wide or single-pass instanced)
+    };
+
+    /// <summary>
+    /// Graphics APIs served by a native VRS backend.
+    /// </summary>
+    public enum VrsBackendType
+    {
+        SOFTWARE,      // No device, rate maps are only built and recorded
+        NVAPI_D3D11,   // NVIDIA VRS helper on Direct3D 11
+        D3D12,         // Direct3D 12 VRS tier 2 shading-rate image
+        VULKAN         // VK_KHR_fragment_shading_rate attachment
+    };
+
+    /// <summary>
+    /// Eyes of a stereo view.
+    /// </summary>
+    public enum Eye
+    {
+        LEFT,
+        RIGHT
     };
 
     /// <summary>
@@ -65,4 +113,47 @@ namespace FoveatedRenderingVRS
         REDUCTION_2X4,      // 1 shading pass / 8 pixels
         REDUCTION_4X4       // 1 shading pass / 16 pixels
     };
-}
+
+    /// <summary>
+    /// Eye movement states reported by the native gaze filter chain.
+    /// </summary>
+    public enum EyeMovementState
+    {
+        FIXATION,
+        PURSUIT,
+        SACCADE
+    };
+
+    /// <summary>
+    /// Stages of the native gaze filter chain.
+    /// </summary>
+    public enum GazeFilterType
+    {
+        DEAD_ZONE,      // Ignore movements below a threshold (legacy behaviour)
+        ONE_EURO,       // Adaptive low-pass, smooth at rest and responsive in motion
+        KALMAN,         // Constant-velocity Kalman filter
+        FIXATION_IVT,   // Velocity-threshold fixation/saccade classifier
+        FIXATION_IDT    // Dispersion-threshold fixation/saccade classifier
+    };
+
+    /// <summary>
+    /// Stages of the native motion-to-photon latency accounting.
+    /// </summary>
+    public enum LatencyStage
+    {
+        CAPTURE_TO_RECEIVE,  // Tracker capture until the plugin received the sample
+        RECEIVE_TO_LATCH,    // Plugin receipt until the render thread latched the sample
+        LATCH_TO_PRESENT,    // Render thread latch until the frame was submitted for present
+        CAPTURE_TO_PRESENT,  // End to end, tracker capture until present
+        COUNT
+    };
+
+    /// <summary>
+    /// Pixel layouts of a color buffer handed to the content-adaptive shading.
+    /// </summary>
+    public enum ContentPixelFormat
+    {
+        RGBA8,   // Four bytes per pixel, red first
+        BGRA8    // Four bytes per pixel, blue first
+    };
+}
\ No newline at end of file
@@ -0,0 +1,304 @@
+﻿using System.Runtime.InteropServices;
+using UnityEngine;
+
+namespace FoveatedRenderingVRS
+{
+    /// <summary>
+    /// Tunables of the native gaze filter chain, mirrors GazeFilterSettings in GazeFilters.h.
+    /// Velocities are in normalized gaze units per second.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GazeFilterSettings
+    {
+        public float deadZoneThreshold;
+
+        public float oneEuroMinCutoff;
+        public float oneEuroBeta;
+        public float oneEuroDerivateCutoff;
+
+        public float kalmanProcessNoise;
+        public float kalmanMeasurementNoise;
+
+        public float saccadeVelocityThreshold;
+        public float pursuitVelocityThreshold;
+
+        public float dispersionThreshold;
+        public float dispersionWindowMs;
+
+        public static GazeFilterSettings Default => new GazeFilterSettings
+        {
+            deadZoneThreshold = 0.05f,
+            oneEuroMinCutoff = 1.0f,
+            oneEuroBeta = 0.5f,
+            oneEuroDerivateCutoff = 1.0f,
+            kalmanProcessNoise = 50.0f,
+            kalmanMeasurementNoise = 1e-4f,
+            saccadeVelocityThreshold = 1.5f,
+            pursuitVelocityThreshold = 0.1f,
+            dispersionThreshold = 0.02f,
+            dispersionWindowMs = 100.0f
+        };
+    }
+
+    /// <summary>
+    /// Counters of the native gaze receiver, mirrors GazeReceiverStats in GazeReceiver.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GazeReceiverStats
+    {
+        public ulong packetsReceived;
+        public ulong packetsRejected;
+        public ulong batches;
+        public ulong foreignClockPackets;
+    }
+
+    /// <summary>
+    /// Counters of the native shared-memory gaze reader, mirrors SharedGazeReaderStats in SharedGazeReader.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct SharedGazeReaderStats
+    {
+        public ulong samplesRead;
+        public ulong samplesInvalid;
+        public ulong samplesDropped;
+        public ulong wakeups;
+        public ulong foreignClockSamples;
+        public ulong attachments;
+    }
+
+    /// <summary>
+    /// Latency histogram of one stage in microseconds, mirrors LatencySummary in LatencyStats.h.
+    /// Percentiles are resolved to the upper bound of their log2 bucket.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct LatencySummary
+    {
+        public ulong count;
+        public ulong minUs;
+        public ulong maxUs;
+        public ulong meanUs;
+        public ulong p50Us;
+        public ulong p95Us;
+        public ulong p99Us;
+
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 32)]
+        public ulong[] buckets;
+    }
+
+    /// <summary>
+    /// Latency of every gaze stage, indexed by LatencyStage, mirrors GazeLatencyStats in LatencyStats.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GazeLatencyStats
+    {
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = (int)LatencyStage.COUNT)]
+        public LatencySummary[] stages;
+    }
+
+    /// <summary>
+    /// Shading work of one frame, mirrors ShadingCostEstimate in ShadingCostModel.h.
+    /// Coverage arrays are indexed by TargetArea.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ShadingCostEstimate
+    {
+        public ulong pixels;
+
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 3)]
+        public float[] regionCoverage;      // Snapped to the shading-rate tiles
+
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 3)]
+        public float[] analyticCoverage;    // Exact ellipses
+
+        public double invocations;
+        public float relativeCost;          // 1 for full-rate shading
+        public float savedFraction;         // Negative when supersampling
+    }
+
+    /// <summary>
+    /// Accumulated savings of one preset combination, mirrors PresetSavings in ShadingCostModel.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PresetSavings
+    {
+        public ulong frames;
+        public double meanRelativeCost;
+        public double meanSavedFraction;
+    }
+
+    /// <summary>
+    /// Per-frame shading cost log, mirrors ShadingCostTelemetryStats in ShadingCostModel.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ShadingCostTelemetryStats
+    {
+        public const int PATTERN_PRESETS = (int)ShadingPatternPreset.SHADING_PATTERN_MAX;
+
+        public ulong frames;
+        public ShadingCostEstimate lastFrame;
+
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = (int)ShadingRatePreset.SHADING_RATE_MAX * (int)ShadingPatternPreset.SHADING_PATTERN_MAX)]
+        public PresetSavings[] presets;
+
+        public PresetSavings GetPresetSavings(ShadingRatePreset ratePreset, ShadingPatternPreset patternPreset)
+        {
+            return presets[((int)ratePreset - 1) * PATTERN_PRESETS + (int)patternPreset - 1];
+        }
+    }
+
+    /// <summary>
+    /// Explicit foveation regions and rates, mirrors FoveationDesc in Foveation.h.
+    /// Radii are in normalized gaze space where the screen spans [-0.5, 0.5].
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct FoveationDesc
+    {
+        public Vector2 innerRadii;
+        public Vector2 middleRadii;
+        public Vector2 peripheralRadii;
+        public ShadingRate innerRate;
+        public ShadingRate middleRate;
+        public ShadingRate peripheralRate;
+    }
+
+    /// <summary>
+    /// Complete VRS configuration submitted in one call, mirrors VrsConfiguration in VrsManager.h.
+    /// Custom radii and rates only take effect under the CUSTOM presets.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct VrsConfiguration
+    {
+        public ShadingRatePreset shadingRatePreset;
+        public ShadingPatternPreset foveationPatternPreset;
+        public Vector2 innerRadii;
+        public Vector2 middleRadii;
+        public Vector2 peripheralRadii;
+        public ShadingRate innerRate;
+        public ShadingRate middleRate;
+        public ShadingRate peripheralRate;
+    }
+
+    /// <summary>
+    /// Settings of the native frame-time governor, mirrors FoveationGovernorSettings in FoveationGovernor.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct FoveationGovernorSettings
+    {
+        [MarshalAs(UnmanagedType.I1)]
+        public bool enabled;
+        public float targetFrameTimeMs;
+        public float hysteresis;        // Relative dead band around the target
+        public float smoothing;         // Weight of a new frame time in the moving average
+        public int holdFrames;          // Minimum frames between two adjustments
+        public float maxStep;           // Largest quality change per adjustment
+        public FoveationDesc lowestQuality;
+        public FoveationDesc highestQuality;
+    }
+
+    /// <summary>
+    /// Observable state of the native frame-time governor, mirrors FoveationGovernorState in FoveationGovernor.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct FoveationGovernorState
+    {
+        public float quality;           // 0 at lowestQuality, 1 at highestQuality
+        public float smoothedFrameTimeMs;
+        public ulong adjustments;
+        public FoveationDesc foveation;
+    }
+
+    /// <summary>
+    /// Counters of one instrumented render-thread scope, mirrors ScopeStats in Instrumentation.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ScopeStats
+    {
+        public ulong calls;
+        public ulong failures;
+        public ulong skipped;
+        public ulong totalNs;
+        public ulong maxNs;
+    }
+
+    /// <summary>
+    /// Native instrumentation counters, mirrors InstrumentationStats in Instrumentation.h.
+    /// The scopes are spelled out in TraceScope order so reading the block does not allocate.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct InstrumentationStats
+    {
+        public ScopeStats handleEvent;
+        public ScopeStats gazeRefresh;
+        public ScopeStats gazeLatch;
+        public ScopeStats enable;
+        public ScopeStats disable;
+        public ulong traceEvents;           // Events recorded since tracing was started
+        public ulong traceEventsDropped;    // Of those, overwritten before they could be written out
+        public int lastNativeError;         // Latest backend failure (NvAPI_Status, HRESULT or VkResult)
+        public int tracing;                 // Non-zero while trace events are recorded
+    }
+
+    /// <summary>
+    /// View and foveation a LOD batch is classified against, mirrors LodClassifierParams in LodClassifier.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct LodClassifierParams
+    {
+        public Matrix4x4 viewProjection;    // projectionMatrix * worldToCameraMatrix
+        public Vector2 gazePos;             // Normalized screen coordinates [-1, 1], y up
+        public Vector2 fovealRadii;
+        public Vector2 midFovealRadii;
+        public float hysteresis;            // Relative margin an object has to cross a boundary by to change level
+    }
+
+    /// <summary>
+    /// Work done by the last LOD spatial index update, mirrors LodSpatialIndexStats in LodSpatialIndex.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct LodSpatialIndexStats
+    {
+        public int objects;
+        public int candidates;              // Objects reclassified by the last update
+        public int cellsVisited;            // Grid cells in the boundary band of the last update
+        public int fullUpdate;              // Non-zero if the last update reclassified every object
+        public ulong fullUpdates;
+        public ulong incrementalUpdates;
+    }
+
+    /// <summary>
+    /// Size of the session trace recorded so far, mirrors TraceWriterStats in TraceWriter.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TraceWriterStats
+    {
+        public ulong records;
+        public ulong bytes;                 // Written to the file, the open chunk excluded
+        public uint chunks;
+        public int recording;               // Non-zero while a trace is open
+    }
+
+    /// <summary>
+    /// Settings of the native content-adaptive shading rates, mirrors ContentShadingSettings in ContentAdaptiveShading.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ContentShadingSettings
+    {
+        [MarshalAs(UnmanagedType.I1)]
+        public bool enabled;
+        public float threshold;             // RMS luma difference of neighbouring pixels (8-bit code values) a halved rate may hide, inner region
+        public float middleScale;           // Threshold multiplier in the middle region
+        public float peripheralScale;       // Threshold multiplier outside the middle region
+    }
+
+    /// <summary>
+    /// Counters of the native content analysis, mirrors ContentShadingStats in ContentAdaptiveShading.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ContentShadingStats
+    {
+        public ulong framesAnalyzed;
+        public float lastAnalysisMs;
+        public int blocksX;                 // 8x8 pixel block grid of the last analyzed frame
+        public int blocksY;
+    }
+}
@@ -32,6 +32,11 @@ namespace FoveatedRenderingVRS_BIRP
         private Camera mainCamera = null;
         private VrsBirpCommandBufferManager bufferManager = new VrsBirpCommandBufferManager();
 
+        // Latches gaze and enables in one render-thread callback, read by the enable buffers every frame
+        private readonly VrsCommandPacket enablePacket = new VrsCommandPacket()
+            .Add(VrsRenderCommandOp.LATCH_GAZE)
+            .Add(VrsRenderCommandOp.ENABLE);
+
         private bool renderingInitialized = false;
         private bool renderingActive = false;
 
@@ -52,6 +57,14 @@ namespace FoveatedRenderingVRS_BIRP
         [SerializeField]
         private ShadingRate peripheralRate = ShadingRate.REDUCTION_4X4;
 
+        [Header("Preset File")]
+        [Tooltip("Preset file written by the PresetOptimizer tool, relative to StreamingAssets. Empty keeps the radii and rates above.")]
+        [SerializeField]
+        private string foveationPresetFile = "";
+        [Tooltip("Entry of the preset file to start with, entries are sorted from cheapest to best quality.")]
+        [SerializeField]
+        private int foveationPresetIndex = 0;
+
         [SerializeField]
         private bool enableZoneVisualizer = true;
         
@@ -100,14 +113,7 @@ namespace FoveatedRenderingVRS_BIRP
             if (renderingInitialized)
             {
                 currentShadingPreset = preset.ClampValue(ShadingRatePreset.SHADING_RATE_HIGHEST_PERFORMANCE, ShadingRatePreset.SHADING_RATE_MAX);
-                VrsPluginApi.SetShadingRatePreset(currentShadingPreset);
-
-                if (currentShadingPreset == ShadingRatePreset.SHADING_RATE_CUSTOM)
-                {
-                    AssignShadingRate(TargetArea.INNER, innerRate);
-                    AssignShadingRate(TargetArea.MIDDLE, middleRate);
-                    AssignShadingRate(TargetArea.PERIPHERAL, peripheralRate);
-                }
+                SubmitConfiguration();
 
                 GL.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.UPDATE_GAZE);
             }
@@ -123,14 +129,7 @@ namespace FoveatedRenderingVRS_BIRP
             if (renderingInitialized)
             {
                 currentPatternPreset = preset.ClampValue(ShadingPatternPreset.SHADING_PATTERN_WIDE, ShadingPatternPreset.SHADING_PATTERN_MAX);
-                VrsPluginApi.SetFoveationPatternPreset(currentPatternPreset);
-
-                if (currentPatternPreset == ShadingPatternPreset.SHADING_PATTERN_CUSTOM)
-                {
-                    AssignRegionRadius(TargetArea.INNER, innerRadius);
-                    AssignRegionRadius(TargetArea.MIDDLE, middleRadius);
-                    AssignRegionRadius(TargetArea.PERIPHERAL, peripheralRadius);
-                }
+                SubmitConfiguration();
 
                 GL.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.UPDATE_GAZE);
             }
@@ -159,11 +158,58 @@ namespace FoveatedRenderingVRS_BIRP
                         break;
                 }
 
-                VrsPluginApi.ConfigureShadingRate(area, clampedRate);
+                SubmitConfiguration();
                 GL.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.UPDATE_GAZE);
             }
         }
 
+        /// <summary>
+        /// Adopts the configured entry of the preset file as the custom radii and rates.
+        /// </summary>
+        private void LoadFoveationPresetFile()
+        {
+            if (string.IsNullOrEmpty(foveationPresetFile))
+            {
+                return;
+            }
+
+            string path = System.IO.Path.Combine(Application.streamingAssetsPath, foveationPresetFile);
+            VrsConfiguration config;
+            if (!VrsPluginApi.LoadFoveationPreset(path, foveationPresetIndex, out config))
+            {
+                Debug.LogWarning("VrsBirpController: Cannot load entry " + foveationPresetIndex + " of preset file " + path);
+                return;
+            }
+
+            currentShadingPreset = config.shadingRatePreset;
+            currentPatternPreset = config.foveationPatternPreset;
+            innerRadius = config.innerRadii;
+            middleRadius = config.middleRadii;
+            peripheralRadius = config.peripheralRadii;
+            innerRate = config.innerRate;
+            middleRate = config.middleRate;
+            peripheralRate = config.peripheralRate;
+        }
+
+        /// <summary>
+        /// Sends presets, radii and rates to the plugin as one configuration.
+        /// </summary>
+        private void SubmitConfiguration()
+        {
+            var config = new VrsConfiguration
+            {
+                shadingRatePreset = currentShadingPreset,
+                foveationPatternPreset = currentPatternPreset,
+                innerRadii = innerRadius,
+                middleRadii = middleRadius,
+                peripheralRadii = peripheralRadius,
+                innerRate = innerRate,
+                middleRate = middleRate,
+                peripheralRate = peripheralRate
+            };
+            VrsPluginApi.SubmitVrsConfiguration(ref config);
+        }
+
         public ShadingRate GetShadingRate(TargetArea area)
         {
             switch (area)
@@ -201,7 +247,7 @@ namespace FoveatedRenderingVRS_BIRP
                         break;
                 }
 
-                VrsPluginApi.ConfigureRegionRadii(area, clampedRadii);
+                SubmitConfiguration();
                 GL.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.UPDATE_GAZE);
                 
                 // Update ZoneVisualizer radii if INNER or MIDDLE
@@ -236,14 +282,30 @@ namespace FoveatedRenderingVRS_BIRP
         {
 
             mainCamera = GetComponent<Camera>();
+            VrsPluginApi.SetRenderMode(mainCamera.stereoEnabled ? VrsRenderMode.STEREO : VrsRenderMode.MONO);
+            if (mainCamera.stereoEnabled)
+            {
+                // Double-wide eye texture
+                VrsPluginApi.ConfigureVrsRenderTarget(UnityEngine.XR.XRSettings.eyeTextureWidth * 2, UnityEngine.XR.XRSettings.eyeTextureHeight);
+            }
+            else
+            {
+                VrsPluginApi.ConfigureVrsRenderTarget(mainCamera.pixelWidth, mainCamera.pixelHeight);
+            }
             renderingInitialized = VrsPluginApi.InitializeFoveatedRendering(mainCamera.fieldOfView, mainCamera.aspect);
             if (renderingInitialized)
             {
+                if (mainCamera.stereoEnabled)
+                {
+                    ConfigureEyeFrustum(Eye.LEFT, mainCamera.GetStereoProjectionMatrix(Camera.StereoscopicEye.Left));
+                    ConfigureEyeFrustum(Eye.RIGHT, mainCamera.GetStereoProjectionMatrix(Camera.StereoscopicEye.Right));
+                }
+
                 var currentPath = mainCamera.actualRenderingPath;
                 if (currentPath == RenderingPath.Forward)
                 {
                     bufferManager.AddCommandBuffer("Enable Foveated Rendering", CameraEvent.BeforeForwardOpaque,
-                        cmd => cmd.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.ENABLE_FOVEATED_RENDERING),
+                        cmd => enablePacket.Issue(cmd),
                         cmd => cmd.ClearRenderTarget(false, true, Color.black));
 
                     bufferManager.AddCommandBuffer("Disable Foveated Rendering", CameraEvent.AfterForwardAlpha,
@@ -252,14 +314,14 @@ namespace FoveatedRenderingVRS_BIRP
                 else if (currentPath == RenderingPath.DeferredShading)
                 {
                     bufferManager.AddCommandBuffer("Enable Foveated Rendering - GBuffer", CameraEvent.BeforeGBuffer,
-                        cmd => cmd.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.ENABLE_FOVEATED_RENDERING),
+                        cmd => enablePacket.Issue(cmd),
                         cmd => cmd.ClearRenderTarget(false, true, Color.black));
 
                     bufferManager.AddCommandBuffer("Disable Foveated Rendering - GBuffer", CameraEvent.AfterGBuffer,
                         cmd => cmd.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.DISABLE_FOVEATED_RENDERING));
 
                     bufferManager.AddCommandBuffer("Enable Foveated Rendering - Alpha", CameraEvent.BeforeForwardAlpha,
-                        cmd => cmd.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.ENABLE_FOVEATED_RENDERING));
+                        cmd => enablePacket.Issue(cmd));
 
                     bufferManager.AddCommandBuffer("Disable Foveated Rendering - Alpha", CameraEvent.AfterForwardAlpha,
                         cmd => cmd.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.DISABLE_FOVEATED_RENDERING));
@@ -268,14 +330,26 @@ namespace FoveatedRenderingVRS_BIRP
                 ToggleFoveatedRendering(true);
                 bool isGazeAttached = VrsGazeUpdater.AttachGazeUpdater(gameObject);
 
-                ConfigureShadingRatePreset(currentShadingPreset);
-                ConfigureShadingPatternPreset(currentPatternPreset);
+                LoadFoveationPresetFile();
+                SubmitConfiguration();
 
                 VrsPluginApi.UpdateGazeDirection(new Vector3(0.0f, 0.0f, 1.0f));
                 GL.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.UPDATE_GAZE);
             }
         }
         
+        /// <summary>
+        /// Passes the asymmetric frustum of an eye projection to the plugin.
+        /// </summary>
+        private static void ConfigureEyeFrustum(Eye eye, Matrix4x4 projection)
+        {
+            VrsPluginApi.ConfigureViewFrustum(eye,
+                (projection.m02 - 1.0f) / projection.m00,
+                (projection.m02 + 1.0f) / projection.m00,
+                (projection.m12 + 1.0f) / projection.m11,
+                (projection.m12 - 1.0f) / projection.m11);
+        }
+
         void Update()
         {
             if (renderingInitialized && if enableZoneVisualizer && zoneVisualizer != null)
@@ -304,6 +378,12 @@ namespace FoveatedRenderingVRS_BIRP
             }
         }
 
+        void OnDestroy()
+        {
+            // Outlives OnDisable, frames queued before the buffers were removed may still read it
+            enablePacket.Dispose();
+        }
+
         void OnPreRender()
         {
         }
@@ -0,0 +1,146 @@
+﻿// VrsBased/Scripts/VrsContentAdaptiveShading.cs
+
+using System.Collections;
+using Unity.Collections;
+using UnityEngine;
+using UnityEngine.Rendering;
+
+namespace FoveatedRenderingVRS
+{
+    /// <summary>
+    /// Reads every presented frame back asynchronously and hands it to the native
+    /// content-adaptive shading, which shades tiles with little detail coarser than
+    /// their foveation region asks for. The rates follow the content a frame or two
+    /// late, which the flat regions they coarsen hide well. The screen is captured,
+    /// so this serves mono rendering at screen resolution.
+    /// </summary>
+    public class VrsContentAdaptiveShading : MonoBehaviour
+    {
+        [SerializeField, Range(0.5f, 16.0f), Tooltip("RMS luma difference of neighbouring pixels (0-255) a halved rate may hide near the gaze")]
+        private float threshold = 3.0f;
+
+        [SerializeField, Range(1.0f, 8.0f)]
+        private float middleScale = 2.0f;
+
+        [SerializeField, Range(1.0f, 16.0f)]
+        private float peripheralScale = 4.0f;
+
+        public ContentShadingStats Stats { get; private set; }
+
+        private RenderTexture capture;
+        private byte[] pixels;
+        private bool readbackPending;
+        private Coroutine captureLoop;
+
+        private void OnEnable()
+        {
+            // The NVAPI helper takes no shading-rate image, reading frames back would only cost time
+            if (VrsPluginApi.GetVrsBackendType() == VrsBackendType.NVAPI_D3D11)
+            {
+                DisableUnsupported();
+                return;
+            }
+
+            Configure(true);
+            captureLoop = StartCoroutine(CaptureFrames());
+        }
+
+        private void OnDisable()
+        {
+            if (captureLoop != null)
+            {
+                StopCoroutine(captureLoop);
+                captureLoop = null;
+            }
+            Configure(false);
+
+            if (capture != null)
+            {
+                capture.Release();
+                Destroy(capture);
+                capture = null;
+            }
+        }
+
+        private void OnValidate()
+        {
+            if (isActiveAndEnabled)
+            {
+                Configure(true);
+            }
+        }
+
+        private IEnumerator CaptureFrames()
+        {
+            var endOfFrame = new WaitForEndOfFrame();
+            while (true)
+            {
+                yield return endOfFrame;
+
+                // One readback in flight, a slow GPU skips frames instead of queueing them
+                if (readbackPending || !SystemInfo.supportsAsyncGPUReadback)
+                {
+                    continue;
+                }
+
+                if (capture == null || capture.width != Screen.width || capture.height != Screen.height)
+                {
+                    if (capture != null)
+                    {
+                        capture.Release();
+                        Destroy(capture);
+                    }
+                    capture = new RenderTexture(Screen.width, Screen.height, 0, RenderTextureFormat.ARGB32);
+                }
+
+                ScreenCapture.CaptureScreenshotIntoRenderTexture(capture);
+                readbackPending = true;
+                AsyncGPUReadback.Request(capture, 0, TextureFormat.RGBA32, OnReadback);
+            }
+        }
+
+        private void OnReadback(AsyncGPUReadbackRequest request)
+        {
+            readbackPending = false;
+            if (request.hasError || !isActiveAndEnabled)
+            {
+                return;
+            }
+
+            NativeArray<byte> data = request.GetData<byte>();
+            if (pixels == null || pixels.Length != data.Length)
+            {
+                pixels = new byte[data.Length];
+            }
+            data.CopyTo(pixels);
+
+            // Screen captures come out bottom row first where UVs start at the bottom (OpenGL-like APIs)
+            int bottomUp = SystemInfo.graphicsUVStartsAtTop ? 0 : 1;
+            if (VrsPluginApi.SubmitContentFrame(pixels, request.width, request.height, request.width * 4, ContentPixelFormat.RGBA8, bottomUp) == 0)
+            {
+                DisableUnsupported();
+                return;
+            }
+            VrsPluginApi.GetContentShadingStats(out ContentShadingStats stats);
+            Stats = stats;
+        }
+
+        private void DisableUnsupported()
+        {
+            Debug.LogWarning("VrsContentAdaptiveShading: The " + VrsPluginApi.GetVrsBackendType() + " backend has no content-adaptive shading, disabling.");
+            enabled = false;
+        }
+
+        private void Configure(bool enable)
+        {
+            var settings = new ContentShadingSettings
+            {
+                enabled = enable,
+                threshold = threshold,
+                middleScale = middleScale,
+                peripheralScale = peripheralScale
+            };
+            VrsPluginApi.ConfigureContentShading(ref settings);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+﻿// VrsBased/Scripts/VrsFoveationGovernor.cs
+
+using UnityEngine;
+
+namespace FoveatedRenderingVRS
+{
+    /// <summary>
+    /// Feeds frame times to the native governor, which trades foveation quality
+    /// for frame time between the two configured bounds.
+    /// </summary>
+    public class VrsFoveationGovernor : MonoBehaviour
+    {
+        [SerializeField]
+        private float targetFrameRate = 90.0f;
+
+        [SerializeField, Range(0.0f, 0.5f)]
+        private float hysteresis = 0.05f;
+
+        [SerializeField, Range(0.01f, 1.0f)]
+        private float smoothing = 0.1f;
+
+        [SerializeField]
+        private int holdFrames = 15;
+
+        [SerializeField, Range(0.001f, 1.0f)]
+        private float maxStep = 0.1f;
+
+        [Header("Lowest Quality")]
+        [SerializeField]
+        private Vector2 lowestInnerRadii = new Vector2(0.20f, 0.20f);
+        [SerializeField]
+        private Vector2 lowestMiddleRadii = new Vector2(0.33f, 0.33f);
+        [SerializeField]
+        private ShadingRate lowestInnerRate = ShadingRate.NORMAL;
+        [SerializeField]
+        private ShadingRate lowestMiddleRate = ShadingRate.REDUCTION_2X2;
+        [SerializeField]
+        private ShadingRate lowestPeripheralRate = ShadingRate.REDUCTION_4X4;
+
+        [Header("Highest Quality")]
+        [SerializeField]
+        private Vector2 highestInnerRadii = new Vector2(0.40f, 0.40f);
+        [SerializeField]
+        private Vector2 highestMiddleRadii = new Vector2(0.55f, 0.55f);
+        [SerializeField]
+        private ShadingRate highestInnerRate = ShadingRate.SUPESAMPLING_X4;
+        [SerializeField]
+        private ShadingRate highestMiddleRate = ShadingRate.NORMAL;
+        [SerializeField]
+        private ShadingRate highestPeripheralRate = ShadingRate.REDUCTION_2X2;
+
+        public FoveationGovernorState State { get; private set; }
+
+        private void OnEnable()
+        {
+            Configure(true);
+        }
+
+        private void OnDisable()
+        {
+            Configure(false);
+        }
+
+        private void OnValidate()
+        {
+            if (isActiveAndEnabled)
+            {
+                Configure(true);
+            }
+        }
+
+        void Update()
+        {
+            VrsPluginApi.SubmitFrameTime(Time.unscaledDeltaTime * 1000.0f);
+
+            VrsPluginApi.GetFoveationGovernorState(out FoveationGovernorState state);
+            State = state;
+        }
+
+        private void Configure(bool enable)
+        {
+            var settings = new FoveationGovernorSettings
+            {
+                enabled = enable,
+                targetFrameTimeMs = 1000.0f / Mathf.Max(targetFrameRate, 1.0f),
+                hysteresis = hysteresis,
+                smoothing = smoothing,
+                holdFrames = holdFrames,
+                maxStep = maxStep,
+                lowestQuality = new FoveationDesc
+                {
+                    innerRadii = lowestInnerRadii,
+                    middleRadii = lowestMiddleRadii,
+                    peripheralRadii = new Vector2(1.0f, 1.0f),
+                    innerRate = lowestInnerRate,
+                    middleRate = lowestMiddleRate,
+                    peripheralRate = lowestPeripheralRate
+                },
+                highestQuality = new FoveationDesc
+                {
+                    innerRadii = highestInnerRadii,
+                    middleRadii = highestMiddleRadii,
+                    peripheralRadii = new Vector2(1.0f, 1.0f),
+                    innerRate = highestInnerRate,
+                    middleRate = highestMiddleRate,
+                    peripheralRate = highestPeripheralRate
+                }
+            };
+            VrsPluginApi.ConfigureFoveationGovernor(ref settings);
+        }
+    }
+}
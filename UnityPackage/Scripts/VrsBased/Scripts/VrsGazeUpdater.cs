@@ -1,5 +1,6 @@
 ﻿// VrsBased/Scripts/VrsGazeUpdater.cs
 
+using System.Collections;
 using UnityEngine;
 using GazeTracking;
 
@@ -9,7 +10,9 @@ namespace FoveatedRenderingVRS
     {
         Plugin,
         Mouse,
-        Python
+        Python,
+        NativeReceiver,  // Binary UDP packets decoded inside the VRS plugin
+        SharedRing       // Shared-memory ring of the GazeTracking tools (BeamSDK), read inside the VRS plugin
     }
 
     public class VrsGazeUpdater : MonoBehaviour
@@ -23,10 +26,20 @@ namespace FoveatedRenderingVRS
         [SerializeField]
         float muly = 0.59f;
 
+        // UDP port of the native receiver
+        [SerializeField]
+        int nativeReceiverPort = 50666;
+
+        // Mapping name the GazeTracking publisher was started with (--name)
+        [SerializeField]
+        string sharedRingName = "FoveatedGaze";
+
         public float x;
         public float y;
 
         private GazeUpdater gazeImplementation;
+        private Coroutine presentFrameRoutine;
+        private readonly WaitForEndOfFrame endOfFrame = new WaitForEndOfFrame();
 
         private void Awake()
         {
@@ -41,10 +54,20 @@ namespace FoveatedRenderingVRS
         private void OnEnable()
         {
             InitializeGazeImplementation();
+            presentFrameRoutine = StartCoroutine(IssuePresentFrame());
         }
 
         private void OnDisable()
         {
+            if (presentFrameRoutine != null)
+            {
+                StopCoroutine(presentFrameRoutine);
+                presentFrameRoutine = null;
+            }
+
+            VrsPluginApi.StopGazeReceiver();
+            VrsPluginApi.StopSharedGazeReader();
+
             // Cleanup Gaze
             if (gazeImplementation != null)
             {
@@ -58,6 +81,16 @@ namespace FoveatedRenderingVRS
             RefreshGazeDirection();
         }
 
+        // Closes the motion-to-photon accounting of the frame once it has been rendered
+        private IEnumerator IssuePresentFrame()
+        {
+            while (true)
+            {
+                yield return endOfFrame;
+                GL.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.PRESENT_FRAME);
+            }
+        }
+
         private void InitializeGazeImplementation()
         {
             // Cleanup existing implementation if any
@@ -66,6 +99,27 @@ namespace FoveatedRenderingVRS
                 gazeImplementation.Cleanup();
                 gazeImplementation = null;
             }
+            VrsPluginApi.StopGazeReceiver();
+            VrsPluginApi.StopSharedGazeReader();
+
+            // Native receiver pushes gaze inside the plugin, no managed implementation needed
+            if (gazeTrackingMethod == GazeTrackingMethod.NativeReceiver)
+            {
+                if (!VrsPluginApi.StartGazeReceiver(nativeReceiverPort))
+                {
+                    Debug.LogError($"VrsGazeUpdater: Cannot start native gaze receiver on port {nativeReceiverPort}.");
+                }
+                return;
+            }
+
+            if (gazeTrackingMethod == GazeTrackingMethod.SharedRing)
+            {
+                if (!VrsPluginApi.StartSharedGazeReader(sharedRingName))
+                {
+                    Debug.LogError($"VrsGazeUpdater: Cannot start shared gaze reader on ring {sharedRingName}.");
+                }
+                return;
+            }
 
             // Instantiate the correct implementation
             switch (gazeTrackingMethod)
@@ -88,6 +142,16 @@ namespace FoveatedRenderingVRS
 
         private void RefreshGazeDirection()
         {
+            if (gazeTrackingMethod == GazeTrackingMethod.NativeReceiver || gazeTrackingMethod == GazeTrackingMethod.SharedRing)
+            {
+                // Report back in the same [-1, 1] mirrored convention as the other updaters
+                Vector2 nativeGaze = VrsPluginApi.GetGazePosition();
+                x = -nativeGaze.x * 2.0f;
+                y = nativeGaze.y * 2.0f;
+                GL.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.UPDATE_GAZE);
+                return;
+            }
+
             if (gazeImplementation == null)
                 return;
 
@@ -0,0 +1,184 @@
+﻿using UnityEngine;
+using UnityEngine.Rendering;
+using FoveatedRenderingVRS;
+
+namespace FoveatedRenderingVRS_BIRP
+{
+    /// <summary>
+    /// Foveates an extra camera (spectator, mirror, render-to-texture view) on its own foveation context,
+    /// next to the VrsBirpController of the main camera. The context has its own render target, FOV,
+    /// configuration and fixed gaze direction; the governor keeps regulating the main camera only.
+    /// </summary>
+    [RequireComponent(typeof(Camera))]
+    public class VrsSecondaryCamera : MonoBehaviour
+    {
+        private Camera secondaryCamera = null;
+        private VrsBirpCommandBufferManager bufferManager = new VrsBirpCommandBufferManager();
+        // Latches gaze and enables this camera's context, the context is filled in on every enable
+        private readonly VrsCommandPacket enablePacket = new VrsCommandPacket();
+
+        private int context = -1;
+        private bool renderingActive = false;
+        private int renderTargetWidth = 0;
+        private int renderTargetHeight = 0;
+
+        [SerializeField]
+        private Vector2 innerRadius = new Vector2(0.7f, 0.4f);
+        [SerializeField]
+        private Vector2 middleRadius = new Vector2(1, 0.7f);
+        [SerializeField]
+        private Vector2 peripheralRadius = new Vector2(5, 5);
+
+        [SerializeField]
+        private ShadingRate innerRate = ShadingRate.NORMAL;
+        [SerializeField]
+        private ShadingRate middleRate = ShadingRate.REDUCTION_2X2;
+        [SerializeField]
+        private ShadingRate peripheralRate = ShadingRate.REDUCTION_4X4;
+
+        [Tooltip("View-space direction the full-rate region is centered on.")]
+        [SerializeField]
+        private Vector3 gazeDirection = new Vector3(0.0f, 0.0f, 1.0f);
+
+        /// <summary>
+        /// Foveation context of this camera, -1 while none is held.
+        /// </summary>
+        public int Context => context;
+
+        /// <summary>
+        /// Enables or disables foveated rendering of this camera, a disabled context shades at full rate.
+        /// </summary>
+        public void ToggleFoveatedRendering(bool activate)
+        {
+            if (context >= 0 && activate != renderingActive)
+            {
+                renderingActive = activate;
+                VrsPluginApi.SetFoveationContextEnabled(context, activate);
+            }
+        }
+
+        /// <summary>
+        /// Moves the full-rate region of this camera.
+        /// </summary>
+        public void SetGazeDirection(Vector3 direction)
+        {
+            gazeDirection = direction;
+            if (context >= 0)
+            {
+                VrsPluginApi.UpdateContextGazeDirection(context, gazeDirection);
+            }
+        }
+
+        private void ConfigureRenderTarget()
+        {
+            renderTargetWidth = secondaryCamera.pixelWidth;
+            renderTargetHeight = secondaryCamera.pixelHeight;
+            VrsPluginApi.ConfigureContextRenderTarget(context, renderTargetWidth, renderTargetHeight);
+        }
+
+        private void SubmitConfiguration()
+        {
+            var config = new VrsConfiguration
+            {
+                shadingRatePreset = ShadingRatePreset.SHADING_RATE_CUSTOM,
+                foveationPatternPreset = ShadingPatternPreset.SHADING_PATTERN_CUSTOM,
+                innerRadii = innerRadius,
+                middleRadii = middleRadius,
+                peripheralRadii = peripheralRadius,
+                innerRate = innerRate,
+                middleRate = middleRate,
+                peripheralRate = peripheralRate
+            };
+            VrsPluginApi.SubmitContextConfiguration(context, ref config);
+        }
+
+        void OnEnable()
+        {
+            secondaryCamera = GetComponent<Camera>();
+            context = VrsPluginApi.CreateFoveationContext();
+            if (context < 0)
+            {
+                Debug.LogWarning("VrsSecondaryCamera: No foveation context left, " + name + " renders at full rate.");
+                return;
+            }
+
+            VrsPluginApi.SetContextRenderMode(context, VrsRenderMode.MONO);
+            ConfigureRenderTarget();
+            if (!VrsPluginApi.InitializeContextFoveatedRendering(context, secondaryCamera.fieldOfView, secondaryCamera.aspect))
+            {
+                Debug.LogWarning("VrsSecondaryCamera: Cannot initialize foveated rendering for " + name);
+                VrsPluginApi.DestroyFoveationContext(context);
+                context = -1;
+                return;
+            }
+
+            SubmitConfiguration();
+            VrsPluginApi.UpdateContextGazeDirection(context, gazeDirection);
+
+            // Select the context first, the packet would otherwise act on the main camera's
+            enablePacket.Clear();
+            enablePacket.SelectContext(context)
+                .Add(VrsRenderCommandOp.LATCH_GAZE)
+                .Add(VrsRenderCommandOp.ENABLE);
+
+            int bufferContext = context;
+            var currentPath = secondaryCamera.actualRenderingPath;
+            if (currentPath == RenderingPath.Forward)
+            {
+                bufferManager.AddCommandBuffer("Enable Foveated Rendering - Secondary", CameraEvent.BeforeForwardOpaque,
+                    cmd => enablePacket.Issue(cmd));
+
+                bufferManager.AddCommandBuffer("Disable Foveated Rendering - Secondary", CameraEvent.AfterForwardAlpha,
+                    cmd => VrsPluginApi.IssueContextEvent(cmd, FoveatedEventID.DISABLE_FOVEATED_RENDERING, bufferContext));
+            }
+            else if (currentPath == RenderingPath.DeferredShading)
+            {
+                bufferManager.AddCommandBuffer("Enable Foveated Rendering - Secondary GBuffer", CameraEvent.BeforeGBuffer,
+                    cmd => enablePacket.Issue(cmd));
+
+                bufferManager.AddCommandBuffer("Disable Foveated Rendering - Secondary GBuffer", CameraEvent.AfterGBuffer,
+                    cmd => VrsPluginApi.IssueContextEvent(cmd, FoveatedEventID.DISABLE_FOVEATED_RENDERING, bufferContext));
+
+                bufferManager.AddCommandBuffer("Enable Foveated Rendering - Secondary Alpha", CameraEvent.BeforeForwardAlpha,
+                    cmd => enablePacket.Issue(cmd));
+
+                bufferManager.AddCommandBuffer("Disable Foveated Rendering - Secondary Alpha", CameraEvent.AfterForwardAlpha,
+                    cmd => VrsPluginApi.IssueContextEvent(cmd, FoveatedEventID.DISABLE_FOVEATED_RENDERING, bufferContext));
+            }
+
+            bufferManager.EnableBuffers(secondaryCamera);
+            ToggleFoveatedRendering(true);
+        }
+
+        void OnPreRender()
+        {
+            // Render textures of the camera may be resized, the rate image follows its target
+            if (context >= 0 && (secondaryCamera.pixelWidth != renderTargetWidth || secondaryCamera.pixelHeight != renderTargetHeight))
+            {
+                ConfigureRenderTarget();
+            }
+        }
+
+        void OnDisable()
+        {
+            if (context < 0)
+            {
+                return;
+            }
+
+            bufferManager.DisableBuffers(secondaryCamera);
+            bufferManager.ClearAllBuffers();
+
+            // Queued events skip the context from here on, the render thread releases it with its backend
+            VrsPluginApi.DestroyFoveationContext(context);
+            context = -1;
+            renderingActive = false;
+        }
+
+        void OnDestroy()
+        {
+            // Outlives OnDisable, frames queued before the buffers were removed may still read it
+            enablePacket.Dispose();
+        }
+    }
+}
@@ -1,4 +1,4 @@
-// Assets/Plugins/VrsBased/Scripts/VrsUrpController.cs
+﻿// Assets/Plugins/VrsBased/Scripts/VrsUrpController.cs
 
 using UnityEngine;
 using UnityEngine.Rendering;
@@ -33,6 +33,14 @@ public class VrsUrpController : MonoBehaviour
     [SerializeField]
     private ShadingRate peripheralRate = ShadingRate.REDUCTION_4X4;
 
+    [Header("Preset File")]
+    [Tooltip("Preset file written by the PresetOptimizer tool, relative to StreamingAssets. Empty keeps the radii and rates above.")]
+    [SerializeField]
+    private string foveationPresetFile = "";
+    [Tooltip("Entry of the preset file to start with, entries are sorted from cheapest to best quality.")]
+    [SerializeField]
+    private int foveationPresetIndex = 0;
+
     private Camera mainCamera;
 
     [Header("Zone Visualizer")]
@@ -62,11 +70,27 @@ public class VrsUrpController : MonoBehaviour
         }
         mainCamera = GetComponent<Camera>();
 
-        // Initialize foveated rendering
+        // Initialize foveated rendering, XR cameras foveate each eye around its own gaze
+        VrsPluginApi.SetRenderMode(mainCamera.stereoEnabled ? VrsRenderMode.STEREO : VrsRenderMode.MONO);
+        if (mainCamera.stereoEnabled)
+        {
+            // Double-wide eye texture
+            VrsPluginApi.ConfigureVrsRenderTarget(UnityEngine.XR.XRSettings.eyeTextureWidth * 2, UnityEngine.XR.XRSettings.eyeTextureHeight);
+        }
+        else
+        {
+            VrsPluginApi.ConfigureVrsRenderTarget(mainCamera.pixelWidth, mainCamera.pixelHeight);
+        }
         renderingInitialized = VrsPluginApi.InitializeFoveatedRendering(mainCamera.fieldOfView, mainCamera.aspect);
 
         if (renderingInitialized)
         {
+            if (mainCamera.stereoEnabled)
+            {
+                ConfigureEyeFrustum(Eye.LEFT, mainCamera.GetStereoProjectionMatrix(Camera.StereoscopicEye.Left));
+                ConfigureEyeFrustum(Eye.RIGHT, mainCamera.GetStereoProjectionMatrix(Camera.StereoscopicEye.Right));
+            }
+
             // Attach and configure GazeUpdater
             bool isGazeAttached = VrsGazeUpdater.AttachGazeUpdater(gameObject, gazeTrackingMethod);
 
@@ -78,8 +102,8 @@ public class VrsUrpController : MonoBehaviour
             // Store reference for dynamic switching
             gazeUpdater = GetComponent<VrsGazeUpdater>();
 
-            ConfigureShadingRatePreset(currentShadingPreset);
-            ConfigureShadingPatternPreset(currentPatternPreset);
+            LoadFoveationPresetFile();
+            SubmitConfiguration();
 
             VrsPluginApi.UpdateGazeDirection(Vector3.forward);
             GL.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.UPDATE_GAZE);
@@ -120,6 +144,18 @@ public class VrsUrpController : MonoBehaviour
         }
     }
 
+    /// <summary>
+    /// Passes the asymmetric frustum of an eye projection to the plugin.
+    /// </summary>
+    private static void ConfigureEyeFrustum(Eye eye, Matrix4x4 projection)
+    {
+        VrsPluginApi.ConfigureViewFrustum(eye,
+            (projection.m02 - 1.0f) / projection.m00,
+            (projection.m02 + 1.0f) / projection.m00,
+            (projection.m12 + 1.0f) / projection.m11,
+            (projection.m12 - 1.0f) / projection.m11);
+    }
+
     void Update()
     {
         if (BorderOn && renderingInitialized && zoneVisualizer != null)
@@ -136,15 +172,8 @@ public class VrsUrpController : MonoBehaviour
     {
         if (renderingInitialized)
         {
-            VrsPluginApi.SetShadingRatePreset(preset);
             currentShadingPreset = preset;
-
-            if (preset == ShadingRatePreset.SHADING_RATE_CUSTOM)
-            {
-                AssignShadingRate(TargetArea.INNER, innerRate);
-                AssignShadingRate(TargetArea.MIDDLE, middleRate);
-                AssignShadingRate(TargetArea.PERIPHERAL, peripheralRate);
-            }
+            SubmitConfiguration();
 
             GL.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.UPDATE_GAZE);
         }
@@ -154,15 +183,8 @@ public class VrsUrpController : MonoBehaviour
     {
         if (renderingInitialized)
         {
-            VrsPluginApi.SetFoveationPatternPreset(preset);
             currentPatternPreset = preset;
-
-            if (preset == ShadingPatternPreset.SHADING_PATTERN_CUSTOM)
-            {
-                AssignRegionRadius(TargetArea.INNER, innerRadius);
-                AssignRegionRadius(TargetArea.MIDDLE, middleRadius);
-                AssignRegionRadius(TargetArea.PERIPHERAL, peripheralRadius);
-            }
+            SubmitConfiguration();
 
             GL.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.UPDATE_GAZE);
         }
@@ -172,7 +194,19 @@ public class VrsUrpController : MonoBehaviour
     {
         if (renderingInitialized)
         {
-            VrsPluginApi.ConfigureShadingRate(area, rate);
+            switch (area)
+            {
+                case TargetArea.INNER:
+                    innerRate = rate;
+                    break;
+                case TargetArea.MIDDLE:
+                    middleRate = rate;
+                    break;
+                case TargetArea.PERIPHERAL:
+                    peripheralRate = rate;
+                    break;
+            }
+            SubmitConfiguration();
             GL.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.UPDATE_GAZE);
         }
     }
@@ -181,7 +215,19 @@ public class VrsUrpController : MonoBehaviour
     {
         if (renderingInitialized)
         {
-            VrsPluginApi.ConfigureRegionRadii(area, radii);
+            switch (area)
+            {
+                case TargetArea.INNER:
+                    innerRadius = radii;
+                    break;
+                case TargetArea.MIDDLE:
+                    middleRadius = radii;
+                    break;
+                case TargetArea.PERIPHERAL:
+                    peripheralRadius = radii;
+                    break;
+            }
+            SubmitConfiguration();
             GL.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), (int)FoveatedEventID.UPDATE_GAZE);
 
             // Update ZoneVisualizer radii if INNER or MIDDLE
@@ -197,6 +243,53 @@ public class VrsUrpController : MonoBehaviour
         }
     }
 
+    /// <summary>
+    /// Adopts the configured entry of the preset file as the custom radii and rates.
+    /// </summary>
+    private void LoadFoveationPresetFile()
+    {
+        if (string.IsNullOrEmpty(foveationPresetFile))
+        {
+            return;
+        }
+
+        string path = System.IO.Path.Combine(Application.streamingAssetsPath, foveationPresetFile);
+        VrsConfiguration config;
+        if (!VrsPluginApi.LoadFoveationPreset(path, foveationPresetIndex, out config))
+        {
+            Debug.LogWarning("VrsUrpController: Cannot load entry " + foveationPresetIndex + " of preset file " + path);
+            return;
+        }
+
+        currentShadingPreset = config.shadingRatePreset;
+        currentPatternPreset = config.foveationPatternPreset;
+        innerRadius = config.innerRadii;
+        middleRadius = config.middleRadii;
+        peripheralRadius = config.peripheralRadii;
+        innerRate = config.innerRate;
+        middleRate = config.middleRate;
+        peripheralRate = config.peripheralRate;
+    }
+
+    /// <summary>
+    /// Sends presets, radii and rates to the plugin as one configuration.
+    /// </summary>
+    private void SubmitConfiguration()
+    {
+        var config = new VrsConfiguration
+        {
+            shadingRatePreset = currentShadingPreset,
+            foveationPatternPreset = currentPatternPreset,
+            innerRadii = innerRadius,
+            middleRadii = middleRadius,
+            peripheralRadii = peripheralRadius,
+            innerRate = innerRate,
+            middleRate = middleRate,
+            peripheralRate = peripheralRate
+        };
+        VrsPluginApi.SubmitVrsConfiguration(ref config);
+    }
+
     /// <summary>
     /// Switches the gaze tracking method at runtime.
     /// </summary>
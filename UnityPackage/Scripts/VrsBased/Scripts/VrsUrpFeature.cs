@@ -1,4 +1,4 @@
-using UnityEngine;
+﻿using UnityEngine;
 using UnityEngine.Rendering;
 using UnityEngine.Rendering.Universal;
 
@@ -22,18 +22,27 @@ public class VrsUrpFeature : ScriptableRendererFeature
     {
         private readonly string profilerTag;
 
+        // Latch the freshest gaze for this camera and enable in one render-thread callback
+        private readonly VrsCommandPacket packet = new VrsCommandPacket()
+            .Add(VrsRenderCommandOp.LATCH_GAZE)
+            .Add(VrsRenderCommandOp.ENABLE);
+
         public EnableFoveatedRenderingPass(string tag)
         {
             profilerTag = tag;
             renderPassEvent = RenderPassEvent.BeforeRenderingOpaques;
         }
 
+        public void Dispose()
+        {
+            packet.Dispose();
+        }
+
         // --- LEGACY PATH ---
         public override void Execute(ScriptableRenderContext context, ref RenderingData renderingData)
         {
             var cmd = CommandBufferPool.Get(profilerTag);
-            cmd.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(),
-                                 (int)FoveatedEventID.ENABLE_FOVEATED_RENDERING);
+            packet.Issue(cmd);
             context.ExecuteCommandBuffer(cmd);
             CommandBufferPool.Release(cmd);
         }
@@ -41,23 +50,24 @@ public class VrsUrpFeature : ScriptableRendererFeature
         // --- RENDER GRAPH PATH ---
         public override void RecordRenderGraph(RenderGraph renderGraph, ContextContainer frameData)
         {
-            using (var builder = renderGraph.AddRasterRenderPass<SimplePassData>(profilerTag, out var passData))
+            using (var builder = renderGraph.AddRasterRenderPass<PacketPassData>(profilerTag, out var passData))
             {
                 builder.AllowPassCulling(false); // Does nothing, without it RenderGraph skips my feature for some reason
 
-                passData.eventID = (int)FoveatedEventID.ENABLE_FOVEATED_RENDERING;
+                passData.packet = packet.Data;
 
-                builder.SetRenderFunc((SimplePassData data, RasterGraphContext rgContext) =>
+                builder.SetRenderFunc((PacketPassData data, RasterGraphContext rgContext) =>
                 {
                     var cmd = rgContext.cmd;
-                    cmd.IssuePluginEvent(VrsPluginApi.GetRenderEventFunc(), data.eventID);
+                    cmd.IssuePluginEventAndData(VrsPluginApi.GetRenderEventAndDataFunc(),
+                                                (int)FoveatedEventID.COMMAND_PACKET, data.packet);
                 });
             }
         }
 
-        private class SimplePassData
+        private class PacketPassData
         {
-            public int eventID;
+            public System.IntPtr packet;
         }
     }
 
@@ -122,6 +132,11 @@ public class VrsUrpFeature : ScriptableRendererFeature
         disablePass = new DisableFoveatedRenderingPass("Disable Foveated Rendering Pass");
     }
 
+    protected override void Dispose(bool disposing)
+    {
+        enablePass?.Dispose();
+    }
+
     public override void AddRenderPasses(ScriptableRenderer renderer, ref RenderingData renderingData)
     {
         if (settings.enableFoveatedRendering)